@@ -0,0 +1,195 @@
+#!/bin/sh
+#
+# bench.sh - measures how fast lifer reads link files in each output mode
+#
+# Copyright 2026 the Lifer contributors
+#
+# This file is part of Lifer.
+#
+#     Lifer is free software: you can redistribute it and/or modify
+#     it under the terms of the GNU General Public License as published by
+#     the Free Software Foundation, either version 3 of the License, or
+#     (at your option) any later version.
+#
+#     Lifer is distributed in the hope that it will be useful,
+#     but WITHOUT ANY WARRANTY; without even the implied warranty of
+#     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#     GNU General Public License for more details.
+#
+#     You should have received a copy of the GNU General Public License
+#     along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Usage: bench.sh [-j jobs] [-r runs] [-m "modes"] [-c old-lifer] lifer corpus
+#
+# corpus is a directory of link files or, as mklinks -d makes, a directory of
+# sub-directories of them. Each mode is timed reading the whole corpus twice:
+# one lifer at a time, sub-directory after sub-directory, then with 'jobs'
+# lifers at once (one per sub-directory, default one per processor). lifer
+# itself is single threaded so running several is how it uses more than one
+# processor. The best of 'runs' (default 3) is reported as files/sec & MB/sec
+# of link files read. With -c the same is done with old-lifer and the change
+# in speed shown, so a slower build stands out.
+#
+# The modes are txt, csv, tsv, xml, timeline, arrow, sqlite, txt-i & xml-i
+# (-i, the IDList details) and gzip (csv through --compress gzip, which
+# compresses on all processors). Output is thrown away, except for sqlite
+# which writes a database per sub-directory in a temporary directory.
+#
+# A corpus made by mklinks has an extradata.txt saying how many of each type of
+# ExtraData block it holds. Before timing anything lifer's txt output must
+# show every one of them decoded, or bench.sh stops: a block lifer skips makes
+# it look faster than it is.
+#
+# Needs a date(1) that knows %N (GNU coreutils or busybox).
+
+MODES="txt csv tsv xml timeline arrow sqlite txt-i xml-i gzip"
+
+# Run one lifer over one directory (also how xargs runs the parallel ones)
+run_shard()
+{
+  case "$2" in
+    txt-i) "$1" -i -o txt "$3" ;;
+    xml-i) "$1" -i -o xml "$3" ;;
+    gzip) "$1" --compress gzip -o csv "$3" ;;
+    sqlite)
+      db="$BENCH_TMP/$(basename "$3").db"
+      rm -f "$db"
+      "$1" -o "sqlite:$db" "$3" ;;
+    *) "$1" -o "$2" "$3" ;;
+  esac > /dev/null
+}
+if [ "$1" = "--shard" ]
+then
+  run_shard "$2" "$3" "$4"
+  exit $?
+fi
+
+now()
+{
+  date +%s%N
+}
+
+# Time (in ns) lifer $1 in mode $2 over $SHARDS, $3 at once. Prints the best
+# of $RUNS or FAIL.
+time_mode()
+{
+  best=""
+  i=0
+  while [ $i -lt "$RUNS" ]
+  do
+    start=$(now)
+    if [ "$3" -eq 1 ]
+    then
+      for s in $SHARDS
+      do
+        run_shard "$1" "$2" "$s" || { echo FAIL; return; }
+      done
+    else
+      printf '%s\n' $SHARDS | xargs -n 1 -P "$3" sh "$0" --shard "$1" "$2" || { echo FAIL; return; }
+    fi
+    t=$(( $(now) - start ))
+    if [ -z "$best" ] || [ "$t" -lt "$best" ]
+    then
+      best=$t
+    fi
+    i=$((i + 1))
+  done
+  echo "$best"
+}
+
+# Print files/sec & MB/sec for a time of $1 ns (and the change from $2 ns)
+rate()
+{
+  if [ "$1" = FAIL ] || [ "${2:-0}" = FAIL ]
+  then
+    printf '%10s %8s' FAIL ""
+    [ -n "$2" ] && printf ' %7s' ""
+    return
+  fi
+  awk -v t="$1" -v o="${2:-0}" -v f="$FILES" -v b="$BYTES" 'BEGIN {
+    s = t / 1e9
+    if (s <= 0) s = 1e-9
+    printf "%10.0f %8.2f", f / s, b / s / 1048576
+    if (o > 0) printf " %+6.1f%%", (o / t - 1) * 100
+  }'
+}
+
+JOBS=$(getconf _NPROCESSORS_ONLN 2> /dev/null || echo 2)
+RUNS=3
+OLD=""
+while getopts "j:r:m:c:h" opt
+do
+  case $opt in
+    j) JOBS=$OPTARG ;;
+    r) RUNS=$OPTARG ;;
+    m) MODES=$OPTARG ;;
+    c) OLD=$OPTARG ;;
+    *) echo "Usage: bench.sh [-j jobs] [-r runs] [-m \"modes\"] [-c old-lifer] lifer corpus" >&2
+       exit 1 ;;
+  esac
+done
+shift $((OPTIND - 1))
+if [ $# -ne 2 ] || [ ! -x "$1" ] || [ ! -d "$2" ]
+then
+  echo "Usage: bench.sh [-j jobs] [-r runs] [-m \"modes\"] [-c old-lifer] lifer corpus" >&2
+  exit 1
+fi
+LIFER=$1
+SHARDS=$(find "$2" -mindepth 1 -maxdepth 1 -type d | sort)
+[ -z "$SHARDS" ] && SHARDS=$2
+FILES=$(find "$2" -name '*.lnk' | wc -l)
+BYTES=$(find "$2" -name '*.lnk' -exec cat {} + | wc -c)
+BENCH_TMP=$(mktemp -d)
+export BENCH_TMP
+trap 'rm -rf "$BENCH_TMP"' EXIT INT TERM
+
+echo "lifer:  $LIFER${OLD:+ (against $OLD)}"
+echo "corpus: $2, $FILES files, $BYTES bytes in $(echo $SHARDS | wc -w) directories"
+echo "best of $RUNS runs, parallel is $JOBS lifers at once"
+if [ -f "$2/extradata.txt" ]
+then
+  for s in $SHARDS
+  do
+    "$LIFER" -o txt "$s"
+  done 2> /dev/null | awk 'NR == FNR { want[$1] = $2; next }
+    $1 == "BlockSignature:" { got[$2]++ }
+    END {
+      for (s in want)
+      {
+        if (got[s] + 0 != want[s])
+        {
+          printf "ExtraData block %s: %d in the corpus, %d decoded\n", s, want[s], got[s] > "/dev/stderr"
+          bad = 1
+        }
+        total += want[s]
+      }
+      if (bad) exit 1
+      printf "ExtraData check: all %d blocks decoded\n", total
+    }' "$2/extradata.txt" - || { echo "ExtraData check failed, not timing $LIFER" >&2; exit 1; }
+fi
+echo
+if [ -n "$OLD" ]
+then
+  printf '%-9s %10s %8s %7s %10s %8s %7s\n' mode "files/sec" "MB/sec" change "files/sec" "MB/sec" change
+  printf '%-9s %-27s %-27s\n' "" "---------- single ---------" "------ parallel ($JOBS) -------"
+else
+  printf '%-9s %10s %8s %10s %8s\n' mode "files/sec" "MB/sec" "files/sec" "MB/sec"
+  printf '%-9s %-19s %-19s\n' "" "----- single ------" "--- parallel ($JOBS) ---"
+fi
+for mode in $MODES
+do
+  t1=$(time_mode "$LIFER" "$mode" 1)
+  tn=$(time_mode "$LIFER" "$mode" "$JOBS")
+  o1=""
+  on=""
+  if [ -n "$OLD" ]
+  then
+    o1=$(time_mode "$OLD" "$mode" 1)
+    on=$(time_mode "$OLD" "$mode" "$JOBS")
+  fi
+  printf '%-9s ' "$mode"
+  rate "$t1" "$o1"
+  printf ' '
+  rate "$tn" "$on"
+  printf '\n'
+done
@@ -0,0 +1,875 @@
+/*********************************************************
+**                                                      **
+**                 microbench.c                         **
+**                                                      **
+** Times liblife's most used primitives, and other      **
+** implementations of them, on real link file data      **
+**                                                      **
+**        Copyright 2026 the Lifer contributors         **
+**                                                      **
+*********************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+microbench is NOT part of lifer, it is for deciding whether a change to one of
+liblife's primitives is worth making. From the ./src/bench directory:
+
+    gcc -Wall -O2 ./microbench.c ../liblife/liblife.c ../libbin2hex/libbin2hex.c -o microbench
+    ./microbench ../Test/WinXP
+
+(in Windows: CL /O2 microbench.c ..\liblife\liblife.c ..\libbin2hex\libbin2hex.c
+..\win\dirent.c ..\win\getopt.c). The link files in the directories named
+(and their sub-directories, default ../Test/WinXP) are decoded once and the
+inputs each primitive really gets are collected from them: every offset in
+the files for get_le_uint16/32/64, the Unicode StringData for get_le_unistr,
+the header times for get_filetime_a_short/long, the tracker droids & format
+IDs for get_droid_a, the ItemIDs for find_propstores & bin2hex_buf (as the
+XML output calls it) and the property stores found for get_propstore_a.
+
+Each primitive has a table of implementations, the first being liblife's
+own. Every implementation is called through a function pointer, as liblife's
+are from another file, for passes over all the inputs until -t ms (default
+200) have gone by, the best of -r (default 3) is reported as ns per call and
+MB/sec of input. The results of each pass are hashed and an implementation
+whose results differ from liblife's is marked DIFFERS. To try out a new
+version of a primitive add it to impls[] below. -p picks the primitives to
+run (e.g. -p get_le_unistr,bin2hex).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <wchar.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#include "../win/dirent.h"
+#include "../win/getopt.h"
+#else
+#include <dirent.h>
+#include <getopt.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MB_SSE2
+#endif
+#include "../liblife/liblife.h"
+#include "../libbin2hex/libbin2hex.h"
+
+// liblife's own primitives, not exported from liblife.h
+uint16_t get_le_uint16(unsigned char[], int);
+uint32_t get_le_uint32(unsigned char[], int);
+uint64_t get_le_uint64(unsigned char[], int);
+int get_le_unistr(unsigned char[], int, int, wchar_t[]);
+void get_filetime_a_short(int64_t, unsigned char[]);
+void get_filetime_a_long(int64_t, unsigned char[]);
+void get_droid_a(struct LIF_CLSID *, struct LIF_CLSID_A *);
+
+#define MB_MAXFILES   20000         // Link files read at most
+#define MB_MAXSIZE    65536         // Largest link file read
+#define MB_PAD        16            // Zeroes after each file (for the SSE2 get_le_unistr)
+#define MB_MAXSTORES  4000          // Property stores kept at most
+
+typedef void(*MB_FN)(void);         // Any implementation (cast to its real type to call it)
+
+struct MB_BUF                       // Some bytes from a link file
+{
+  unsigned char     * data;
+  int                 size;
+  uint64_t            posn;         // Their offset in the file
+};
+
+struct MB_STR                       // A Unicode string in a link file
+{
+  unsigned char     * data;
+  int                 pos;
+  int                 max;
+};
+
+struct MB_PRIM
+{
+  const char        * name;
+  uint64_t         (* pass)(MB_FN); // One pass over the inputs, returns a hash of the results
+  uint64_t            ops;          // Calls per pass
+  uint64_t            bytes;        // Bytes of input per pass
+};
+
+struct MB_IMPL
+{
+  int                 prim;         // MB_PRIM index
+  const char        * name;
+  MB_FN               fn;
+};
+
+// The inputs
+static struct MB_BUF   files[MB_MAXFILES];
+static struct MB_BUF   items[MB_MAXFILES * ITEMIDS];
+static struct MB_STR   strs[MB_MAXFILES * 5];
+static int64_t         times[MB_MAXFILES * 3];
+static struct LIF_CLSID droids[MB_MAXFILES * 8];
+static struct LIF_SER_PROPSTORE * stores;
+static int nfiles, nitems, nstrs, ntimes, ndroids, nstores;
+static struct LIF lif;              // Far too big for the stack
+
+//Local function declarations
+uint64_t hash(uint64_t, const void *, size_t);
+int64_t now_ns(void);
+void load_file(const char *);
+void load_dir(const char *, int);
+uint16_t le16_shift(unsigned char[], int);
+uint32_t le32_shift(unsigned char[], int);
+uint64_t le64_shift(unsigned char[], int);
+uint16_t le16_memcpy(unsigned char[], int);
+uint32_t le32_memcpy(unsigned char[], int);
+uint64_t le64_memcpy(unsigned char[], int);
+int unistr_scalar(unsigned char[], int, int, wchar_t[]);
+int unistr_sse2(unsigned char[], int, int, wchar_t[]);
+int ft_civil(int64_t, unsigned char[], int);
+void ft_short_table(int64_t, unsigned char[]);
+void ft_long_table(int64_t, unsigned char[]);
+int find_memchr(unsigned char *, int, uint64_t, struct LIF_PROPERTY_STORE_PROPS *);
+size_t b2h_snprintf(char *, size_t, const unsigned char *, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int);
+uint64_t pass_le16(MB_FN);
+uint64_t pass_le32(MB_FN);
+uint64_t pass_le64(MB_FN);
+uint64_t pass_unistr(MB_FN);
+uint64_t pass_ft_short(MB_FN);
+uint64_t pass_ft_long(MB_FN);
+uint64_t pass_droid(MB_FN);
+uint64_t pass_find(MB_FN);
+uint64_t pass_psa(MB_FN);
+uint64_t pass_b2h(MB_FN);
+
+enum { P_LE16, P_LE32, P_LE64, P_UNISTR, P_FT_SHORT, P_FT_LONG, P_DROID, P_FIND, P_PSA, P_B2H, NUMPRIMS };
+
+static struct MB_PRIM prims[NUMPRIMS] =
+{
+  { "get_le_uint16", pass_le16, 0, 0 },
+  { "get_le_uint32", pass_le32, 0, 0 },
+  { "get_le_uint64", pass_le64, 0, 0 },
+  { "get_le_unistr", pass_unistr, 0, 0 },
+  { "get_filetime_a_short", pass_ft_short, 0, 0 },
+  { "get_filetime_a_long", pass_ft_long, 0, 0 },
+  { "get_droid_a", pass_droid, 0, 0 },
+  { "find_propstores", pass_find, 0, 0 },
+  { "get_propstore_a", pass_psa, 0, 0 },
+  { "bin2hex", pass_b2h, 0, 0 }
+};
+
+// The implementations, liblife's first for each primitive
+static const struct MB_IMPL impls[] =
+{
+  { P_LE16, "liblife", (MB_FN)get_le_uint16 },
+  { P_LE16, "shift", (MB_FN)le16_shift },
+  { P_LE16, "memcpy", (MB_FN)le16_memcpy },
+  { P_LE32, "liblife", (MB_FN)get_le_uint32 },
+  { P_LE32, "shift", (MB_FN)le32_shift },
+  { P_LE32, "memcpy", (MB_FN)le32_memcpy },
+  { P_LE64, "liblife", (MB_FN)get_le_uint64 },
+  { P_LE64, "shift", (MB_FN)le64_shift },
+  { P_LE64, "memcpy", (MB_FN)le64_memcpy },
+  { P_UNISTR, "liblife", (MB_FN)get_le_unistr },
+  { P_UNISTR, "scalar", (MB_FN)unistr_scalar },
+#ifdef MB_SSE2
+  { P_UNISTR, "sse2", (MB_FN)unistr_sse2 },
+#endif
+  { P_FT_SHORT, "liblife", (MB_FN)get_filetime_a_short },
+  { P_FT_SHORT, "table", (MB_FN)ft_short_table },
+  { P_FT_LONG, "liblife", (MB_FN)get_filetime_a_long },
+  { P_FT_LONG, "table", (MB_FN)ft_long_table },
+  { P_DROID, "liblife", (MB_FN)get_droid_a },
+  { P_FIND, "liblife", (MB_FN)find_propstores },
+  { P_FIND, "memchr", (MB_FN)find_memchr },
+  { P_PSA, "liblife", (MB_FN)get_propstore_a },
+  { P_B2H, "liblife", (MB_FN)bin2hex_buf },
+  { P_B2H, "snprintf", (MB_FN)b2h_snprintf }
+};
+#define NUMIMPLS (sizeof(impls) / sizeof(impls[0]))
+
+int main(int argc, char *argv[])
+{
+  int opt, rounds = 3, r, want[NUMPRIMS];
+  unsigned int i, j;
+  int64_t mintime = 200000000, start, t, best;
+  uint64_t passes, ref = 0, h;
+  char *p;
+
+  for (j = 0; j < NUMPRIMS; j++)
+  {
+    want[j] = 1;
+  }
+  while ((opt = getopt(argc, argv, "t:r:p:h")) != -1)
+  {
+    switch (opt)
+    {
+    case 't':
+      mintime = atol(optarg) * 1000000LL;
+      break;
+    case 'r':
+      rounds = atoi(optarg);
+      break;
+    case 'p':
+      for (j = 0; j < NUMPRIMS; j++)
+      {
+        want[j] = 0;
+      }
+      for (p = strtok(optarg, ","); p != NULL; p = strtok(NULL, ","))
+      {
+        for (j = 0; (j < NUMPRIMS) && (strcmp(p, prims[j].name) != 0); j++);
+        if (j == NUMPRIMS)
+        {
+          fprintf(stderr, "Unknown primitive '%s'\n", p);
+          return 1;
+        }
+        want[j] = 1;
+      }
+      break;
+    default:
+      fprintf(stderr, "Usage: microbench [-t ms] [-r rounds] [-p primitive,...] [directory|file ...]\n");
+      return 1;
+    }
+  }
+  if ((rounds < 1) || (mintime <= 0))
+  {
+    fprintf(stderr, "Usage: microbench [-t ms] [-r rounds] [-p primitive,...] [directory|file ...]\n");
+    return 1;
+  }
+  if ((stores = malloc(MB_MAXSTORES * sizeof(struct LIF_SER_PROPSTORE))) == NULL)
+  {
+    fprintf(stderr, "Unable to allocate memory for the property stores\n");
+    return 1;
+  }
+  if (optind >= argc)
+  {
+    load_dir("../Test/WinXP", 0);
+  }
+  for (; optind < argc; optind++)
+  {
+    load_dir(argv[optind], 0);
+  }
+  if (nfiles == 0)
+  {
+    fprintf(stderr, "No link files found\n");
+    return 1;
+  }
+  prims[P_LE16].bytes = prims[P_LE16].ops * 2;
+  prims[P_LE32].bytes = prims[P_LE32].ops * 4;
+  prims[P_LE64].bytes = prims[P_LE64].ops * 8;
+  prims[P_FT_SHORT].bytes = prims[P_FT_SHORT].ops * 8;
+  prims[P_FT_LONG].bytes = prims[P_FT_LONG].ops * 8;
+  printf("%d link files: %d ItemIDs, %d Unicode strings, %d times, %d droids/format IDs, %d property stores\n\n",
+    nfiles, nitems, nstrs, ntimes, ndroids, nstores);
+  printf("%-21s %-9s %10s %10s %10s  %s\n", "primitive", "impl", "calls/pass", "ns/call", "MB/sec", "results");
+
+  for (i = 0; i < NUMIMPLS; i++)
+  {
+    if (!want[impls[i].prim] || (prims[impls[i].prim].ops == 0))
+    {
+      continue;
+    }
+    h = prims[impls[i].prim].pass(impls[i].fn); // Warm up (& the results)
+    if (strcmp(impls[i].name, "liblife") == 0)
+    {
+      ref = h;
+    }
+    best = 0;
+    for (r = 0; r < rounds; r++)
+    {
+      passes = 0;
+      start = now_ns();
+      do
+      {
+        prims[impls[i].prim].pass(impls[i].fn);
+        passes++;
+      } while ((t = now_ns() - start) < mintime);
+      t /= passes;
+      if ((best == 0) || (t < best))
+      {
+        best = t;
+      }
+    }
+    printf("%-21s %-9s %10"PRIu64" %10.2f %10.1f  %s\n", prims[impls[i].prim].name, impls[i].name,
+      prims[impls[i].prim].ops, (double)best / prims[impls[i].prim].ops,
+      prims[impls[i].prim].bytes / (best / 1e9) / 1048576,
+      (strcmp(impls[i].name, "liblife") == 0) ? "reference" : ((h == ref) ? "same" : "DIFFERS"));
+  }
+  return 0;
+}
+
+//
+//Function: hash() adds size bytes at p to the FNV-1a hash h
+uint64_t hash(uint64_t h, const void * p, size_t size)
+{
+  const unsigned char *b = p;
+
+  while (size-- > 0)
+  {
+    h = (h ^ *b++) * 0x100000001B3ULL;
+  }
+  return h;
+}
+
+//
+//Function: now_ns() returns the monotonic clock in ns
+int64_t now_ns(void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER freq, now;
+
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (int64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+#endif
+}
+
+//
+//Function: load_file() reads a link file, decodes it and collects the
+//          inputs for each primitive from it
+void load_file(const char * fname)
+{
+  FILE *fp;
+  unsigned char *data;
+  int size, i, j, pos;
+  struct LIF_PROPERTY_STORE_PROPS *psp;
+
+  if ((nfiles >= MB_MAXFILES) || ((fp = fopen(fname, "rb")) == NULL))
+  {
+    return;
+  }
+  fseek(fp, 0, SEEK_END);
+  size = (int)ftell(fp);
+  if ((size < 0x4C) || (size > MB_MAXSIZE) || (test_link(fp) != 0) ||
+    ((data = calloc(size + MB_PAD, 1)) == NULL))
+  {
+    fclose(fp);
+    return;
+  }
+  fseek(fp, 0, SEEK_SET);
+  if ((fread(data, 1, size, fp) != (size_t)size) || (get_lif_at(fp, 0, size, LIF_SEC_ALL, &lif) < 0))
+  {
+    free(data);
+    fclose(fp);
+    return;
+  }
+  fclose(fp);
+  files[nfiles].data = data;
+  files[nfiles].size = size;
+  files[nfiles++].posn = 0;
+  prims[P_LE16].ops += size - 1;
+  prims[P_LE32].ops += size - 3;
+  prims[P_LE64].ops += size - 7;
+
+  // The Unicode StringData strings (found as get_stringdata() does)
+  pos = 0x4C + ((lif.lh.Flags & 0x00000001) ? lif.lidl.IDListSize + 2 : 0) + ((lif.lh.Flags & 0x00000002) ? lif.li.Size : 0);
+  for (i = 0; (i < 5) && (lif.lh.Flags & 0x00000080); i++)
+  {
+    if ((lif.lh.Flags & (0x00000004 << i)) && (pos + 2 <= size))
+    {
+      j = get_le_uint16(data, pos);
+      if (pos + 2 + (j * 2) > size)
+      {
+        break;
+      }
+      strs[nstrs].data = data;
+      strs[nstrs].pos = pos + 2;
+      strs[nstrs++].max = (j + 1 < 300) ? j + 1 : 300; // As get_stringdata() limits them
+      prims[P_UNISTR].ops++;
+      prims[P_UNISTR].bytes += j * 2;
+      pos += 2 + (j * 2);
+    }
+  }
+
+  times[ntimes++] = lif.lh.CrDate;
+  times[ntimes++] = lif.lh.AcDate;
+  times[ntimes++] = lif.lh.WtDate;
+  prims[P_FT_SHORT].ops += 3;
+  prims[P_FT_LONG].ops += 3;
+
+  if (lif.led.edtypes & TRACKER_PROPS)
+  {
+    droids[ndroids++] = lif.led.ltp.Droid1;
+    droids[ndroids++] = lif.led.ltp.Droid2;
+    droids[ndroids++] = lif.led.ltp.DroidBirth1;
+    droids[ndroids++] = lif.led.ltp.DroidBirth2;
+    prims[P_DROID].ops += 4;
+  }
+
+  // The ItemIDs, and the property stores in them & the ExtraData
+  for (i = 0; i < lif.lidl.NumItemIDs; i++)
+  {
+    items[nitems].data = data + lif.lidl.Items[i].Posn + 2;
+    items[nitems].size = lif.lidl.Items[i].ItemIDSize - 2;
+    items[nitems++].posn = lif.lidl.Items[i].Posn + 2;
+    prims[P_FIND].ops++;
+    prims[P_FIND].bytes += lif.lidl.Items[i].ItemIDSize - 2;
+    prims[P_B2H].ops++;
+    prims[P_B2H].bytes += lif.lidl.Items[i].ItemIDSize - 2;
+  }
+  psp = &lif.led.lpsp;
+  for (i = -1; i < lif.lidl.NumItemIDs; i++)
+  {
+    if (i >= 0)
+    {
+      if (find_propstores(lif.lidl.Items[i].Data, lif.lidl.Items[i].ItemIDSize - 2, 0, psp) != 0)
+      {
+        continue;
+      }
+    }
+    else if (!(lif.led.edtypes & PROPERTY_STORE_PROPS))
+    {
+      continue;
+    }
+    for (j = 0; (j < psp->NumStores) && (nstores < MB_MAXSTORES); j++)
+    {
+      stores[nstores++] = psp->Stores[j];
+      prims[P_PSA].ops++;
+      prims[P_PSA].bytes += psp->Stores[j].StorageSize;
+      droids[ndroids++] = psp->Stores[j].FormatID;
+      prims[P_DROID].ops++;
+    }
+  }
+  prims[P_DROID].bytes = prims[P_DROID].ops * 16;
+}
+
+//
+//Function: load_dir() loads the link files in a directory and its
+//          sub-directories (or a single file)
+void load_dir(const char * name, int depth)
+{
+  DIR *dp;
+  struct dirent *entry;
+  struct stat st;
+  char path[4096];
+
+  if (stat(name, &st) != 0)
+  {
+    perror("Error");
+    fprintf(stderr, "whilst reading: \'%s\'\n", name);
+    return;
+  }
+  if ((st.st_mode & S_IFMT) == S_IFREG)
+  {
+    load_file(name);
+    return;
+  }
+  if ((depth > 8) || ((dp = opendir(name)) == NULL))
+  {
+    return;
+  }
+  while ((entry = readdir(dp)) != NULL)
+  {
+    if ((strcmp(entry->d_name, ".") != 0) && (strcmp(entry->d_name, "..") != 0))
+    {
+      snprintf(path, sizeof(path), "%s/%s", name, entry->d_name);
+      load_dir(path, depth + 1);
+    }
+  }
+  closedir(dp);
+}
+
+//
+//Functions: le16_shift(), le32_shift() & le64_shift() read little endian
+//           integers with one expression of shifts
+uint16_t le16_shift(unsigned char buf[], int pos)
+{
+  return (uint16_t)(buf[pos] | (buf[pos + 1] << 8));
+}
+uint32_t le32_shift(unsigned char buf[], int pos)
+{
+  return (uint32_t)buf[pos] | ((uint32_t)buf[pos + 1] << 8) | ((uint32_t)buf[pos + 2] << 16) | ((uint32_t)buf[pos + 3] << 24);
+}
+uint64_t le64_shift(unsigned char buf[], int pos)
+{
+  return (uint64_t)le32_shift(buf, pos) | ((uint64_t)le32_shift(buf, pos + 4) << 32);
+}
+
+//
+//Functions: le16_memcpy(), le32_memcpy() & le64_memcpy() copy the bytes into
+//           an integer (one unaligned load) and swap them on big endian
+//           machines
+static const union { uint16_t u; unsigned char c[2]; } mb_endian = { 1 };
+uint16_t le16_memcpy(unsigned char buf[], int pos)
+{
+  uint16_t v;
+
+  memcpy(&v, buf + pos, 2);
+  return mb_endian.c[0] ? v : (uint16_t)((v >> 8) | (v << 8));
+}
+uint32_t le32_memcpy(unsigned char buf[], int pos)
+{
+  uint32_t v;
+
+  memcpy(&v, buf + pos, 4);
+  return mb_endian.c[0] ? v : le32_shift(buf, pos);
+}
+uint64_t le64_memcpy(unsigned char buf[], int pos)
+{
+  uint64_t v;
+
+  memcpy(&v, buf + pos, 8);
+  return mb_endian.c[0] ? v : le64_shift(buf, pos);
+}
+
+//
+//Function: unistr_scalar() is get_le_unistr() reading each character
+//          straight from buf
+int unistr_scalar(unsigned char buf[], int pos, int max, wchar_t targ[])
+{
+  int i;
+  unsigned char *p = buf + pos;
+
+  for (i = 0; i < (max - 1); i++, p += 2)
+  {
+    if ((targ[i] = (wchar_t)(p[0] | (p[1] << 8))) == 0)
+    {
+      break;
+    }
+  }
+  targ[max - 1] = 0;
+  return i;
+}
+
+//
+//Function: unistr_sse2() is get_le_unistr() copying 8 characters at a time
+//          until a block holds the terminating zero. It reads up to 14 bytes
+//          beyond the terminator (the inputs here are padded with zeroes), in
+//          liblife it would need to know where the buffer ends.
+int unistr_sse2(unsigned char buf[], int pos, int max, wchar_t targ[])
+{
+#ifdef MB_SSE2
+  int i = 0;
+  __m128i v, zero = _mm_setzero_si128();
+
+  while (i + 8 <= (max - 1))
+  {
+    v = _mm_loadu_si128((const __m128i *)(buf + pos + (i * 2)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)) != 0)
+    {
+      break;
+    }
+    if (sizeof(wchar_t) == 4)
+    {
+      _mm_storeu_si128((__m128i *)(targ + i), _mm_unpacklo_epi16(v, zero));
+      _mm_storeu_si128((__m128i *)(targ + i + 4), _mm_unpackhi_epi16(v, zero));
+    }
+    else
+    {
+      _mm_storeu_si128((__m128i *)(targ + i), v);
+    }
+    i += 8;
+  }
+  for (; i < (max - 1); i++)
+  {
+    if ((targ[i] = (wchar_t)(buf[pos + (i * 2)] | (buf[pos + (i * 2) + 1] << 8))) == 0)
+    {
+      break;
+    }
+  }
+  targ[max - 1] = 0;
+  return i;
+#else
+  return unistr_scalar(buf, pos, max, targ);
+#endif
+}
+
+//
+//Function: ft_civil() writes 'YYYY-MM-DD HH:MM:SS' for a FILETIME to result
+//          with the date worked out arithmetically (days_from_civil in
+//          reverse) rather than by gmtime() and the digits from a table of
+//          pairs rather than strftime(). Returns 0, or -1 (having written
+//          what get_filetime_a_short() does) if the time is out of range.
+static const char mb_digits[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+int ft_civil(int64_t ft, unsigned char result[], int size)
+{
+  int64_t secs, days, era, doe, yoe, doy, mp, y, m, d, sod;
+
+  secs = ft / 10000000LL - 11644473600LL; // As liblife rounds it
+  if (!((secs > 0) && (secs < 0x7FFFFFFFL)))
+  {
+    snprintf((char *)result, size, (secs == -11644473600LL) ? "Date not set (i.e. 0 value)" : "Could not convert");
+    return -1;
+  }
+  days = secs / 86400;
+  sod = secs % 86400;
+  days += 719468;
+  era = days / 146097;
+  doe = days - era * 146097;
+  yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp + ((mp < 10) ? 3 : -9);
+  y = yoe + era * 400 + (m <= 2);
+  memcpy(result, mb_digits + (y / 100) * 2, 2);
+  memcpy(result + 2, mb_digits + (y % 100) * 2, 2);
+  result[4] = '-';
+  memcpy(result + 5, mb_digits + m * 2, 2);
+  result[7] = '-';
+  memcpy(result + 8, mb_digits + d * 2, 2);
+  result[10] = ' ';
+  memcpy(result + 11, mb_digits + (sod / 3600) * 2, 2);
+  result[13] = ':';
+  memcpy(result + 14, mb_digits + ((sod / 60) % 60) * 2, 2);
+  result[16] = ':';
+  memcpy(result + 17, mb_digits + (sod % 60) * 2, 2);
+  result[19] = 0;
+  return 0;
+}
+
+//
+//Functions: ft_short_table() & ft_long_table() are get_filetime_a_short() &
+//           get_filetime_a_long() built on ft_civil()
+void ft_short_table(int64_t ft, unsigned char result[])
+{
+  if (ft_civil(ft, result, 30) == 0)
+  {
+    memcpy(result + 19, " (UTC)", 7);
+  }
+}
+void ft_long_table(int64_t ft, unsigned char result[])
+{
+  uint64_t cns = (uint64_t)ft % 10000000; // Printed without leading zeroes, as liblife does
+  char digits[8];
+  int n = 0;
+
+  if (ft_civil(ft, result, 40) == 0)
+  {
+    do
+    {
+      digits[n++] = (char)('0' + (cns % 10));
+      cns /= 10;
+    } while (cns > 0);
+    result[19] = '.';
+    for (ft = 20; n > 0; ft++)
+    {
+      result[ft] = digits[--n];
+    }
+    memcpy(result + ft, " (UTC)", 7);
+  }
+}
+
+//
+//Function: find_memchr() is find_propstores() finding the '1SPS' signature
+//          with memchr() and then letting liblife decode the stores from
+//          there (it finds the signature straight away)
+int find_memchr(unsigned char * data_buf, int size, uint64_t position, struct LIF_PROPERTY_STORE_PROPS * psp)
+{
+  unsigned char *p = data_buf + 4, *end = data_buf + size - 23;
+
+  while ((p < end) && ((p = memchr(p, 0x31, end - p)) != NULL))
+  {
+    if ((p[1] == 0x53) && (p[2] == 0x50) && (p[3] == 0x53))
+    {
+      return find_propstores(p - 4, size - (int)(p - 4 - data_buf), position + (p - 4 - data_buf), psp);
+    }
+    p++;
+  }
+  return -1;
+}
+
+//
+//Function: b2h_snprintf() is bin2hex_buf() for the layout lifer uses in its
+//          XML (16 columns, gaps, ANSI characters, no margin, offset or
+//          header) the way bin2hex() used to do it, a byte at a time with
+//          snprintf()
+size_t b2h_snprintf(char * out, size_t outsize, const unsigned char * bytes, unsigned int size,
+  unsigned int gap, unsigned int cols, unsigned int margin, unsigned int ansi, unsigned int hdr)
+{
+  char *p = out, ansistr[20];
+  unsigned int i, line, n;
+
+  (void)gap; (void)cols; (void)margin; (void)ansi; (void)hdr;
+  for (line = 0; line <= size / 16; line++)
+  {
+    n = (line < size / 16) ? 16 : size % 16;
+    snprintf(ansistr, 2, " ");
+    for (i = 0; i < 16; i++)
+    {
+      if (i < n)
+      {
+        p += snprintf(p, outsize - (p - out), "%.2"PRIX8" ", bytes[(line * 16) + i]);
+        snprintf(ansistr + 1 + i, 2, "%c", ((bytes[(line * 16) + i] > 0x1F) & (bytes[(line * 16) + i] < 0x80)) ? bytes[(line * 16) + i] : '.');
+      }
+      else
+      {
+        p += snprintf(p, outsize - (p - out), "   ");
+      }
+    }
+    p += snprintf(p, outsize - (p - out), "%s\n", ansistr);
+  }
+  return p - out;
+}
+
+//
+//Functions: pass_*() call an implementation of each primitive for every
+//           input and return a hash of the results
+uint64_t pass_le16(MB_FN fn)
+{
+  uint16_t (*f)(unsigned char[], int) = (uint16_t (*)(unsigned char[], int))fn;
+  uint64_t h = 0;
+  int i, p;
+
+  for (i = 0; i < nfiles; i++)
+  {
+    for (p = 0; p < files[i].size - 1; p++)
+    {
+      h = (h * 31) + f(files[i].data, p);
+    }
+  }
+  return h;
+}
+uint64_t pass_le32(MB_FN fn)
+{
+  uint32_t (*f)(unsigned char[], int) = (uint32_t (*)(unsigned char[], int))fn;
+  uint64_t h = 0;
+  int i, p;
+
+  for (i = 0; i < nfiles; i++)
+  {
+    for (p = 0; p < files[i].size - 3; p++)
+    {
+      h = (h * 31) + f(files[i].data, p);
+    }
+  }
+  return h;
+}
+uint64_t pass_le64(MB_FN fn)
+{
+  uint64_t (*f)(unsigned char[], int) = (uint64_t (*)(unsigned char[], int))fn;
+  uint64_t h = 0;
+  int i, p;
+
+  for (i = 0; i < nfiles; i++)
+  {
+    for (p = 0; p < files[i].size - 7; p++)
+    {
+      h = (h * 31) + f(files[i].data, p);
+    }
+  }
+  return h;
+}
+uint64_t pass_unistr(MB_FN fn)
+{
+  int (*f)(unsigned char[], int, int, wchar_t[]) = (int (*)(unsigned char[], int, int, wchar_t[]))fn;
+  wchar_t buf[300];
+  uint64_t h = 0;
+  int i, n;
+
+  for (i = 0; i < nstrs; i++)
+  {
+    n = f(strs[i].data, strs[i].pos, strs[i].max, buf);
+    h = hash(h + n, buf, (n + 1) * sizeof(wchar_t));
+  }
+  return h;
+}
+uint64_t pass_ft_short(MB_FN fn)
+{
+  void (*f)(int64_t, unsigned char[]) = (void (*)(int64_t, unsigned char[]))fn;
+  unsigned char buf[40];
+  uint64_t h = 0;
+  int i;
+
+  for (i = 0; i < ntimes; i++)
+  {
+    f(times[i], buf);
+    h = hash(h, buf, strlen((char *)buf));
+  }
+  return h;
+}
+uint64_t pass_ft_long(MB_FN fn)
+{
+  return pass_ft_short(fn); // The same call
+}
+uint64_t pass_droid(MB_FN fn)
+{
+  void (*f)(struct LIF_CLSID *, struct LIF_CLSID_A *) = (void (*)(struct LIF_CLSID *, struct LIF_CLSID_A *))fn;
+  struct LIF_CLSID_A a;
+  uint64_t h = 0;
+  int i;
+
+  for (i = 0; i < ndroids; i++)
+  {
+    f(&droids[i], &a);
+    h = hash(h, a.UUID, strlen((char *)a.UUID));
+    h = hash(h, a.Version, strlen((char *)a.Version));
+    h = hash(h, a.Name, strlen((char *)a.Name));
+  }
+  return h;
+}
+uint64_t pass_find(MB_FN fn)
+{
+  int (*f)(unsigned char *, int, uint64_t, struct LIF_PROPERTY_STORE_PROPS *) =
+    (int (*)(unsigned char *, int, uint64_t, struct LIF_PROPERTY_STORE_PROPS *))fn;
+  struct LIF_PROPERTY_STORE_PROPS *psp = &lif.led.lpsp;
+  uint64_t h = 0;
+  int i;
+
+  for (i = 0; i < nitems; i++)
+  {
+    if (f(items[i].data, items[i].size, items[i].posn, psp) == 0)
+    {
+      h = (h * 31) + psp->Posn + psp->Size + psp->NumStores;
+    }
+  }
+  return h;
+}
+uint64_t pass_psa(MB_FN fn)
+{
+  int (*f)(struct LIF_SER_PROPSTORE *, struct LIF_SER_PROPSTORE_A *) =
+    (int (*)(struct LIF_SER_PROPSTORE *, struct LIF_SER_PROPSTORE_A *))fn;
+  static struct LIF_SER_PROPSTORE_A psa;
+  uint64_t h = 0;
+  int i, j;
+
+  for (i = 0; i < nstores; i++)
+  {
+    f(&stores[i], &psa);
+    for (j = 0; j < stores[i].NumValues; j++)
+    {
+      h = hash(h, psa.PropValues[j].Value, strlen((char *)psa.PropValues[j].Value));
+    }
+  }
+  return h;
+}
+uint64_t pass_b2h(MB_FN fn)
+{
+  size_t (*f)(char *, size_t, const unsigned char *, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int) =
+    (size_t (*)(char *, size_t, const unsigned char *, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int))fn;
+  static char buf[(MAXITEMIDSIZE / 16 + 1) * 70 + 1];
+  uint64_t h = 0;
+  size_t n;
+  int i;
+
+  for (i = 0; i < nitems; i++)
+  {
+    n = f(buf, sizeof(buf), items[i].data, items[i].size, 1, 16, 0, 1, 0);
+    h = hash(h, buf, n);
+  }
+  return h;
+}
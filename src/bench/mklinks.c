@@ -0,0 +1,1139 @@
+/*********************************************************
+**                                                      **
+**                 mklinks.c                            **
+**                                                      **
+** Writes a corpus of synthetic (but realistic) link    **
+** files for measuring the throughput of lifer          **
+**                                                      **
+**        Copyright 2026 the Lifer contributors         **
+**                                                      **
+*********************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+mklinks is NOT part of lifer, it only makes test data. From the ./src/bench
+directory:
+
+    gcc -Wall -O2 ./mklinks.c -o mklinks
+    ./mklinks -n 1000000 -s 1 -d 10000 /tmp/corpus
+
+writes a million link files, 10000 to a sub-directory (/tmp/corpus/0000,
+/tmp/corpus/0001 ...) as lifer only reads one directory at a time. The same
+seed always gives the same files. In Windows build it with:
+
+    CL mklinks.c ..\win\getopt.c
+
+Each link is made by filling in a struct LIF (from liblife.h) at random and
+then writing it out the way MS-SHLLINK lays it out, so the generator follows
+the structures that lifer decodes. The mix is roughly that of a real user
+profile: local and network targets, IDLists of 2 to 10 shell items (root
+folder, volume or network location, XP and Vista+ style file entries and
+the odd item carrying a property store), ANSI and Unicode StringData, and
+every ExtraData block type (TrackerDataBlock & PropertyStoreDataBlock most
+often, Console and Darwin blocks rarely). Strings are kept as UTF-8 in the
+LIF and written as UTF-16 or, for ANSI strings, Latin-1.
+
+How many link files have each type of ExtraData block is written to
+extradata.txt in the directory (a signature and a count a line). bench.sh
+checks lifer decodes every one of them before it times anything, so a block
+that lifer silently skips is caught rather than making lifer look faster.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include "../win/getopt.h"
+#define mkdir(d, m) _mkdir(d)
+#else
+#include <getopt.h>
+#endif
+#include "../liblife/liblife.h"
+
+#define LINKMAX     65536           // Largest link file written
+#define FT_1970     116444736000000000LL // FILETIME of 1970-01-01
+#define T_START     1104537600      // Link times are between 2005-01-01
+#define T_SPAN      599529600       // and 2024-01-01
+#define SIG_VISTA   0xA000000C      // VistaAndAboveIDListDataBlock (MS-SHLLINK S2.5.11)
+
+struct LIF_RAW // What is kept about a link besides the struct LIF
+{
+  int            Unicode;           // StringData is Unicode
+  unsigned char  Path[300];         // The target (UTF-8), local or UNC
+  unsigned char  Name[5][300];      // The StringData strings (UTF-8)
+  int            VistaItems;        // ItemIDs in the VistaAndAboveIDListDataBlock
+};
+
+static const char * dirs[] =
+{
+  "Documents", "Pictures", "Music", "Videos", "Downloads", "Desktop", "Projects", "Reports",
+  "Invoices", "2016", "2019", "2021", "Backup", "Photos", "Holiday", "Work", "Clients",
+  "Archive", "Scans", "Old stuff"
+};
+static const char * files[] =
+{
+  "report", "budget", "notes", "letter", "invoice 0042", "presentation", "IMG_2041", "scan",
+  "setup", "readme", "contract", "minutes", "timesheet"
+};
+static const char * exts[] = { ".docx", ".xlsx", ".pdf", ".txt", ".jpg", ".pptx", ".zip", ".exe", ".mp3", ".doc" };
+static const char * users[] = { "alice", "bob", "Administrator", "jsmith", "student", "Owner" };
+// Names in other languages (1 in 40 names), for the Unicode paths
+static const char * intl[] =
+{
+  "Caf\xC3\xA9", "\xC3\x9C" "bersicht", "R\xC3\xA9sum\xC3\xA9", "\xC3\x89milie",
+  "\xD0\x9F\xD1\x80\xD0\xBE\xD0\xB5\xD0\xBA\xD1\x82\xD1\x8B", "\xE8\xA8\x88\xE7\x94\xBB"
+};
+static const char * servers[] = { "\\\\FILESRV01\\shared", "\\\\NAS\\public", "\\\\dc01.corp.local\\users", "\\\\10.0.0.5\\scans" };
+static const char * machines[] = { "desktop-4f2k9ab", "laptop-jsmith", "WORKSTATION12", "pc-reception", "lab-07" };
+static const char * layers[] = { "WINXPSP3", "WIN7RTM", "VISTARTM", "RUNASADMIN" };
+
+// Root folder shell items, known folders & property sets (as in lifguids.h)
+static const struct LIF_CLSID root_mycomputer = { 0x20D04FE0, 0x3AEA, 0x1069, { 0xA2, 0xD8 }, { 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D } };
+static const struct LIF_CLSID root_network = { 0x208D2C60, 0x3AEA, 0x1069, { 0xA2, 0xD7 }, { 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D } };
+static const struct LIF_CLSID root_userfiles = { 0x59031A47, 0x3F72, 0x44A7, { 0x89, 0xC5 }, { 0x55, 0x95, 0xFE, 0x6B, 0x30, 0xEE } };
+static const struct LIF_CLSID known_folders[] =
+{
+  { 0xFDD39AD0, 0x238F, 0x46AF, { 0xAD, 0xB4 }, { 0x6C, 0x85, 0x48, 0x03, 0x69, 0xC7 } }, // Documents
+  { 0x374DE290, 0x123F, 0x4565, { 0x91, 0x64 }, { 0x39, 0xC4, 0x92, 0x5E, 0x46, 0x7B } }, // Downloads
+  { 0xB4BFCC3A, 0xDB2C, 0x424C, { 0xB0, 0x29 }, { 0x7F, 0xE9, 0x9A, 0x87, 0xC6, 0x41 } }, // Desktop
+  { 0x33E28130, 0x4E1E, 0x4676, { 0x83, 0x5A }, { 0x98, 0x39, 0x5C, 0x3B, 0xC3, 0xBB } }  // Pictures
+};
+static const struct LIF_CLSID fmtid_storage = { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } };
+static const struct LIF_CLSID fmtid_link = { 0x28636AA6, 0x953D, 0x11D2, { 0xB5, 0xD6 }, { 0x00, 0xC0, 0x4F, 0xD9, 0x18, 0xD0 } };
+// The ExtraData blocks put_extradata() writes, for extradata.txt
+static const struct
+{
+  enum EDTYPES     edtype;
+  uint32_t         sig;
+} edsigs[] =
+{
+  { ENVIRONMENT_PROPS, 0xA0000001 }, { CONSOLE_PROPS, 0xA0000002 }, { TRACKER_PROPS, 0xA0000003 },
+  { CONSOLE_FE_PROPS, 0xA0000004 }, { SPECIAL_FOLDER_PROPS, 0xA0000005 }, { DARWIN_PROPS, 0xA0000006 },
+  { ICON_ENVIRONMENT_PROPS, 0xA0000007 }, { SHIM_PROPS, 0xA0000008 }, { PROPERTY_STORE_PROPS, 0xA0000009 },
+  { KNOWN_FOLDER_PROPS, 0xA000000B }, { VISTA_AND_ABOVE_IDLIST_PROPS, SIG_VISTA }
+};
+#define EDSIGS (int)(sizeof(edsigs) / sizeof(edsigs[0]))
+static const struct LIF_CLSID fmtid_thumb = { 0x446D16B1, 0x8DAD, 0x4870, { 0xA7, 0x48 }, { 0x40, 0x2E, 0xA4, 0x3D, 0x78, 0x8C } };
+
+static uint64_t rng_state;
+static struct LIF lif;              // Far too big for the stack
+static struct LIF_RAW raw;
+static unsigned char out[LINKMAX];
+
+//Local function declarations
+uint64_t rng(void);
+uint32_t rnd(uint32_t);
+const char * pick(const char *[], int);
+int utf8_next(const unsigned char **);
+int put_u16(unsigned char *, int, uint16_t);
+int put_u32(unsigned char *, int, uint32_t);
+int put_u64(unsigned char *, int, uint64_t);
+int put_guid(unsigned char *, int, const struct LIF_CLSID *);
+int put_str(unsigned char *, int, const unsigned char *, int, int);
+int put_hdr(unsigned char *, struct LIF_HDR *);
+int put_items(unsigned char *, int, struct LIF_ITEMID *, int);
+int put_linkinfo(unsigned char *, int, struct LIF_INFO *);
+int put_stringdata(unsigned char *, int, struct LIF_HDR *);
+int put_propstores(unsigned char *, int, struct LIF_SER_PROPSTORE *, int);
+int put_extradata(unsigned char *, int, struct LIF_EXTRA_DATA *);
+int64_t gen_filetime(void);
+uint16_t fat_date(int64_t);
+uint16_t fat_time(int64_t);
+void gen_uuid(struct LIF_CLSID *, int64_t, const unsigned char *);
+void gen_propvalue(struct LIF_SER_PROPVALUE *, uint32_t, uint16_t, const unsigned char *, uint64_t);
+void gen_propstore(struct LIF_SER_PROPSTORE *, const struct LIF_CLSID *);
+int gen_fileentry(struct LIF_ITEMID *, const unsigned char *, int, int64_t);
+int gen_items(struct LIF_ITEMID *, int);
+void gen_lif(void);
+int write_link(const char *);
+int write_edcounts(const char *, const long[]);
+
+int main(int argc, char *argv[])
+{
+  int opt, perdir = 0, i, j;
+  long count = 1000, edcount[EDSIGS] = { 0 };
+  uint64_t seed = 1, bytes = 0;
+  char path[1024];
+  struct stat st;
+
+  while ((opt = getopt(argc, argv, "n:s:d:h")) != -1)
+  {
+    switch (opt)
+    {
+    case 'n':
+      count = atol(optarg);
+      break;
+    case 's':
+      seed = strtoull(optarg, NULL, 10);
+      break;
+    case 'd':
+      perdir = atoi(optarg);
+      break;
+    default:
+      fprintf(stderr, "Usage: mklinks [-n count] [-s seed] [-d files per sub-directory] directory\n");
+      return 1;
+    }
+  }
+  if ((optind >= argc) || (count < 1) || (perdir < 0))
+  {
+    fprintf(stderr, "Usage: mklinks [-n count] [-s seed] [-d files per sub-directory] directory\n");
+    return 1;
+  }
+  mkdir(argv[optind], 0755);
+  rng_state = (seed * 0x9E3779B97F4A7C15ULL) | 1; // Never 0
+  for (i = 0; i < count; i++)
+  {
+    if (perdir > 0)
+    {
+      snprintf(path, sizeof(path), "%s/%04d", argv[optind], i / perdir);
+      if (i % perdir == 0)
+      {
+        mkdir(path, 0755);
+      }
+      snprintf(path, sizeof(path), "%s/%04d/%08d.lnk", argv[optind], i / perdir, i);
+    }
+    else
+    {
+      snprintf(path, sizeof(path), "%s/%08d.lnk", argv[optind], i);
+    }
+    gen_lif();
+    if (write_link(path) < 0)
+    {
+      return 1;
+    }
+    for (j = 0; j < EDSIGS; j++)
+    {
+      if (lif.led.edtypes & edsigs[j].edtype)
+      {
+        edcount[j]++;
+      }
+    }
+    if (stat(path, &st) == 0)
+    {
+      bytes += st.st_size;
+    }
+  }
+  if (write_edcounts(argv[optind], edcount) < 0)
+  {
+    return 1;
+  }
+  printf("%ld files, %"PRIu64" bytes written to %s\n", count, bytes, argv[optind]);
+  return 0;
+}
+
+//
+//Function: rng() is xorshift64*, the same on every platform (unlike rand())
+uint64_t rng(void)
+{
+  rng_state ^= rng_state >> 12;
+  rng_state ^= rng_state << 25;
+  rng_state ^= rng_state >> 27;
+  return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+//
+//Function: rnd() returns a random number from 0 to n - 1
+uint32_t rnd(uint32_t n)
+{
+  return (uint32_t)((rng() >> 32) % n);
+}
+
+//
+//Function: pick() returns a random member of a list of n strings
+const char * pick(const char * list[], int n)
+{
+  return list[rnd(n)];
+}
+#define PICK(list) pick(list, sizeof(list) / sizeof(list[0]))
+
+//
+//Function: utf8_next() returns the next character of a UTF-8 string (the
+//          strings here are all valid and in the BMP) and moves *s past it
+int utf8_next(const unsigned char ** s)
+{
+  const unsigned char *p = *s;
+  int c;
+
+  if (p[0] < 0x80)
+  {
+    c = p[0];
+    *s += 1;
+  }
+  else if (p[0] < 0xE0)
+  {
+    c = ((p[0] & 0x1F) << 6) | (p[1] & 0x3F);
+    *s += 2;
+  }
+  else
+  {
+    c = ((p[0] & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+    *s += 3;
+  }
+  return c;
+}
+
+//
+//Functions: put_u16(), put_u32(), put_u64() & put_guid() write little endian
+//           values at buf[p] and return the position after them
+int put_u16(unsigned char * buf, int p, uint16_t v)
+{
+  buf[p] = (unsigned char)v;
+  buf[p + 1] = (unsigned char)(v >> 8);
+  return p + 2;
+}
+int put_u32(unsigned char * buf, int p, uint32_t v)
+{
+  p = put_u16(buf, p, (uint16_t)v);
+  return put_u16(buf, p, (uint16_t)(v >> 16));
+}
+int put_u64(unsigned char * buf, int p, uint64_t v)
+{
+  p = put_u32(buf, p, (uint32_t)v);
+  return put_u32(buf, p, (uint32_t)(v >> 32));
+}
+int put_guid(unsigned char * buf, int p, const struct LIF_CLSID * g)
+{
+  p = put_u32(buf, p, g->Data1);
+  p = put_u16(buf, p, g->Data2);
+  p = put_u16(buf, p, g->Data3);
+  memcpy(buf + p, g->Data4hi, 2);
+  memcpy(buf + p + 2, g->Data4lo, 6);
+  return p + 8;
+}
+
+//
+//Function: put_str() writes the UTF-8 string s at buf[p] as UTF-16LE (if
+//          unicode) or Latin-1 ('?' if it isn't Latin-1), followed by a
+//          terminating zero if nul. Returns the position after it.
+int put_str(unsigned char * buf, int p, const unsigned char * s, int unicode, int nul)
+{
+  int c;
+
+  while (*s != 0)
+  {
+    c = utf8_next(&s);
+    if (unicode)
+    {
+      p = put_u16(buf, p, (uint16_t)c);
+    }
+    else
+    {
+      buf[p++] = (c < 0x100) ? (unsigned char)c : '?';
+    }
+  }
+  if (nul)
+  {
+    p = unicode ? put_u16(buf, p, 0) : p + 1;
+    if (!unicode)
+    {
+      buf[p - 1] = 0;
+    }
+  }
+  return p;
+}
+
+//
+//Function: put_hdr() writes the ShellLinkHeader (MS-SHLLINK S2.1)
+int put_hdr(unsigned char * buf, struct LIF_HDR * lh)
+{
+  int p;
+
+  p = put_u32(buf, 0, lh->H_size);
+  p = put_guid(buf, p, &lh->CLSID);
+  p = put_u32(buf, p, lh->Flags);
+  p = put_u32(buf, p, lh->Attr);
+  p = put_u64(buf, p, (uint64_t)lh->CrDate);
+  p = put_u64(buf, p, (uint64_t)lh->AcDate);
+  p = put_u64(buf, p, (uint64_t)lh->WtDate);
+  p = put_u32(buf, p, lh->Size);
+  p = put_u32(buf, p, (uint32_t)lh->IconIndex);
+  p = put_u32(buf, p, lh->ShowState);
+  buf[p++] = lh->Hotkey.LowKey;
+  buf[p++] = lh->Hotkey.HighKey;
+  p = put_u16(buf, p, lh->Reserved1);
+  p = put_u32(buf, p, lh->Reserved2);
+  return put_u32(buf, p, lh->Reserved3);
+}
+
+//
+//Function: put_items() writes num ItemIDs and the TerminalID (S2.2.1)
+int put_items(unsigned char * buf, int p, struct LIF_ITEMID * items, int num)
+{
+  int i;
+
+  for (i = 0; i < num; i++)
+  {
+    p = put_u16(buf, p, items[i].ItemIDSize);
+    memcpy(buf + p, items[i].Data, items[i].ItemIDSize - 2);
+    p += items[i].ItemIDSize - 2;
+  }
+  return put_u16(buf, p, 0);
+}
+
+//
+//Function: put_linkinfo() writes the LinkInfo (S2.3) with an ANSI (0x1C
+//          byte) header, filling in the sizes & offsets in li as it goes
+int put_linkinfo(unsigned char * buf, int p, struct LIF_INFO * li)
+{
+  int start = p, q;
+
+  li->HeaderSize = 0x1C;
+  q = p + 0x1C;
+  li->IDOffset = li->LBPOffset = li->CNRLOffset = 0;
+  if (li->Flags & 0x00000001) // VolumeIDAndLocalBasePath
+  {
+    li->IDOffset = q - start;
+    li->VolID.VLOffset = 0x10;
+    li->VolID.Size = 0x10 + (uint32_t)strlen((char *)li->VolID.VolumeLabel) + 1;
+    put_u32(buf, q, li->VolID.Size);
+    put_u32(buf, q + 4, li->VolID.DriveType);
+    put_u32(buf, q + 8, li->VolID.DriveSN);
+    put_u32(buf, q + 12, li->VolID.VLOffset);
+    q = put_str(buf, q + 16, li->VolID.VolumeLabel, 0, 1);
+    li->LBPOffset = q - start;
+    q = put_str(buf, q, li->LBP, 0, 1);
+  }
+  if (li->Flags & 0x00000002) // CommonNetworkRelativeLinkAndPathSuffix
+  {
+    li->CNRLOffset = q - start;
+    li->CNR.NetNameOffset = 0x14;
+    put_u32(buf, q + 4, li->CNR.Flags);
+    put_u32(buf, q + 8, li->CNR.NetNameOffset);
+    put_u32(buf, q + 16, li->CNR.NetworkProviderType);
+    q = put_str(buf, q + 0x14, li->CNR.NetName, 0, 1);
+    li->CNR.DeviceNameOffset = 0;
+    if (li->CNR.Flags & 0x00000001) // ValidDevice
+    {
+      li->CNR.DeviceNameOffset = q - (start + li->CNRLOffset);
+      q = put_str(buf, q, li->CNR.DeviceName, 0, 1);
+    }
+    put_u32(buf, start + li->CNRLOffset + 12, li->CNR.DeviceNameOffset);
+    li->CNR.Size = q - (start + li->CNRLOffset);
+    put_u32(buf, start + li->CNRLOffset, li->CNR.Size);
+  }
+  li->CPSOffset = q - start;
+  q = put_str(buf, q, li->CPS, 0, 1);
+  li->Size = q - start;
+  put_u32(buf, p, li->Size);
+  put_u32(buf, p + 4, li->HeaderSize);
+  put_u32(buf, p + 8, li->Flags);
+  put_u32(buf, p + 12, li->IDOffset);
+  put_u32(buf, p + 16, li->LBPOffset);
+  put_u32(buf, p + 20, li->CNRLOffset);
+  put_u32(buf, p + 24, li->CPSOffset);
+  return q;
+}
+
+//
+//Function: put_stringdata() writes the StringData strings (S2.4) that the
+//          header flags say are there, counting their characters
+int put_stringdata(unsigned char * buf, int p, struct LIF_HDR * lh)
+{
+  int i, q;
+
+  for (i = 0; i < 5; i++)
+  {
+    if (lh->Flags & (0x00000004 << i))
+    {
+      q = put_str(buf, p + 2, raw.Name[i], raw.Unicode, 0);
+      lif.lsd.CountChars[i] = (uint16_t)(raw.Unicode ? (q - p - 2) / 2 : (q - p - 2));
+      put_u16(buf, p, lif.lsd.CountChars[i]);
+      p = q;
+    }
+  }
+  return p;
+}
+
+//
+//Function: put_propstores() writes num serialized property stores (MS-
+//          PROPSTORE S2.2) and the empty one that ends the list. The values'
+//          ValueSize must already be set, Value holds the typed content.
+int put_propstores(unsigned char * buf, int p, struct LIF_SER_PROPSTORE * stores, int num)
+{
+  int i, j, start;
+
+  for (i = 0; i < num; i++)
+  {
+    start = p;
+    p = put_u32(buf, p + 4, 0x53505331); // '1SPS'
+    p = put_guid(buf, p, &stores[i].FormatID);
+    for (j = 0; j < stores[i].NumValues; j++)
+    {
+      p = put_u32(buf, p, stores[i].PropValues[j].ValueSize);
+      p = put_u32(buf, p, stores[i].PropValues[j].NameSizeOrID);
+      buf[p++] = stores[i].PropValues[j].Reserved;
+      p = put_u16(buf, p, stores[i].PropValues[j].PropertyType);
+      p = put_u16(buf, p, stores[i].PropValues[j].Padding);
+      memcpy(buf + p, stores[i].PropValues[j].Value, stores[i].PropValues[j].ValueSize - 13);
+      p += stores[i].PropValues[j].ValueSize - 13;
+    }
+    p = put_u32(buf, p, 0); // The empty value that ends the store
+    stores[i].StorageSize = p - start;
+    put_u32(buf, start, stores[i].StorageSize);
+  }
+  return put_u32(buf, p, 0);
+}
+
+//
+//Function: put_extradata() writes the ExtraData blocks (S2.5) in led->edtypes
+//          and the TerminalBlock. The Unicode strings are written from the
+//          ANSI ones.
+int put_extradata(unsigned char * buf, int p, struct LIF_EXTRA_DATA * led)
+{
+  int j, start;
+
+  if (led->edtypes & ENVIRONMENT_PROPS)
+  {
+    put_u32(buf, p, 0x314);
+    put_u32(buf, p + 4, 0xA0000001);
+    memset(buf + p + 8, 0, 0x314 - 8);
+    put_str(buf, p + 8, led->lep.TargetAnsi, 0, 1);
+    put_str(buf, p + 8 + 260, led->lep.TargetAnsi, 1, 1);
+    p += 0x314;
+  }
+  if (led->edtypes & CONSOLE_PROPS)
+  {
+    start = p;
+    p = put_u32(buf, p, 0xCC);
+    p = put_u32(buf, p, 0xA0000002);
+    p = put_u16(buf, p, led->lcp.FillAttributes);
+    p = put_u16(buf, p, led->lcp.PopupFillAttributes);
+    p = put_u16(buf, p, led->lcp.ScreenBufferSizeX);
+    p = put_u16(buf, p, led->lcp.ScreenBufferSizeY);
+    p = put_u16(buf, p, led->lcp.WindowSizeX);
+    p = put_u16(buf, p, led->lcp.WindowSizeY);
+    p = put_u16(buf, p, led->lcp.WindowOriginX);
+    p = put_u16(buf, p, led->lcp.WindowOriginY);
+    p = put_u32(buf, p, 0);
+    p = put_u32(buf, p, 0);
+    p = put_u16(buf, p, led->lcp.FontSize_Width);
+    p = put_u16(buf, p, led->lcp.FontSize_Height);
+    p = put_u32(buf, p, led->lcp.FontFamily);
+    p = put_u32(buf, p, led->lcp.FontWeight);
+    memset(buf + p, 0, 64);
+    for (j = 0; (j < 31) && (led->lcp.FaceName[j] != 0); j++)
+    {
+      put_u16(buf, p + (j * 2), (uint16_t)led->lcp.FaceName[j]);
+    }
+    p += 64;
+    p = put_u32(buf, p, led->lcp.CursorSize);
+    p = put_u32(buf, p, led->lcp.FullScreen);
+    p = put_u32(buf, p, led->lcp.QuickEdit);
+    p = put_u32(buf, p, led->lcp.InsertMode);
+    p = put_u32(buf, p, led->lcp.AutoPosition);
+    p = put_u32(buf, p, led->lcp.HistoryBufferSize);
+    p = put_u32(buf, p, led->lcp.NumberOfHistoryBuffers);
+    p = put_u32(buf, p, led->lcp.HistoryNoDup);
+    for (j = 0; j < 16; j++)
+    {
+      p = put_u32(buf, p, led->lcp.ColorTable[j]);
+    }
+  }
+  if (led->edtypes & CONSOLE_FE_PROPS)
+  {
+    p = put_u32(buf, p, 0x0C);
+    p = put_u32(buf, p, 0xA0000004);
+    p = put_u32(buf, p, led->lcfep.CodePage);
+  }
+  if (led->edtypes & DARWIN_PROPS)
+  {
+    put_u32(buf, p, 0x314);
+    put_u32(buf, p + 4, 0xA0000006);
+    memset(buf + p + 8, 0, 0x314 - 8);
+    put_str(buf, p + 8, led->ldp.DarwinDataAnsi, 0, 1);
+    put_str(buf, p + 8 + 260, led->ldp.DarwinDataAnsi, 1, 1);
+    p += 0x314;
+  }
+  if (led->edtypes & ICON_ENVIRONMENT_PROPS)
+  {
+    put_u32(buf, p, 0x314);
+    put_u32(buf, p + 4, 0xA0000007);
+    memset(buf + p + 8, 0, 0x314 - 8);
+    put_str(buf, p + 8, led->liep.TargetAnsi, 0, 1);
+    put_str(buf, p + 8 + 260, led->liep.TargetAnsi, 1, 1);
+    p += 0x314;
+  }
+  if (led->edtypes & SHIM_PROPS)
+  {
+    put_u32(buf, p, 0x88);
+    put_u32(buf, p + 4, 0xA0000008);
+    memset(buf + p + 8, 0, 0x88 - 8);
+    for (j = 0; (j < 63) && (led->lsp.LayerName[j] != 0); j++)
+    {
+      put_u16(buf, p + 8 + (j * 2), (uint16_t)led->lsp.LayerName[j]);
+    }
+    p += 0x88;
+  }
+  if (led->edtypes & SPECIAL_FOLDER_PROPS)
+  {
+    p = put_u32(buf, p, 0x10);
+    p = put_u32(buf, p, 0xA0000005);
+    p = put_u32(buf, p, led->lsfp.SpecialFolderID);
+    p = put_u32(buf, p, led->lsfp.Offset);
+  }
+  if (led->edtypes & KNOWN_FOLDER_PROPS)
+  {
+    p = put_u32(buf, p, 0x1C);
+    p = put_u32(buf, p, 0xA000000B);
+    p = put_guid(buf, p, &led->lkfp.KFGUID);
+    p = put_u32(buf, p, led->lkfp.KFOffset);
+  }
+  if (led->edtypes & PROPERTY_STORE_PROPS)
+  {
+    start = p;
+    p = put_propstores(buf, p + 8, led->lpsp.Stores, led->lpsp.NumStores);
+    led->lpsp.Size = p - start;
+    put_u32(buf, start, led->lpsp.Size);
+    put_u32(buf, start + 4, 0xA0000009);
+  }
+  if (led->edtypes & TRACKER_PROPS)
+  {
+    p = put_u32(buf, p, 0x60);
+    p = put_u32(buf, p, 0xA0000003);
+    p = put_u32(buf, p, 0x58);
+    p = put_u32(buf, p, 0);
+    memcpy(buf + p, led->ltp.MachineID, 16);
+    p += 16;
+    p = put_guid(buf, p, &led->ltp.Droid1);
+    p = put_guid(buf, p, &led->ltp.Droid2);
+    p = put_guid(buf, p, &led->ltp.DroidBirth1);
+    p = put_guid(buf, p, &led->ltp.DroidBirth2);
+  }
+  if (led->edtypes & VISTA_AND_ABOVE_IDLIST_PROPS)
+  {
+    start = p;
+    p = put_items(buf, p + 8, led->lvidlp.Items, led->lvidlp.NumItemIDs);
+    led->lvidlp.Size = p - start;
+    put_u32(buf, start, led->lvidlp.Size);
+    put_u32(buf, start + 4, SIG_VISTA);
+  }
+  return put_u32(buf, p, 0);
+}
+
+//
+//Function: gen_filetime() returns a random FILETIME from 2005 to 2023
+int64_t gen_filetime(void)
+{
+  return FT_1970 + ((int64_t)T_START + rnd(T_SPAN)) * 10000000LL + rnd(10000000);
+}
+
+//
+//Functions: fat_date() & fat_time() convert a FILETIME to a FAT date or time
+uint16_t fat_date(int64_t ft)
+{
+  time_t t = (time_t)((ft - FT_1970) / 10000000LL);
+  struct tm *tm = gmtime(&t);
+
+  return (uint16_t)(((tm->tm_year - 80) << 9) | ((tm->tm_mon + 1) << 5) | tm->tm_mday);
+}
+uint16_t fat_time(int64_t ft)
+{
+  time_t t = (time_t)((ft - FT_1970) / 10000000LL);
+  struct tm *tm = gmtime(&t);
+
+  return (uint16_t)((tm->tm_hour << 11) | (tm->tm_min << 5) | (tm->tm_sec / 2));
+}
+
+//
+//Function: gen_uuid() makes a time based (version 1) UUID as the link
+//          tracking service does, node is the MAC address
+void gen_uuid(struct LIF_CLSID * u, int64_t ft, const unsigned char * node)
+{
+  uint64_t t = (uint64_t)(ft + 5748192000000000LL); // 100ns since 1582-10-15
+  uint16_t seq = (uint16_t)(rnd(0x4000) | 0x8000);
+
+  u->Data1 = (uint32_t)t;
+  u->Data2 = (uint16_t)(t >> 32);
+  u->Data3 = (uint16_t)(((t >> 48) & 0x0FFF) | 0x1000);
+  u->Data4hi[0] = (unsigned char)(seq >> 8);
+  u->Data4hi[1] = (unsigned char)seq;
+  memcpy(u->Data4lo, node, 6);
+}
+
+//
+//Function: gen_propvalue() fills in a property value of the given type from
+//          s (VT_LPWSTR, UTF-8) or v (the other types)
+void gen_propvalue(struct LIF_SER_PROPVALUE * pv, uint32_t id, uint16_t type, const unsigned char * s, uint64_t v)
+{
+  int n;
+
+  pv->NameSizeOrID = id;
+  pv->Reserved = 0;
+  pv->PropertyType = type;
+  pv->Padding = 0;
+  switch (type)
+  {
+  case VT_LPWSTR:
+    n = put_str(pv->Value, 4, s, 1, 1);
+    put_u32(pv->Value, 0, (uint32_t)((n - 4) / 2)); // Characters, with the zero
+    n = (n + 3) & ~3;
+    break;
+  case VT_BOOL:
+    put_u32(pv->Value, 0, v ? 0xFFFF : 0);
+    n = 4;
+    break;
+  case VT_UI4:
+    n = put_u32(pv->Value, 0, (uint32_t)v);
+    break;
+  default: // VT_UI8 & VT_FILETIME
+    n = put_u64(pv->Value, 0, v);
+  }
+  pv->ValueSize = 13 + n;
+}
+
+//
+//Function: gen_propstore() fills in a property store of the sort Windows
+//          puts in links to files: the name, type, size & times of the target
+void gen_propstore(struct LIF_SER_PROPSTORE * ps, const struct LIF_CLSID * fmtid)
+{
+  ps->FormatID = *fmtid;
+  ps->NameType = 0xFF;
+  ps->NumValues = 0;
+  if (fmtid == &fmtid_storage)
+  {
+    gen_propvalue(&ps->PropValues[ps->NumValues++], 10, VT_LPWSTR, raw.Name[0], 0); // System.ItemNameDisplay
+    gen_propvalue(&ps->PropValues[ps->NumValues++], 12, VT_UI8, NULL, lif.lh.Size); // System.Size
+    gen_propvalue(&ps->PropValues[ps->NumValues++], 14, VT_FILETIME, NULL, (uint64_t)lif.lh.WtDate); // System.DateModified
+    if (rnd(2))
+    {
+      gen_propvalue(&ps->PropValues[ps->NumValues++], 4, VT_LPWSTR, (const unsigned char *)"File", 0); // System.ItemTypeText
+    }
+  }
+  else if (fmtid == &fmtid_link)
+  {
+    gen_propvalue(&ps->PropValues[ps->NumValues++], 30, VT_LPWSTR, raw.Path, 0); // System.ParsingPath
+  }
+  else
+  {
+    gen_propvalue(&ps->PropValues[ps->NumValues++], 100, VT_UI8, NULL, rng()); // System.ThumbnailCacheId
+  }
+}
+
+//
+//Function: gen_fileentry() makes a file entry shell item (class 0x31 for a
+//          directory, 0x32 for a file) with a 0xBEEF0004 extension block of
+//          version 3 (XP), 8 (Vista/7) or 9 (8 & 10)
+int gen_fileentry(struct LIF_ITEMID * item, const unsigned char * name, int dir, int64_t ft)
+{
+  unsigned char *d = item->Data, shortname[16];
+  const unsigned char *s = name;
+  int p, ext, n = 0, c, version;
+
+  // A DOS 8.3 name made from the ASCII letters & digits of the long one
+  while ((*s != 0) && (*s != '.') && (n < 6))
+  {
+    c = utf8_next(&s);
+    if (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')))
+    {
+      shortname[n++] = (unsigned char)((c >= 'a') ? c - 32 : c);
+    }
+  }
+  shortname[n++] = '~';
+  shortname[n++] = '1';
+  shortname[n] = 0;
+  if ((s = (const unsigned char *)strrchr((const char *)name, '.')) != NULL)
+  {
+    for (c = 0; (c < 4) && (s[c] != 0); c++)
+    {
+      shortname[n++] = (unsigned char)(((s[c] >= 'a') && (s[c] <= 'z')) ? s[c] - 32 : s[c]);
+    }
+    shortname[n] = 0;
+  }
+  version = (rnd(3) == 0) ? 3 : (rnd(2) ? 8 : 9);
+  d[0] = dir ? 0x31 : 0x32;
+  d[1] = 0;
+  put_u32(d, 2, dir ? 0 : lif.lh.Size);
+  put_u16(d, 6, fat_date(ft));
+  put_u16(d, 8, fat_time(ft));
+  put_u16(d, 10, (uint16_t)(dir ? 0x10 : 0x20));
+  p = put_str(d, 12, shortname, 0, 1);
+  p += (p & 1);
+  ext = p;
+  put_u16(d, ext + 2, (uint16_t)version);
+  put_u32(d, ext + 4, 0xBEEF0004);
+  put_u16(d, ext + 8, fat_date(lif.lh.CrDate ? lif.lh.CrDate : ft));
+  put_u16(d, ext + 10, fat_time(lif.lh.CrDate ? lif.lh.CrDate : ft));
+  put_u16(d, ext + 12, fat_date(lif.lh.AcDate));
+  put_u16(d, ext + 14, fat_time(lif.lh.AcDate));
+  if (version == 3)
+  {
+    put_u16(d, ext + 16, 0x14);
+    put_u16(d, ext + 18, 0);
+    p = ext + 20;
+  }
+  else
+  {
+    put_u16(d, ext + 16, (uint16_t)((version == 8) ? 0x26 : 0x2E));
+    put_u16(d, ext + 18, 0);
+    put_u64(d, ext + 20, (rnd(0x100000) + 0x100) | ((uint64_t)(rnd(20) + 1) << 48)); // MFT entry & sequence
+    put_u64(d, ext + 28, 0);
+    put_u16(d, ext + 36, 0);
+    put_u32(d, ext + 38, 0);
+    p = ext + 42;
+    if (version == 9)
+    {
+      put_u32(d, p, 0);
+      p += 4;
+    }
+  }
+  p = put_str(d, p, name, 1, 1);
+  p = put_u16(d, p, (uint16_t)(ext + 2)); // Offset of the first extension block in the item
+  put_u16(d, ext, (uint16_t)(p - ext));
+  item->ItemIDSize = (uint16_t)(p + 2);
+  return 0;
+}
+
+//
+//Function: gen_items() makes the shell items for raw.Path, at most max
+//          of them. Returns the number made.
+int gen_items(struct LIF_ITEMID * items, int max)
+{
+  unsigned char comp[300], *c, *d;
+  const unsigned char *p;
+  int n = 0, q;
+
+  d = items[n].Data;
+  d[0] = 0x1F;
+  if (raw.Path[0] == '\\') // \\server\share\...
+  {
+    d[1] = 0x58;
+    put_guid(d, 2, &root_network);
+    items[n++].ItemIDSize = 20;
+    // The server & share as one network location
+    p = raw.Path + 2;
+    while ((*p != '\\') && (*p != 0))
+    {
+      p++;
+    }
+    for (p++; (*p != '\\') && (*p != 0); p++);
+    d = items[n].Data;
+    d[0] = 0x43; // A share
+    d[1] = 0x01;
+    d[2] = 0x81; // Has a description
+    memcpy(comp, raw.Path, p - raw.Path);
+    comp[p - raw.Path] = 0;
+    q = put_str(d, 3, comp, 0, 1);
+    q = put_str(d, q, (const unsigned char *)"Microsoft Network", 0, 1);
+    q = put_u16(d, q, 0);
+    items[n++].ItemIDSize = (uint16_t)(q + 2);
+  }
+  else
+  {
+    d[1] = 0x50;
+    put_guid(d, 2, rnd(8) ? &root_mycomputer : &root_userfiles);
+    items[n++].ItemIDSize = 20;
+    d = items[n].Data;
+    memset(d, 0, 23);
+    d[0] = 0x2F;
+    memcpy(d + 1, raw.Path, 3); // C:\ .
+    items[n++].ItemIDSize = 25;
+    p = raw.Path + 3;
+  }
+  // Then a file entry for each path component
+  while ((*p != 0) && (n < max))
+  {
+    if (*p == '\\')
+    {
+      p++;
+    }
+    for (c = comp; (*p != '\\') && (*p != 0); *c++ = *p++);
+    *c = 0;
+    gen_fileentry(&items[n++], comp, (*p == '\\'), lif.lh.WtDate - (int64_t)rnd(1000) * 864000000000LL);
+  }
+  // Search results & libraries carry a property store in an unknown item
+  if ((n < max) && (rnd(10) == 0))
+  {
+    d = items[n].Data;
+    d[0] = 0x00;
+    d[1] = 0x00;
+    put_u16(d, 2, 0);
+    put_u32(d, 4, 0x23FEBBEE);
+    gen_propstore(&lif.led.lpsp.Stores[0], &fmtid_storage);
+    q = put_propstores(d, 8, lif.led.lpsp.Stores, 1);
+    q = put_u16(d, q, 0);
+    items[n++].ItemIDSize = (uint16_t)(q + 2);
+  }
+  return n;
+}
+
+//
+//Function: gen_lif() fills in lif & raw with a new random link
+void gen_lif(void)
+{
+  unsigned char dir[300], file[100], node[6];
+  const char *user = rnd(40) ? PICK(users) : PICK(intl);
+  int i, depth, unc, fe;
+  int64_t t;
+
+  // The target: a file a few directories down a user profile, a program or
+  // a file on a network share
+  unc = (rnd(6) == 0);
+  depth = 1 + rnd(5);
+  if (unc)
+  {
+    snprintf((char *)dir, sizeof(dir), "%s", PICK(servers));
+  }
+  else if (rnd(5) == 0)
+  {
+    snprintf((char *)dir, sizeof(dir), "C:\\Program Files\\%s", PICK(files));
+    depth = 0;
+  }
+  else
+  {
+    snprintf((char *)dir, sizeof(dir), "%c:\\%s\\%s", rnd(8) ? 'C' : 'D', rnd(4) ? "Users" : "Documents and Settings", user);
+  }
+  for (i = 0; i < depth; i++)
+  {
+    snprintf((char *)dir + strlen((char *)dir), sizeof(dir) - strlen((char *)dir), "\\%s", rnd(40) ? PICK(dirs) : PICK(intl));
+  }
+  snprintf((char *)file, sizeof(file), "%s%s", rnd(40) ? PICK(files) : PICK(intl), PICK(exts));
+  snprintf((char *)raw.Path, sizeof(raw.Path), "%s\\%s", dir, file);
+
+  // The header
+  memset(&lif.lh, 0, sizeof(lif.lh));
+  lif.lh.H_size = 0x4C;
+  lif.lh.CLSID.Data1 = 0x00021401;
+  lif.lh.CLSID.Data4hi[0] = 0xC0;
+  lif.lh.CLSID.Data4lo[5] = 0x46;
+  lif.lh.Flags = 0x00000002 | 0x00000008 | 0x00000010; // HasLinkInfo, HasRelativePath, HasWorkingDir
+  lif.lh.Flags |= rnd(10) ? 0x00000001 : 0; // HasLinkTargetIDList
+  lif.lh.Flags |= rnd(3) ? 0x00000080 : 0;  // IsUnicode
+  lif.lh.Flags |= rnd(4) ? 0 : 0x00000004;  // HasName
+  lif.lh.Flags |= rnd(5) ? 0 : 0x00000020;  // HasArguments
+  lif.lh.Flags |= rnd(4) ? 0 : 0x00000040;  // HasIconLocation
+  lif.lh.Flags |= rnd(8) ? 0 : 0x00000200;  // HasExpString
+  lif.lh.Flags |= rnd(30) ? 0 : 0x00001000; // HasDarwinID
+  lif.lh.Flags |= rnd(12) ? 0 : 0x00004000; // HasExpIcon
+  lif.lh.Flags |= rnd(40) ? 0 : 0x00020000; // RunWithShimLayer
+  lif.lh.Flags |= rnd(3) ? 0 : 0x00080000;  // EnableTargetMetadata
+  lif.lh.Attr = rnd(6) ? 0x20 : (rnd(2) ? 0x80 : 0x21 | (rnd(2) ? 0x2000 : 0x800));
+  lif.lh.CrDate = gen_filetime();
+  lif.lh.WtDate = lif.lh.CrDate + (int64_t)rnd(500) * 864000000000LL;
+  lif.lh.AcDate = lif.lh.WtDate + (int64_t)rnd(100) * 864000000000LL;
+  if (rnd(20) == 0)
+  {
+    lif.lh.CrDate = 0; // Not set
+  }
+  lif.lh.Size = rnd(4) ? rnd(1 << 20) : rng() >> 40;
+  lif.lh.IconIndex = rnd(4) ? 0 : rnd(50);
+  lif.lh.ShowState = rnd(10) ? 1 : (rnd(2) ? 3 : 7);
+  if (rnd(20) == 0)
+  {
+    lif.lh.Hotkey.LowKey = 0x41 + rnd(26);
+    lif.lh.Hotkey.HighKey = 1 + rnd(7);
+  }
+
+  // The IDList
+  lif.lidl.NumItemIDs = 0;
+  if (lif.lh.Flags & 0x00000001)
+  {
+    lif.lidl.NumItemIDs = gen_items(lif.lidl.Items, ITEMIDS);
+  }
+
+  // The LinkInfo
+  memset(&lif.li, 0, sizeof(lif.li));
+  if (unc)
+  {
+    lif.li.Flags = 0x00000002;
+    lif.li.CNR.Flags = rnd(2) ? 0x00000003 : 0x00000002; // ValidNetType (& ValidDevice)
+    lif.li.CNR.NetworkProviderType = 0x00020000; // WNNC_NET_LANMAN
+    for (i = 2; (raw.Path[i] != '\\'); i++);
+    for (i++; (raw.Path[i] != '\\'); i++);
+    memcpy(lif.li.CNR.NetName, raw.Path, i);
+    snprintf((char *)lif.li.CNR.DeviceName, 300, "%c:", 'M' + rnd(14));
+    snprintf((char *)lif.li.CPS, 100, "%s", raw.Path + i + 1);
+  }
+  else
+  {
+    lif.li.Flags = 0x00000001;
+    lif.li.VolID.DriveType = (raw.Path[0] == 'D') ? (rnd(2) ? 2 : 5) : 3; // DRIVE_REMOVABLE, DRIVE_CDROM, DRIVE_FIXED
+    lif.li.VolID.DriveSN = (uint32_t)rng();
+    snprintf((char *)lif.li.VolID.VolumeLabel, 33, "%s", rnd(3) ? "" : (raw.Path[0] == 'D' ? "USB DISK" : "OS"));
+    snprintf((char *)lif.li.LBP, 300, "%s", raw.Path);
+  }
+
+  // The StringData: description, relative path, working directory, arguments & icon
+  raw.Unicode = (lif.lh.Flags & 0x00000080) != 0;
+  snprintf((char *)raw.Name[0], 300, "%s", file);
+  snprintf((char *)raw.Name[1], 300, "..\\..\\%s", file);
+  snprintf((char *)raw.Name[2], 300, "%s", dir);
+  snprintf((char *)raw.Name[3], 300, "%s", rnd(2) ? "/n" : "--profile-directory=Default");
+  snprintf((char *)raw.Name[4], 300, "%%SystemRoot%%\\system32\\SHELL32.dll");
+
+  // The ExtraData
+  memset(&lif.led, 0, sizeof(lif.led));
+  fe = (lif.lh.Flags & 0x00000001) && (rnd(3) == 0); // Vista+ links often repeat the IDList
+  lif.led.edtypes = TRACKER_PROPS * (rnd(5) != 0) | PROPERTY_STORE_PROPS * (rnd(2)) |
+    SPECIAL_FOLDER_PROPS * (rnd(6) == 0) | KNOWN_FOLDER_PROPS * (rnd(4) == 0) |
+    CONSOLE_PROPS * (rnd(50) == 0) | CONSOLE_FE_PROPS * (rnd(60) == 0) | VISTA_AND_ABOVE_IDLIST_PROPS * fe;
+  if (lif.lh.Flags & 0x00000200)
+  {
+    lif.led.edtypes |= ENVIRONMENT_PROPS;
+    snprintf((char *)lif.led.lep.TargetAnsi, 260, "%%USERPROFILE%%\\%s", file);
+  }
+  if (lif.lh.Flags & 0x00001000)
+  {
+    lif.led.edtypes |= DARWIN_PROPS;
+    snprintf((char *)lif.led.ldp.DarwinDataAnsi, 260, "w_1^VX!!!!!!!!!MKKSkEXCELFiles>tW{~$4Q]c@II=l2xaTO5Z");
+  }
+  if (lif.lh.Flags & 0x00004000)
+  {
+    lif.led.edtypes |= ICON_ENVIRONMENT_PROPS;
+    snprintf((char *)lif.led.liep.TargetAnsi, 260, "%%ProgramFiles%%\\%s\\app.exe", PICK(files));
+  }
+  if (lif.lh.Flags & 0x00020000)
+  {
+    lif.led.edtypes |= SHIM_PROPS;
+    mbstowcs(lif.led.lsp.LayerName, PICK(layers), 600);
+  }
+  if (lif.led.edtypes & CONSOLE_PROPS)
+  {
+    lif.led.lcp.FillAttributes = 0x07;
+    lif.led.lcp.PopupFillAttributes = 0xF5;
+    lif.led.lcp.ScreenBufferSizeX = 80 + rnd(2) * 40;
+    lif.led.lcp.ScreenBufferSizeY = 300 + rnd(9000);
+    lif.led.lcp.WindowSizeX = lif.led.lcp.ScreenBufferSizeX;
+    lif.led.lcp.WindowSizeY = 25 + rnd(30);
+    lif.led.lcp.FontSize_Height = 12 + rnd(8);
+    lif.led.lcp.FontFamily = 0x36;
+    lif.led.lcp.FontWeight = 400;
+    mbstowcs(lif.led.lcp.FaceName, rnd(2) ? "Consolas" : "Lucida Console", 32);
+    lif.led.lcp.CursorSize = 25;
+    lif.led.lcp.QuickEdit = rnd(2);
+    lif.led.lcp.InsertMode = 1;
+    lif.led.lcp.AutoPosition = 1;
+    lif.led.lcp.HistoryBufferSize = 50;
+    lif.led.lcp.NumberOfHistoryBuffers = 4;
+    for (i = 0; i < 16; i++)
+    {
+      lif.led.lcp.ColorTable[i] = (uint32_t)rng() & 0x00FFFFFF;
+    }
+  }
+  lif.led.lcfep.CodePage = rnd(2) ? 437 : 1252;
+  lif.led.lsfp.SpecialFolderID = rnd(2) ? 0x05 : 0x26; // CSIDL_PERSONAL or CSIDL_PROGRAM_FILES
+  lif.led.lsfp.Offset = 0x14 + 0x19;
+  lif.led.lkfp.KFGUID = known_folders[rnd(4)];
+  lif.led.lkfp.KFOffset = 0x14;
+  if (lif.led.edtypes & PROPERTY_STORE_PROPS)
+  {
+    lif.led.lpsp.NumStores = 1 + rnd(3);
+    gen_propstore(&lif.led.lpsp.Stores[0], &fmtid_storage);
+    if (lif.led.lpsp.NumStores > 1)
+    {
+      gen_propstore(&lif.led.lpsp.Stores[1], &fmtid_link);
+    }
+    if (lif.led.lpsp.NumStores > 2)
+    {
+      gen_propstore(&lif.led.lpsp.Stores[2], &fmtid_thumb);
+    }
+  }
+  if (lif.led.edtypes & TRACKER_PROPS)
+  {
+    snprintf((char *)lif.led.ltp.MachineID, 16, "%s", PICK(machines));
+    for (i = 0; i < 6; i++)
+    {
+      node[i] = (unsigned char)rnd(256);
+    }
+    t = lif.lh.CrDate ? lif.lh.CrDate : lif.lh.WtDate;
+    gen_uuid(&lif.led.ltp.Droid2, t, node);
+    lif.led.ltp.Droid1.Data1 = (uint32_t)rng();
+    lif.led.ltp.Droid1.Data2 = (uint16_t)rng();
+    lif.led.ltp.Droid1.Data3 = (uint16_t)((rng() & 0x0FFF) | 0x4000); // The volume's ID is random (version 4)
+    memcpy(lif.led.ltp.Droid1.Data4hi, "\x9A\x3C", 2);
+    memcpy(lif.led.ltp.Droid1.Data4lo, "\x51\x2E\x77\x08\xC1\xF0", 6);
+    lif.led.ltp.DroidBirth1 = lif.led.ltp.Droid1;
+    lif.led.ltp.DroidBirth2 = lif.led.ltp.Droid2;
+    if (rnd(10) == 0) // The target has moved since the link was made
+    {
+      gen_uuid(&lif.led.ltp.Droid2, lif.lh.WtDate, node);
+    }
+  }
+  if (fe)
+  {
+    lif.led.lvidlp.NumItemIDs = lif.lidl.NumItemIDs;
+    memcpy(lif.led.lvidlp.Items, lif.lidl.Items, sizeof(lif.lidl.Items));
+  }
+}
+
+//
+//Function: write_link() lays out lif as a link file and writes it to path
+int write_link(const char * path)
+{
+  FILE *fp;
+  int p, q;
+
+  p = put_hdr(out, &lif.lh);
+  if (lif.lh.Flags & 0x00000001)
+  {
+    q = put_items(out, p + 2, lif.lidl.Items, lif.lidl.NumItemIDs);
+    lif.lidl.IDListSize = (uint16_t)(q - p - 2);
+    put_u16(out, p, lif.lidl.IDListSize);
+    p = q;
+  }
+  p = put_linkinfo(out, p, &lif.li);
+  p = put_stringdata(out, p, &lif.lh);
+  p = put_extradata(out, p, &lif.led);
+  if ((fp = fopen(path, "wb")) == NULL)
+  {
+    perror("Error");
+    fprintf(stderr, "whilst creating file: \'%s\'\n", path);
+    return -1;
+  }
+  if ((fwrite(out, 1, p, fp) != (size_t)p) | (fclose(fp) != 0))
+  {
+    perror("Error");
+    fprintf(stderr, "whilst writing file: \'%s\'\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+//
+//Function: write_edcounts() writes extradata.txt to dir: the signature of
+//          each type of ExtraData block and how many link files have one
+int write_edcounts(const char * dir, const long edcount[])
+{
+  FILE *fp;
+  char path[1024];
+  int j, err;
+
+  snprintf(path, sizeof(path), "%s/extradata.txt", dir);
+  if ((fp = fopen(path, "w")) == NULL)
+  {
+    perror("Error");
+    fprintf(stderr, "whilst creating file: \'%s\'\n", path);
+    return -1;
+  }
+  err = 0;
+  for (j = 0; j < EDSIGS; j++)
+  {
+    err |= (fprintf(fp, "0x%08" PRIX32 " %ld\n", edsigs[j].sig, edcount[j]) < 0);
+  }
+  if (err | (fclose(fp) != 0))
+  {
+    perror("Error");
+    fprintf(stderr, "whilst writing file: \'%s\'\n", path);
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,1003 @@
+/***************************************************************
+**                                                            **
+**                    libarrowipc.c                           **
+**                                                            **
+**    A small writer for the Apache Arrow IPC streaming       **
+** format that needs no Arrow or Flatbuffers library.         **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libarrowipc.h for the exported functions               **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "./libarrowipc.h"
+
+/*
+A stream is the Schema message, then for each batch any new dictionary
+entries (a DictionaryBatch per dictionary column, the first one complete and
+later ones as deltas) followed by the RecordBatch, and finally an end of
+stream marker. Each message is a 0xFFFFFFFF continuation marker, the length
+of its metadata, the metadata (a flatbuffer) and the message body (the column
+buffers, each padded to 8 bytes). Everything is little endian.
+
+The flatbuffers are built front to back: a table's vtable is written just
+before it and the objects a table refers to are written after it, so the
+unsigned offsets to them are always forward as the format requires. Offset
+fields are written as 0 and patched once the object they point at exists.
+*/
+
+#define AIPC_MAXDATA  (1 << 30) // Start a new batch before a string column's data nears 2GB
+
+// Message header and type identifiers from Message.fbs & Schema.fbs
+#define AIPC_V5           4
+#define AIPC_SCHEMA       1
+#define AIPC_DICTBATCH    2
+#define AIPC_RECORDBATCH  3
+#define AIPC_TYPE_INT     2
+#define AIPC_TYPE_UTF8    5
+
+struct AIPC_BUF // A growable byte buffer
+{
+  unsigned char *    p;
+  size_t             len;
+  size_t             size;
+  int                err;   // Set if an allocation failed
+};
+
+struct AIPC_FB // A field of a flatbuffer table being written
+{
+  int                Size;  // 1, 2, 4 or 8 bytes, 0 if the field is absent
+  uint64_t           Value; // Offset fields are patched later
+  size_t             Posn;  // Where the field was written
+};
+
+struct AIPC_PART // A buffer of a message body
+{
+  const unsigned char *  p;
+  size_t                 len;
+};
+
+struct AIPC_COL
+{
+  enum AIPC_TYPE     Type;
+  int                Width;  // Bytes per value (the index for AIPC_DICT)
+  int                Set;    // The value for the current row is set
+  int64_t            Nulls;  // In the current batch
+  struct AIPC_BUF    Valid;  // Validity bitmap
+  struct AIPC_BUF    Data;   // Values, UTF-8 bytes or dictionary indices
+  struct AIPC_BUF    Offs;   // AIPC_UTF8 only: int32 offsets into Data
+  // AIPC_DICT only: every dictionary entry & a hash table of them
+  struct AIPC_BUF    DictData;
+  struct AIPC_BUF    DictOffs; // uint32_t offsets into DictData (host order)
+  int32_t            DictNum;
+  int32_t            DictSent; // Entries already written to the stream
+  int32_t *          Hash;     // Entry numbers, -1 if the slot is free
+  uint32_t           HashSize;
+};
+
+struct AIPC_WRITER
+{
+  FILE *                     fp;
+  const struct AIPC_FIELD *  Fields;
+  int                        NumCols;
+  struct AIPC_COL *          Cols;
+  int                        Rows;     // In the current batch
+  int                        MaxRows;
+  int                        Full;     // A string column needs a new batch
+  int                        Batches;  // Written so far
+  int                        err;
+  struct AIPC_BUF            fb;       // Flatbuffer of the message being written
+  struct AIPC_BUF            tmp;      // Scratch for converted strings
+  struct AIPC_PART *         Parts;
+  int64_t *                  Nodes;    // FieldNode structs (length & null count)
+  int64_t *                  Bufs;     // Buffer structs (offset & length)
+};
+
+//Local function declarations
+int aipc_need(struct AIPC_BUF *, size_t);
+void aipc_put(struct AIPC_BUF *, const void *, size_t);
+void aipc_le(struct AIPC_BUF *, uint64_t, int);
+void aipc_pad(struct AIPC_BUF *, size_t);
+void aipc_store(unsigned char *, uint64_t, int);
+void aipc_patch(struct AIPC_BUF *, size_t, size_t);
+size_t aipc_table(struct AIPC_BUF *, struct AIPC_FB *, int);
+size_t aipc_string(struct AIPC_BUF *, const char *);
+size_t aipc_vector(struct AIPC_BUF *, int);
+size_t aipc_structs(struct AIPC_BUF *, const int64_t *, int);
+size_t aipc_int_type(struct AIPC_BUF *, int, int);
+int aipc_schema(struct AIPC_WRITER *);
+int aipc_message(struct AIPC_WRITER *, int, int64_t, int64_t, int, int, int);
+int aipc_dicts(struct AIPC_WRITER *);
+int aipc_batch(struct AIPC_WRITER *);
+void aipc_value(struct AIPC_WRITER *, int, const unsigned char *, size_t);
+int32_t aipc_lookup(struct AIPC_COL *, const unsigned char *, size_t);
+uint32_t aipc_hash(const unsigned char *, size_t);
+int aipc_utf8(const unsigned char *, size_t *);
+void aipc_utf8_char(struct AIPC_BUF *, uint32_t);
+void aipc_free(struct AIPC_WRITER *);
+
+//
+//Function: aipc_open() sets up the writer and writes the schema
+extern int aipc_open(FILE * fp, const struct AIPC_FIELD * fields, int num, int rows, struct AIPC_WRITER ** wp)
+{
+  struct AIPC_WRITER  *w;
+  struct AIPC_COL     *c;
+  int                 i, err = 0;
+
+  *wp = NULL;
+  if (rows <= 0)
+  {
+    rows = AIPC_ROWS;
+  }
+  if (((w = calloc(1, sizeof(struct AIPC_WRITER))) == NULL) ||
+    ((w->Cols = calloc(num, sizeof(struct AIPC_COL))) == NULL) ||
+    ((w->Parts = calloc(3 * num, sizeof(struct AIPC_PART))) == NULL) ||
+    ((w->Nodes = calloc(2 * num, sizeof(int64_t))) == NULL) ||
+    ((w->Bufs = calloc(6 * num, sizeof(int64_t))) == NULL))
+  {
+    fprintf(stderr, "Unable to allocate memory for the Arrow output\n");
+    aipc_free(w);
+    return -1;
+  }
+  w->fp = fp;
+  w->Fields = fields;
+  w->NumCols = num;
+  w->MaxRows = rows;
+  for (i = 0; i < num; i++)
+  {
+    c = &w->Cols[i];
+    c->Type = fields[i].Type;
+    switch (c->Type)
+    {
+    case AIPC_INT16:
+    case AIPC_UINT16:
+      c->Width = 2;
+      break;
+    case AIPC_INT64:
+    case AIPC_UINT64:
+      c->Width = 8;
+      break;
+    case AIPC_UTF8:
+      c->Width = 0;
+      err |= aipc_need(&c->Offs, ((size_t)rows + 1) * 4);
+      break;
+    default:
+      c->Width = 4;
+    }
+    err |= aipc_need(&c->Valid, ((size_t)rows + 7) / 8);
+    if (c->Width > 0)
+    {
+      err |= aipc_need(&c->Data, (size_t)rows * c->Width);
+    }
+    else
+    {
+      aipc_store(c->Offs.p, 0, 4);
+    }
+    if (c->Type == AIPC_DICT)
+    {
+      aipc_le(&c->DictOffs, 0, 4); // The first entry's start (host order is fine, all zeros)
+      err |= c->DictOffs.err;
+    }
+    if (err == 0)
+    {
+      memset(c->Valid.p, 0, ((size_t)rows + 7) / 8);
+    }
+  }
+  if (err)
+  {
+    fprintf(stderr, "Unable to allocate memory for the Arrow output\n");
+    aipc_free(w);
+    return -1;
+  }
+  if (aipc_schema(w) < 0)
+  {
+    aipc_free(w);
+    return -1;
+  }
+  *wp = w;
+  return 0;
+}
+
+//
+//Function: aipc_int() sets a number column
+extern void aipc_int(struct AIPC_WRITER * w, int col, int64_t v)
+{
+  struct AIPC_COL *c = &w->Cols[col];
+
+  if ((c->Type == AIPC_UTF8) || (c->Type == AIPC_DICT))
+  {
+    return;
+  }
+  aipc_store(c->Data.p + (size_t)w->Rows * c->Width, (uint64_t)v, c->Width);
+  c->Valid.p[w->Rows / 8] |= (unsigned char)(1 << (w->Rows % 8));
+  c->Set = 1;
+}
+
+//
+//Function: aipc_str() sets a string column from a UTF-8 (or, failing that,
+//Latin-1) string
+extern void aipc_str(struct AIPC_WRITER * w, int col, const char * s)
+{
+  const unsigned char  *u = (const unsigned char *)s;
+  size_t               len, i;
+
+  if (aipc_utf8(u, &len))
+  {
+    aipc_value(w, col, u, len);
+    return;
+  }
+  w->tmp.len = 0;
+  for (i = 0; u[i] != 0; i++)
+  {
+    aipc_utf8_char(&w->tmp, u[i]);
+  }
+  aipc_value(w, col, w->tmp.p, w->tmp.len);
+}
+
+//
+//Function: aipc_wstr() sets a string column from a wide string, which may
+//hold UTF-16 surrogate pairs where wchar_t is 16 bits
+extern void aipc_wstr(struct AIPC_WRITER * w, int col, const wchar_t * s)
+{
+  uint32_t  ch, lo;
+  size_t    i;
+
+  w->tmp.len = 0;
+  for (i = 0; s[i] != 0; i++)
+  {
+    ch = (uint32_t)s[i];
+    if ((ch >= 0xD800) && (ch <= 0xDBFF))
+    {
+      lo = (uint32_t)s[i + 1];
+      if ((lo >= 0xDC00) && (lo <= 0xDFFF))
+      {
+        ch = 0x10000 + ((ch - 0xD800) << 10) + (lo - 0xDC00);
+        i++;
+      }
+      else
+      {
+        ch = 0xFFFD;
+      }
+    }
+    else if (((ch >= 0xDC00) && (ch <= 0xDFFF)) || (ch > 0x10FFFF))
+    {
+      ch = 0xFFFD;
+    }
+    aipc_utf8_char(&w->tmp, ch);
+  }
+  aipc_value(w, col, (w->tmp.len > 0) ? w->tmp.p : (const unsigned char *)"", w->tmp.len);
+}
+
+//
+//Function: aipc_null() sets a column to null
+extern void aipc_null(struct AIPC_WRITER * w, int col)
+{
+  struct AIPC_COL *c = &w->Cols[col];
+
+  if (c->Type == AIPC_UTF8)
+  {
+    aipc_store(c->Offs.p + ((size_t)w->Rows + 1) * 4, c->Data.len, 4);
+  }
+  else
+  {
+    memset(c->Data.p + (size_t)w->Rows * c->Width, 0, c->Width);
+  }
+  c->Nulls++;
+  c->Set = 1;
+}
+
+//
+//Function: aipc_row() ends a row and writes the batch once it is full
+extern int aipc_row(struct AIPC_WRITER * w)
+{
+  int i;
+
+  for (i = 0; i < w->NumCols; i++)
+  {
+    if (!w->Cols[i].Set)
+    {
+      aipc_null(w, i);
+    }
+    w->Cols[i].Set = 0;
+  }
+  w->Rows++;
+  if ((w->Rows == w->MaxRows) || w->Full)
+  {
+    aipc_batch(w);
+  }
+  return w->err;
+}
+
+//
+//Function: aipc_peak() returns the bytes of the writer's buffers, which
+//only grow, so it is the most they have used
+extern size_t aipc_peak(struct AIPC_WRITER * w)
+{
+  size_t size = w->fb.size + w->tmp.size;
+  int i;
+
+  for (i = 0; i < w->NumCols; i++)
+  {
+    size += w->Cols[i].Valid.size + w->Cols[i].Data.size + w->Cols[i].Offs.size +
+      w->Cols[i].DictData.size + w->Cols[i].DictOffs.size + (w->Cols[i].HashSize * sizeof(int32_t));
+  }
+  return size;
+}
+
+//
+//Function: aipc_close() writes the last batch and the end of stream marker
+extern int aipc_close(struct AIPC_WRITER * w)
+{
+  static const unsigned char  eos[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0 };
+  int                         result;
+
+  if (w->Rows > 0)
+  {
+    aipc_batch(w);
+  }
+  if ((w->err == 0) && ((fwrite(eos, 1, 8, w->fp) != 8) || (fflush(w->fp) != 0)))
+  {
+    perror("Error writing the Arrow stream");
+    w->err = -1;
+  }
+  result = w->err;
+  aipc_free(w);
+  return result;
+}
+
+//
+//Function: aipc_schema() writes the Schema message. Every field is nullable,
+//numbers are Int types and the dictionary columns are Utf8 values with int32
+//indices (the dictionary id is the column number).
+int aipc_schema(struct AIPC_WRITER * w)
+{
+  struct AIPC_BUF  *b = &w->fb;
+  struct AIPC_FB   m[4] = { { 2, AIPC_V5 }, { 1, AIPC_SCHEMA }, { 4, 0 }, { 8, 0 } };
+  struct AIPC_FB   s[2] = { { 2, 0 }, { 4, 0 } }; // Little endian, fields
+  struct AIPC_FB   f[6], d[2];
+  size_t           fields;
+  int              i, num;
+
+  b->len = 0;
+  aipc_le(b, 0, 4); // Root table offset
+  aipc_patch(b, 0, aipc_table(b, m, 4));
+  aipc_patch(b, m[2].Posn, aipc_table(b, s, 2));
+  fields = aipc_vector(b, w->NumCols);
+  aipc_patch(b, s[1].Posn, fields);
+  for (i = 0; i < w->NumCols; i++)
+  {
+    num = (w->Cols[i].Type != AIPC_UTF8) && (w->Cols[i].Type != AIPC_DICT);
+    // name, nullable, type_type, type, dictionary, children
+    f[0].Size = 4; f[0].Value = 0;
+    f[1].Size = 1; f[1].Value = 1;
+    f[2].Size = 1; f[2].Value = num ? AIPC_TYPE_INT : AIPC_TYPE_UTF8;
+    f[3].Size = 4; f[3].Value = 0;
+    f[4].Size = (w->Cols[i].Type == AIPC_DICT) ? 4 : 0; f[4].Value = 0;
+    f[5].Size = 4; f[5].Value = 0;
+    aipc_patch(b, fields + 4 + 4 * i, aipc_table(b, f, 6));
+    aipc_patch(b, f[0].Posn, aipc_string(b, w->Fields[i].Name));
+    if (num)
+    {
+      aipc_patch(b, f[3].Posn, aipc_int_type(b, w->Cols[i].Width * 8, (w->Cols[i].Type == AIPC_INT16) ||
+        (w->Cols[i].Type == AIPC_INT32) || (w->Cols[i].Type == AIPC_INT64)));
+    }
+    else
+    {
+      aipc_patch(b, f[3].Posn, aipc_table(b, NULL, 0)); // Utf8 has no fields
+    }
+    if (w->Cols[i].Type == AIPC_DICT)
+    {
+      d[0].Size = 8; d[0].Value = i; // id, indexType
+      d[1].Size = 4; d[1].Value = 0;
+      aipc_patch(b, f[4].Posn, aipc_table(b, d, 2));
+      aipc_patch(b, d[1].Posn, aipc_int_type(b, 32, 1));
+    }
+    aipc_patch(b, f[5].Posn, aipc_vector(b, 0));
+  }
+  return aipc_message(w, AIPC_SCHEMA, 0, 0, 0, 0, 0);
+}
+
+//
+//Function: aipc_message() builds the metadata of a RecordBatch or a
+//DictionaryBatch (when 'type' is AIPC_DICTBATCH) for the 'nodes' FieldNodes
+//and 'parts' body buffers that have been set up and writes the message. A
+//Schema message's metadata is already built and is just written.
+int aipc_message(struct AIPC_WRITER * w, int type, int64_t length, int64_t id, int delta, int nodes, int parts)
+{
+  struct AIPC_BUF  *b = &w->fb;
+  struct AIPC_FB   m[4] = { { 2, AIPC_V5 }, { 1, 0 }, { 4, 0 }, { 8, 0 } };
+  struct AIPC_FB   d[3] = { { 8, 0 }, { 4, 0 }, { 1, 0 } };
+  struct AIPC_FB   r[3] = { { 8, 0 }, { 4, 0 }, { 4, 0 } };
+  unsigned char    head[8], zero[8] = { 0 };
+  size_t           body = 0, meta, slot;
+  int              i;
+
+  for (i = 0; i < parts; i++)
+  {
+    w->Bufs[2 * i] = (int64_t)body;
+    w->Bufs[2 * i + 1] = (int64_t)w->Parts[i].len;
+    body += (w->Parts[i].len + 7) & ~(size_t)7;
+  }
+  if (type != AIPC_SCHEMA)
+  {
+    b->len = 0;
+    aipc_le(b, 0, 4); // Root table offset
+    m[1].Value = type;
+    m[3].Value = body;
+    aipc_patch(b, 0, aipc_table(b, m, 4));
+    slot = m[2].Posn;
+    if (type == AIPC_DICTBATCH)
+    {
+      d[0].Value = (uint64_t)id;
+      d[2].Value = delta;
+      aipc_patch(b, slot, aipc_table(b, d, 3));
+      slot = d[1].Posn;
+    }
+    r[0].Value = (uint64_t)length;
+    aipc_patch(b, slot, aipc_table(b, r, 3));
+    aipc_patch(b, r[1].Posn, aipc_structs(b, w->Nodes, nodes));
+    aipc_patch(b, r[2].Posn, aipc_structs(b, w->Bufs, parts));
+  }
+  if (b->err)
+  {
+    fprintf(stderr, "Unable to allocate memory for the Arrow output\n");
+    w->err = -1;
+    return -1;
+  }
+  // The continuation marker, metadata length (padded so the body starts on
+  // an 8 byte boundary), metadata & body
+  meta = (b->len + 7) & ~(size_t)7;
+  aipc_store(head, 0xFFFFFFFF, 4);
+  aipc_store(head + 4, meta, 4);
+  if ((fwrite(head, 1, 8, w->fp) != 8) || (fwrite(b->p, 1, b->len, w->fp) != b->len) ||
+    (fwrite(zero, 1, meta - b->len, w->fp) != meta - b->len))
+  {
+    perror("Error writing the Arrow stream");
+    w->err = -1;
+    return -1;
+  }
+  for (i = 0; i < parts; i++)
+  {
+    if (((w->Parts[i].len > 0) && (fwrite(w->Parts[i].p, 1, w->Parts[i].len, w->fp) != w->Parts[i].len)) ||
+      (fwrite(zero, 1, ((w->Parts[i].len + 7) & ~(size_t)7) - w->Parts[i].len, w->fp) !=
+      ((w->Parts[i].len + 7) & ~(size_t)7) - w->Parts[i].len))
+    {
+      perror("Error writing the Arrow stream");
+      w->err = -1;
+      return -1;
+    }
+  }
+  return 0;
+}
+
+//
+//Function: aipc_dicts() writes the dictionary entries added since the last
+//batch. Before the first batch every dictionary is written, even if empty,
+//as a reader needs them all before it can read a RecordBatch.
+int aipc_dicts(struct AIPC_WRITER * w)
+{
+  struct AIPC_COL  *c;
+  uint32_t         *offs;
+  int32_t          n, j;
+  int              i;
+
+  for (i = 0; i < w->NumCols; i++)
+  {
+    c = &w->Cols[i];
+    if ((c->Type != AIPC_DICT) || ((c->DictNum == c->DictSent) && (w->Batches > 0)))
+    {
+      continue;
+    }
+    n = c->DictNum - c->DictSent;
+    offs = (uint32_t *)c->DictOffs.p + c->DictSent;
+    // The new entries' offsets start from 0
+    w->tmp.len = 0;
+    for (j = 0; j <= n; j++)
+    {
+      aipc_le(&w->tmp, offs[j] - offs[0], 4);
+    }
+    if (w->tmp.err)
+    {
+      fprintf(stderr, "Unable to allocate memory for the Arrow output\n");
+      w->err = -1;
+      return -1;
+    }
+    w->Nodes[0] = n;
+    w->Nodes[1] = 0;
+    w->Parts[0].p = NULL; // No nulls, so no validity bitmap
+    w->Parts[0].len = 0;
+    w->Parts[1].p = w->tmp.p;
+    w->Parts[1].len = w->tmp.len;
+    w->Parts[2].p = c->DictData.p + offs[0];
+    w->Parts[2].len = offs[n] - offs[0];
+    if (aipc_message(w, AIPC_DICTBATCH, n, i, c->DictSent > 0, 1, 3) < 0)
+    {
+      return -1;
+    }
+    c->DictSent = c->DictNum;
+  }
+  return 0;
+}
+
+//
+//Function: aipc_batch() writes the rows collected so far as a RecordBatch
+//and empties the columns for the next one
+int aipc_batch(struct AIPC_WRITER * w)
+{
+  struct AIPC_COL  *c;
+  int              i, parts = 0;
+
+  if ((w->err == 0) && (aipc_dicts(w) == 0))
+  {
+    for (i = 0; i < w->NumCols; i++)
+    {
+      c = &w->Cols[i];
+      w->Nodes[2 * i] = w->Rows;
+      w->Nodes[2 * i + 1] = c->Nulls;
+      w->Parts[parts].p = c->Valid.p;
+      w->Parts[parts++].len = ((size_t)w->Rows + 7) / 8;
+      if (c->Type == AIPC_UTF8)
+      {
+        w->Parts[parts].p = c->Offs.p;
+        w->Parts[parts++].len = ((size_t)w->Rows + 1) * 4;
+      }
+      w->Parts[parts].p = c->Data.p;
+      w->Parts[parts++].len = (c->Type == AIPC_UTF8) ? c->Data.len : (size_t)w->Rows * c->Width;
+    }
+    aipc_message(w, AIPC_RECORDBATCH, w->Rows, 0, 0, w->NumCols, parts);
+  }
+  w->Batches++;
+  for (i = 0; i < w->NumCols; i++)
+  {
+    c = &w->Cols[i];
+    memset(c->Valid.p, 0, ((size_t)w->Rows + 7) / 8);
+    c->Nulls = 0;
+    if (c->Type == AIPC_UTF8)
+    {
+      c->Data.len = 0;
+    }
+  }
+  w->Rows = 0;
+  w->Full = 0;
+  return w->err;
+}
+
+//
+//Function: aipc_value() sets a string column to 'len' bytes of UTF-8
+void aipc_value(struct AIPC_WRITER * w, int col, const unsigned char * s, size_t len)
+{
+  struct AIPC_COL  *c = &w->Cols[col];
+  int32_t          index;
+
+  if (c->Type == AIPC_UTF8)
+  {
+    aipc_put(&c->Data, s, len);
+    aipc_store(c->Offs.p + ((size_t)w->Rows + 1) * 4, c->Data.len, 4);
+    if (c->Data.len > AIPC_MAXDATA)
+    {
+      w->Full = 1;
+    }
+  }
+  else if (c->Type == AIPC_DICT)
+  {
+    if ((index = aipc_lookup(c, s, len)) < 0)
+    {
+      c->Data.err = 1;
+    }
+    aipc_store(c->Data.p + (size_t)w->Rows * 4, (uint32_t)index, 4);
+  }
+  else
+  {
+    return;
+  }
+  if (c->Data.err)
+  {
+    fprintf(stderr, "Unable to allocate memory for the Arrow output\n");
+    w->err = -1;
+    aipc_null(w, col);
+    return;
+  }
+  c->Valid.p[w->Rows / 8] |= (unsigned char)(1 << (w->Rows % 8));
+  c->Set = 1;
+}
+
+//
+//Function: aipc_lookup() returns the dictionary index of a string, adding it
+//if it is new (or -1 if memory runs out)
+int32_t aipc_lookup(struct AIPC_COL * c, const unsigned char * s, size_t len)
+{
+  uint32_t  *offs, i, size, h;
+  int32_t   *hash, e;
+
+  // Keep the table at most half full
+  if ((uint32_t)c->DictNum * 2 >= c->HashSize)
+  {
+    size = (c->HashSize > 0) ? c->HashSize * 2 : 64;
+    if ((hash = malloc(size * sizeof(int32_t))) == NULL)
+    {
+      return -1;
+    }
+    memset(hash, 0xFF, size * sizeof(int32_t));
+    offs = (uint32_t *)c->DictOffs.p;
+    for (e = 0; e < c->DictNum; e++)
+    {
+      for (i = aipc_hash(c->DictData.p + offs[e], offs[e + 1] - offs[e]) & (size - 1); hash[i] >= 0; i = (i + 1) & (size - 1));
+      hash[i] = e;
+    }
+    free(c->Hash);
+    c->Hash = hash;
+    c->HashSize = size;
+  }
+  h = aipc_hash(s, len);
+  offs = (uint32_t *)c->DictOffs.p;
+  for (i = h & (c->HashSize - 1); (e = c->Hash[i]) >= 0; i = (i + 1) & (c->HashSize - 1))
+  {
+    if ((offs[e + 1] - offs[e] == len) && (memcmp(c->DictData.p + offs[e], s, len) == 0))
+    {
+      return e;
+    }
+  }
+  aipc_put(&c->DictData, s, len);
+  if (aipc_need(&c->DictOffs, sizeof(uint32_t)) < 0)
+  {
+    return -1;
+  }
+  ((uint32_t *)c->DictOffs.p)[c->DictNum + 1] = (uint32_t)c->DictData.len;
+  c->DictOffs.len += sizeof(uint32_t);
+  c->Hash[i] = c->DictNum;
+  return (c->DictData.err) ? -1 : c->DictNum++;
+}
+
+//
+//Function: aipc_hash() is FNV-1a
+uint32_t aipc_hash(const unsigned char * s, size_t len)
+{
+  uint32_t  h = 2166136261u;
+  size_t    i;
+
+  for (i = 0; i < len; i++)
+  {
+    h = (h ^ s[i]) * 16777619u;
+  }
+  return h;
+}
+
+//
+//Function: aipc_utf8() returns 1 if a zero terminated string is valid UTF-8
+//(and its length in len), 0 if not
+int aipc_utf8(const unsigned char * s, size_t * len)
+{
+  size_t  i = 0;
+  int     n, k;
+
+  while (s[i] != 0)
+  {
+    if (s[i] < 0x80)
+    {
+      i++;
+      continue;
+    }
+    if ((s[i] >= 0xC2) && (s[i] <= 0xDF))
+    {
+      n = 1;
+    }
+    else if ((s[i] >= 0xE0) && (s[i] <= 0xEF))
+    {
+      n = 2;
+    }
+    else if ((s[i] >= 0xF0) && (s[i] <= 0xF4))
+    {
+      n = 3;
+    }
+    else
+    {
+      return 0;
+    }
+    // (A terminating zero fails this test so the string is never overrun)
+    for (k = 1; k <= n; k++)
+    {
+      if ((s[i + k] & 0xC0) != 0x80)
+      {
+        return 0;
+      }
+    }
+    // Overlong forms, surrogates and values above U+10FFFF
+    if (((s[i] == 0xE0) && (s[i + 1] < 0xA0)) || ((s[i] == 0xED) && (s[i + 1] >= 0xA0)) ||
+      ((s[i] == 0xF0) && (s[i + 1] < 0x90)) || ((s[i] == 0xF4) && (s[i + 1] >= 0x90)))
+    {
+      return 0;
+    }
+    i += n + 1;
+  }
+  *len = i;
+  return 1;
+}
+
+//
+//Function: aipc_utf8_char() appends a character as UTF-8
+void aipc_utf8_char(struct AIPC_BUF * b, uint32_t ch)
+{
+  unsigned char  u[4];
+  size_t         n;
+
+  if (ch < 0x80)
+  {
+    u[0] = (unsigned char)ch;
+    n = 1;
+  }
+  else if (ch < 0x800)
+  {
+    u[0] = (unsigned char)(0xC0 | (ch >> 6));
+    u[1] = (unsigned char)(0x80 | (ch & 0x3F));
+    n = 2;
+  }
+  else if (ch < 0x10000)
+  {
+    u[0] = (unsigned char)(0xE0 | (ch >> 12));
+    u[1] = (unsigned char)(0x80 | ((ch >> 6) & 0x3F));
+    u[2] = (unsigned char)(0x80 | (ch & 0x3F));
+    n = 3;
+  }
+  else
+  {
+    u[0] = (unsigned char)(0xF0 | (ch >> 18));
+    u[1] = (unsigned char)(0x80 | ((ch >> 12) & 0x3F));
+    u[2] = (unsigned char)(0x80 | ((ch >> 6) & 0x3F));
+    u[3] = (unsigned char)(0x80 | (ch & 0x3F));
+    n = 4;
+  }
+  aipc_put(b, u, n);
+}
+
+//
+//Function: aipc_table() writes a flatbuffer table (preceded by its vtable)
+//with the fields laid out 4, 8, 2 then 1 byte ones so that each is aligned.
+//The position of each field is returned in its Posn. Returns the position
+//of the table.
+size_t aipc_table(struct AIPC_BUF * b, struct AIPC_FB * f, int n)
+{
+  static const int  order[4] = { 4, 8, 2, 1 };
+  size_t            off[8], vt, tbl, size = 4; // The table starts with the offset to its vtable
+  int               i, j;
+
+  for (i = 0; i < n; i++)
+  {
+    off[i] = 0;
+  }
+  for (j = 0; j < 4; j++)
+  {
+    for (i = 0; i < n; i++)
+    {
+      if (f[i].Size == order[j])
+      {
+        size = (size + order[j] - 1) & ~(size_t)(order[j] - 1);
+        off[i] = size;
+        size += order[j];
+      }
+    }
+  }
+  aipc_pad(b, 2);
+  vt = b->len;
+  aipc_le(b, 4 + 2 * n, 2);
+  aipc_le(b, size, 2);
+  for (i = 0; i < n; i++)
+  {
+    aipc_le(b, off[i], 2);
+  }
+  aipc_pad(b, 8);
+  tbl = b->len;
+  aipc_le(b, tbl - vt, 4);
+  if (aipc_need(b, size - 4) < 0)
+  {
+    return 0;
+  }
+  memset(b->p + b->len, 0, size - 4);
+  b->len += size - 4;
+  for (i = 0; i < n; i++)
+  {
+    if (off[i] > 0)
+    {
+      aipc_store(b->p + tbl + off[i], f[i].Value, f[i].Size);
+      f[i].Posn = tbl + off[i];
+    }
+  }
+  return tbl;
+}
+
+//
+//Function: aipc_int_type() writes an Int type table
+size_t aipc_int_type(struct AIPC_BUF * b, int bits, int is_signed)
+{
+  struct AIPC_FB t[2] = { { 4, 0 }, { 1, 0 } }; // bitWidth, is_signed
+
+  t[0].Value = bits;
+  t[1].Value = is_signed;
+  return aipc_table(b, t, 2);
+}
+
+//
+//Function: aipc_string() writes a flatbuffer string, returning its position
+size_t aipc_string(struct AIPC_BUF * b, const char * s)
+{
+  size_t pos, len = strlen(s);
+
+  aipc_pad(b, 4);
+  pos = b->len;
+  aipc_le(b, len, 4);
+  aipc_put(b, s, len + 1);
+  return pos;
+}
+
+//
+//Function: aipc_vector() writes a vector of 'n' offsets (to be patched),
+//returning its position. The i'th offset is at position + 4 + 4 * i.
+size_t aipc_vector(struct AIPC_BUF * b, int n)
+{
+  size_t  pos;
+  int     i;
+
+  aipc_pad(b, 4);
+  pos = b->len;
+  aipc_le(b, n, 4);
+  for (i = 0; i < n; i++)
+  {
+    aipc_le(b, 0, 4);
+  }
+  return pos;
+}
+
+//
+//Function: aipc_structs() writes a vector of 'n' structs of two int64s
+//(FieldNode or Buffer), which have to start on an 8 byte boundary.
+size_t aipc_structs(struct AIPC_BUF * b, const int64_t * v, int n)
+{
+  size_t  pos;
+  int     i;
+
+  aipc_pad(b, 8);
+  aipc_le(b, 0, 4);
+  pos = b->len;
+  aipc_le(b, n, 4);
+  for (i = 0; i < 2 * n; i++)
+  {
+    aipc_le(b, (uint64_t)v[i], 8);
+  }
+  return pos;
+}
+
+//
+//Function: aipc_patch() points the offset at 'slot' to 'target'
+void aipc_patch(struct AIPC_BUF * b, size_t slot, size_t target)
+{
+  if (b->err == 0)
+  {
+    aipc_store(b->p + slot, target - slot, 4);
+  }
+}
+
+//
+//Function: aipc_store() stores an 'n' byte little endian number
+void aipc_store(unsigned char * p, uint64_t v, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    p[i] = (unsigned char)(v & 0xFF);
+    v >>= 8;
+  }
+}
+
+//
+//Function: aipc_need() makes room for 'n' more bytes in a buffer
+int aipc_need(struct AIPC_BUF * b, size_t n)
+{
+  unsigned char  *p;
+  size_t         size;
+
+  if (b->err)
+  {
+    return -1;
+  }
+  if (b->len + n <= b->size)
+  {
+    return 0;
+  }
+  for (size = (b->size > 0) ? b->size : 256; size < b->len + n; size *= 2);
+  if ((p = realloc(b->p, size)) == NULL)
+  {
+    b->err = 1;
+    return -1;
+  }
+  b->p = p;
+  b->size = size;
+  return 0;
+}
+
+//
+//Function: aipc_put() appends bytes to a buffer
+void aipc_put(struct AIPC_BUF * b, const void * data, size_t n)
+{
+  // Empty values come with a NULL 'data', which memcpy() may not be given
+  if (n == 0)
+  {
+    return;
+  }
+  if (aipc_need(b, n) == 0)
+  {
+    memcpy(b->p + b->len, data, n);
+    b->len += n;
+  }
+}
+
+//
+//Function: aipc_le() appends an 'n' byte little endian number to a buffer
+void aipc_le(struct AIPC_BUF * b, uint64_t v, int n)
+{
+  if (aipc_need(b, n) == 0)
+  {
+    aipc_store(b->p + b->len, v, n);
+    b->len += n;
+  }
+}
+
+//
+//Function: aipc_pad() pads a buffer with zeros to a multiple of 'align'
+void aipc_pad(struct AIPC_BUF * b, size_t align)
+{
+  while ((b->err == 0) && (b->len % align != 0))
+  {
+    aipc_le(b, 0, 1);
+  }
+}
+
+//
+//Function: aipc_free() frees a writer and its buffers
+void aipc_free(struct AIPC_WRITER * w)
+{
+  int i;
+
+  if (w == NULL)
+  {
+    return;
+  }
+  if (w->Cols != NULL)
+  {
+    for (i = 0; i < w->NumCols; i++)
+    {
+      free(w->Cols[i].Valid.p);
+      free(w->Cols[i].Data.p);
+      free(w->Cols[i].Offs.p);
+      free(w->Cols[i].DictData.p);
+      free(w->Cols[i].DictOffs.p);
+      free(w->Cols[i].Hash);
+    }
+  }
+  free(w->Cols);
+  free(w->Parts);
+  free(w->Nodes);
+  free(w->Bufs);
+  free(w->fb.p);
+  free(w->tmp.p);
+  free(w);
+}
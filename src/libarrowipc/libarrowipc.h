@@ -0,0 +1,101 @@
+/***************************************************************
+**                                                            **
+**                    libarrowipc.h                           **
+**                                                            **
+**    A small writer for the Apache Arrow IPC streaming       **
+** format (https://arrow.apache.org/docs/format/Columnar.html)**
+** that needs no Arrow or Flatbuffers library. Rows are       **
+** collected column by column and written as record batches.  **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int aipc_open(FILE * fp,                                   **
+**               const struct AIPC_FIELD * fields,            **
+**               int num,                                     **
+**               int rows,                                    **
+**               struct AIPC_WRITER ** w)                     **
+**      Writes the schema of the 'num' fields to fp and       **
+**      returns a writer in w that writes a record batch      **
+**      every 'rows' rows (0 for AIPC_ROWS).                  **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** void aipc_int(struct AIPC_WRITER * w, int col, int64_t v)  **
+** void aipc_str(struct AIPC_WRITER * w, int col,             **
+**               const char * s)                              **
+** void aipc_wstr(struct AIPC_WRITER * w, int col,            **
+**               const wchar_t * s)                           **
+** void aipc_null(struct AIPC_WRITER * w, int col)            **
+**      Set the value of column 'col' in the current row.     **
+**      Strings that are not valid UTF-8 are taken to be      **
+**      Latin-1, wide strings are UTF-16 or UTF-32.           **
+**                                                            **
+** int aipc_row(struct AIPC_WRITER * w)                       **
+**      Ends the current row (columns not set are null).      **
+**      Returns 0 if successful, -1 on a write error.         **
+**                                                            **
+** size_t aipc_peak(struct AIPC_WRITER * w)                   **
+**      Returns the bytes the writer's buffers have grown to  **
+**      (the most they have needed for a batch, and the       **
+**      dictionaries).                                        **
+**                                                            **
+** int aipc_close(struct AIPC_WRITER * w)                     **
+**      Writes the last batch and the end of stream marker    **
+**      and frees the writer.                                 **
+**      Returns 0 if successful, -1 on a write error.         **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBARROWIPC_H_
+#define _LIBARROWIPC_H_
+
+#include <stdio.h>
+#include <wchar.h>
+#include <inttypes.h>
+
+#define AIPC_ROWS   65536   // Default rows in a record batch
+
+enum AIPC_TYPE
+{
+  AIPC_INT16, AIPC_INT32, AIPC_INT64,
+  AIPC_UINT16, AIPC_UINT32, AIPC_UINT64,
+  AIPC_UTF8,
+  AIPC_DICT     // UTF-8 strings, dictionary encoded (for columns with few distinct values)
+};
+
+struct AIPC_FIELD
+{
+  const char *       Name;
+  enum AIPC_TYPE     Type;
+};
+
+struct AIPC_WRITER; // Private to libarrowipc.c
+
+extern int aipc_open(FILE *, const struct AIPC_FIELD *, int, int, struct AIPC_WRITER **);
+extern void aipc_int(struct AIPC_WRITER *, int, int64_t);
+extern void aipc_str(struct AIPC_WRITER *, int, const char *);
+extern void aipc_wstr(struct AIPC_WRITER *, int, const wchar_t *);
+extern void aipc_null(struct AIPC_WRITER *, int);
+extern int aipc_row(struct AIPC_WRITER *);
+extern size_t aipc_peak(struct AIPC_WRITER *);
+extern int aipc_close(struct AIPC_WRITER *);
+
+#endif
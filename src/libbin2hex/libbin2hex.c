@@ -15,10 +15,30 @@
 **             unsigned int    gap,                           **
 **             unsigned int    cols,                          **
 **             unsigned int    margin,                        **
-**             unsigned int    ansi                           **
+**             unsigned int    ansi,                          **
+**             unsigned int    header                         **
 **            )                                               **
-**      Returns 0 if the byte array is converted successfully **
-**      -1 if not.                                            **
+**      Prints the dump on stdout. Returns 0 if the byte      **
+**      array is converted successfully -1 if not.            **
+**                                                            **
+** size_t bin2hex_buf(                                        **
+**             char *          out,                           **
+**             size_t          outsize,                       **
+**             const unsigned char * byte_array,              **
+**             unsigned int    size,                          **
+**             unsigned int    gap,                           **
+**             unsigned int    cols,                          **
+**             unsigned int    margin,                        **
+**             unsigned int    ansi,                          **
+**             unsigned int    header                         **
+**            )                                               **
+**      Writes the same dump as bin2hex() into out as a zero  **
+**      terminated string, without allocating any memory.     **
+**      Returns the length of the dump (not counting the      **
+**      terminating 0x00) or 0 if the parameters are bad.     **
+**      Nothing is written unless the length is less than     **
+**      outsize, so call it with out == NULL to find the      **
+**      size of buffer needed.                                **
 **                                                            **
 ** byte_array   an array of binary bytes with values          **
 **              0 <= value >= 255                             **
@@ -26,9 +46,10 @@
 ** size         size of the byte array. Max = 4294967295      **
 **                                                            **
 ** gap          == 0 = no gap between hexadecimal bytes       **
-**              > 0 = a gap of 1 space between output bytes   **
+**              == 1 = a gap of 1 space between output bytes  **
 **                                                            **
-** cols         number of columns in hex output. Max = 1024   **
+** cols         number of columns in hex output.              **
+**              1 <= cols <= 1024                             **
 **                                                            **
 ** margin       number of padding spaces to add before each   **
 **              output line. Max = 1024                       **
@@ -38,7 +59,9 @@
 **                    any hex output                          **
 **                                                            **
 ** header      == 0 = no header                               **
-**             >0 = print a header so long as cols % 8        **
+**             >0 = print an offset before each line, and a   **
+**                  header so long as cols % 8 == 0,          **
+**                  cols < 33 and gap > 0                     **
 **                                                            **
 ***************************************************************/
 
@@ -61,157 +84,206 @@ along with bin2hex.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "./libbin2hex.h"
 
+#define B2H_LINEMAX  (1024 + 9 + (1024 * 4) + 2) // Longest line: margin, offset, hex & ansi
+#define B2H_BUFSIZE  (4 * B2H_LINEMAX)           // bin2hex() output buffer (on the stack)
 
-extern int bin2hex(unsigned char * byte_array, unsigned int size, unsigned int gap, unsigned int cols, unsigned int margin, unsigned int ansi, unsigned int hdr)
+// The layout of a dump, from the bin2hex() parameters
+struct B2H_FMT
 {
-  unsigned int i, j, stringlen = 0, line = 0, numlines = 0, charsinlastline = 0, spaces = 0;
-  char *string, *pad, hex[4], offset[10], printchar[2], ansistr[34];
-
-  // Ensure that parameters are within boundaries
-#if defined NDEBUG // If NDEBUG is defined then use assert.h to check parameters
-  assert(gap < 2);
-  assert(cols < 1025);
-  assert(margin < 1025);
-  assert(size < 4294967296);
-#endif // NDEBUG
-#if !defined NDEBUG // If assert.h is not being used then print an error message & quit anyway
-  if ((cols > 1024) | (margin > 1024))
+  unsigned int gap;       // 0 or 1 space after each hex byte
+  unsigned int cols;
+  unsigned int margin;
+  unsigned int ansi;      // > 0 = ansi characters after the hex
+  unsigned int offset;    // > 0 = offset before each line
+  unsigned int header;    // > 0 = header & underline before the first line
+};
+
+static const char b2h_nibble[16] =
+{
+  '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+//Local function declarations
+int b2h_fmt(struct B2H_FMT *, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int);
+size_t b2h_len(struct B2H_FMT *, unsigned int);
+size_t b2h_hdr(char *, struct B2H_FMT *);
+size_t b2h_row(char *, const unsigned char *, unsigned int, unsigned int, struct B2H_FMT *);
+
+//
+//Function: b2h_fmt() checks the parameters and fills in the layout
+int b2h_fmt(struct B2H_FMT * f, unsigned int gap, unsigned int cols, unsigned int margin, unsigned int ansi, unsigned int hdr)
+{
+  if ((cols == 0) | (cols > 1024) | (margin > 1024))
   {
-    fprintf(stderr, "\nERROR: bin2hex() function called with columns or margin > 1024\n");
+    fprintf(stderr, "\nERROR: bin2hex() function called with columns of 0 or columns or margin > 1024\n");
     return -1;
   }
   if (gap > 1)
   {
     fprintf(stderr, "\nERROR: bin2hex() function called with gap > 1\n");
-  }
-  if (size > 4294967295)
-  {
-    fprintf(stderr, "\nERROR: bin2hex() function called with size > 4,294,967,295\n");
     return -1;
   }
-#endif
+  f->gap = gap;
+  f->cols = cols;
+  f->margin = margin;
+  f->ansi = ansi;
+  f->offset = hdr;
+  f->header = (cols < 33) & (cols % 8 == 0) & (gap > 0) & (hdr > 0);
+  return 0;
+}
 
-  stringlen = (gap * cols) + (cols * 2) + margin + (ansi * cols) + 0x20; // determine max length of a line
-                                                                         // with (quite) a bit left over for a terminating 0x00 and other stuff
-  numlines = size / cols;
-  charsinlastline = size % cols;
+//
+//Function: b2h_len() returns the length of the whole dump of 'size' bytes
+size_t b2h_len(struct B2H_FMT * f, unsigned int size)
+{
+  size_t row, hdr = 0;
 
-  string = malloc(stringlen);
-  if (string == NULL)
+  // Every line (the last is padded) is the same length bar its ansi characters
+  row = f->margin + ((f->offset > 0) ? 9 : 0) + (size_t)f->cols * (2 + f->gap) + 1;
+  if (f->header)
   {
-    fprintf(stderr, "\nERROR: bin2hex() function unable to allocate memory\n");
-    return -1;
+    hdr = f->margin + 9 + (f->cols * 3) + 6; // "OFFSET   00 01 ... ANSI\n"
+    hdr += f->margin + hdr + 1;              // and the underline
   }
+  // There is always a last line, even if it is empty
+  return hdr + (((size_t)size / f->cols) + 1) * (row + ((f->ansi > 0) ? 1 : 0)) + ((f->ansi > 0) ? size : 0);
+}
 
-  if ((cols < 33) & (cols % 8 == 0) & (gap > 0) & (hdr > 0))
+//
+//Function: b2h_hdr() writes the header and its underline to out and returns
+//          the number of characters written
+size_t b2h_hdr(char * out, struct B2H_FMT * f)
+{
+  char *p = out;
+  size_t len;
+  unsigned int j;
+
+  memset(p, ' ', f->margin);
+  p += f->margin;
+  memcpy(p, "OFFSET   ", 9);
+  p += 9;
+  for (j = 0; j < f->cols; j++)
   {
-    // Build the header string
-    snprintf(string, 10 + margin, "%*sOFFSET%*s", margin, "", 3, "");
-    for (j = 0; j < cols; j++)
-    {
-      snprintf(hex, 4, "%.2"PRIX8" ", j);
-      strcat(string, hex);
-    }
-    strcat(string, " ANSI\n");
-    // Print the header
-    printf("%s", string);
-    // Now underline the header
-    printf("%*s", margin, "");
-    for (j = 0; j < (int)strlen(string); j++)
-    {
-      printf("-");
-    }
-    printf("\n");
+    *p++ = b2h_nibble[j >> 4];
+    *p++ = b2h_nibble[j & 0x0F];
+    *p++ = ' ';
   }
+  memcpy(p, " ANSI\n", 6);
+  p += 6;
+  // Underline it all, margin and newline included (as it always has been)
+  len = p - out;
+  memset(p, ' ', f->margin);
+  p += f->margin;
+  memset(p, '-', len);
+  p += len;
+  *p++ = '\n';
+  return p - out;
+}
 
-  while (line < numlines) // line is the number of the whole line we are working on (0 based)
+//
+//Function: b2h_row() writes one line of 'n' bytes (n < cols for the last
+//          line, which is padded to line up the ansi characters) starting
+//          at 'offset' to out and returns the number of characters written
+size_t b2h_row(char * out, const unsigned char * bytes, unsigned int n, unsigned int offset, struct B2H_FMT * f)
+{
+  char *p = out;
+  unsigned int i;
+  int shift;
+
+  memset(p, ' ', f->margin);
+  p += f->margin;
+  if (f->offset > 0)
   {
-    snprintf(string, margin + 1, "%*s", margin, "");
-    if (hdr > 0)
+    for (shift = 28; shift >= 0; shift -= 4)
     {
-      snprintf(offset, 10, "%.8"PRIX32" ", line * cols);
-      strcat(string, offset);
+      *p++ = b2h_nibble[(offset >> shift) & 0x0F];
     }
-    if (ansi == 1)
+    *p++ = ' ';
+  }
+  for (i = 0; i < n; i++)
+  {
+    *p++ = b2h_nibble[bytes[i] >> 4];
+    *p++ = b2h_nibble[bytes[i] & 0x0F];
+    if (f->gap > 0)
     {
-      ansistr[0] = 0x20; //Reset ansistr to a single space string
-      ansistr[1] = 0x00;
+      *p++ = ' ';
     }
-    for(i = 0; i < cols; i++)
+  }
+  memset(p, ' ', (f->cols - n) * (2 + f->gap));
+  p += (f->cols - n) * (2 + f->gap);
+  if (f->ansi > 0)
+  {
+    *p++ = ' ';
+    for (i = 0; i < n; i++)
     {
-      snprintf(hex, 3, "%.2"PRIX8, byte_array[(line * cols) + i]);
-      if(gap == 1)
-      {
-        strcat(hex, " ");
-      }
-      strcat(string, hex);
-      if(ansi == 1)
-      {
-        if((byte_array[(line * cols) + i] > 0x1F) & (byte_array[(line * cols) + i] < 0x80))
-        {
-          snprintf(printchar, 2, "%c", byte_array[(line * cols) + i]);
-        }
-        else
-        {
-          snprintf(printchar, 2, ".");
-        }
-        strcat(ansistr, printchar);
-      }
+      *p++ = ((bytes[i] > 0x1F) & (bytes[i] < 0x80)) ? (char)bytes[i] : '.';
     }
-    strcat(string, ansistr);
-    strcat(string, "\n");
-    printf("%s", string);
-    line++;
   }
-  // Print the last line
-  snprintf(string, margin + 1, "%*s", margin, "");
-  if (hdr == 1)
+  *p++ = '\n';
+  return p - out;
+}
+
+//
+//Function: bin2hex_buf() writes the dump into a caller's buffer
+extern size_t bin2hex_buf(char * out, size_t outsize, const unsigned char * byte_array, unsigned int size, unsigned int gap, unsigned int cols, unsigned int margin, unsigned int ansi, unsigned int hdr)
+{
+  struct B2H_FMT f;
+  size_t len;
+  unsigned int line, numlines;
+  char *p;
+
+  if (b2h_fmt(&f, gap, cols, margin, ansi, hdr) < 0)
   {
-    snprintf(offset, 10, "%.8"PRIX32" ", line * cols); // line has been incrmented to the last line
-    strcat(string, offset);
+    return 0;
   }
-  if (ansi == 1)
+  len = b2h_len(&f, size);
+  if ((out == NULL) | (len >= outsize))
   {
-    ansistr[0] = 0x20; //Reset ansistr to a single space string
-    ansistr[1] = 0x00;
+    return len;
   }
-  for ( i = 0; i < charsinlastline; i++)
+  p = out;
+  if (f.header)
   {
-    snprintf(hex, 3, "%.2"PRIX8, byte_array[(line * cols) + i]);
-    if (gap == 1)
-    {
-      strcat(hex, " ");
-    }
-    strcat(string, hex);
-    if (ansi == 1)
-    {
-      if ((byte_array[(line * cols) + i] > 0x1F) & (byte_array[(line * cols) + i] < 0x80))
-      {
-        snprintf(printchar, 2, "%c", byte_array[(line * cols) + i]);
-      }
-      else
-      {
-        snprintf(printchar, 2, ".");
-      }
-      strcat(ansistr, printchar);
-    }
+    p += b2h_hdr(p, &f);
   }
-  spaces = ((cols - charsinlastline) * (2 + gap));
-  pad = malloc(spaces + 2);
-  if (pad == NULL)
+  numlines = size / cols;
+  for (line = 0; line < numlines; line++)
+  {
+    p += b2h_row(p, byte_array + (line * cols), cols, line * cols, &f);
+  }
+  p += b2h_row(p, byte_array + (line * cols), size % cols, line * cols, &f);
+  *p = '\0';
+  return len;
+}
+
+//
+//Function: bin2hex() prints the dump to stdout. The lines are built in a
+//          buffer on the stack which is written whenever it fills up.
+extern int bin2hex(unsigned char * byte_array, unsigned int size, unsigned int gap, unsigned int cols, unsigned int margin, unsigned int ansi, unsigned int hdr)
+{
+  struct B2H_FMT f;
+  char buf[B2H_BUFSIZE];
+  size_t used = 0;
+  unsigned int line, numlines;
+
+  if (b2h_fmt(&f, gap, cols, margin, ansi, hdr) < 0)
   {
-    fprintf(stderr, "\nERROR: bin2hex() function unable to allocate memory\n");
     return -1;
   }
-  else
+  if (f.header)
+  {
+    used = b2h_hdr(buf, &f); // Much less than B2H_LINEMAX as cols < 33
+  }
+  numlines = size / cols;
+  for (line = 0; line <= numlines; line++)
   {
-    snprintf(pad, spaces + 1, "%*s", spaces, "");
+    if (used + B2H_LINEMAX > sizeof(buf))
+    {
+      fwrite(buf, 1, used, stdout);
+      used = 0;
+    }
+    used += b2h_row(buf + used, byte_array + (line * cols), (line < numlines) ? cols : size % cols, line * cols, &f);
   }
-  strcat(string, pad);
-  strcat(string, ansistr);
-  printf("%s", string);
-  printf("\n");
-  free(pad);
-  free(string);
+  fwrite(buf, 1, used, stdout);
   return 0;
 }
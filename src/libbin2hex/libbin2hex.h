@@ -15,30 +15,53 @@
 **             unsigned int    gap,                           **
 **             unsigned int    cols,                          **
 **             unsigned int    margin,                        **
-**             unsigned int    ansi                           **
+**             unsigned int    ansi,                          **
+**             unsigned int    header                         **
 **            )                                               **
-**      Returns 0 if the byte array is converted successfully **
-**      -1 if not.                                            **
+**      Prints the dump on stdout. Returns 0 if the byte      **
+**      array is converted successfully -1 if not.            **
+**                                                            **
+** size_t bin2hex_buf(                                        **
+**             char *          out,                           **
+**             size_t          outsize,                       **
+**             const unsigned char * byte_array,              **
+**             unsigned int    size,                          **
+**             unsigned int    gap,                           **
+**             unsigned int    cols,                          **
+**             unsigned int    margin,                        **
+**             unsigned int    ansi,                          **
+**             unsigned int    header                         **
+**            )                                               **
+**      Writes the same dump as bin2hex() into out as a zero  **
+**      terminated string, without allocating any memory.     **
+**      Returns the length of the dump (not counting the      **
+**      terminating 0x00) or 0 if the parameters are bad.     **
+**      Nothing is written unless the length is less than     **
+**      outsize, so call it with out == NULL to find the      **
+**      size of buffer needed.                                **
 **                                                            **
 ** byte_array   an array of binary bytes with values          **
 **              0 <= value >= 255                             **
 **                                                            **
-** size         size of the byte array                        **
+** size         size of the byte array. Max = 4294967295      **
 **                                                            **
 ** gap          == 0 = no gap between hexadecimal bytes       **
-**              > 0 = a gap of 1 space between output bytes   **
+**              == 1 = a gap of 1 space between output bytes  **
 **                                                            **
-** cols         number of columns in hex output.  Max = 1024  **
+** cols         number of columns in hex output.              **
+**              1 <= cols <= 1024                             **
 **                                                            **
 ** margin       number of padding spaces to add before each   **
-**              output line.  Max = 1024                      **
+**              output line. Max = 1024                       **
 **                                                            **
 ** ansi         == 0 = no ansi output                         **
 **              > 0 = output printable ansi characters after  **
 **                    any hex output                          **
 **                                                            **
 ** header      == 0 = no header                               **
-**             >0 = print a header so long as cols % 8        **
+**             >0 = print an offset before each line, and a   **
+**                  header so long as cols % 8 == 0,          **
+**                  cols < 33 and gap > 0                     **
 **                                                            **
 ***************************************************************/
 
@@ -70,5 +93,6 @@ along with libbin2hex.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
 
 extern int bin2hex(unsigned char *, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int);
+extern size_t bin2hex_buf(char *, size_t, const unsigned char *, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int);
 
 #endif
@@ -0,0 +1,577 @@
+/***************************************************************
+**                                                            **
+**                    libisolate.c                            **
+**                                                            **
+**    Renders link files in crash-isolated worker processes.  **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libisolate.h for the exported functions                **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "./libisolate.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#define ISO_POSIX
+#endif
+#ifdef __GLIBC__
+#include <stdio_ext.h> // __fsetlocking()
+#endif
+
+#ifdef ISO_POSIX
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define ISO_MAXWORKERS  256
+
+// Slot states
+#define ISO_FREE        0       // lifer can put a file in it
+#define ISO_POSTED      1       // The file is waiting for the worker
+#define ISO_RUNNING     2       // The worker is rendering it
+#define ISO_DONE        3       // Rendered (or failed), waiting for its turn to be written
+
+// Why a slot failed
+#define ISO_OK          0
+#define ISO_CRASHED     1       // The worker died
+#define ISO_TIMEDOUT    2       // The worker was killed after ISO_TIMEOUT seconds
+#define ISO_OVERFLOW    3       // The output didn't fit in the slot
+
+struct ISO_SLOT
+{
+  int                 State;    // Shared by lifer & the worker (atomic loads & stores)
+  int                 Failed;   // ISO_OK, or why the file has no output
+  int                 Status;   // The dead worker's wait status
+  uint64_t            Seq;      // The file's place in the output
+  int64_t             Started;  // When the worker started on it (monotonic ns)
+  size_t              Len;      // Bytes of output
+  char                Path[ISO_PATHMAX];
+  char                Out[ISO_OUTSIZE];
+};
+
+struct ISO_RING                 // In memory shared by lifer & one worker
+{
+  uint32_t            Take;     // The worker's next slot (a count, not an index)
+  uint32_t            Posted;   // lifer's next slot (the same)
+  int                 Asleep;   // The worker is waiting on its doorbell
+  int                 Waiting;  // lifer is waiting on the doorbells
+  struct ISO_SLOT     Slot[ISO_SLOTS];
+};
+
+struct ISO_WORKER
+{
+  pid_t               pid;
+  int                 fd;       // lifer's end of the doorbell (-1 if the worker isn't running)
+  int                 Killed;   // Killed for taking too long
+  uint32_t            Post;     // lifer's next slot (a count, not an index)
+  struct ISO_RING   * Ring;
+};
+
+static struct ISO_WORKER      iso_workers[ISO_MAXWORKERS];
+static int                    iso_nworkers = 0;
+static int                    iso_running = 0;
+static struct ISO_SLOT     ** iso_order = NULL;  // The slot of each file not yet written, by Seq
+static size_t                 iso_window = 0;    // Files that can be out at once
+static uint64_t               iso_seq = 0;       // The next file's Seq
+static uint64_t               iso_written = 0;   // The next Seq to write
+static struct ISO_CALLBACKS   iso_cb;
+static void                 * iso_ctx;
+
+//Local function declarations
+int64_t iso_now(void);
+int iso_spawn(int);
+void iso_worker(struct ISO_RING *, int);
+void iso_ring(int);
+void iso_died(struct ISO_WORKER *);
+int iso_wait(void);
+void iso_flush(void);
+
+//
+//Function: iso_now() returns the monotonic clock in ns
+int64_t iso_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+//
+//Function: iso_spawn() starts (or restarts) worker i on its ring. Returns 0
+//          or -1.
+int iso_spawn(int i)
+{
+  struct ISO_WORKER * w = &iso_workers[i];
+  int sv[2], j;
+
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0)
+  {
+    perror("Error making a worker's doorbell");
+    return -1;
+  }
+  fflush(NULL); // (so the worker doesn't write what is buffered again)
+  if ((w->pid = fork()) < 0)
+  {
+    perror("Error starting a worker");
+    close(sv[0]);
+    close(sv[1]);
+    return -1;
+  }
+  if (w->pid == 0)
+  {
+    // The worker keeps only its end of its own doorbell
+    close(sv[0]);
+    for (j = 0; j < iso_nworkers; j++)
+    {
+      if ((j != i) && (iso_workers[j].fd >= 0))
+      {
+        close(iso_workers[j].fd);
+      }
+    }
+    iso_worker(w->Ring, sv[1]);
+    _exit(EXIT_SUCCESS);
+  }
+  close(sv[1]);
+  w->fd = sv[0];
+  w->Killed = 0;
+  return 0;
+}
+
+//
+//Function: iso_worker() is a worker's loop. It renders the files posted in
+//          its ring in turn and waits on the doorbell when there is none.
+//          The doorbell is only rung (either way) for a side that has said
+//          it is waiting, so a busy run costs no system calls per file. The
+//          worker ends when lifer closes the doorbell.
+void iso_worker(struct ISO_RING * ring, int fd)
+{
+  struct ISO_SLOT * s;
+  char buf[64];
+  FILE * out;
+  long len;
+  ssize_t n;
+
+  for (;;)
+  {
+    s = &ring->Slot[ring->Take % ISO_SLOTS];
+    while (__atomic_load_n(&s->State, __ATOMIC_ACQUIRE) != ISO_POSTED)
+    {
+      // (lifer posts then looks at Asleep, so one of the two sees the other)
+      __atomic_store_n(&ring->Asleep, 1, __ATOMIC_SEQ_CST);
+      if (__atomic_load_n(&s->State, __ATOMIC_SEQ_CST) == ISO_POSTED)
+      {
+        __atomic_store_n(&ring->Asleep, 0, __ATOMIC_RELAXED);
+        break;
+      }
+      n = read(fd, buf, sizeof(buf));
+      __atomic_store_n(&ring->Asleep, 0, __ATOMIC_RELAXED);
+      if ((n == 0) || ((n < 0) && (errno != EINTR)))
+      {
+        return; // lifer has finished (or gone)
+      }
+    }
+    s->Started = iso_now();
+    __atomic_store_n(&s->State, ISO_RUNNING, __ATOMIC_RELEASE);
+    s->Len = 0;
+    if ((out = fmemopen(s->Out, ISO_OUTSIZE, "w")) == NULL)
+    {
+      s->Failed = ISO_OVERFLOW;
+    }
+    else
+    {
+#ifdef __GLIBC__
+      // (glibc locks an fmemopen() stream on every putc(), the worker has one thread)
+      __fsetlocking(out, FSETLOCKING_BYCALLER);
+#endif
+      iso_cb.render(iso_ctx, s->Path, out);
+      fflush(out);
+      len = ftell(out);
+      // (a full buffer may have lost output, and fmemopen() wants room for a 0)
+      if (ferror(out) || (len < 0) || (len >= ISO_OUTSIZE - 1))
+      {
+        s->Failed = ISO_OVERFLOW;
+      }
+      else
+      {
+        s->Len = (size_t)len;
+      }
+      fclose(out);
+    }
+    // Take is moved on first: a worker that dies from here on has finished
+    // with the slot, one that dies before has the slot RUNNING
+    __atomic_store_n(&ring->Take, ring->Take + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&s->State, ISO_DONE, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->Waiting, __ATOMIC_SEQ_CST) &&
+      (__atomic_load_n(&ring->Posted, __ATOMIC_ACQUIRE) - ring->Take <= ISO_SLOTS / 2))
+    {
+      send(fd, "", 1, MSG_DONTWAIT | MSG_NOSIGNAL); // (a full doorbell is already ringing)
+    }
+  }
+}
+
+//
+//Function: iso_ring() rings worker i's doorbell, if it is asleep
+void iso_ring(int i)
+{
+  ssize_t n;
+
+  if ((iso_workers[i].fd < 0) || !__atomic_load_n(&iso_workers[i].Ring->Asleep, __ATOMIC_SEQ_CST))
+  {
+    return; // (it is restarted by iso_wait(), and looks at its ring then)
+  }
+  do
+  {
+    n = send(iso_workers[i].fd, "", 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+  } while ((n < 0) && (errno == EINTR));
+  // EAGAIN is left: the worker has rings it hasn't read, so it isn't waiting
+}
+
+//
+//Function: iso_died() deals with a worker that has gone. The file it was
+//          rendering (if any) is marked failed so it is reported in its
+//          turn, then the worker is restarted on the same ring.
+void iso_died(struct ISO_WORKER * w)
+{
+  struct ISO_SLOT * s;
+  int status = 0, i;
+
+  close(w->fd);
+  w->fd = -1;
+  while ((waitpid(w->pid, &status, 0) < 0) && (errno == EINTR))
+    ;
+  for (i = 0; i < ISO_SLOTS; i++)
+  {
+    s = &w->Ring->Slot[i];
+    if (__atomic_load_n(&s->State, __ATOMIC_ACQUIRE) == ISO_RUNNING)
+    {
+      s->Failed = w->Killed ? ISO_TIMEDOUT : ISO_CRASHED;
+      s->Status = status;
+      w->Ring->Take++;
+      __atomic_store_n(&s->State, ISO_DONE, __ATOMIC_RELEASE);
+    }
+  }
+}
+
+//
+//Function: iso_wait() waits (up to a second) for a worker to finish a file,
+//          restarting those that die and killing those that take too long,
+//          then writes what it can. Returns 0, or -1 if a worker can't be
+//          restarted.
+int iso_wait(void)
+{
+  struct pollfd fds[ISO_MAXWORKERS];
+  struct ISO_SLOT * s;
+  char buf[256];
+  int64_t now;
+  ssize_t n;
+  int i, timeout = 1000;
+
+  for (i = 0; i < iso_nworkers; i++)
+  {
+    fds[i].fd = iso_workers[i].fd;
+    fds[i].events = POLLIN;
+    fds[i].revents = 0;
+    __atomic_store_n(&iso_workers[i].Ring->Waiting, 1, __ATOMIC_SEQ_CST);
+    if (iso_workers[i].Post != __atomic_load_n(&iso_workers[i].Ring->Take, __ATOMIC_ACQUIRE))
+    {
+      iso_ring(i);
+    }
+  }
+  // (the workers finish then look at Waiting, so one of the two sees the other)
+  s = iso_order[iso_written % iso_window];
+  if ((s != NULL) && (__atomic_load_n(&s->State, __ATOMIC_SEQ_CST) == ISO_DONE))
+  {
+    timeout = 0;
+  }
+  n = poll(fds, (nfds_t)iso_nworkers, timeout);
+  for (i = 0; i < iso_nworkers; i++)
+  {
+    __atomic_store_n(&iso_workers[i].Ring->Waiting, 0, __ATOMIC_RELAXED);
+  }
+  if ((n < 0) && (errno != EINTR))
+  {
+    perror("Error waiting for the workers");
+    return -1;
+  }
+  for (i = 0; i < iso_nworkers; i++)
+  {
+    if (fds[i].revents == 0)
+    {
+      continue;
+    }
+    do
+    {
+      n = recv(iso_workers[i].fd, buf, sizeof(buf), MSG_DONTWAIT);
+    } while (n > 0);
+    if ((n == 0) || ((n < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+    {
+      iso_died(&iso_workers[i]);
+      if (iso_spawn(i) < 0)
+      {
+        return -1;
+      }
+    }
+  }
+  // A file that is taking too long is taken to have hung liblife
+  now = iso_now();
+  for (i = 0; i < iso_nworkers; i++)
+  {
+    s = &iso_workers[i].Ring->Slot[iso_workers[i].Ring->Take % ISO_SLOTS];
+    if ((!iso_workers[i].Killed) &&
+      (__atomic_load_n(&s->State, __ATOMIC_ACQUIRE) == ISO_RUNNING) &&
+      (now - s->Started > (int64_t)ISO_TIMEOUT * 1000000000))
+    {
+      iso_workers[i].Killed = 1;
+      kill(iso_workers[i].pid, SIGKILL); // (its doorbell closes, which is seen above next time)
+    }
+  }
+  iso_flush();
+  return 0;
+}
+
+//
+//Function: iso_flush() passes on the output of the files that are done, in
+//          order, freeing their slots
+void iso_flush(void)
+{
+  struct ISO_SLOT * s;
+  char why[64];
+
+  while (iso_written < iso_seq)
+  {
+    s = iso_order[iso_written % iso_window];
+    if (__atomic_load_n(&s->State, __ATOMIC_ACQUIRE) != ISO_DONE)
+    {
+      break;
+    }
+    switch (s->Failed)
+    {
+    case ISO_OK:
+      iso_cb.write(iso_ctx, s->Path, s->Out, s->Len);
+      break;
+    case ISO_CRASHED:
+      if (WIFSIGNALED(s->Status))
+      {
+        snprintf(why, sizeof(why), "the worker died of signal %d", WTERMSIG(s->Status));
+      }
+      else
+      {
+        snprintf(why, sizeof(why), "the worker exited with status %d", WEXITSTATUS(s->Status));
+      }
+      iso_cb.quarantine(iso_ctx, s->Path, why);
+      break;
+    case ISO_TIMEDOUT:
+      snprintf(why, sizeof(why), "the worker took more than %d seconds", ISO_TIMEOUT);
+      iso_cb.quarantine(iso_ctx, s->Path, why);
+      break;
+    default:
+      snprintf(why, sizeof(why), "its output is more than %d MB", ISO_OUTSIZE / (1024 * 1024));
+      iso_cb.quarantine(iso_ctx, s->Path, why);
+    }
+    iso_order[iso_written % iso_window] = NULL;
+    __atomic_store_n(&s->State, ISO_FREE, __ATOMIC_RELEASE);
+    iso_written++;
+  }
+}
+#endif
+
+//
+//Function: iso_start() sets up the workers
+extern int iso_start(int workers, const struct ISO_CALLBACKS * cb, void * ctx)
+{
+#ifdef ISO_POSIX
+  void * p;
+  int i;
+
+  if (workers <= 0)
+  {
+    workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  iso_nworkers = (workers < 1) ? 1 : (workers > ISO_MAXWORKERS) ? ISO_MAXWORKERS : workers;
+  iso_cb = *cb;
+  iso_ctx = ctx;
+  iso_window = (size_t)iso_nworkers * ISO_SLOTS;
+  if ((iso_order = calloc(iso_window, sizeof(struct ISO_SLOT *))) == NULL)
+  {
+    fprintf(stderr, "Error allocating memory for the workers\n");
+    return -1;
+  }
+  for (i = 0; i < iso_nworkers; i++)
+  {
+    // (only the pages a worker writes are ever touched)
+    p = mmap(NULL, sizeof(struct ISO_RING), PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED)
+    {
+      perror("Error mapping the workers\' memory");
+      while (--i >= 0)
+      {
+        munmap(iso_workers[i].Ring, sizeof(struct ISO_RING));
+      }
+      free(iso_order);
+      iso_order = NULL;
+      return -1;
+    }
+    iso_workers[i].Ring = (struct ISO_RING *)p;
+    iso_workers[i].fd = -1;
+    iso_workers[i].Post = 0;
+  }
+  iso_seq = 0;
+  iso_written = 0;
+  iso_running = 0;
+  return 0;
+#else
+  (void)workers;
+  (void)cb;
+  (void)ctx;
+  fprintf(stderr, "Sorry, \'--isolate\' is not available in Windows\n");
+  return -1;
+#endif
+}
+
+//
+//Function: iso_file() gives path to the worker with the fewest files waiting
+extern int iso_file(const char * path)
+{
+#ifdef ISO_POSIX
+  struct ISO_WORKER * w;
+  struct ISO_SLOT * s;
+  int i, best, load, least;
+
+  if (!iso_running)
+  {
+    for (i = 0; i < iso_nworkers; i++)
+    {
+      if (iso_spawn(i) < 0)
+      {
+        return -1;
+      }
+    }
+    iso_running = 1;
+  }
+  for (;;)
+  {
+    iso_flush();
+    best = -1;
+    least = ISO_SLOTS;
+    for (i = 0; i < iso_nworkers; i++)
+    {
+      w = &iso_workers[i];
+      load = (int)(w->Post - __atomic_load_n(&w->Ring->Take, __ATOMIC_ACQUIRE));
+      if ((load < least) &&
+        (__atomic_load_n(&w->Ring->Slot[w->Post % ISO_SLOTS].State, __ATOMIC_ACQUIRE) == ISO_FREE))
+      {
+        best = i;
+        least = load;
+      }
+    }
+    if (best >= 0)
+    {
+      break;
+    }
+    if (iso_wait() < 0)
+    {
+      return -1;
+    }
+  }
+  w = &iso_workers[best];
+  s = &w->Ring->Slot[w->Post % ISO_SLOTS];
+  s->Seq = iso_seq;
+  s->Failed = ISO_OK;
+  s->Status = 0;
+  s->Len = 0;
+  strncpy(s->Path, path, ISO_PATHMAX - 1);
+  s->Path[ISO_PATHMAX - 1] = '\0';
+  iso_order[iso_seq % iso_window] = s;
+  iso_seq++;
+  w->Post++;
+  __atomic_store_n(&w->Ring->Posted, w->Post, __ATOMIC_RELEASE);
+  __atomic_store_n(&s->State, ISO_POSTED, __ATOMIC_SEQ_CST);
+  // A sleeping worker is woken for half a ring at a time, not for each file
+  // (iso_wait() wakes it for fewer), and it only wakes lifer when its ring is
+  // half empty, so on a busy processor the two don't take turns a file at a
+  // time
+  if (w->Post - __atomic_load_n(&w->Ring->Take, __ATOMIC_ACQUIRE) >= ISO_SLOTS / 2)
+  {
+    iso_ring(best);
+  }
+  return 0;
+#else
+  (void)path;
+  return -1;
+#endif
+}
+
+//
+//Function: iso_finish() waits for the rest of the files & stops the workers
+extern int iso_finish(void)
+{
+#ifdef ISO_POSIX
+  int i, ret = 0;
+
+  if (iso_order == NULL)
+  {
+    return 0;
+  }
+  while (iso_running && (iso_written < iso_seq))
+  {
+    if (iso_wait() < 0)
+    {
+      ret = -1;
+      break;
+    }
+  }
+  for (i = 0; i < iso_nworkers; i++)
+  {
+    if (iso_workers[i].fd >= 0)
+    {
+      close(iso_workers[i].fd); // (the worker sees its doorbell close & ends)
+      iso_workers[i].fd = -1;
+      while ((waitpid(iso_workers[i].pid, NULL, 0) < 0) && (errno == EINTR))
+        ;
+    }
+    munmap(iso_workers[i].Ring, sizeof(struct ISO_RING));
+  }
+  free(iso_order);
+  iso_order = NULL;
+  iso_running = 0;
+  return ret;
+#else
+  return -1;
+#endif
+}
@@ -0,0 +1,82 @@
+/***************************************************************
+**                                                            **
+**                    libisolate.h                            **
+**                                                            **
+**    Renders link files in worker processes so that one that **
+** crashes liblife (or hangs it) can't end a long run         **
+** ('--isolate'). Each worker has a ring of slots in memory   **
+** shared with lifer: lifer puts the name of a link file in a **
+** free slot and the worker renders it straight into the      **
+** slot. The slots are given out in the order the files are   **
+** read and the output is taken from them in the same order,  **
+** so it is the same as without '--isolate'. A worker that    **
+** dies (or takes more than ISO_TIMEOUT seconds over a file,  **
+** when it is killed) is replaced, the new worker carries on  **
+** with the rest of its ring and the file it was rendering is **
+** reported to the quarantine callback in its place.          **
+** Not available in Windows.                                  **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int iso_start(int workers, const struct ISO_CALLBACKS * cb,**
+**               void * ctx)                                  **
+**      Sets up 'workers' workers (0 for one per processor),  **
+**      they are started by the first iso_file() (so they     **
+**      have the directory lifer is in then). Returns 0 if    **
+**      successful, -1 (having said why) if not.              **
+**                                                            **
+** int iso_file(const char * path)                            **
+**      Gives path to a worker, first passing on the output   **
+**      of the files before it that are done. Returns 0 if    **
+**      successful, -1 if the workers can't be (re)started.   **
+**                                                            **
+** int iso_finish(void)                                       **
+**      Waits for the rest of the files, passes on their      **
+**      output and stops the workers. Returns 0 or -1.        **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBISOLATE_H_
+#define _LIBISOLATE_H_
+
+#include <stdio.h>
+
+#define ISO_SLOTS     8                    // Slots in each worker's ring
+#define ISO_OUTSIZE   (16 * 1024 * 1024)   // Most output a slot can hold (only what is used is touched)
+#define ISO_PATHMAX   4096
+#define ISO_TIMEOUT   60                   // Seconds a worker may spend on one file
+
+struct ISO_CALLBACKS
+{
+  // Called in a worker: render the link file 'path' to out
+  void (*render)(void * ctx, const char * path, FILE * out);
+  // Called in lifer, in the order of the files: the output of 'path'
+  void (*write)(void * ctx, const char * path, const char * out, size_t len);
+  // Called in lifer, in place of write(), for a file a worker died over
+  void (*quarantine)(void * ctx, const char * path, const char * why);
+};
+
+extern int iso_start(int, const struct ISO_CALLBACKS *, void *);
+extern int iso_file(const char *);
+extern int iso_finish(void);
+
+#endif
@@ -0,0 +1,335 @@
+/***************************************************************
+**                                                            **
+**                    libjsonw.c                              **
+**                                                            **
+**    Writes JSON Lines as it goes.                           **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libjsonw.h for the exported functions                  **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <inttypes.h>
+#include "./libjsonw.h"
+
+//Local function declarations
+int jw_utf8len(const unsigned char *, size_t);
+void jw_putcp(FILE *, uint32_t);
+void jw_esc(FILE *, const unsigned char *, size_t);
+void jw_value(struct JW_WRITER *, const char *);
+void jw_end(struct JW_WRITER *);
+
+//
+//Function: jw_utf8len() returns the length of the valid UTF-8 sequence
+//          starting at p (which is >= 0x80, with n bytes left), or 0 if it
+//          isn't one. Overlong forms and surrogates are not valid.
+int jw_utf8len(const unsigned char * p, size_t n)
+{
+  if ((p[0] >= 0xC2) && (p[0] <= 0xDF) && (n >= 2))
+  {
+    return ((p[1] & 0xC0) == 0x80) ? 2 : 0;
+  }
+  if ((p[0] >= 0xE0) && (p[0] <= 0xEF) && (n >= 3))
+  {
+    if (((p[1] & 0xC0) != 0x80) || ((p[2] & 0xC0) != 0x80))
+      return 0;
+    if (((p[0] == 0xE0) && (p[1] < 0xA0)) || ((p[0] == 0xED) && (p[1] > 0x9F)))
+      return 0;
+    return 3;
+  }
+  if ((p[0] >= 0xF0) && (p[0] <= 0xF4) && (n >= 4))
+  {
+    if (((p[1] & 0xC0) != 0x80) || ((p[2] & 0xC0) != 0x80) || ((p[3] & 0xC0) != 0x80))
+      return 0;
+    if (((p[0] == 0xF0) && (p[1] < 0x90)) || ((p[0] == 0xF4) && (p[1] > 0x8F)))
+      return 0;
+    return 4;
+  }
+  return 0;
+}
+
+//
+//Function: jw_putcp() writes a code point in a string, escaped if JSON
+//          needs it to be
+void jw_putcp(FILE * fp, uint32_t c)
+{
+  if (c == '"' || c == '\\')
+  {
+    putc('\\', fp);
+    putc((int)c, fp);
+  }
+  else if (c < 0x20)
+  {
+    switch (c)
+    {
+    case '\n':
+      fputs("\\n", fp);
+      break;
+    case '\r':
+      fputs("\\r", fp);
+      break;
+    case '\t':
+      fputs("\\t", fp);
+      break;
+    default:
+      fprintf(fp, "\\u%04x", (unsigned int)c);
+    }
+  }
+  else if (c < 0x80)
+  {
+    putc((int)c, fp);
+  }
+  else if (c < 0x800)
+  {
+    putc((int)(0xC0 | (c >> 6)), fp);
+    putc((int)(0x80 | (c & 0x3F)), fp);
+  }
+  else if (c < 0x10000)
+  {
+    putc((int)(0xE0 | (c >> 12)), fp);
+    putc((int)(0x80 | ((c >> 6) & 0x3F)), fp);
+    putc((int)(0x80 | (c & 0x3F)), fp);
+  }
+  else
+  {
+    putc((int)(0xF0 | (c >> 18)), fp);
+    putc((int)(0x80 | ((c >> 12) & 0x3F)), fp);
+    putc((int)(0x80 | ((c >> 6) & 0x3F)), fp);
+    putc((int)(0x80 | (c & 0x3F)), fp);
+  }
+}
+
+//
+//Function: jw_esc() writes n bytes as the inside of a string. Runs of
+//          printable ASCII & valid UTF-8 are written with one fwrite(),
+//          anything else a character at a time.
+void jw_esc(FILE * fp, const unsigned char * s, size_t n)
+{
+  size_t i = 0, run;
+  int len;
+
+  while (i < n)
+  {
+    run = i;
+    for (;;)
+    {
+      if ((i < n) && (s[i] >= 0x20) && (s[i] < 0x80) && (s[i] != '"') && (s[i] != '\\'))
+      {
+        i++;
+      }
+      else if ((i < n) && (s[i] >= 0x80) && ((len = jw_utf8len(s + i, n - i)) > 0))
+      {
+        i += len;
+      }
+      else
+      {
+        break;
+      }
+    }
+    if (i > run)
+    {
+      fwrite(s + run, 1, i - run, fp);
+    }
+    if (i < n)
+    {
+      jw_putcp(fp, s[i]); // An escape, or a Latin-1 character
+      i++;
+    }
+  }
+}
+
+//
+//Function: jw_value() starts a value: the comma before it and its key
+void jw_value(struct JW_WRITER * w, const char * key)
+{
+  if (w->Depth > 0)
+  {
+    if (w->Count[w->Depth - 1]++ > 0)
+    {
+      putc(',', w->fp);
+    }
+    if (w->Type[w->Depth - 1] == '{')
+    {
+      if (key == NULL)
+      {
+        w->Error = -1;
+        key = "";
+      }
+      putc('"', w->fp);
+      jw_esc(w->fp, (const unsigned char *)key, strlen(key));
+      fputs("\":", w->fp);
+      return;
+    }
+  }
+  if (key != NULL)
+  {
+    w->Error = -1; // (and it is left out)
+  }
+}
+
+//
+//Function: jw_end() ends a value, with a new line if it is at the top level
+void jw_end(struct JW_WRITER * w)
+{
+  if (w->Depth == 0)
+  {
+    putc('\n', w->fp);
+  }
+}
+
+//
+//Function: jw_start() sets up a writer
+extern void jw_start(struct JW_WRITER * w, FILE * fp)
+{
+  memset(w, 0, sizeof(struct JW_WRITER));
+  w->fp = fp;
+}
+
+//
+//Function: jw_open() opens an object or array
+extern void jw_open(struct JW_WRITER * w, const char * key, char type)
+{
+  jw_value(w, key);
+  if (w->Depth >= JW_MAXDEPTH)
+  {
+    w->Error = -1;
+    return;
+  }
+  type = (type == '[') ? '[' : '{';
+  putc(type, w->fp);
+  w->Type[w->Depth] = type;
+  w->Count[w->Depth] = 0;
+  w->Depth++;
+}
+
+//
+//Function: jw_close() closes the innermost object or array
+extern void jw_close(struct JW_WRITER * w)
+{
+  if (w->Depth == 0)
+  {
+    w->Error = -1;
+    return;
+  }
+  w->Depth--;
+  putc((w->Type[w->Depth] == '[') ? ']' : '}', w->fp);
+  jw_end(w);
+}
+
+//
+//Function: jw_int(), jw_uint(), jw_null() & jw_bool() write a number,
+//          null, true or false
+extern void jw_int(struct JW_WRITER * w, const char * key, int64_t v)
+{
+  jw_value(w, key);
+  fprintf(w->fp, "%"PRId64, v);
+  jw_end(w);
+}
+extern void jw_uint(struct JW_WRITER * w, const char * key, uint64_t v)
+{
+  jw_value(w, key);
+  fprintf(w->fp, "%"PRIu64, v);
+  jw_end(w);
+}
+extern void jw_null(struct JW_WRITER * w, const char * key)
+{
+  jw_value(w, key);
+  fputs("null", w->fp);
+  jw_end(w);
+}
+extern void jw_bool(struct JW_WRITER * w, const char * key, int v)
+{
+  jw_value(w, key);
+  fputs(v ? "true" : "false", w->fp);
+  jw_end(w);
+}
+
+//
+//Function: jw_str() writes a string
+extern void jw_str(struct JW_WRITER * w, const char * key, const char * s, size_t len)
+{
+  jw_value(w, key);
+  putc('"', w->fp);
+  if (s != NULL)
+  {
+    jw_esc(w->fp, (const unsigned char *)s, (len == JW_NUL) ? strlen(s) : len);
+  }
+  putc('"', w->fp);
+  jw_end(w);
+}
+
+//
+//Function: jw_utf16() writes a UTF-16LE string
+extern void jw_utf16(struct JW_WRITER * w, const char * key, const unsigned char * s, size_t size)
+{
+  size_t i;
+  uint32_t c, lo;
+
+  jw_value(w, key);
+  putc('"', w->fp);
+  for (i = 0; (s != NULL) && (i + 1 < size); i += 2)
+  {
+    c = s[i] | (s[i + 1] << 8);
+    if (c == 0)
+    {
+      break;
+    }
+    if ((c >= 0xD800) && (c <= 0xDBFF) && (i + 3 < size) &&
+      ((lo = s[i + 2] | (s[i + 3] << 8)) >= 0xDC00) && (lo <= 0xDFFF))
+    {
+      c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+      i += 2;
+    }
+    else if ((c >= 0xD800) && (c <= 0xDFFF))
+    {
+      c = 0xFFFD;
+    }
+    jw_putcp(w->fp, c);
+  }
+  putc('"', w->fp);
+  jw_end(w);
+}
+
+//
+//Function: jw_hex() writes bytes as a string of hex digits
+extern void jw_hex(struct JW_WRITER * w, const char * key, const unsigned char * data, size_t size)
+{
+  static const char digits[] = "0123456789ABCDEF";
+  size_t i;
+
+  jw_value(w, key);
+  putc('"', w->fp);
+  for (i = 0; i < size; i++)
+  {
+    putc(digits[data[i] >> 4], w->fp);
+    putc(digits[data[i] & 0x0F], w->fp);
+  }
+  putc('"', w->fp);
+  jw_end(w);
+}
+
+//
+//Function: jw_error() returns -1 if anything written wasn't valid
+extern int jw_error(struct JW_WRITER * w)
+{
+  return w->Error;
+}
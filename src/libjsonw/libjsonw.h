@@ -0,0 +1,107 @@
+/***************************************************************
+**                                                            **
+**                    libjsonw.h                              **
+**                                                            **
+**    Writes JSON as it goes, one value at a time, with no    **
+** tree built first. The writer keeps track of the objects &  **
+** arrays that are open so the commas come out right, and     **
+** each top level value is ended with a new line (JSON Lines, **
+** https://jsonlines.org). Strings are escaped as they are    **
+** written, bytes that aren't valid UTF-8 are taken to be     **
+** Latin-1, so the output is always valid UTF-8 JSON.         **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** void jw_start(struct JW_WRITER * w, FILE * fp)             **
+**      Sets up w to write to fp.                             **
+**                                                            **
+** void jw_open(struct JW_WRITER * w, const char * key,       **
+**              char type)                                    **
+**      Opens an object (type '{') or an array ('['). 'key'   **
+**      is its name in the enclosing object, NULL in an array **
+**      or at the top level (as it is for all the functions   **
+**      below).                                               **
+**                                                            **
+** void jw_close(struct JW_WRITER * w)                        **
+**      Closes the innermost object or array.                 **
+**                                                            **
+** void jw_int(struct JW_WRITER * w, const char * key,        **
+**             int64_t v)                                     **
+** void jw_uint(struct JW_WRITER * w, const char * key,       **
+**              uint64_t v)                                   **
+** void jw_null(struct JW_WRITER * w, const char * key)       **
+** void jw_bool(struct JW_WRITER * w, const char * key,       **
+**              int v)                                        **
+**      Write a number, null, true or false.                  **
+**                                                            **
+** void jw_str(struct JW_WRITER * w, const char * key,        **
+**             const char * s, size_t len)                    **
+**      Writes the len bytes at s as a string (JW_NUL for len **
+**      if s is zero terminated).                             **
+**                                                            **
+** void jw_utf16(struct JW_WRITER * w, const char * key,      **
+**               const unsigned char * s, size_t size)        **
+**      Writes the UTF-16LE string of 'size' bytes at s (up   **
+**      to a zero character). Unpaired surrogates are written **
+**      as U+FFFD.                                            **
+**                                                            **
+** void jw_hex(struct JW_WRITER * w, const char * key,        **
+**             const unsigned char * data, size_t size)       **
+**      Writes 'size' bytes as a string of hex digits.        **
+**                                                            **
+** int jw_error(struct JW_WRITER * w)                         **
+**      Returns -1 if anything written was not valid (too     **
+**      deeply nested, a key missing or not wanted), else 0.  **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBJSONW_H_
+#define _LIBJSONW_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define JW_MAXDEPTH 32
+#define JW_NUL      ((size_t)-1)  // jw_str()'s len for a zero terminated string
+
+struct JW_WRITER
+{
+  FILE          * fp;
+  int             Depth;                // Objects & arrays open
+  char            Type[JW_MAXDEPTH];    // '{' or '[' of each
+  int             Count[JW_MAXDEPTH];   // Values written in each
+  int             Error;
+};
+
+extern void jw_start(struct JW_WRITER *, FILE *);
+extern void jw_open(struct JW_WRITER *, const char *, char);
+extern void jw_close(struct JW_WRITER *);
+extern void jw_int(struct JW_WRITER *, const char *, int64_t);
+extern void jw_uint(struct JW_WRITER *, const char *, uint64_t);
+extern void jw_null(struct JW_WRITER *, const char *);
+extern void jw_bool(struct JW_WRITER *, const char *, int);
+extern void jw_str(struct JW_WRITER *, const char *, const char *, size_t);
+extern void jw_utf16(struct JW_WRITER *, const char *, const unsigned char *, size_t);
+extern void jw_hex(struct JW_WRITER *, const char *, const unsigned char *, size_t);
+extern int jw_error(struct JW_WRITER *);
+
+#endif
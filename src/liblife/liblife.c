@@ -25,21 +25,50 @@ This file is part of Lifer.
     along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64 //So that fseeko() can reach beyond 2GiB on 32 bit platforms
+#endif
 #include "./liblife.h"
+#include "./lifguids.h"
+
+//The name of a flag or attribute bit, with the " | " that separates it from
+//the next already on the end so that get_flag_a() & get_attr_a() can copy
+//each one with a single memcpy()
+struct LIF_BIT_NAME
+{
+  uint32_t      Bit;
+  const char    *Name;
+  size_t        Len;  //strlen(Name)
+};
+#define LIF_BIT(bit, name) { bit, name " | ", sizeof(name " | ") - 1 }
 
 //Declaration of functions used privately
-int get_lhdr(FILE *, struct LIF *);
-int get_lhdr_a(struct LIF_HDR *, struct LIF_HDR_A *);
-int get_idlist(FILE *, int, int, struct LIF *);
+int lif_seek(FILE *, uint64_t);
+int get_lhdr(FILE *, uint64_t, struct LIF *);
+int get_lhdr_a(struct LIF_HDR *, struct LIF_HDR_A *, uint32_t);
+int get_idlist(FILE *, int, uint64_t, int, struct LIF *);
 int get_idlist_a(struct LIF_IDLIST *, struct LIF_IDLIST_A *);
-int get_linkinfo(FILE *, int, int, struct LIF *);
+int get_itemids(unsigned char *, int, uint64_t, struct LIF_ITEMID[], uint16_t *);
+void get_itemids_a(struct LIF_ITEMID[], uint16_t, struct LIF_ITEMID_A[]);
+void get_shellitem(unsigned char *, int, struct LIF_SHELLITEM *);
+void get_shellitem_a(struct LIF_SHELLITEM *, struct LIF_SHELLITEM_A *);
+int get_shi_root(unsigned char *, int, struct LIF_SHELLITEM *);
+int get_shi_volume(unsigned char *, int, struct LIF_SHELLITEM *);
+int get_shi_file(unsigned char *, int, struct LIF_SHELLITEM *);
+int get_shi_network(unsigned char *, int, struct LIF_SHELLITEM *);
+int get_shi_uri(unsigned char *, int, struct LIF_SHELLITEM *);
+void get_beef0004(unsigned char *, int, struct LIF_SHELLITEM *);
+int get_ansistr(unsigned char[], int, int, unsigned char[], int);
+void get_fattime_a(uint16_t, uint16_t, unsigned char[]);
+int get_linkinfo(FILE *, int, uint64_t, int, struct LIF *);
 int get_linkinfo_a(struct LIF_INFO *, struct LIF_INFO_A *);
-int get_stringdata(FILE *, int, struct LIF *);
+int get_stringdata(FILE *, uint64_t, int, struct LIF *);
 int get_stringdata_a(struct LIF_STRINGDATA *, struct LIF_STRINGDATA_A *);
-int get_extradata(FILE *, int, struct LIF *);
-int get_extradata_a(struct LIF_EXTRA_DATA *, struct LIF_EXTRA_DATA_A *);
-void get_flag_a(unsigned char *, struct LIF_HDR *);
-void get_attr_a(unsigned char *, struct LIF_HDR *);
+int get_extradata(FILE *, uint64_t, int, struct LIF *);
+int get_extradata_a(struct LIF_EXTRA_DATA *, uint32_t, struct LIF_EXTRA_DATA_A *);
+size_t put_bits_a(char *, size_t, uint32_t, const struct LIF_BIT_NAME *, int);
+void get_flag_a(unsigned char *, size_t, struct LIF_HDR *, uint32_t);
+void get_attr_a(unsigned char *, size_t, struct LIF_HDR *, uint32_t);
 uint64_t get_le_uint64(unsigned char[], int);
 int64_t get_le_int64(unsigned char[], int);
 uint32_t  get_le_uint32(unsigned char[], int);
@@ -48,27 +77,45 @@ int32_t get_le_int32(unsigned char[], int);
 int16_t get_le_int16(unsigned char[], int);
 void get_chars(unsigned char[], int, int, unsigned char[]);
 int get_le_unistr(unsigned char[], int, int, wchar_t[]);
+void lif_gmtime(const time_t *, struct tm *);
 void get_filetime_a_short(int64_t, unsigned char[]);
 void get_filetime_a_long(int64_t, unsigned char[]);
 void get_ltp(struct LIF_TRACKER_PROPS *, unsigned char*);
 void get_droid_a(struct LIF_CLSID *, struct LIF_CLSID_A *);
+uint32_t guid_hash(unsigned char[], uint32_t);
+const struct LIF_GUID_NAME * guid_lookup(struct LIF_CLSID *, uint32_t,
+  const struct LIF_GUID_NAME[], int, const uint16_t[], int);
 void led_setnull(struct LIF_EXTRA_DATA *);
+enum EDTYPES get_edtype(uint32_t);
 
 
 //Function get_lif(FILE* fp, int size, struct LIF lif) takes an open file
 //pointer and populates the LIF with relevant data.
 extern int get_lif(FILE* fp, int size, struct LIF* lif)
+{
+  return get_lif_at(fp, 0, size, LIF_SEC_ALL, lif);
+}
+//
+//Function get_lif_at(FILE* fp, uint64_t base, int size, struct LIF* lif) does
+//the work of get_lif() for a link file whose first byte is at offset 'base'
+//in fp (a jump list stream or a carved disk image for instance). 'pos' is
+//kept relative to the start of the link, 'base' is added whenever the file
+//is read or a Posn is recorded. Only the sections in 'mask' are decoded, the
+//rest are stepped over using their size fields.
+extern int get_lif_at(FILE* fp, uint64_t base, int size, uint32_t mask, struct LIF* lif)
 {
   int pos = 0;
 
   assert(size >= 0x4C);   //Min size for a LIF (must contain a header at least)
-  if (get_lhdr(fp, lif) < 0)
+  lif->Base = base;
+  lif->Sections = mask | LIF_SEC_HDR;
+  if (get_lhdr(fp, base, lif) < 0)
   {
     return -1;
   }
   pos += 0x4C;
 
-  if (get_idlist(fp, size, pos, lif) < 0)
+  if (get_idlist(fp, size, base, pos, lif) < 0)
   {
     return -2;
   }
@@ -77,13 +124,13 @@ extern int get_lif(FILE* fp, int size, struct LIF* lif)
     pos += (lif->lidl.IDListSize + 2);
   }
 
-  if (get_linkinfo(fp, size, pos, lif) < 0)
+  if (get_linkinfo(fp, size, base, pos, lif) < 0)
   {
     return -3;
   }
   pos += (lif->li.Size);
 
-  if (get_stringdata(fp, pos, lif) < 0)
+  if (get_stringdata(fp, base, pos, lif) < 0)
   {
     return -4;
   }
@@ -91,7 +138,7 @@ extern int get_lif(FILE* fp, int size, struct LIF* lif)
 
   if (pos < size) //Only get the extra data if it exists
   {
-    if (get_extradata(fp, pos, lif) < 0)
+    if (get_extradata(fp, base, pos, lif) < 0)
     {
       return -5;
     }
@@ -109,7 +156,14 @@ extern int get_lif(FILE* fp, int size, struct LIF* lif)
 //structure with the ASCII representation of a LIF
 extern int get_lif_a(struct LIF* lif, struct LIF_A* lif_a)
 {
-  if (get_lhdr_a(&lif->lh, &lif_a->lha) < 0)
+  return get_lif_a_opt(lif, lif_a, 0);
+}
+//
+//Function get_lif_a_opt(struct LIF* lif, struct LIF_A* lif_a, uint32_t opts)
+//does the work of get_lif_a(), 'opts' is a mask of LIF_A_* options
+extern int get_lif_a_opt(struct LIF* lif, struct LIF_A* lif_a, uint32_t opts)
+{
+  if (get_lhdr_a(&lif->lh, &lif_a->lha, opts) < 0)
   {
     return -1;
   }
@@ -117,7 +171,7 @@ extern int get_lif_a(struct LIF* lif, struct LIF_A* lif_a)
   {
     return -2;
   }
-  if (get_linkinfo_a(&lif->li, &lif_a->lia) < 0)
+  if ((lif->Sections & LIF_SEC_LINKINFO) && (get_linkinfo_a(&lif->li, &lif_a->lia) < 0))
   {
     return -3;
   }
@@ -125,7 +179,7 @@ extern int get_lif_a(struct LIF* lif, struct LIF_A* lif_a)
   {
     return -4;
   }
-  if (get_extradata_a(&lif->led, &lif_a->leda) < 0)
+  if (get_extradata_a(&lif->led, lif->Sections, &lif_a->leda) < 0)
   {
     return -5;
   }
@@ -135,6 +189,13 @@ extern int get_lif_a(struct LIF* lif, struct LIF_A* lif_a)
 //Function test_link(FILE *fp) takes an open file pointer as an argument
 //and returns 0 if the file IS a Windows link file or -1 if not.
 extern int test_link(FILE* fp)
+{
+  return test_link_at(fp, 0);
+}
+//
+//Function test_link_at(FILE *fp, uint64_t base) is test_link() for a link
+//file that starts at offset 'base' within fp.
+extern int test_link_at(FILE* fp, uint64_t base)
 {
   struct LIF lif;
   int i;
@@ -145,7 +206,7 @@ extern int test_link(FILE* fp)
     return -1; //Same as the previous but won't kill execution if NDEBUG is defined
   }
 
-  get_lhdr(fp, &lif);
+  get_lhdr(fp, base, &lif);
   //Check the value of HeaderSize
   if (lif.lh.H_size != 0x0000004C)
     return -1;
@@ -185,13 +246,12 @@ extern int test_link(FILE* fp)
 //          but in LE format). It is assumed that this is the first in a 
 //          possible series of LIF_SER_PROPSTORE objects with a terminator of
 //          0x00000000
-//          'posn' is the location of the first byte of data_buf relative to the start of
-//          the link file.
+//          'position' is the absolute file offset of the first byte of data_buf.
 //
 //          Return value is 0 on success (object found) and !0 on object not found or
 //          error. If the return value is 0 then the position of the first
 //          LIF_SER_PROPSTORE is in psp->Posn.
-extern int find_propstores(unsigned char * data_buf, int size, int position, struct LIF_PROPERTY_STORE_PROPS * psp)
+extern int find_propstores(unsigned char * data_buf, int size, uint64_t position, struct LIF_PROPERTY_STORE_PROPS * psp)
 {
   int i, j, k, p, vp, posn;
 
@@ -320,6 +380,7 @@ extern int get_propstore_a(struct LIF_SER_PROPSTORE * ps, struct LIF_SER_PROPSTO
   double    currency;
   char      decsign[9], lp_buf[300];
   wchar_t   lpw_buf[300];
+  const char *        name;
   struct LIF_CLSID    guid;
   struct LIF_CLSID_A  guida;
 
@@ -351,6 +412,18 @@ extern int get_propstore_a(struct LIF_SER_PROPSTORE * ps, struct LIF_SER_PROPSTO
         snprintf((char *)psa->PropValues[j].NameSizeOrID, 12, "0x%.8"PRIX32, ps->PropValues[j].NameSizeOrID);
         snprintf((char *)psa->PropValues[j].Name, 6, "[N/A]");
       }
+      if ((ps->NameType != 0) && ((name = get_propkey_name(&ps->FormatID, ps->PropValues[j].NameSizeOrID)) != NULL))
+      {
+        snprintf((char *)psa->PropValues[j].KeyName, 64, "%s", name);
+      }
+      else if (ps->NameType != 0)
+      {
+        snprintf((char *)psa->PropValues[j].KeyName, 64, "[UNKNOWN]");
+      }
+      else
+      {
+        snprintf((char *)psa->PropValues[j].KeyName, 64, "[N/A]");
+      }
       snprintf((char *)psa->PropValues[j].Reserved, 6, "0x%.2"PRIX8, ps->PropValues[j].Reserved);
       snprintf((char *)psa->PropValues[j].PropertyType, 12, "0x%.4"PRIX16, ps->PropValues[j].PropertyType);
       snprintf((char *)psa->PropValues[j].Padding, 12, "0x%.4"PRIX16, ps->PropValues[j].Padding);
@@ -598,8 +671,15 @@ extern int get_propstore_a(struct LIF_SER_PROPSTORE * ps, struct LIF_SER_PROPSTO
         get_chars(ps->PropValues[j].Value, 8, 2, guid.Data4hi);
         get_chars(ps->PropValues[j].Value, 10, 6, guid.Data4lo);
         get_droid_a(&guid, &guida);
-        // For now just print out the GUID, and (if appropriate) the time and MAC address
-        snprintf((char *)psa->PropValues[j].Value, 150, "UUID: %s, Time: %s, Node (MAC addr): %s", guida.UUID, guida.Time_long, guida.Node);
+        // For now just print out the GUID, its name (if known) and (if appropriate) the time and MAC address
+        if ((name = get_guid_name(&guid)) != NULL)
+        {
+          snprintf((char *)psa->PropValues[j].Value, 150, "UUID: %s (%s), Time: %s, Node (MAC addr): %s", guida.UUID, name, guida.Time_long, guida.Node);
+        }
+        else
+        {
+          snprintf((char *)psa->PropValues[j].Value, 150, "UUID: %s, Time: %s, Node (MAC addr): %s", guida.UUID, guida.Time_long, guida.Node);
+        }
         break;
       case VT_VERSIONED_STREAM: //Not Tested
         strcat((char *)psa->PropValues[j].PropertyType, " VT_VERSIONED_STREAM");
@@ -632,6 +712,7 @@ extern int get_propstore_a(struct LIF_SER_PROPSTORE * ps, struct LIF_SER_PROPSTO
       snprintf((char *)psa->PropValues[j].NameSizeOrID, 6, "[N/A]");
       snprintf((char *)psa->PropValues[j].Reserved, 6, "[N/A]");
       snprintf((char *)psa->PropValues[j].Name, 6, "[N/A]");
+      snprintf((char *)psa->PropValues[j].KeyName, 6, "[N/A]");
       snprintf((char *)psa->PropValues[j].PropertyType, 6, "[N/A]");
       snprintf((char *)psa->PropValues[j].Padding, 6, "[N/A]");
       snprintf((char *)psa->PropValues[j].Value, 6, "[N/A]");
@@ -640,10 +721,23 @@ extern int get_propstore_a(struct LIF_SER_PROPSTORE * ps, struct LIF_SER_PROPSTO
   return 0;
 }
 //
-//Function get_lhdr(FILE *fp, struct LIF_HDR *lh) takes an open file pointer
-//and a pointer to a LIF_HDR structure.
+//Function lif_seek(FILE *fp, uint64_t posn) moves fp to the absolute offset
+//posn. fseek() only takes a long which is 32 bits on Windows (and on 32 bit
+//*nix) so it can't reach links embedded deep in a large container.
+int lif_seek(FILE *fp, uint64_t posn)
+{
+#ifdef _WIN32
+  return _fseeki64(fp, (__int64)posn, SEEK_SET);
+#else
+  return fseeko(fp, (off_t)posn, SEEK_SET);
+#endif
+}
+//
+//Function get_lhdr(FILE *fp, uint64_t base, struct LIF_HDR *lh) takes an open
+//file pointer, the offset of the link within it and a pointer to a LIF_HDR
+//structure.
 //On exit the LIF_HDR will be populated.
-int get_lhdr(FILE *fp, struct LIF *lif)
+int get_lhdr(FILE *fp, uint64_t base, struct LIF *lif)
 {
   unsigned char header[0x4C];
   int chr;
@@ -656,7 +750,7 @@ int get_lhdr(FILE *fp, struct LIF *lif)
     return -1; //Same as the previous but won't kill execution if NDEBUG defined
   }
 
-  rewind(fp);
+  lif_seek(fp, base);
   //I'd love to use 'read()' here but I'm trying to avoid using unistd.h
   //because I want the library to compile under Windoze
   for (i = 0; i < 0x4C; i++)
@@ -693,18 +787,16 @@ int get_lhdr(FILE *fp, struct LIF *lif)
   return 0;
 }
 //
-//Function get_lhdr_a(LIF_HDR*, LIF_HDR_A*) converts the data in a LIF_HDR
-//into a readable form and populates the strings in LIF_HDR_A
-int get_lhdr_a(struct LIF_HDR* lh, struct LIF_HDR_A* lha)
+//Function get_lhdr_a(LIF_HDR*, LIF_HDR_A*, uint32_t) converts the data in a
+//LIF_HDR into a readable form and populates the strings in LIF_HDR_A
+int get_lhdr_a(struct LIF_HDR* lh, struct LIF_HDR_A* lha, uint32_t opts)
 {
-  unsigned char lk[30], hk1[24], hk2[10], hk3[10], attr_str[400], flag_str[600];
+  unsigned char lk[30], hk1[24], hk2[10], hk3[10];
 
   snprintf((char *)lha->H_size, 10, "%"PRIu32, lh->H_size);
   snprintf((char *)lha->CLSID, 40, "{00021401-0000-0000-C000-000000000046}");
-  get_flag_a(flag_str, lh);
-  snprintf((char *)lha->Flags, 550, "0x%.8"PRIX32"  %s", lh->Flags, flag_str);
-  get_attr_a(attr_str, lh);
-  snprintf((char *)lha->Attr, 250, "0x%.8"PRIX32"  %s", lh->Attr, attr_str);
+  get_flag_a(lha->Flags, sizeof(lha->Flags), lh, opts);
+  get_attr_a(lha->Attr, sizeof(lha->Attr), lh, opts);
   get_filetime_a_short(lh->CrDate, lha->CrDate);
   get_filetime_a_long(lh->CrDate, lha->CrDate_long);
   get_filetime_a_short(lh->AcDate, lha->AcDate);
@@ -803,48 +895,34 @@ int get_lhdr_a(struct LIF_HDR* lh, struct LIF_HDR_A* lha)
 //
 // Function 'get_idlist()' fills a LIF_IDLIST structure with data from the
 // opened file fp
-int get_idlist(FILE * fp, int size, int loc, struct LIF * lif)
+int get_idlist(FILE * fp, int size, uint64_t base, int loc, struct LIF * lif)
 {
   unsigned char   size_buf[2];   //A small buffer to hold the size element
-  int             numItems = 0, posn = loc + 2, i, datasize;
+  unsigned char * data_buf;
 
+  lif->lidl.NumItemIDs = 0;
   if (lif->lh.Flags & 0x00000001)
   {
-    fseek(fp, loc, SEEK_SET);
+    lif_seek(fp, base + loc);
     size_buf[0] = getc(fp);
     size_buf[1] = getc(fp);
     lif->lidl.IDListSize = get_le_uint16(size_buf, 0);
-    if (lif->lidl.IDListSize > 0)
+    if ((lif->lidl.IDListSize > 0) && (lif->Sections & LIF_SEC_IDLIST))
     {
-      //posn points to the first ItemID relative to the start of TargetIDList
-      while (posn < (loc + 2 + lif->lidl.IDListSize))
+      //Read the whole list in one go then decode the ItemIDs from the buffer
+      data_buf = (unsigned char*)calloc((size_t)lif->lidl.IDListSize, 1);
+      assert(data_buf != NULL);
+      if (fread(data_buf, 1, lif->lidl.IDListSize, fp) < lif->lidl.IDListSize)
       {
-        fseek(fp, posn, SEEK_SET);
-        size_buf[0] = getc(fp);
-        size_buf[1] = getc(fp);
-        lif->lidl.Items[numItems].ItemIDSize = get_le_uint16(size_buf, 0);
-        datasize = lif->lidl.Items[numItems].ItemIDSize - 2;
-        if (lif->lidl.Items[numItems].ItemIDSize == 0)
-        {
-          break;
-        }
-        else
-        {
-          for (i = 0; (i < datasize + 2) && (i <= MAXITEMIDSIZE); i++)
-          {
-            lif->lidl.Items[numItems].Data[i] = getc(fp);
-          }
-        }
-        posn = posn + lif->lidl.Items[numItems].ItemIDSize;
-        numItems++;
+        fprintf(stderr, "LinkTargetIDList is truncated\n");
       }
-      lif->lidl.NumItemIDs = numItems;
+      get_itemids(data_buf, lif->lidl.IDListSize, base + loc + 2, lif->lidl.Items, &lif->lidl.NumItemIDs);
+      free(data_buf);
     }
   }
   else //No ID List
   {
     lif->lidl.IDListSize = 0;
-    lif->lidl.NumItemIDs = 0;
   }
 
   return 0;
@@ -853,8 +931,6 @@ int get_idlist(FILE * fp, int size, int loc, struct LIF * lif)
 // Converts the data in a LIF_IDLIST into its ASCII representation
 int get_idlist_a(struct LIF_IDLIST * lidl, struct LIF_IDLIST_A * lidla)
 {
-  int  i;
-
   if (!(lidl->IDListSize == 0))
   {
     snprintf((char *)lidla->IDListSize, 10, "%"PRIu16, lidl->IDListSize);
@@ -865,18 +941,391 @@ int get_idlist_a(struct LIF_IDLIST * lidl, struct LIF_IDLIST_A * lidla)
     snprintf((char *)lidla->IDListSize, 10, "[N/A]");
     snprintf((char *)lidla->NumItemIDs, 10, "[N/A]");
   }
-  for (i = 0; i < lidl->NumItemIDs; i++)
+  get_itemids_a(lidl->Items, lidl->NumItemIDs, lidla->Items);
+
+  return 0;
+}
+//
+// Function 'get_itemids()' decodes the ItemIDs of an IDList (MS-SHLLINK
+// S2.2.1) straight from 'buf' which holds 'size' bytes starting at the first
+// ItemID. It is used for both the LinkTargetIDList and the IDList in a
+// VistaAndAboveIDListDataBlock. 'posn' is the absolute file offset of buf[0].
+// Each ItemID's Data holds the ItemIDSize - 2 bytes after its size field.
+// Decoding stops at the TerminalID, at the end of the buffer or after ITEMIDS
+// items, whichever comes first, and *num is set to the number decoded.
+int get_itemids(unsigned char * buf, int size, uint64_t posn, struct LIF_ITEMID items[], uint16_t * num)
+{
+  int       p = 0, datasize;
+  uint16_t  n = 0;
+
+  while (((p + 2) <= size) && (n < ITEMIDS))
+  {
+    items[n].ItemIDSize = get_le_uint16(buf, p);
+    //A TerminalID (or something too small to be an ItemID) or an ItemID that
+    //runs off the end of the list finishes the job
+    if ((items[n].ItemIDSize < 2) || ((p + items[n].ItemIDSize) > size))
+    {
+      break;
+    }
+    items[n].Posn = posn + p;
+    datasize = items[n].ItemIDSize - 2;
+    if (datasize > MAXITEMIDSIZE)
+    {
+      datasize = MAXITEMIDSIZE;
+    }
+    memcpy(items[n].Data, &buf[p + 2], (size_t)datasize);
+    get_shellitem(items[n].Data, datasize, &items[n].Shell);
+    p += items[n].ItemIDSize;
+    n++;
+  }
+  *num = n;
+  return p;
+}
+//
+// Converts an array of 'num' LIF_ITEMIDs into their ASCII representation
+void get_itemids_a(struct LIF_ITEMID items[], uint16_t num, struct LIF_ITEMID_A items_a[])
+{
+  int  i;
+
+  for (i = 0; i < num; i++)
+  {
+    snprintf((char *)items_a[i].ItemIDSize, 10, "%"PRIu16, items[i].ItemIDSize);
+    items_a[i].Data[0] = (unsigned char)0;
+    get_shellitem_a(&items[i].Shell, &items_a[i].Shell);
+  }
+}
+//
+// Shell item decoders, one for each group of class type indicators. The
+// table is indexed by the top nibble of the class byte (the bottom nibble
+// holds flags that modify the item). A NULL entry or a decoder returning
+// < 0 leaves the item as SHI_UNKNOWN so that lifer falls back to a hex dump.
+typedef int(*shellitem_decoder)(unsigned char *, int, struct LIF_SHELLITEM *);
+static const shellitem_decoder shellitem_decoders[16] =
+{
+  NULL,             // 0x0_
+  get_shi_root,     // 0x1_ Root folder
+  get_shi_volume,   // 0x2_ Volume
+  get_shi_file,     // 0x3_ File entry
+  get_shi_network,  // 0x4_ Network location
+  NULL,             // 0x5_
+  get_shi_uri,      // 0x6_ URI
+  NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+//
+// Function 'get_shellitem()' interprets the 'size' bytes of ItemID Data
+// (everything after the ItemIDSize field) as a shell item.
+void get_shellitem(unsigned char * data, int size, struct LIF_SHELLITEM * shi)
+{
+  shellitem_decoder  decoder;
+
+  shi->Type = SHI_UNKNOWN;
+  shi->ExtVersion = 0;
+  shi->Name[0] = 0;
+  shi->Description[0] = 0;
+  shi->Comments[0] = 0;
+  shi->LongName[0] = (wchar_t)0;
+  memset(&shi->FolderID, 0, sizeof(struct LIF_CLSID));
+  if (size < 1)
+  {
+    shi->Class = 0;
+    return;
+  }
+  shi->Class = data[0];
+  decoder = shellitem_decoders[data[0] >> 4];
+  if ((decoder == NULL) || (decoder(data, size, shi) < 0))
+  {
+    shi->Type = SHI_UNKNOWN;
+  }
+}
+//
+// Root folder shell item (class 0x1F): sort index then a shell folder GUID
+int get_shi_root(unsigned char * data, int size, struct LIF_SHELLITEM * shi)
+{
+  if ((data[0] != 0x1F) || (size < 18))
+  {
+    return -1;
+  }
+  shi->Type = SHI_ROOT_FOLDER;
+  shi->SortIndex = data[1];
+  shi->FolderID.Data1 = get_le_uint32(data, 2);
+  shi->FolderID.Data2 = get_le_uint16(data, 6);
+  shi->FolderID.Data3 = get_le_uint16(data, 8);
+  get_chars(data, 10, 2, shi->FolderID.Data4hi);
+  get_chars(data, 12, 6, shi->FolderID.Data4lo);
+  return 0;
+}
+//
+// Volume shell item (classes 0x2_): if flag 0x01 is set the drive name
+// (e.g. 'C:\') follows the class byte. Class 0x2E items without a name are
+// usually delegate items: a size, that much data, the delegate folder CLSID
+// {5E591A74-DF96-48D3-8D67-1733BCEE28BA} and then the shell folder GUID.
+int get_shi_volume(unsigned char * data, int size, struct LIF_SHELLITEM * shi)
+{
+  int       p;
+
+  shi->Type = SHI_VOLUME;
+  if (data[0] & 0x01)
+  {
+    get_ansistr(data, 1, size, shi->Name, SHELLNAMESIZE);
+  }
+  else if ((data[0] == 0x2E) && (size >= 4))
+  {
+    p = 4 + get_le_uint16(data, 2);
+    if (((p + 32) <= size) && (get_le_uint32(data, p) == 0x5E591A74) &&
+      (get_le_uint16(data, p + 4) == 0xDF96) && (get_le_uint16(data, p + 6) == 0x48D3))
+    {
+      p += 16;
+      shi->FolderID.Data1 = get_le_uint32(data, p);
+      shi->FolderID.Data2 = get_le_uint16(data, p + 4);
+      shi->FolderID.Data3 = get_le_uint16(data, p + 6);
+      get_chars(data, p + 8, 2, shi->FolderID.Data4hi);
+      get_chars(data, p + 10, 6, shi->FolderID.Data4lo);
+    }
+  }
+  return 0;
+}
+//
+// File entry shell item (classes 0x3_): flag 0x01 = directory, 0x02 = file
+// and 0x04 = the primary name is Unicode. The primary name is followed by
+// any extension blocks, of which 0xBEEF0004 holds the useful stuff.
+int get_shi_file(unsigned char * data, int size, struct LIF_SHELLITEM * shi)
+{
+  wchar_t   uni_buf[SHELLNAMESIZE];
+  int       p;
+
+  if (size < 13)
+  {
+    return -1;
+  }
+  shi->Type = SHI_FILE_ENTRY;
+  shi->FileSize = get_le_uint32(data, 2);
+  shi->ModDate = get_le_uint16(data, 6);
+  shi->ModTime = get_le_uint16(data, 8);
+  shi->FileAttr = get_le_uint16(data, 10);
+  if (data[0] & 0x04) //Unicode primary name
+  {
+    for (p = 12; ((p + 1) < size) && ((data[p] != 0) || (data[p + 1] != 0)); p += 2);
+    //A name needs at least 2 bytes, without them Name is left empty
+    if ((size >= 14) && get_le_unistr(data, 12, ((size - 12) / 2 < SHELLNAMESIZE) ? (size - 12) / 2 : SHELLNAMESIZE, uni_buf) > 0)
+    {
+      snprintf((char *)shi->Name, SHELLNAMESIZE, "%.*ls", SHELLNAMESIZE - 1, uni_buf);
+    }
+    p += 2;
+  }
+  else
+  {
+    p = get_ansistr(data, 12, size, shi->Name, SHELLNAMESIZE);
+  }
+  //Extension blocks start on a 16 bit boundary (the ItemIDSize field is
+  //2 bytes so the alignment is the same relative to Data)
+  p += (p & 1);
+  //The last 2 bytes of the item hold the offset of the first extension block
+  //relative to the start of the ItemID, use it if the computed position is
+  //not a 0xBEEF0004 block
+  if (((p + 8) > size) || (get_le_uint32(data, p + 4) != 0xBEEF0004))
+  {
+    p = (int)get_le_uint16(data, size - 2) - 2;
+  }
+  if ((p >= 13) && ((p + 8) <= size) && (get_le_uint32(data, p + 4) == 0xBEEF0004))
+  {
+    get_beef0004(&data[p], size - p, shi);
+  }
+  return 0;
+}
+//
+// The 0xBEEF0004 extension block, 'size' is the number of bytes left in the
+// item from the start of the block
+void get_beef0004(unsigned char * ext, int size, struct LIF_SHELLITEM * shi)
+{
+  int       extsize, q;
+  uint64_t  mftref;
+
+  extsize = get_le_uint16(ext, 0);
+  if ((extsize > size) || (extsize < 20))
+  {
+    return;
+  }
+  shi->ExtVersion = get_le_uint16(ext, 2);
+  shi->CrDate = get_le_uint16(ext, 8);
+  shi->CrTime = get_le_uint16(ext, 10);
+  shi->AcDate = get_le_uint16(ext, 12);
+  shi->AcTime = get_le_uint16(ext, 14);
+  q = 18;
+  if (shi->ExtVersion >= 7)
+  {
+    if (extsize < 38)
+    {
+      return;
+    }
+    mftref = get_le_uint64(ext, 20);
+    shi->MFTEntry = mftref & 0x0000FFFFFFFFFFFFULL;
+    shi->MFTSeq = (uint16_t)(mftref >> 48);
+    q = 36;
+  }
+  if (shi->ExtVersion >= 3)
   {
-    snprintf((char *)lidla->Items[i].ItemIDSize, 10, "%"PRIu16, lidl->Items[i].ItemIDSize);
+    q += 2; //Long string size
   }
+  if (shi->ExtVersion >= 9)
+  {
+    q += 4;
+  }
+  if (shi->ExtVersion >= 8)
+  {
+    q += 4;
+  }
+  //The long name is null terminated, make sure it can't run out of the block
+  if ((q + 2) <= extsize)
+  {
+    get_le_unistr(ext, q, ((extsize - q) / 2 < SHELLNAMESIZE) ? (extsize - q) / 2 : SHELLNAMESIZE, shi->LongName);
+  }
+}
+//
+// Network location shell item (classes 0x4_): the location, then a
+// description if flag 0x80 is set and comments if 0x40 is set
+int get_shi_network(unsigned char * data, int size, struct LIF_SHELLITEM * shi)
+{
+  int       p;
 
+  if (size < 4)
+  {
+    return -1;
+  }
+  shi->Type = SHI_NETWORK;
+  p = get_ansistr(data, 3, size, shi->Name, SHELLNAMESIZE);
+  if (data[2] & 0x80)
+  {
+    p = get_ansistr(data, p, size, shi->Description, SHELLNAMESIZE);
+  }
+  if (data[2] & 0x40)
+  {
+    get_ansistr(data, p, size, shi->Comments, SHELLNAMESIZE);
+  }
   return 0;
 }
 //
+// URI shell item (class 0x61): flags, a data size, 2 unknown bytes and the
+// data (FTP details etc.) followed by the URI itself which is Unicode if flag
+// 0x80 is set
+int get_shi_uri(unsigned char * data, int size, struct LIF_SHELLITEM * shi)
+{
+  wchar_t   uni_buf[SHELLNAMESIZE];
+  int       p;
+
+  if ((data[0] != 0x61) || (size < 4))
+  {
+    return -1;
+  }
+  shi->Type = SHI_URI;
+  p = 6 + get_le_uint16(data, 2);
+  if ((p + 2) <= size)
+  {
+    if (data[1] & 0x80)
+    {
+      if (get_le_unistr(data, p, ((size - p) / 2 < SHELLNAMESIZE) ? (size - p) / 2 : SHELLNAMESIZE, uni_buf) > 0)
+      {
+        snprintf((char *)shi->Name, SHELLNAMESIZE, "%.*ls", SHELLNAMESIZE - 1, uni_buf);
+      }
+    }
+    else
+    {
+      get_ansistr(data, p, size, shi->Name, SHELLNAMESIZE);
+    }
+  }
+  return 0;
+}
+//
+// Converts a LIF_SHELLITEM to its ASCII representation
+void get_shellitem_a(struct LIF_SHELLITEM * shi, struct LIF_SHELLITEM_A * shia)
+{
+  snprintf((char *)shia->Class, 6, "0x%.2"PRIX8, shi->Class);
+  switch (shi->Type)
+  {
+  case SHI_ROOT_FOLDER:
+    snprintf((char *)shia->Type, 40, "Root Folder");
+    break;
+  case SHI_VOLUME:
+    snprintf((char *)shia->Type, 40, "Volume");
+    break;
+  case SHI_FILE_ENTRY:
+    if (shi->Class & 0x01)
+      snprintf((char *)shia->Type, 40, "File Entry (Directory)");
+    else if (shi->Class & 0x02)
+      snprintf((char *)shia->Type, 40, "File Entry (File)");
+    else
+      snprintf((char *)shia->Type, 40, "File Entry");
+    break;
+  case SHI_NETWORK:
+    snprintf((char *)shia->Type, 40, "Network Location");
+    break;
+  case SHI_URI:
+    snprintf((char *)shia->Type, 40, "URI");
+    break;
+  default:
+    snprintf((char *)shia->Type, 40, "[UNKNOWN]");
+  }
+  if (shi->Type == SHI_ROOT_FOLDER)
+  {
+    snprintf((char *)shia->SortIndex, 6, "0x%.2"PRIX8, shi->SortIndex);
+  }
+  else
+  {
+    snprintf((char *)shia->SortIndex, 6, "[N/A]");
+  }
+  if ((shi->Type == SHI_ROOT_FOLDER) || (shi->FolderID.Data1 != 0))
+  {
+    get_droid_a(&shi->FolderID, &shia->FolderID);
+  }
+  else
+  {
+    snprintf((char *)shia->FolderID.UUID, 40, "[N/A]");
+    snprintf((char *)shia->FolderID.Name, 64, "[N/A]");
+  }
+  if (shi->Type == SHI_FILE_ENTRY)
+  {
+    snprintf((char *)shia->FileSize, 12, "%"PRIu32, shi->FileSize);
+    get_fattime_a(shi->ModDate, shi->ModTime, shia->ModTime);
+    snprintf((char *)shia->FileAttr, 10, "0x%.4"PRIX16, shi->FileAttr);
+  }
+  else
+  {
+    snprintf((char *)shia->FileSize, 12, "[N/A]");
+    snprintf((char *)shia->ModTime, 30, "[N/A]");
+    snprintf((char *)shia->FileAttr, 10, "[N/A]");
+  }
+  snprintf((char *)shia->Name, SHELLNAMESIZE, "%s", shi->Name);
+  snprintf((char *)shia->Description, SHELLNAMESIZE, "%s", shi->Description);
+  snprintf((char *)shia->Comments, SHELLNAMESIZE, "%s", shi->Comments);
+  if (shi->ExtVersion > 0)
+  {
+    snprintf((char *)shia->ExtVersion, 8, "%"PRIu16, shi->ExtVersion);
+    get_fattime_a(shi->CrDate, shi->CrTime, shia->CrTime);
+    get_fattime_a(shi->AcDate, shi->AcTime, shia->AcTime);
+    snprintf((char *)shia->LongName, SHELLNAMESIZE * 2, "%.*ls", SHELLNAMESIZE * 2 - 1, shi->LongName);
+  }
+  else
+  {
+    snprintf((char *)shia->ExtVersion, 8, "[N/A]");
+    snprintf((char *)shia->CrTime, 30, "[N/A]");
+    snprintf((char *)shia->AcTime, 30, "[N/A]");
+    shia->LongName[0] = 0;
+  }
+  if (shi->ExtVersion >= 7)
+  {
+    snprintf((char *)shia->MFTEntry, 24, "%"PRIu64, shi->MFTEntry);
+    snprintf((char *)shia->MFTSeq, 8, "%"PRIu16, shi->MFTSeq);
+  }
+  else
+  {
+    snprintf((char *)shia->MFTEntry, 24, "[N/A]");
+    snprintf((char *)shia->MFTSeq, 8, "[N/A]");
+  }
+}
+//
 // Fills a LIF_INFO structure with data
 // This includes filling the VolID and CNR structures (a lot of data, hence the
 // big function)
-int get_linkinfo(FILE * fp, int size, int pos, struct LIF * lif)
+int get_linkinfo(FILE * fp, int size, uint64_t base, int pos, struct LIF * lif)
 {
   unsigned char      size_buf[4];   //A small buffer to hold the size element
   unsigned char *    data_buf;
@@ -891,12 +1340,16 @@ int get_linkinfo(FILE * fp, int size, int pos, struct LIF * lif)
     {
       return -1;
     }
-    fseek(fp, pos, SEEK_SET);
+    lif_seek(fp, base + pos);
     for (i = 0; i < 4; i++) // Get the initial size
     {
       size_buf[i] = getc(fp);
     }
     lif->li.Size = get_le_uint32(size_buf, 0);
+    if (!(lif->Sections & LIF_SEC_LINKINFO)) // Not wanted, the size is enough to step over it
+    {
+      return 0;
+    }
     // The general idea here is to fill a temporary buffer with the characters
     // (rather than read the data directly) I then have control over reading the
     // data from the buffer as little/big endian or ANSI vs Unicode too.
@@ -1460,7 +1913,7 @@ int get_linkinfo_a(struct LIF_INFO *li, struct LIF_INFO_A *lia)
 //
 //Fills the LIF_STRINGDATA structure with the necessary data (converting
 //Unicode strings to ASCII if necessary)
-int get_stringdata(FILE * fp, int pos, struct LIF * lif)
+int get_stringdata(FILE * fp, uint64_t base, int pos, struct LIF * lif)
 {
   unsigned char      size_buf[2];   //A small buffer to hold the size element
   uint32_t           tsize = 0, str_size = 0;
@@ -1480,11 +1933,16 @@ int get_stringdata(FILE * fp, int pos, struct LIF * lif)
     {
       if (lif->lh.Flags & (0x00000004 << i))
       {
-        fseek(fp, (pos + (tsize)), SEEK_SET);
+        lif_seek(fp, base + pos + tsize);
         size_buf[0] = getc(fp);
         size_buf[1] = getc(fp);
         str_size = get_le_uint16(size_buf, 0);
         lif->lsd.CountChars[i] = str_size;
+        tsize += ((lif->lsd.CountChars[i] * 2) + 2);
+        if (!(lif->Sections & LIF_SEC_STRINGDATA)) // Only the sizes are wanted
+        {
+          continue;
+        }
         if (str_size > 299)
         {
           str_size = 299;
@@ -1497,8 +1955,6 @@ int get_stringdata(FILE * fp, int pos, struct LIF * lif)
         data_buf[(str_size * 2) + 1] = 0;
         get_le_unistr(data_buf, 0, str_size + 1, uni_buf);
         snprintf((char *)lif->lsd.Data[i], 300, "%ls", uni_buf);
-
-        tsize += ((lif->lsd.CountChars[i] * 2) + 2);
       }
     }
   }
@@ -1508,11 +1964,16 @@ int get_stringdata(FILE * fp, int pos, struct LIF * lif)
     {
       if (lif->lh.Flags & (0x00000004 << i))
       {
-        fseek(fp, (pos + (tsize)), SEEK_SET);
+        lif_seek(fp, base + pos + tsize);
         size_buf[0] = getc(fp);
         size_buf[1] = getc(fp);
         str_size = get_le_uint16(size_buf, 0);
         lif->lsd.CountChars[i] = str_size;
+        tsize += (lif->lsd.CountChars[i] + 2);
+        if (!(lif->Sections & LIF_SEC_STRINGDATA)) // Only the sizes are wanted
+        {
+          continue;
+        }
         if (str_size > 299)
         {
           str_size = 299;
@@ -1526,7 +1987,6 @@ int get_stringdata(FILE * fp, int pos, struct LIF * lif)
         {
           lif->lsd.Data[i][str_size] = 0;
         }
-        tsize += (lif->lsd.CountChars[i] + 2);
       }
     }
   }
@@ -1560,10 +2020,12 @@ int get_stringdata_a(struct LIF_STRINGDATA * lsd, struct LIF_STRINGDATA_A * lsda
 //
 //Fills the LIF_EXTRA_DATA structure with the necessary data (converting
 //Unicode strings to ASCII if necessary)
-int get_extradata(FILE * fp, int pos, struct LIF * lif)
+int get_extradata(FILE * fp, uint64_t base, int pos, struct LIF * lif)
 {
-  unsigned int       i = 0, j = 0, p = 0, vp = 0, posn = 0, offset = pos;
-  uint32_t           blocksize, blocksig, datasize;
+  unsigned int       i = 0, j = 0, p = 0, vp = 0, posn;
+  uint64_t           offset = base + pos;
+  uint32_t           blocksize, blocksig, datasize, skipped = 0;
+  enum EDTYPES       edtype;
   unsigned char      size_buf[4];   //A small buffer to hold the size element
   unsigned char      sig_buf[4];
   unsigned char      data_buf[4096];
@@ -1571,7 +2033,7 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
   led_setnull(&lif->led); //set all the extradata BlockSize and BlockSignature sections to 0 initially
   lif->led.edtypes = EMPTY;
 
-  fseek(fp, pos, SEEK_SET);
+  lif_seek(fp, offset);
   size_buf[0] = getc(fp);
   size_buf[1] = getc(fp);
   size_buf[2] = getc(fp);
@@ -1591,15 +2053,27 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
     sig_buf[2] = getc(fp);
     sig_buf[3] = getc(fp);
     blocksig = get_le_uint32(sig_buf, 0);
-    for (i = 0; i < datasize; i++)
+    edtype = get_edtype(blocksig);
+    if ((edtype != EMPTY) && !(lif->Sections & LIF_SEC_ED(edtype)))
     {
-      // data_buf holds just the data for this ExtraData Block
-      data_buf[i] = getc(fp);
+      // Not wanted, just note that it is present and jump over it
+      lif->led.edtypes |= edtype;
+      skipped += blocksize;
+      lif_seek(fp, offset + blocksize);
+      blocksig = 0;
+    }
+    else
+    {
+      for (i = 0; i < datasize; i++)
+      {
+        // data_buf holds just the data for this ExtraData Block
+        data_buf[i] = getc(fp);
+      }
     }
     switch (blocksig)
     {
     case 0xA0000001: // Signature for a EnvironmentVariableDataBlock S2.5.4
-      lif->led.lep.Posn = (uint16_t)offset;
+      lif->led.lep.Posn = offset;
       assert(blocksize == 0x00000314); // Spec states this MUST be the value
       lif->led.lep.Size = blocksize;
       lif->led.lep.sig = blocksig;
@@ -1611,7 +2085,7 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
       }
       break;
     case 0xA0000002: // Signature for a ConsoleDataBlock S2.5.1
-      lif->led.lcp.Posn = (uint16_t)offset;
+      lif->led.lcp.Posn = offset;
       assert(blocksize == 0x000000CC); // Spec states this MUST be the value
       lif->led.lcp.Size = blocksize;
       lif->led.lcp.sig = blocksig;
@@ -1651,14 +2125,14 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
       }
       break;
     case 0xA0000003: //Signature for a TrackerDataBlock S2.5.10
-      lif->led.ltp.Posn = (uint16_t)offset;
+      lif->led.ltp.Posn = offset;
       lif->led.ltp.Size = blocksize;
       lif->led.ltp.sig = blocksig;
       lif->led.edtypes += TRACKER_PROPS;
       get_ltp(&lif->led.ltp, data_buf);
       break;
     case 0xA0000004: // Signature for a ConsoleFEDataBlock S2.5.2
-      lif->led.lcfep.Posn = (uint16_t)offset;
+      lif->led.lcfep.Posn = offset;
       assert(blocksize == 0x0000000C); // Spec states this MUST be the value
       lif->led.lcfep.Size = blocksize;
       lif->led.lcfep.sig = blocksig;
@@ -1666,7 +2140,7 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
       lif->led.lcfep.CodePage = get_le_int32(data_buf, 0);
       break;
     case 0xA0000005: // Signature for a SpecialFolderDataBlock S2.5.9
-      lif->led.lsfp.Posn = (uint16_t)offset;
+      lif->led.lsfp.Posn = offset;
       lif->led.lsfp.Size = blocksize;
       lif->led.lsfp.sig = blocksig;
       lif->led.edtypes += SPECIAL_FOLDER_PROPS;
@@ -1674,7 +2148,7 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
       lif->led.lsfp.Offset = get_le_uint32(data_buf, 4);
       break;
     case 0xA0000006: // Signature for a DarwinDataBlock S2.5.3
-      lif->led.ldp.Posn = (uint16_t)offset;
+      lif->led.ldp.Posn = offset;
       assert(blocksize == 0x00000314); // Spec states this MUST be the value
       lif->led.ldp.Size = blocksize;
       lif->led.ldp.sig = blocksig;
@@ -1686,7 +2160,7 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
       }
       break;
     case 0xA0000007: // Signature for a IconEnvironmentDataBlock S2.5.5
-      lif->led.liep.Posn = (uint16_t)offset;
+      lif->led.liep.Posn = offset;
       assert(blocksize == 0x00000314); // Spec states this MUST be the value
       lif->led.liep.Size = blocksize;
       lif->led.liep.sig = blocksig;
@@ -1698,7 +2172,7 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
       }
       break;
     case 0xA0000008: // Signature for a ShimDataBlock S2.5.8
-      lif->led.lsp.Posn = (uint16_t)offset;
+      lif->led.lsp.Posn = offset;
       lif->led.lsp.Size = blocksize;
       lif->led.lsp.sig = blocksig;
       lif->led.edtypes += SHIM_PROPS;
@@ -1708,10 +2182,11 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
       }
       break;
     case 0xA0000009: // Signature for a PropertyStoreDataBlock S2.5.7
-      lif->led.lpsp.Posn = (uint16_t)offset;
+      lif->led.lpsp.Posn = offset;
       lif->led.lpsp.Size = blocksize;
       lif->led.lpsp.sig = blocksig;
       lif->led.edtypes += PROPERTY_STORE_PROPS;
+      posn = 0;
       for (i = 0; i < PROPSTORES; i++) // Cycle through all the valid property stores
       {
         lif->led.lpsp.Stores[i].NumValues = 0;
@@ -1778,21 +2253,17 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
         lif->led.lpsp.NumStores++;
       } //Cycle through the Propstores
       break;
-    case 0xA000000A: // Signature for a VistaAndAboveIDListDataBlock S2.5.11
-      lif->led.lvidlp.Posn = (uint16_t)offset;
+    case 0xA000000C: // Signature for a VistaAndAboveIDListDataBlock S2.5.11
+    case 0xA000000A: // (which older versions of liblife took it to be)
+      lif->led.lvidlp.Posn = offset;
       lif->led.lvidlp.Size = blocksize;
       lif->led.lvidlp.sig = blocksig;
-      lif->led.lvidlp.NumItemIDs = 0;
       lif->led.edtypes += VISTA_AND_ABOVE_IDLIST_PROPS;
-      while (posn < (lif->led.lvidlp.Size - 8))
-      {
-        i = get_le_uint16(data_buf, posn);
-        posn += i;
-        lif->led.lvidlp.NumItemIDs++;
-      }
+      // The IDList follows the signature, decode it in place
+      get_itemids(data_buf, datasize, offset + 8, lif->led.lvidlp.Items, &lif->led.lvidlp.NumItemIDs);
       break;
     case 0xA000000B: // Signature for a KnownFolderDataBlock S2.5.6
-      lif->led.lkfp.Posn = (uint16_t)offset;
+      lif->led.lkfp.Posn = offset;
       lif->led.lkfp.Size = blocksize;
       lif->led.lkfp.sig = blocksig;
       lif->led.edtypes += KNOWN_FOLDER_PROPS;
@@ -1827,15 +2298,17 @@ int get_extradata(FILE * fp, int pos, struct LIF * lif)
     lif->led.lsfp.Size +
     lif->led.ltp.Size +
     lif->led.lvidlp.Size +
+    skipped +
     4;
   return lif->led.Size;
 }
 //
 //Function get_extradata_a(struct LIF_EXTRA_DATA*, struct LIF_EXTRA_DATA_A)
 //copies the strings and creates an ASCII representation of the data.
-int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
+int get_extradata_a(struct LIF_EXTRA_DATA * led, uint32_t sections, struct LIF_EXTRA_DATA_A * leda)
 {
   int       i;
+  uint32_t  decoded = led->edtypes & (sections >> 8); // The blocks that are present AND were decoded
 
   snprintf((char *)leda->Size, 10, "%"PRIu32, led->Size);
   leda->edtypes[0] = (char)0;
@@ -1843,7 +2316,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & CONSOLE_PROPS)
   {
     strcat((char *)leda->edtypes, "CONSOLE_PROPS | ");
-    snprintf((char *)leda->lcpa.Posn, 8, "%"PRIu16, led->lcp.Posn);
+  }
+  if (decoded & CONSOLE_PROPS)
+  {
+    snprintf((char *)leda->lcpa.Posn, 24, "%"PRIu64, led->lcp.Posn);
     snprintf((char *)leda->lcpa.Size, 10, "%"PRIu32, led->lcp.Size);
     snprintf((char *)leda->lcpa.sig, 12, "0x%.8"PRIX32, led->lcp.sig);
     snprintf((char *)leda->lcpa.FillAttributes, 8, "0x%.4"PRIX16, led->lcp.FillAttributes);
@@ -1877,7 +2353,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->lcpa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lcpa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lcpa.Size, 10, "[N/A]");
     snprintf((char *)leda->lcpa.sig, 12, "[N/A]");
     snprintf((char *)leda->lcpa.FillAttributes, 8, "[N/A]");
@@ -1912,14 +2388,17 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & CONSOLE_FE_PROPS)
   {
     strcat((char *)leda->edtypes, "CONSOLE_FE_PROPS | ");
-    snprintf((char *)leda->lcfepa.Posn, 8, "%"PRIu16, led->lcfep.Posn);
+  }
+  if (decoded & CONSOLE_FE_PROPS)
+  {
+    snprintf((char *)leda->lcfepa.Posn, 24, "%"PRIu64, led->lcfep.Posn);
     snprintf((char *)leda->lcfepa.Size, 10, "%"PRIu32, led->lcfep.Size);
     snprintf((char *)leda->lcfepa.sig, 12, "0x%.8"PRIX32, led->lcfep.sig);
     snprintf((char *)leda->lcfepa.CodePage, 12, "0x%.8"PRIX32, led->lcfep.CodePage);
   }
   else
   {
-    snprintf((char *)leda->lcfepa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lcfepa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lcfepa.Size, 10, "[N/A]");
     snprintf((char *)leda->lcfepa.sig, 12, "[N/A]");
     snprintf((char *)leda->lcfepa.CodePage, 12, "[N/A]");
@@ -1928,7 +2407,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & DARWIN_PROPS)
   {
     strcat((char *)leda->edtypes, "DARWIN_PROPS | ");
-    snprintf((char *)leda->ldpa.Posn, 8, "%"PRIu16, led->ldp.Posn);
+  }
+  if (decoded & DARWIN_PROPS)
+  {
+    snprintf((char *)leda->ldpa.Posn, 24, "%"PRIu64, led->ldp.Posn);
     snprintf((char *)leda->ldpa.Size, 10, "%"PRIu32, led->ldp.Size);
     snprintf((char *)leda->ldpa.sig, 12, "0x%.8"PRIX32, led->ldp.sig);
     snprintf((char *)leda->ldpa.DarwinDataAnsi, 260, "%s", led->ldp.DarwinDataAnsi);
@@ -1936,7 +2418,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->ldpa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->ldpa.Posn, 24, "[N/A]");
     snprintf((char *)leda->ldpa.Size, 10, "[N/A]");
     snprintf((char *)leda->ldpa.sig, 12, "[N/A]");
     snprintf((char *)leda->ldpa.DarwinDataAnsi, 260, "[N/A]");
@@ -1946,7 +2428,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & ENVIRONMENT_PROPS)
   {
     strcat((char *)leda->edtypes, "ENVIRONMENT_PROPS | ");
-    snprintf((char *)leda->lepa.Posn, 8, "%"PRIu16, led->lep.Posn);
+  }
+  if (decoded & ENVIRONMENT_PROPS)
+  {
+    snprintf((char *)leda->lepa.Posn, 24, "%"PRIu64, led->lep.Posn);
     snprintf((char *)leda->lepa.Size, 10, "%"PRIu32, led->lep.Size);
     snprintf((char *)leda->lepa.sig, 12, "0x%.8"PRIX32, led->lep.sig);
     snprintf((char *)leda->lepa.TargetAnsi, 260, "%s", led->lep.TargetAnsi);
@@ -1954,7 +2439,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->lepa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lepa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lepa.Size, 10, "[N/A]");
     snprintf((char *)leda->lepa.sig, 12, "[N/A]");
     snprintf((char *)leda->lepa.TargetAnsi, 260, "[N/A]");
@@ -1964,7 +2449,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & ICON_ENVIRONMENT_PROPS)
   {
     strcat((char *)leda->edtypes, "ICON_ENVIRONMENT_PROPS | ");
-    snprintf((char *)leda->liepa.Posn, 8, "%"PRIu16, led->liep.Posn);
+  }
+  if (decoded & ICON_ENVIRONMENT_PROPS)
+  {
+    snprintf((char *)leda->liepa.Posn, 24, "%"PRIu64, led->liep.Posn);
     snprintf((char *)leda->liepa.Size, 10, "%"PRIu32, led->liep.Size);
     snprintf((char *)leda->liepa.sig, 12, "0x%.8"PRIX32, led->liep.sig);
     snprintf((char *)leda->liepa.TargetAnsi, 260, "%s", led->liep.TargetAnsi);
@@ -1972,7 +2460,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->liepa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->liepa.Posn, 24, "[N/A]");
     snprintf((char *)leda->liepa.Size, 10, "[N/A]");
     snprintf((char *)leda->liepa.sig, 12, "[N/A]");
     snprintf((char *)leda->liepa.TargetAnsi, 260, "[N/A]");
@@ -1982,7 +2470,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & KNOWN_FOLDER_PROPS)
   {
     strcat((char *)leda->edtypes, "KNOWN_FOLDER_PROPS | ");
-    snprintf((char *)leda->lkfpa.Posn, 8, "%"PRIu16, led->lkfp.Posn);
+  }
+  if (decoded & KNOWN_FOLDER_PROPS)
+  {
+    snprintf((char *)leda->lkfpa.Posn, 24, "%"PRIu64, led->lkfp.Posn);
     snprintf((char *)leda->lkfpa.Size, 10, "%"PRIu32, led->lkfp.Size);
     snprintf((char *)leda->lkfpa.sig, 12, "0x%.8"PRIX32, led->lkfp.sig);
     get_droid_a(&led->lkfp.KFGUID, &leda->lkfpa.KFGUID);
@@ -1990,10 +2481,11 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->lkfpa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lkfpa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lkfpa.Size, 10, "[N/A]");
     snprintf((char *)leda->lkfpa.sig, 10, "[N/A]");
     snprintf((char *)leda->lkfpa.KFGUID.UUID, 40, "[N/A]");
+    snprintf((char *)leda->lkfpa.KFGUID.Name, 64, "[N/A]");
     snprintf((char *)leda->lkfpa.KFGUID.Version, 40, "[N/A]");
     snprintf((char *)leda->lkfpa.KFGUID.Variant, 40, "[N/A]");
     snprintf((char *)leda->lkfpa.KFGUID.Time, 30, "[N/A]");
@@ -2005,7 +2497,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & PROPERTY_STORE_PROPS)
   {
     strcat((char *)leda->edtypes, "PROPERTY_STORE_PROPS | ");
-    snprintf((char *)leda->lpspa.Posn, 8, "%"PRIu16, led->lpsp.Posn);
+  }
+  if (decoded & PROPERTY_STORE_PROPS)
+  {
+    snprintf((char *)leda->lpspa.Posn, 24, "%"PRIu64, led->lpsp.Posn);
     snprintf((char *)leda->lpspa.Size, 10, "%"PRIu32, led->lpsp.Size);
     snprintf((char *)leda->lpspa.sig, 12, "0x%.8"PRIX32, led->lpsp.sig);
     snprintf((char *)leda->lpspa.NumStores, 10, "%"PRIi32, led->lpsp.NumStores);
@@ -2016,7 +2511,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->lpspa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lpspa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lpspa.Size, 10, "[N/A]");
     snprintf((char *)leda->lpspa.sig, 10, "[N/A]");
     snprintf((char *)leda->lpspa.NumStores, 10, "[N/A]");
@@ -2025,14 +2520,17 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & SHIM_PROPS)
   {
     strcat((char *)leda->edtypes, "SHIM_PROPS | ");
-    snprintf((char *)leda->lspa.Posn, 8, "%"PRIu16, led->lsp.Posn);
+  }
+  if (decoded & SHIM_PROPS)
+  {
+    snprintf((char *)leda->lspa.Posn, 24, "%"PRIu64, led->lsp.Posn);
     snprintf((char *)leda->lspa.Size, 10, "%"PRIu32, led->lsp.Size);
     snprintf((char *)leda->lspa.sig, 12, "0x%.8"PRIX32, led->lsp.sig);
     snprintf((char *)leda->lspa.LayerName, 600, "%ls", led->lsp.LayerName);
   }
   else
   {
-    snprintf((char *)leda->lspa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lspa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lspa.Size, 10, "[N/A]");
     snprintf((char *)leda->lspa.sig, 10, "[N/A]");
     snprintf((char *)leda->lspa.LayerName, 600, "[N/A]");
@@ -2041,7 +2539,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & SPECIAL_FOLDER_PROPS)
   {
     strcat((char *)leda->edtypes, "SPECIAL_FOLDER_PROPS | ");
-    snprintf((char *)leda->lsfpa.Posn, 8, "%"PRIu16, led->lsfp.Posn);
+  }
+  if (decoded & SPECIAL_FOLDER_PROPS)
+  {
+    snprintf((char *)leda->lsfpa.Posn, 24, "%"PRIu64, led->lsfp.Posn);
     snprintf((char *)leda->lsfpa.Size, 10, "%"PRIu32, led->lsfp.Size);
     snprintf((char *)leda->lsfpa.sig, 12, "0x%.8"PRIX32, led->lsfp.sig);
     snprintf((char *)leda->lsfpa.SpecialFolderID, 10, "%"PRIu32, led->lsfp.SpecialFolderID);
@@ -2049,7 +2550,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->lsfpa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lsfpa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lsfpa.Size, 10, "[N/A]");
     snprintf((char *)leda->lsfpa.sig, 10, "[N/A]");
     snprintf((char *)leda->lsfpa.SpecialFolderID, 10, "[N/A]");
@@ -2059,7 +2560,10 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & TRACKER_PROPS)
   {
     strcat((char *)leda->edtypes, "TRACKER_PROPS | ");
-    snprintf((char *)leda->ltpa.Posn, 8, "%"PRIu16, led->ltp.Posn);
+  }
+  if (decoded & TRACKER_PROPS)
+  {
+    snprintf((char *)leda->ltpa.Posn, 24, "%"PRIu64, led->ltp.Posn);
     snprintf((char *)leda->ltpa.Size, 10, "%"PRIu32, led->ltp.Size);
     snprintf((char *)leda->ltpa.sig, 12, "0x%.8"PRIX32, led->ltp.sig);
     snprintf((char *)leda->ltpa.Length, 10, "%"PRIu32, led->ltp.Length);
@@ -2072,13 +2576,14 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   }
   else
   {
-    snprintf((char *)leda->ltpa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->ltpa.Posn, 24, "[N/A]");
     snprintf((char *)leda->ltpa.Size, 10, "[N/A]");
     snprintf((char *)leda->ltpa.sig, 10, "[N/A]");
     snprintf((char *)leda->ltpa.Length, 10, "[N/A]");
     snprintf((char *)leda->ltpa.Version, 10, "[N/A]");
     snprintf((char *)leda->ltpa.MachineID, 17, "[N/A]");
     snprintf((char *)leda->ltpa.Droid1.UUID, 40, "[N/A]");
+    snprintf((char *)leda->ltpa.Droid1.Name, 64, "[N/A]");
     snprintf((char *)leda->ltpa.Droid1.Version, 40, "[N/A]");
     snprintf((char *)leda->ltpa.Droid1.Variant, 40, "[N/A]");
     snprintf((char *)leda->ltpa.Droid1.Time, 30, "[N/A]");
@@ -2086,6 +2591,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
     snprintf((char *)leda->ltpa.Droid1.ClockSeq, 10, "[N/A]");
     snprintf((char *)leda->ltpa.Droid1.Node, 20, "[N/A]");
     snprintf((char *)leda->ltpa.Droid2.UUID, 40, "[N/A]");
+    snprintf((char *)leda->ltpa.Droid2.Name, 64, "[N/A]");
     snprintf((char *)leda->ltpa.Droid2.Version, 40, "[N/A]");
     snprintf((char *)leda->ltpa.Droid2.Variant, 40, "[N/A]");
     snprintf((char *)leda->ltpa.Droid2.Time, 30, "[N/A]");
@@ -2093,6 +2599,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
     snprintf((char *)leda->ltpa.Droid2.ClockSeq, 10, "[N/A]");
     snprintf((char *)leda->ltpa.Droid2.Node, 20, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth1.UUID, 40, "[N/A]");
+    snprintf((char *)leda->ltpa.DroidBirth1.Name, 64, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth1.Version, 40, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth1.Variant, 40, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth1.Time, 30, "[N/A]");
@@ -2100,6 +2607,7 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
     snprintf((char *)leda->ltpa.DroidBirth1.ClockSeq, 10, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth1.Node, 20, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth2.UUID, 40, "[N/A]");
+    snprintf((char *)leda->ltpa.DroidBirth2.Name, 64, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth2.Version, 40, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth2.Variant, 40, "[N/A]");
     snprintf((char *)leda->ltpa.DroidBirth2.Time, 30, "[N/A]");
@@ -2111,14 +2619,18 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   if (led->edtypes & VISTA_AND_ABOVE_IDLIST_PROPS)
   {
     strcat((char *)leda->edtypes, "VISTA_AND_ABOVE_IDLIST_PROPS | ");
-    snprintf((char *)leda->lvidlpa.Posn, 8, "%"PRIu16, led->lvidlp.Posn);
+  }
+  if (decoded & VISTA_AND_ABOVE_IDLIST_PROPS)
+  {
+    snprintf((char *)leda->lvidlpa.Posn, 24, "%"PRIu64, led->lvidlp.Posn);
     snprintf((char *)leda->lvidlpa.Size, 10, "%"PRIu32, led->lvidlp.Size);
     snprintf((char *)leda->lvidlpa.sig, 12, "0x%.8"PRIX32, led->lvidlp.sig);
     snprintf((char *)leda->lvidlpa.NumItemIDs, 10, "%"PRIu32, led->lvidlp.NumItemIDs);
+    get_itemids_a(led->lvidlp.Items, led->lvidlp.NumItemIDs, leda->lvidlpa.Items);
   }
   else
   {
-    snprintf((char *)leda->lvidlpa.Posn, 8, "[N/A]");
+    snprintf((char *)leda->lvidlpa.Posn, 24, "[N/A]");
     snprintf((char *)leda->lvidlpa.Size, 10, "[N/A]");
     snprintf((char *)leda->lvidlpa.sig, 12, "[N/A]");
     snprintf((char *)leda->lvidlpa.NumItemIDs, 10, "[N/A]");
@@ -2140,135 +2652,135 @@ int get_extradata_a(struct LIF_EXTRA_DATA * led, struct LIF_EXTRA_DATA_A * leda)
   return 0;
 }
 //
-//Function get_attr_a(char *attr_str, struct LIF_HDR *lh) converts the
-//attributes in the LIF header to a readable string
-void get_flag_a(unsigned char *flag_str, struct LIF_HDR *lh)
+//The names of the header flags (MS-SHLLINK Sec 2.1.1) & file attributes
+//(Sec 2.1.2) in the order they are printed
+static const struct LIF_BIT_NAME lif_flag_names[] =
 {
-  sprintf((char *)flag_str, " ");
+  LIF_BIT(0x1, "HasLinkTargetIDList"),
+  LIF_BIT(0x2, "HasLinkInfo"),
+  LIF_BIT(0x4, "HasName"),
+  LIF_BIT(0x8, "HasRelativePath"),
+  LIF_BIT(0x10, "HasWorkingDir"),
+  LIF_BIT(0x20, "HasArguments"),
+  LIF_BIT(0x40, "HasIconLocation"),
+  LIF_BIT(0x80, "IsUnicode"),
+  LIF_BIT(0x100, "ForceNoLinkInfo"),
+  LIF_BIT(0x200, "HasExpString"),
+  LIF_BIT(0x400, "RunInSeparateProcess"),
+  LIF_BIT(0x800, "Unused1"),
+  LIF_BIT(0x1000, "HasDarwinID"),
+  LIF_BIT(0x2000, "RunAsUser"),
+  LIF_BIT(0x4000, "HasExpIcon"),
+  LIF_BIT(0x8000, "NoPidlAlias"),
+  LIF_BIT(0x10000, "Unused2"),
+  LIF_BIT(0x20000, "RunWithShimLayer"),
+  LIF_BIT(0x40000, "ForceNoLinkTrack"),
+  LIF_BIT(0x80000, "EnableTargetMetadata"),
+  LIF_BIT(0x100000, "DisableLinkPathTracking"),
+  LIF_BIT(0x200000, "DisableKnownFolderTracking"),
+  LIF_BIT(0x400000, "DisableKnownFolderAlias"),
+  LIF_BIT(0x800000, "AllowLinkToLink"),
+  LIF_BIT(0x1000000, "UnaliasOnSave"),
+  LIF_BIT(0x2000000, "PreferEnvironmentPath"),
+  LIF_BIT(0x4000000, "KeepLocalIDListForUNCTarget")
+};
+static const struct LIF_BIT_NAME lif_attr_names[] =
+{
+  LIF_BIT(0x1, "FILE_ATTRIBUTE_READONLY"),
+  LIF_BIT(0x2, "FILE_ATTRIBUTE_HIDDEN"),
+  LIF_BIT(0x4, "FILE_ATTRIBUTE_SYSTEM"),
+  LIF_BIT(0x10, "FILE_ATTRIBUTE_DIRECTORY"),
+  LIF_BIT(0x20, "FILE_ATTRIBUTE_ARCHIVE"),
+  // There is something wrong with the link file if 0x40 is set
+  // According to MS-SHLLINK S.2.1.2 G
+  LIF_BIT(0x40, "Reserved2"),
+  // FILE_ATTRIBUTE_NORMAL (0x80) can't be set with others (see get_attr_a())
+  LIF_BIT(0x100, "FILE_ATTRIBUTE_TEMPORARY"),
+  LIF_BIT(0x200, "FILE_ATTRIBUTE_SPARSE_FILE"),
+  LIF_BIT(0x400, "FILE_ATTRIBUTE_REPARSE_POINT"),
+  LIF_BIT(0x800, "FILE_ATTRIBUTE_COMPRESSED"),
+  LIF_BIT(0x1000, "FILE_ATTRIBUTE_OFFLINE"),
+  LIF_BIT(0x2000, "FILE_ATTRIBUTE_NOT_CONTENT_INDEXED"),
+  LIF_BIT(0x4000, "FILE_ATTRIBUTE_ENCRYPTED")
+};
+#define LIF_NUMFLAGS (int)(sizeof(lif_flag_names) / sizeof(lif_flag_names[0]))
+#define LIF_NUMATTRS (int)(sizeof(lif_attr_names) / sizeof(lif_attr_names[0]))
+//
+//Function put_bits_a(char *out, size_t size, uint32_t value, ...) writes the
+//names of the bits set in value, separated by " | ", to out (which has room
+//for 'size' characters including the terminating 0). Returns the length.
+size_t put_bits_a(char *out, size_t size, uint32_t value, const struct LIF_BIT_NAME *names, int n)
+{
+  size_t len = 0;
+  int i;
 
-  //check for the states that are constant
-  if (lh->Attr == 0) //No attributes set
+  for (i = 0; i < n; i++)
+  {
+    if ((value & names[i].Bit) && (len + names[i].Len < size))
+    {
+      memcpy(out + len, names[i].Name, names[i].Len);
+      len += names[i].Len;
+    }
+  }
+  if (len > 0)
+  {
+    len -= 3; // Remove the last space,pipe,space combination
+  }
+  out[len] = (char)0;
+  return len;
+}
+//
+//Function get_flag_a(unsigned char *flags, size_t size, struct LIF_HDR *lh,
+//uint32_t opts) writes the flags in the LIF header as a bit mask followed
+//(unless opts has LIF_A_NUMERIC) by their names
+void get_flag_a(unsigned char *flags, size_t size, struct LIF_HDR *lh, uint32_t opts)
+{
+  int n;
+
+  n = snprintf((char *)flags, size, "0x%.8"PRIX32, lh->Flags);
+  if ((opts & LIF_A_NUMERIC) || (n < 0) || ((size_t)n + 4 > size))
   {
-    sprintf((char *)flag_str, "NONE");
     return;
   }
-  if (lh->Flags & 0x1)
-    strcat((char *)flag_str, "HasLinkTargetIDList | ");
-  if (lh->Flags & 0x2)
-    strcat((char *)flag_str, "HasLinkInfo | ");
-  if (lh->Flags & 0x4)
-    strcat((char *)flag_str, "HasName | ");
-  if (lh->Flags & 0x8)
-    strcat((char *)flag_str, "HasRelativePath | ");
-  if (lh->Flags & 0x10)
-    strcat((char *)flag_str, "HasWorkingDir | ");
-  if (lh->Flags & 0x20)
-    strcat((char *)flag_str, "HasArguments | ");
-  if (lh->Flags & 0x40)
-    strcat((char *)flag_str, "HasIconLocation | ");
-  if (lh->Flags & 0x80)
-    strcat((char *)flag_str, "IsUnicode | ");
-  if (lh->Flags & 0x100)
-    strcat((char *)flag_str, "ForceNoLinkInfo | ");
-  if (lh->Flags & 0x200)
-    strcat((char *)flag_str, "HasExpString | ");
-  if (lh->Flags & 0x400)
-    strcat((char *)flag_str, "RunInSeparateProcess | ");
-  if (lh->Flags & 0x800)
-    strcat((char *)flag_str, "Unused1 | ");
-  if (lh->Flags & 0x1000)
-    strcat((char *)flag_str, "HasDarwinID | ");
-  if (lh->Flags & 0x2000)
-    strcat((char *)flag_str, "RunAsUser | ");
-  if (lh->Flags & 0x4000)
-    strcat((char *)flag_str, "HasExpIcon | ");
-  if (lh->Flags & 0x8000)
-    strcat((char *)flag_str, "NoPidlAlias | ");
-  if (lh->Flags & 0x10000)
-    strcat((char *)flag_str, "Unused2 | ");
-  if (lh->Flags & 0x20000)
-    strcat((char *)flag_str, "RunWithShimLayer | ");
-  if (lh->Flags & 0x40000)
-    strcat((char *)flag_str, "ForceNoLinkTrack | ");
-  if (lh->Flags & 0x80000)
-    strcat((char *)flag_str, "EnableTargetMetadata | ");
-  if (lh->Flags & 0x100000)
-    strcat((char *)flag_str, "DisableLinkPathTracking | ");
-  if (lh->Flags & 0x200000)
-    strcat((char *)flag_str, "DisableKnownFolderTracking | ");
-  if (lh->Flags & 0x400000)
-    strcat((char *)flag_str, "DisableKnownFolderAlias | ");
-  if (lh->Flags & 0x800000)
-    strcat((char *)flag_str, "AllowLinkToLink | ");
-  if (lh->Flags & 0x1000000)
-    strcat((char *)flag_str, "UnaliasOnSave | ");
-  if (lh->Flags & 0x2000000)
-    strcat((char *)flag_str, "PreferEnvironmentPath | ");
-  if (lh->Flags & 0x4000000)
-    strcat((char *)flag_str, "KeepLocalIDListForUNCTarget | ");
-
-  if (strlen((char *)flag_str) > 0)
-    flag_str[strlen((char *)flag_str) - 3] = (unsigned char)0;
-  return;
+  //NONE is printed when there are no attributes (not flags) as it always has been
+  if (lh->Attr == 0)
+  {
+    snprintf((char *)flags + n, size - n, "  NONE");
+    return;
+  }
+  memcpy(flags + n, "   ", 3);
+  put_bits_a((char *)flags + n + 3, size - n - 3, lh->Flags, lif_flag_names, LIF_NUMFLAGS);
 }
 //
-//Function get_attr_a(char *attr_str, struct LIF_HDR *lh) converts the
-//attributes in the LIF header to a readable string
-void get_attr_a(unsigned char *attr_str, struct LIF_HDR *lh)
+//Function get_attr_a(unsigned char *attr, size_t size, struct LIF_HDR *lh,
+//uint32_t opts) writes the file attributes in the LIF header as a bit mask
+//followed (unless opts has LIF_A_NUMERIC) by their names
+void get_attr_a(unsigned char *attr, size_t size, struct LIF_HDR *lh, uint32_t opts)
 {
-  sprintf((char *)attr_str, " ");
+  int n;
 
+  n = snprintf((char *)attr, size, "0x%.8"PRIX32, lh->Attr);
+  if ((opts & LIF_A_NUMERIC) || (n < 0) || ((size_t)n + 4 > size))
+  {
+    return;
+  }
   //check for the states that are constant
   if (lh->Attr == 0) //No attributes set
   {
-    sprintf((char *)attr_str, "NONE");
+    snprintf((char *)attr + n, size - n, "  NONE");
     return;
   }
   if (lh->Attr == 0x80) //'NORMAL attribute set - no others allowed
   {
-    sprintf((char *)attr_str, "FILE_ATTRIBUTE_NORMAL");
+    snprintf((char *)attr + n, size - n, "  FILE_ATTRIBUTE_NORMAL");
     return;
   }
-  if (lh->Attr & 0x1)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_READONLY | ");
-  if (lh->Attr & 0x2)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_HIDDEN | ");
-  if (lh->Attr & 0x4)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_SYSTEM | ");
-  if (lh->Attr & 0x10)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_DIRECTORY | ");
-  if (lh->Attr & 0x20)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_ARCHIVE | ");
-  if (lh->Attr & 0x40)
-    // There is something wrong with the link file if we are here
-    // According to MS-SHLLINK S.2.1.2 G
-    strcat((char *)attr_str, "Reserved2 | ");
-  // FILE_ATTRIBUTE_NORMAL (0x80) is dealt with above
-  if (lh->Attr & 0x100)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_TEMPORARY | ");
-  if (lh->Attr & 0x200)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_SPARSE_FILE | ");
-  if (lh->Attr & 0x400)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_REPARSE_POINT | ");
-  if (lh->Attr & 0x800)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_COMPRESSED | ");
-  if (lh->Attr & 0x1000)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_OFFLINE | ");
-  if (lh->Attr & 0x2000)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_NOT_CONTENT_INDEXED | ");
-  if (lh->Attr & 0x4000)
-    strcat((char *)attr_str, "FILE_ATTRIBUTE_ENCRYPTED | ");
-  if (strlen((char *)attr_str) > 3)
-  {
-    // Remove the last space,pipe,space combination
-    attr_str[strlen((char *)attr_str) - 3] = (unsigned char)0;
-  }
-  else
+  memcpy(attr + n, "   ", 3);
+  if (put_bits_a((char *)attr + n + 3, size - n - 3, lh->Attr, lif_attr_names, LIF_NUMATTRS) == 0)
   {
     //The only way to get here is to have an unrecognised file attribute
-    sprintf((char *)attr_str, "[UNKNOWN FILE ATTRIBUTE]");
+    snprintf((char *)attr + n, size - n, "  [UNKNOWN FILE ATTRIBUTE]");
   }
-  return;
 }
 //
 //Function get_le_ulong_int(unsigned char *, int pos) reads 4 unsigned
@@ -2385,12 +2897,23 @@ int16_t get_le_int16(unsigned char buf[], int pos)
 //ISO 8601 specification (i.e. 'yyyy-mm-dd hh:mm:ss')
 }
 //
+//Function lif_gmtime(const time_t * t, struct tm * tms) is gmtime() into the
+//caller's struct tm, so that links can be converted in more than one thread
+void lif_gmtime(const time_t * t, struct tm * tms)
+{
+#ifdef _WIN32
+  gmtime_s(tms, t);
+#else
+  gmtime_r(t, tms);
+#endif
+}
+//
 //Function get_filetime_a_short(struct FILETIME ft) returns the character string
 //representation of the Filetime passed in ft. The output is as per the
 //ISO 8601 specification (i.e. 'yyyy-mm-dd hh:mm:ss')
 void get_filetime_a_short(int64_t ft, unsigned char result[])
 {
-  struct tm* tms;
+  struct tm tms;
   time_t time;
   int64_t epoch_diff = 11644473600LL, cns2sec = 10000000L;
 
@@ -2400,8 +2923,8 @@ void get_filetime_a_short(int64_t ft, unsigned char result[])
   if ((sizeof(time_t) == sizeof(int64_t)) && ((ft > 0) && (ft < 0x7FFFFFFFL)))
   {
     time = (time_t)ft;
-    tms = gmtime(&time);
-    strftime((char *)result, 29, "%Y-%m-%d %H:%M:%S (UTC)", tms);
+    lif_gmtime(&time, &tms);
+    strftime((char *)result, 29, "%Y-%m-%d %H:%M:%S (UTC)", &tms);
   }
   //Can't cope with large time_t values
   else if (ft == -11644473600LL)
@@ -2419,7 +2942,7 @@ void get_filetime_a_short(int64_t ft, unsigned char result[])
 //ISO 8601 specification (i.e. 'yyyy-mm-dd hh:mm:ss.sssssss')
 void get_filetime_a_long(int64_t ft, unsigned char result[])
 {
-  struct tm* tms;
+  struct tm tms;
   time_t time;
   uint64_t cns; //100 nanosecond component
   int64_t epoch_diff = 11644473600LL, cns2sec = 10000000;
@@ -2431,8 +2954,8 @@ void get_filetime_a_long(int64_t ft, unsigned char result[])
   if ((sizeof(time_t) == sizeof(int64_t)) && ((ft > 0) && (ft < 0x7FFFFFFFL)))
   {
     time = (time_t)ft;
-    tms = gmtime(&time);
-    strftime((char *)interim, 29, "%Y-%m-%d %H:%M:%S", tms);
+    lif_gmtime(&time, &tms);
+    strftime((char *)interim, 29, "%Y-%m-%d %H:%M:%S", &tms);
     snprintf((char *)result, 40, "%s.%"PRIu64" (UTC)", interim, cns);
   }
   //Can't cope with large time_t values
@@ -2459,18 +2982,58 @@ void get_chars(unsigned char buf[], int pos, int num, unsigned char targ[])
   }
 }
 //
+//Function get_ansistr(unsigned char buf[], int pos, int end, unsigned char targ[], int max)
+//Copies a null terminated ANSI string from buf (starting at pos and not
+//reading at or beyond 'end') into targ, which is 'max' bytes long. The
+//return value is the position just past the string's null terminator.
+int get_ansistr(unsigned char buf[], int pos, int end, unsigned char targ[], int max)
+{
+  int i = 0;
+
+  while ((pos < end) && (buf[pos] != 0))
+  {
+    if (i < (max - 1))
+    {
+      targ[i++] = buf[pos];
+    }
+    pos++;
+  }
+  targ[i] = 0;
+  return pos + 1;
+}
+//
+//Function get_fattime_a(uint16_t fdate, uint16_t ftime, unsigned char result[])
+//Converts an MS-DOS (FAT) date and time, as used in shell items, into a
+//string of the form 'YYYY-MM-DD HH:MM:SS'
+void get_fattime_a(uint16_t fdate, uint16_t ftime, unsigned char result[])
+{
+  if ((fdate == 0) && (ftime == 0))
+  {
+    snprintf((char *)result, 30, "[NOT SET]");
+    return;
+  }
+  snprintf((char *)result, 30, "%.4u-%.2u-%.2u %.2u:%.2u:%.2u",
+    (unsigned int)(fdate >> 9) + 1980, (unsigned int)(fdate >> 5) & 0x0F, (unsigned int)fdate & 0x1F,
+    (unsigned int)(ftime >> 11), (unsigned int)(ftime >> 5) & 0x3F, ((unsigned int)ftime & 0x1F) * 2);
+}
+//
 //Function get_le_unistr(unsigned char buf[], int pos, int max, wchar_t targ[])
 //Fetches a unicode string from buf starting at position pos. It quits when a
 //(wchar_t) 0 is encountered or max (in whchar_t terms) characters are copied.
 //The encoding is considered to be the Windows default (little endian)
 //The result is placed in targ. The function returns the number of wchar_t
-//characters that have been copied or -1 on failure.
+//characters that have been copied or -1 on failure. If max is less than 1
+//there is no room even for the terminator and targ is not touched.
 int get_le_unistr(unsigned char buf[], int pos, int max, wchar_t targ[])
 {
   int i, n = 0;
   uint16_t widechar;
   unsigned char temp_buf[2];
 
+  if (max < 1)
+  {
+    return 0;
+  }
   for (i = 0; i < (max - 1); i++)
   {
     temp_buf[0] = buf[((i * 2) + pos)];
@@ -2554,8 +3117,9 @@ void get_ltp(struct LIF_TRACKER_PROPS * ltp, unsigned char * data_buf)
 void get_droid_a(struct LIF_CLSID * droid, struct LIF_CLSID_A * droid_a)
 {
   uint8_t  Version, Variant;
-  int16_t Timehi, ClockSeq;
+  int16_t ClockSeq;
   int64_t Time;
+  const char * name;
   // Build the UUID string
   snprintf((char *)droid_a->UUID, 40, "{%.8"PRIX32"-%.4"PRIX16"-%.4"PRIX16"-%.2"PRIX8"%.2"PRIX8"-%.2"PRIX8"%.2"PRIX8"%.2"PRIX8"%.2"PRIX8"%.2"PRIX8"%.2"PRIX8"}",
     droid->Data1,
@@ -2569,6 +3133,14 @@ void get_droid_a(struct LIF_CLSID * droid, struct LIF_CLSID_A * droid_a)
     droid->Data4lo[3],
     droid->Data4lo[4],
     droid->Data4lo[5]);
+  if ((name = get_guid_name(droid)) != NULL)
+  {
+    snprintf((char *)droid_a->Name, 64, "%s", name);
+  }
+  else
+  {
+    snprintf((char *)droid_a->Name, 64, "[UNKNOWN]");
+  }
 
   // Work out the Version Number
   Version = (uint8_t)((droid->Data3 & 0xF000) >> 12);
@@ -2621,16 +3193,7 @@ void get_droid_a(struct LIF_CLSID * droid, struct LIF_CLSID_A * droid_a)
     snprintf((char *)droid_a->ClockSeq, 10, "%"PRIu16, ClockSeq);
 
     //Work out the time
-    //****
-    // Build up the time in simple steps
-    Time = (int64_t)droid->Data1;
-    Time += ((int64_t)droid->Data2) << 32;
-    Timehi = ((int16_t)droid->Data3 & 0x0FFF);
-    Time += ((int64_t)Timehi) << 48;
-
-    //Now convert to filetime
-    Time -= (((int64_t)(1000 * 1000 * 10))*((int64_t)(60 * 60 * 24))*
-      ((int64_t)(17 + 30 + 31 + (365 * 18) + 5)));
+    Time = get_uuid_time(droid);
     //Now get sensible answers
     get_filetime_a_long(Time, droid_a->Time_long);
     get_filetime_a_short(Time, droid_a->Time);
@@ -2654,6 +3217,126 @@ void get_droid_a(struct LIF_CLSID * droid, struct LIF_CLSID_A * droid_a)
   }
 }
 //
+//Function: get_uuid_time(struct LIF_CLSID * uuid) returns the time stamp of a
+//version 1 (time based) UUID as a FILETIME, 0 for any other version.
+extern int64_t get_uuid_time(struct LIF_CLSID * uuid)
+{
+  int64_t Time;
+
+  if (((uuid->Data3 & 0xF000) >> 12) != 1)
+  {
+    return 0;
+  }
+  // Build up the time in simple steps (100ns intervals since 1582-10-15)
+  Time = (int64_t)uuid->Data1;
+  Time += ((int64_t)uuid->Data2) << 32;
+  Time += ((int64_t)(uuid->Data3 & 0x0FFF)) << 48;
+
+  //Now convert to filetime
+  Time -= (((int64_t)(1000 * 1000 * 10))*((int64_t)(60 * 60 * 24))*
+    ((int64_t)(17 + 30 + 31 + (365 * 18) + 5)));
+  return Time;
+}
+//
+//Function: get_guid_name(struct LIF_CLSID * guid) returns the name of a well
+//known shell folder CLSID or KnownFolder ID (NULL if it isn't in guids.txt)
+extern const char * get_guid_name(struct LIF_CLSID * guid)
+{
+  const struct LIF_GUID_NAME * gn;
+
+  gn = guid_lookup(guid, 0, guid_names, GUID_NAMES, guid_disp, GUID_BUCKETS);
+  return (gn == NULL) ? NULL : gn->Name;
+}
+//
+//Function: get_propkey_name(struct LIF_CLSID * fmtid, uint32_t pid) returns
+//the canonical name of a property key (NULL if it isn't in guids.txt)
+extern const char * get_propkey_name(struct LIF_CLSID * fmtid, uint32_t pid)
+{
+  const struct LIF_GUID_NAME * gn;
+
+  gn = guid_lookup(fmtid, pid, pkey_names, PKEY_NAMES, pkey_disp, PKEY_BUCKETS);
+  return (gn == NULL) ? NULL : gn->Name;
+}
+//
+//Function: guid_lookup() finds a GUID (and property ID) in one of the perfect
+//hash tables generated by mkguids.c: the bucket's displacement gives the only
+//slot the key can be in, so it is two hashes and a comparison.
+const struct LIF_GUID_NAME * guid_lookup(struct LIF_CLSID * guid, uint32_t pid,
+  const struct LIF_GUID_NAME names[], int num, const uint16_t disp[], int buckets)
+{
+  unsigned char   key[20];
+  int             i;
+  const struct LIF_GUID_NAME * gn;
+
+  // Build the key the same way as mkguids.c (the GUID as it is on disk + PID)
+  for (i = 0; i < 4; i++)
+  {
+    key[i] = (unsigned char)(guid->Data1 >> (8 * i));
+    key[16 + i] = (unsigned char)(pid >> (8 * i));
+  }
+  key[4] = (unsigned char)guid->Data2;
+  key[5] = (unsigned char)(guid->Data2 >> 8);
+  key[6] = (unsigned char)guid->Data3;
+  key[7] = (unsigned char)(guid->Data3 >> 8);
+  memcpy(&key[8], guid->Data4hi, 2);
+  memcpy(&key[10], guid->Data4lo, 6);
+
+  gn = &names[guid_hash(key, disp[guid_hash(key, 0) % buckets]) % num];
+  if ((gn->PID == pid) && (gn->Guid.Data1 == guid->Data1) && (gn->Guid.Data2 == guid->Data2) &&
+    (gn->Guid.Data3 == guid->Data3) && (memcmp(gn->Guid.Data4hi, guid->Data4hi, 2) == 0) &&
+    (memcmp(gn->Guid.Data4lo, guid->Data4lo, 6) == 0))
+  {
+    return gn;
+  }
+  return NULL;
+}
+//
+//Function: guid_hash() is 32 bit FNV-1a over the 20 byte key followed by a
+//final mix. It MUST stay identical to the one in mkguids.c
+uint32_t guid_hash(unsigned char key[], uint32_t seed)
+{
+  uint32_t  h = 0x811C9DC5 ^ (seed * 0x9E3779B9);
+  int       i;
+
+  for (i = 0; i < 20; i++)
+  {
+    h ^= key[i];
+    h *= 0x01000193;
+  }
+  h ^= h >> 16;
+  h *= 0x85EBCA6B;
+  h ^= h >> 13;
+  return h;
+}
+//
+//Function: get_edtype(uint32_t sig) returns the EDTYPES value of an ExtraData
+//block signature (EMPTY if the signature is not known)
+enum EDTYPES get_edtype(uint32_t sig)
+{
+  static const enum EDTYPES edtypes[13] =
+  {
+    EMPTY,
+    ENVIRONMENT_PROPS,            // 0xA0000001
+    CONSOLE_PROPS,                // 0xA0000002
+    TRACKER_PROPS,                // 0xA0000003
+    CONSOLE_FE_PROPS,             // 0xA0000004
+    SPECIAL_FOLDER_PROPS,         // 0xA0000005
+    DARWIN_PROPS,                 // 0xA0000006
+    ICON_ENVIRONMENT_PROPS,       // 0xA0000007
+    SHIM_PROPS,                   // 0xA0000008
+    PROPERTY_STORE_PROPS,         // 0xA0000009
+    VISTA_AND_ABOVE_IDLIST_PROPS, // 0xA000000A (not a signature, tolerated for 0xA000000C)
+    KNOWN_FOLDER_PROPS,           // 0xA000000B
+    VISTA_AND_ABOVE_IDLIST_PROPS  // 0xA000000C
+  };
+
+  if ((sig < 0xA0000001) || (sig > 0xA000000C))
+  {
+    return EMPTY;
+  }
+  return edtypes[sig - 0xA0000000];
+}
+//
 //Function led_setnull(struct LIF_EXTRA_DATA * led) just sets all the Extra Data
 //structures to 0
 void led_setnull(struct LIF_EXTRA_DATA * led)
@@ -2713,6 +3396,7 @@ void led_setnull(struct LIF_EXTRA_DATA * led)
   led->lvidlp.Size = 0;
   led->lvidlp.sig = 0;
   led->lvidlp.Posn = 0;
+  led->lvidlp.NumItemIDs = 0;
 
   led->terminal = 0;
 }
@@ -17,15 +17,39 @@
 **       Returns 0 if the file pointed to by fp is a          **
 **       Windows Link file -1 if not.                         **
 **                                                            **
+** test_link_at(FILE*, uint64_t)                              **
+**       As test_link() but for a link that starts at the     **
+**       given offset in a larger container (carved/embedded) **
+**                                                            **
 ** get_lif(FILE*, int, LIF*)                                  **
 **       Populates LIF with the decoded link file data        **
 **                                                            **
+** get_lif_at(FILE*, uint64_t, int, uint32_t, LIF*)           **
+**       As get_lif() but for a link that starts at the       **
+**       given offset, all Posn values are absolute offsets   **
+**       and only the LIF_SEC_* sections in the mask decoded  **
+**                                                            **
 ** get_lif_a(LIF*, LIF_A*)                                    **
 **       Converts the LIF to a readable version               **
 **                                                            **
+** get_lif_a_opt(LIF*, LIF_A*, uint32_t)                      **
+**       As get_lif_a() but with a mask of LIF_A_* options    **
+**                                                            **
 ** get_propstore_a(LIF_SER_PROPSTORE * LIF_SER_PROPSTORE_A *) **
 **       Converts the property store to a readable version    **
 **                                                            **
+** get_guid_name(LIF_CLSID*)                                  **
+**       Returns the name of a well known shell folder CLSID  **
+**       or KnownFolder ID, NULL if it is not known           **
+**                                                            **
+** get_propkey_name(LIF_CLSID*, uint32_t)                     **
+**       Returns the canonical name of a property key (format **
+**       ID & property ID), NULL if it is not known           **
+**                                                            **
+** get_uuid_time(LIF_CLSID*)                                  **
+**       Returns the FILETIME of a time based (version 1)     **
+**       UUID, 0 if the UUID is of another version            **
+**                                                            **
 ***************************************************************/
 
 /*
@@ -72,6 +96,7 @@ https://msdn.microsoft.com/en-us/library/dd871305.aspx )
 #define PROPVALUES    10    // The number of LIF_SER_PROPVALUE in each LIF_SER_PROPSTORE structure
 #define ITEMIDS       10    // The number of LIF_ITEMID items in a LIF_IDLIST
 #define MAXITEMIDSIZE 4096  // The maximum number of raw bytes in an ItemID
+#define SHELLNAMESIZE 260   // The maximum number of characters kept from a shell item name
 
 // extradata types
 enum EDTYPES
@@ -90,6 +115,24 @@ enum EDTYPES
   VISTA_AND_ABOVE_IDLIST_PROPS  = 1024
 };
 
+// Section decode mask for get_lif_at(). The header is always decoded and the
+// sizes of skipped sections are still read so that later sections can be
+// found. ExtraData blocks that are not in the mask are noted in edtypes (so
+// their presence is still reported) but their content is not decoded.
+#define LIF_SEC_HDR         0x00000001
+#define LIF_SEC_IDLIST      0x00000002
+#define LIF_SEC_LINKINFO    0x00000004
+#define LIF_SEC_STRINGDATA  0x00000008
+#define LIF_SEC_ED(t)       ((uint32_t)(t) << 8) // One or more EDTYPES blocks
+#define LIF_SEC_EXTRADATA   LIF_SEC_ED(0x7FF)    // Every ExtraData block
+#define LIF_SEC_TRACKER     LIF_SEC_ED(TRACKER_PROPS)
+#define LIF_SEC_ALL         0xFFFFFFFF
+
+// Options for get_lif_a_opt(). LIF_A_NUMERIC leaves the names out of the
+// header flags & file attributes, just the bit masks (e.g. "0x0000009B") are
+// written, for outputs that have no use for the text.
+#define LIF_A_NUMERIC       0x00000001
+
 enum PROPERTY_TYPE // From MS-OLEPS https://msdn.microsoft.com/en-us/library/dd942532.aspx
 {
   VT_EMPTY              = 0x0000, // 0 bytes
@@ -132,6 +175,19 @@ enum PROPERTY_TYPE // From MS-OLEPS https://msdn.microsoft.com/en-us/library/dd9
   VT_ARRAY              = 0x2000  // Variable Dimension of objects - Type (4 bytes) * NumDimensions (next 4 bytes) * sizeof Type = (size - 8 bytes)
 };
 
+// Shell item (ItemID) types, the class type indicator is the first byte of
+// the ItemID Data. None of this is in MS-SHLLINK, the layouts follow the
+// reverse engineering in Joachim Metz's libfwsi documentation.
+enum SHELLITEM_TYPE
+{
+  SHI_UNKNOWN                   = 0,
+  SHI_ROOT_FOLDER               = 1, // Class 0x1F
+  SHI_VOLUME                    = 2, // Classes 0x20 to 0x2F
+  SHI_FILE_ENTRY                = 3, // Classes 0x30 to 0x3F
+  SHI_NETWORK                   = 4, // Classes 0x40 to 0x4F
+  SHI_URI                       = 5  // Class 0x61
+};
+
 struct LIF_CLSID
 {
   uint32_t           Data1;       //32bit Data1         - Represented LE
@@ -150,6 +206,7 @@ struct LIF_CLSID_A
   unsigned char     Time_long[40];
   unsigned char     ClockSeq[10];
   unsigned char     Node[20];
+  unsigned char     Name[64];    // Well known name or "[UNKNOWN]"
 };
 
 // Following definition taken from MS-PROPSTORE and MS-OLEPS
@@ -171,6 +228,7 @@ struct LIF_SER_PROPVALUE_A
   unsigned char       NameSizeOrID[12];
   unsigned char       Reserved[6];
   unsigned char       Name[300];  // Will be "[N/A]" if an Integer Type
+  unsigned char       KeyName[64]; // Canonical name of an Integer Type (e.g. "System.ItemNameDisplay")
   unsigned char       PropertyType[40]; // Something like: "VT_VECTOR | VT_FILETIME"
   unsigned char       Padding[7]; // Should be "0x0000"
   unsigned char       Value[400]; // Interpreted property content
@@ -200,7 +258,7 @@ struct LIF_SER_PROPSTORE_A
 struct LIF_PROPERTY_STORE_PROPS
 {
   // Now named PropertyStoreDataBlock MS-SHLLINK S2.5.7
-  uint16_t                  Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t                  Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t                  Size;
   uint32_t                  sig;
   int32_t                   NumStores; //Not in spec but used to report the number of stores in this DataBlock
@@ -209,7 +267,7 @@ struct LIF_PROPERTY_STORE_PROPS
 
 struct LIF_PROPERTY_STORE_PROPS_A
 {
-  unsigned char               Posn[8];
+  unsigned char               Posn[24];
   unsigned char               Size[10];
   unsigned char               sig[12];
   unsigned char               NumStores[10];
@@ -218,7 +276,7 @@ struct LIF_PROPERTY_STORE_PROPS_A
 
 struct LIF_CONSOLE_PROPS
 {
-  uint16_t       Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t       Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t       Size;
   uint32_t       sig;
   uint16_t       FillAttributes;
@@ -252,7 +310,7 @@ struct LIF_CONSOLE_PROPS
 
 struct LIF_CONSOLE_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
   unsigned char      FillAttributes[8];
@@ -284,7 +342,7 @@ struct LIF_CONSOLE_PROPS_A
 
 struct LIF_CONSOLE_FE_PROPS
 {
-  uint16_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   uint32_t           CodePage;
@@ -292,7 +350,7 @@ struct LIF_CONSOLE_FE_PROPS
 
 struct LIF_CONSOLE_FE_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
   unsigned char      CodePage[12];
@@ -300,7 +358,7 @@ struct LIF_CONSOLE_FE_PROPS_A
 
 struct LIF_DARWIN_PROPS
 {
-  uint16_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   unsigned char      DarwinDataAnsi[260];
@@ -309,7 +367,7 @@ struct LIF_DARWIN_PROPS
 
 struct LIF_DARWIN_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
   unsigned char      DarwinDataAnsi[260];
@@ -318,7 +376,7 @@ struct LIF_DARWIN_PROPS_A
 
 struct LIF_ENVIRONMENT_PROPS
 {
-  uint16_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   unsigned char      TargetAnsi[260];
@@ -327,7 +385,7 @@ struct LIF_ENVIRONMENT_PROPS
 
 struct LIF_ENVIRONMENT_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
   unsigned char      TargetAnsi[260];
@@ -336,7 +394,7 @@ struct LIF_ENVIRONMENT_PROPS_A
 
 struct LIF_ICON_ENVIRONMENT_PROPS
 {
-  uint16_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;	// Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   unsigned char      TargetAnsi[260];
@@ -345,7 +403,7 @@ struct LIF_ICON_ENVIRONMENT_PROPS
 
 struct LIF_ICON_ENVIRONMENT_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
   unsigned char      TargetAnsi[260];
@@ -354,7 +412,7 @@ struct LIF_ICON_ENVIRONMENT_PROPS_A
 
 struct LIF_KNOWN_FOLDER_PROPS
 {
-  uint16_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   struct LIF_CLSID   KFGUID;
@@ -363,7 +421,7 @@ struct LIF_KNOWN_FOLDER_PROPS
 
 struct LIF_KNOWN_FOLDER_PROPS_A
 {
-  unsigned char       Posn[8];
+  unsigned char       Posn[24];
   unsigned char       Size[10];
   unsigned char       sig[12];
   struct LIF_CLSID_A  KFGUID;
@@ -372,7 +430,7 @@ struct LIF_KNOWN_FOLDER_PROPS_A
 
 struct LIF_SHIM_PROPS
 {
-  uint16_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   wchar_t            LayerName[600];
@@ -380,7 +438,7 @@ struct LIF_SHIM_PROPS
 
 struct LIF_SHIM_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
   unsigned char      LayerName[600];
@@ -388,7 +446,7 @@ struct LIF_SHIM_PROPS_A
 
 struct LIF_SPECIAL_FOLDER_PROPS
 {
-  uint16_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   uint32_t           SpecialFolderID;
@@ -397,7 +455,7 @@ struct LIF_SPECIAL_FOLDER_PROPS
 
 struct LIF_SPECIAL_FOLDER_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
   unsigned char      SpecialFolderID[10];
@@ -406,7 +464,7 @@ struct LIF_SPECIAL_FOLDER_PROPS_A
 
 struct LIF_TRACKER_PROPS
 {
-  uint16_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
   uint32_t           Length;
@@ -420,7 +478,7 @@ struct LIF_TRACKER_PROPS
 
 struct LIF_TRACKER_PROPS_A
 {
-  unsigned char       Posn[8];
+  unsigned char       Posn[24];
   unsigned char       Size[10];
   unsigned char       sig[12];
   unsigned char       Length[10];
@@ -432,22 +490,82 @@ struct LIF_TRACKER_PROPS_A
   struct LIF_CLSID_A  DroidBirth2;
 };
 
+struct LIF_SHELLITEM
+{
+  uint8_t              Class;       // The class type indicator
+  enum SHELLITEM_TYPE  Type;
+  uint8_t              SortIndex;   // Root folder
+  struct LIF_CLSID     FolderID;    // Root folder shell folder identifier
+  uint32_t             FileSize;    // File entry
+  uint16_t             ModDate;     // File entry last modification FAT date
+  uint16_t             ModTime;     // and FAT time
+  uint16_t             FileAttr;    // File entry
+  unsigned char        Name[SHELLNAMESIZE]; // Volume: drive, File entry: primary (short) name,
+                                            // Network: location, URI: the URI
+  unsigned char        Description[SHELLNAMESIZE]; // Network
+  unsigned char        Comments[SHELLNAMESIZE];    // Network
+  // The 0xBEEF0004 extension block of a file entry
+  uint16_t             ExtVersion;  // 0 if there isn't an extension block
+  uint16_t             CrDate;      // Creation FAT date & time
+  uint16_t             CrTime;
+  uint16_t             AcDate;      // Last access FAT date & time
+  uint16_t             AcTime;
+  uint64_t             MFTEntry;    // NTFS file reference (version 7 and above)
+  uint16_t             MFTSeq;
+  wchar_t              LongName[SHELLNAMESIZE];
+};
+
+struct LIF_SHELLITEM_A
+{
+  unsigned char        Class[6];
+  unsigned char        Type[40];
+  unsigned char        SortIndex[6];
+  struct LIF_CLSID_A   FolderID;
+  unsigned char        FileSize[12];
+  unsigned char        ModTime[30];
+  unsigned char        FileAttr[10];
+  unsigned char        Name[SHELLNAMESIZE];
+  unsigned char        Description[SHELLNAMESIZE];
+  unsigned char        Comments[SHELLNAMESIZE];
+  unsigned char        ExtVersion[8];
+  unsigned char        CrTime[30];
+  unsigned char        AcTime[30];
+  unsigned char        MFTEntry[24];
+  unsigned char        MFTSeq[8];
+  unsigned char        LongName[SHELLNAMESIZE * 2];
+};
+
+struct LIF_ITEMID
+{
+  uint64_t              Posn;       // Not in the spec: the absolute file offset of the ItemIDSize field
+  uint16_t              ItemIDSize;
+  unsigned char         Data[MAXITEMIDSIZE];
+  struct LIF_SHELLITEM  Shell;      // Not in the spec: the typed interpretation of Data (if known)
+};
+
+struct LIF_ITEMID_A
+{
+  unsigned char               ItemIDSize[10];
+  unsigned char               Data[100];  // Room for some general notes about the data
+                                          // (property stores are found on demand with find_propstores())
+  struct LIF_SHELLITEM_A      Shell;
+};
+
 struct LIF_VISTA_IDLIST_PROPS
 {
-  uint16_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
+  uint64_t           Posn;  // Not in the spec but included to assist in forensic analysis and therefore the authentication of results
   uint32_t           Size;
   uint32_t           sig;
-  //TODO Fix this!
-  //  struct ITEMID**    Items;      //A variable number of variable length structures
+  struct LIF_ITEMID  Items[ITEMIDS]; //The IDList, decoded the same way as the LinkTargetIDList
   uint16_t           NumItemIDs; //This isn't in the specification but it seemed like a good idea to include it.
 };
 
 struct LIF_VISTA_IDLIST_PROPS_A
 {
-  unsigned char      Posn[8];
+  unsigned char      Posn[24];
   unsigned char      Size[10];
   unsigned char      sig[12];
-  //  struct ITEMID_A**  Items;          //A variable number of variable length structures
+  struct LIF_ITEMID_A  Items[ITEMIDS];
   unsigned char      NumItemIDs[10];
 };
 
@@ -602,19 +720,6 @@ struct LIF_INFO_A
   unsigned char               CPSU[100]; //Common Path Suffix, Unicode
 };
 
-struct LIF_ITEMID
-{
-  uint16_t           ItemIDSize;
-  unsigned char      Data[MAXITEMIDSIZE];
-};
-
-struct LIF_ITEMID_A
-{
-  unsigned char               ItemIDSize[10];
-  unsigned char               Data[100];  // Room for some general notes about the data
-  struct LIF_SER_PROPSTORE_A  DataStores[PROPSTORES]; // Where the ID list contains property stores the interpretation can be held here
-};
-
 struct LIF_IDLIST
 {
   struct LIF_ITEMID  Items[ITEMIDS];  //
@@ -652,7 +757,7 @@ struct LIF_HDR_A
   unsigned char               H_size[10];
   unsigned char               CLSID[40];
   unsigned char               Flags[550];       //Sec 2.1.1
-  unsigned char               Attr[250];        //Sec 2.1.2
+  unsigned char               Attr[400];        //Sec 2.1.2
   unsigned char               CrDate[30];
   unsigned char               AcDate[30];
   unsigned char               WtDate[30];
@@ -673,6 +778,8 @@ struct LIF_HDR_A
 
 struct LIF //LInk File structure
 {
+  uint64_t                 Base; //Not in the spec: offset of the link within its container (0 for a standalone file)
+  uint32_t                 Sections; //Not in the spec: LIF_SEC_* mask of the sections that were decoded
   struct LIF_HDR           lh;   //Section 2.1 of MS-SHLLINK
   struct LIF_IDLIST        lidl; //Section 2.2
   struct LIF_INFO          li;   //Section 2.3
@@ -695,24 +802,45 @@ struct LIF_A //ASCII version of the LIF structure
 extern int test_link(FILE *);
 //FILE* is an opened FILE pointer
 
+//Tests to see if there is a link file at an offset within a file
+//(0 if it is, < -1 if not)
+extern int test_link_at(FILE *, uint64_t);
+//FILE* is an opened FILE pointer
+//uint64_t is the offset of the link within the file
+
 //fills the LIF structure with data (0 if successful < -1 if not)
 extern int get_lif(FILE *, int, struct LIF *);
 //FILE* is an opened FILE pointer
 //int is the size of the opened file
 //LIF is a pointer to a struct LIF which will hold the data
 
+//fills the LIF structure with data from a link file embedded in (or carved
+//from) a larger container (0 if successful < -1 if not)
+extern int get_lif_at(FILE *, uint64_t, int, uint32_t, struct LIF *);
+//FILE* is an opened FILE pointer
+//uint64_t is the offset of the first byte of the link within the file
+//int is the size of the link
+//uint32_t is a LIF_SEC_* mask of the sections to decode (LIF_SEC_ALL for all)
+//LIF is a pointer to a struct LIF which will hold the data, every Posn
+//value is the absolute offset within the file (i.e. includes the uint64_t)
+
 //fills LIF_A with the ASCII representation of the LIF
 //(0 if successful, != 0 if not)
 extern int get_lif_a(struct LIF *, struct LIF_A *);
 //LIF must be a filled LIF structure
-//LIF_A is an empty LIF_A structure
+//LIF_A is an empty LIF_A structure, a LinkInfo section that was not decoded
+//is not converted (the ExtraData blocks that were not decoded are "[N/A]")
+
+//As get_lif_a() (0 if successful, != 0 if not)
+extern int get_lif_a_opt(struct LIF *, struct LIF_A *, uint32_t);
+//uint32_t is a mask of LIF_A_* options (0 for none)
 
 //Finds a series of Property stores in a buffer
 //(0 if successful, != 0 if not)
-extern int find_propstores(unsigned char *, int, int, struct LIF_PROPERTY_STORE_PROPS *);
+extern int find_propstores(unsigned char *, int, uint64_t, struct LIF_PROPERTY_STORE_PROPS *);
 // unsigned char * (arg 0) is a pointer to a filled byte array
 // int (arg 1) is the size of the array
-// int (arg 2) is the position of the first byte in the array relative to the start of the link file
+// uint64_t (arg 2) is the absolute file offset of the first byte in the array
 // LIF_PROPERTY_STORE_PROPS * (arg 3) is a pointer to an empty structure (filled on success)
 
 //fills a LIF_SER_PROPSTORE_A with the ASCII representation
@@ -722,4 +850,19 @@ extern int get_propstore_a(struct LIF_SER_PROPSTORE *, struct LIF_SER_PROPSTORE_
 //LIF_SER_PROPSTORE   must be a filled structure
 //LIF_SER_PROPSTORE_A is an empty structure (filled on success)
 
+//Looks up the name of a well known shell folder CLSID or KnownFolder ID
+//(a pointer to a static string, NULL if the GUID is not known)
+extern const char * get_guid_name(struct LIF_CLSID *);
+//LIF_CLSID is the GUID to look up
+
+//Looks up the canonical name of a property key (a pointer to a static
+//string, NULL if the property key is not known)
+extern const char * get_propkey_name(struct LIF_CLSID *, uint32_t);
+//LIF_CLSID is the property store's format ID (FMTID)
+//uint32_t is the property ID within the store
+
+//Gets the time stamp of a version 1 (time based) UUID such as a tracker
+//droid as a FILETIME (0 if the UUID is not time based)
+extern int64_t get_uuid_time(struct LIF_CLSID *);
+
 #endif
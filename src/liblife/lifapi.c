@@ -0,0 +1,515 @@
+/***************************************************************
+**                                                            **
+**                    lifapi.c                                **
+**                                                            **
+**    The stable interface to liblife (liblife.so).           **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See lifapi.h for the exported functions                    **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _WIN32
+#define _FILE_OFFSET_BITS 64 //As liblife.c, FILE must be the same for both
+#endif
+#include <stddef.h>
+#include <limits.h>
+#include "./liblife.h"
+#include "./lifapi.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#define LIFAPI_ADD(p, n) InterlockedExchangeAdd64((volatile LONG64 *)(p), (LONG64)(n))
+#else
+#include <unistd.h>
+#include <pthread.h>
+#define LIFAPI_ADD(p, n) __atomic_fetch_add((p), (int64_t)(n), __ATOMIC_RELAXED)
+#endif
+
+#define LIFAPI_MAXTHREADS 64
+
+// The LIF_PARSE_* sections are liblife's LIF_SEC_* (this won't compile if not)
+typedef char lif_parse_is_lif_sec[((LIF_PARSE_IDLIST == LIF_SEC_IDLIST) && (LIF_PARSE_LINKINFO == LIF_SEC_LINKINFO) &&
+  (LIF_PARSE_STRINGDATA == LIF_SEC_STRINGDATA) && (LIF_PARSE_EXTRADATA == LIF_SEC_EXTRADATA)) ? 1 : -1];
+
+struct LIF_PARSER
+{
+  uint32_t            Sections;     // LIF_SEC_* to decode
+  uint32_t            Options;      // LIF_OPT_*
+  int                 Threads;      // For a batch
+};
+
+struct LIF_RESULT
+{
+  int                 Error;        // Of the last parse (LIF_E_NOTPARSED before the first)
+  int                 Text;         // lif_a has been made from lif
+  uint32_t            Options;      // The parser's, for making the text
+  struct LIF          lif;
+  struct LIF_A      * lif_a;        // Allocated the first time text is wanted
+};
+
+// A batch, shared by the threads parsing it
+struct LIF_BATCH
+{
+  struct LIF_PARSER   * Parser;
+  size_t                Num;
+  const void * const  * Bufs;
+  const size_t        * Sizes;
+  struct LIF_RESULT  ** Results;
+  volatile int64_t      Next;       // The next to be taken
+  volatile int64_t      Done;       // Decoded successfully
+};
+
+// Where each LIF_T_* field is in a LIF_A, and the section it is in (0 for
+// one that is always converted)
+struct LIF_TEXT_FIELD
+{
+  size_t              Offset;
+  uint32_t            Section;
+};
+#define LIFAPI_T(m, s) { offsetof(struct LIF_A, m), s }
+
+static const struct LIF_TEXT_FIELD lif_text_fields[LIF_T_NUMFIELDS] =
+{
+  LIFAPI_T(lha.Flags, 0),
+  LIFAPI_T(lha.Attr, 0),
+  LIFAPI_T(lha.CrDate, 0),
+  LIFAPI_T(lha.AcDate, 0),
+  LIFAPI_T(lha.WtDate, 0),
+  LIFAPI_T(lha.ShowState, 0),
+  LIFAPI_T(lha.Hotkey, 0),
+  LIFAPI_T(lsda.Data[0], LIF_SEC_STRINGDATA),
+  LIFAPI_T(lsda.Data[1], LIF_SEC_STRINGDATA),
+  LIFAPI_T(lsda.Data[2], LIF_SEC_STRINGDATA),
+  LIFAPI_T(lsda.Data[3], LIF_SEC_STRINGDATA),
+  LIFAPI_T(lsda.Data[4], LIF_SEC_STRINGDATA),
+  LIFAPI_T(lia.LBP, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.LBPU, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.CPS, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.CPSU, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.VolID.DriveType, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.VolID.VolumeLabel, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.VolID.VolumeLabelU, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.CNR.NetName, LIF_SEC_LINKINFO),
+  LIFAPI_T(lia.CNR.DeviceName, LIF_SEC_LINKINFO),
+  LIFAPI_T(leda.edtypes, 0),
+  LIFAPI_T(leda.lepa.TargetAnsi, LIF_SEC_ED(ENVIRONMENT_PROPS)),
+  LIFAPI_T(leda.lepa.TargetUnicode, LIF_SEC_ED(ENVIRONMENT_PROPS)),
+  LIFAPI_T(leda.liepa.TargetUnicode, LIF_SEC_ED(ICON_ENVIRONMENT_PROPS)),
+  LIFAPI_T(leda.ldpa.DarwinDataUnicode, LIF_SEC_ED(DARWIN_PROPS)),
+  LIFAPI_T(leda.lkfpa.KFGUID.UUID, LIF_SEC_ED(KNOWN_FOLDER_PROPS)),
+  LIFAPI_T(leda.lkfpa.KFGUID.Name, LIF_SEC_ED(KNOWN_FOLDER_PROPS)),
+  LIFAPI_T(leda.lspa.LayerName, LIF_SEC_ED(SHIM_PROPS)),
+  LIFAPI_T(leda.ltpa.MachineID, LIF_SEC_TRACKER),
+  LIFAPI_T(leda.ltpa.Droid1.UUID, LIF_SEC_TRACKER),
+  LIFAPI_T(leda.ltpa.Droid2.UUID, LIF_SEC_TRACKER)
+};
+
+static const size_t lif_item_fields[LIF_I_NUMFIELDS] =
+{
+  offsetof(struct LIF_ITEMID_A, Shell.Type),
+  offsetof(struct LIF_ITEMID_A, Shell.Name),
+  offsetof(struct LIF_ITEMID_A, Shell.LongName),
+  offsetof(struct LIF_ITEMID_A, Shell.ModTime),
+  offsetof(struct LIF_ITEMID_A, Shell.FileSize),
+  offsetof(struct LIF_ITEMID_A, Shell.MFTEntry)
+};
+
+//Local function declarations
+FILE * lif_memopen(const void *, size_t);
+int lif_decode(struct LIF_PARSER *, const void *, size_t, struct LIF_RESULT *);
+int lif_make_text(struct LIF_RESULT *);
+int lif_nproc(void);
+
+//
+//Function: lif_memopen() returns a read only stream of the buffer (NULL if
+//          one can't be had). liblife reads from a FILE, fmemopen() gives
+//          one without copying; Windows has no fmemopen() so the buffer is
+//          copied to a temporary file.
+FILE * lif_memopen(const void * buf, size_t size)
+{
+#ifdef _WIN32
+  FILE * fp;
+
+  if ((fp = tmpfile()) == NULL)
+  {
+    return NULL;
+  }
+  if ((fwrite(buf, 1, size, fp) != size) || (fseek(fp, 0, SEEK_SET) != 0))
+  {
+    fclose(fp);
+    return NULL;
+  }
+  return fp;
+#else
+  return fmemopen((void *)buf, size, "rb");
+#endif
+}
+
+//
+//Function: lif_nproc() returns the number of processors
+int lif_nproc(void)
+{
+#ifdef _WIN32
+  SYSTEM_INFO si;
+
+  GetSystemInfo(&si);
+  return (int)si.dwNumberOfProcessors;
+#else
+  return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+//
+//Function: lif_decode() does the work of lif_parse(). The link is tested
+//          first, liblife expects a link file (and asserts that it is
+//          at least as long as a header).
+int lif_decode(struct LIF_PARSER * p, const void * buf, size_t size, struct LIF_RESULT * r)
+{
+  FILE * fp;
+
+  r->Text = 0;
+  r->Options = p->Options;
+  if ((buf == NULL) || (size > INT_MAX))
+  {
+    return r->Error = LIF_E_ARGS;
+  }
+  if (size < 0x4C)
+  {
+    return r->Error = LIF_E_SHORT;
+  }
+  if ((fp = lif_memopen(buf, size)) == NULL)
+  {
+    return r->Error = LIF_E_NOMEM;
+  }
+  if (test_link(fp) != 0)
+  {
+    r->Error = LIF_E_NOTLINK;
+  }
+  else if (get_lif_at(fp, 0, (int)size, p->Sections, &r->lif) < 0)
+  {
+    r->Error = LIF_E_DECODE;
+  }
+  else
+  {
+    r->Error = 0;
+  }
+  fclose(fp);
+  if ((r->Error == 0) && (p->Options & LIF_OPT_TEXT))
+  {
+    lif_make_text(r); // (If it can't be done now lif_text() tries again)
+  }
+  return r->Error;
+}
+
+//
+//Function: lif_make_text() converts the result's LIF to text. Returns 0 if
+//          successful, -1 if not.
+int lif_make_text(struct LIF_RESULT * r)
+{
+  if ((r->lif_a == NULL) && ((r->lif_a = malloc(sizeof(struct LIF_A))) == NULL))
+  {
+    return -1;
+  }
+  if (get_lif_a_opt(&r->lif, r->lif_a, (r->Options & LIF_OPT_NUMERIC) ? LIF_A_NUMERIC : 0) != 0)
+  {
+    return -1;
+  }
+  r->Text = 1;
+  return 0;
+}
+
+//
+//Function: lif_work() parses the batch's links until there are none left
+#ifdef _WIN32
+static DWORD WINAPI lif_work(LPVOID arg)
+#else
+static void * lif_work(void * arg)
+#endif
+{
+  struct LIF_BATCH * b = arg;
+  int64_t i;
+
+  while ((i = LIFAPI_ADD(&b->Next, 1)) < (int64_t)b->Num)
+  {
+    if ((b->Results[i] != NULL) &&
+      (lif_decode(b->Parser, (b->Bufs != NULL) ? b->Bufs[i] : NULL, (b->Sizes != NULL) ? b->Sizes[i] : 0, b->Results[i]) == 0))
+    {
+      LIFAPI_ADD(&b->Done, 1);
+    }
+  }
+  return 0;
+}
+
+//
+//Function: lif_api_version() returns the library's interface version
+extern LIFAPI int lif_api_version(void)
+{
+  return LIFAPI_VERSION;
+}
+
+//
+//Function: lif_parser_new() makes a parser
+extern LIFAPI struct LIF_PARSER * lif_parser_new(uint32_t sections, uint32_t options, int threads)
+{
+  struct LIF_PARSER * p;
+
+  if ((p = malloc(sizeof(struct LIF_PARSER))) == NULL)
+  {
+    return NULL;
+  }
+  p->Sections = sections | LIF_SEC_HDR;
+  p->Options = options;
+  if (threads <= 0)
+  {
+    threads = lif_nproc();
+  }
+  p->Threads = (threads < 1) ? 1 : ((threads > LIFAPI_MAXTHREADS) ? LIFAPI_MAXTHREADS : threads);
+  return p;
+}
+
+//
+//Function: lif_parser_free() frees a parser
+extern LIFAPI void lif_parser_free(struct LIF_PARSER * p)
+{
+  free(p);
+}
+
+//
+//Function: lif_result_new() makes an empty result
+extern LIFAPI struct LIF_RESULT * lif_result_new(void)
+{
+  struct LIF_RESULT * r;
+
+  if ((r = malloc(sizeof(struct LIF_RESULT))) == NULL)
+  {
+    return NULL;
+  }
+  r->Error = LIF_E_NOTPARSED;
+  r->Text = 0;
+  r->Options = 0;
+  r->lif_a = NULL;
+  return r;
+}
+
+//
+//Function: lif_result_free() frees a result
+extern LIFAPI void lif_result_free(struct LIF_RESULT * r)
+{
+  if (r != NULL)
+  {
+    free(r->lif_a);
+    free(r);
+  }
+}
+
+//
+//Function: lif_parse() decodes one link file
+extern LIFAPI int lif_parse(struct LIF_PARSER * p, const void * buf, size_t size, struct LIF_RESULT * r)
+{
+  if (r == NULL)
+  {
+    return LIF_E_ARGS;
+  }
+  if (p == NULL)
+  {
+    return r->Error = LIF_E_ARGS;
+  }
+  return lif_decode(p, buf, size, r);
+}
+
+//
+//Function: lif_parse_batch() decodes n link files. With more than one
+//          thread they take the next link in turn until all are done, so
+//          a few big links don't hold the others up.
+extern LIFAPI size_t lif_parse_batch(struct LIF_PARSER * p, size_t n, const void * const bufs[], const size_t sizes[], struct LIF_RESULT * results[])
+{
+  struct LIF_BATCH b;
+#ifdef _WIN32
+  HANDLE threads[LIFAPI_MAXTHREADS];
+#else
+  pthread_t threads[LIFAPI_MAXTHREADS];
+#endif
+  int i, nthreads, started = 0;
+
+  if ((p == NULL) || (results == NULL))
+  {
+    return 0;
+  }
+  b.Parser = p;
+  b.Num = n;
+  b.Bufs = bufs;
+  b.Sizes = sizes;
+  b.Results = results;
+  b.Next = 0;
+  b.Done = 0;
+  nthreads = ((size_t)p->Threads < n) ? p->Threads : (int)n;
+  // This thread is one of them, start the rest
+  for (i = 1; i < nthreads; i++)
+  {
+#ifdef _WIN32
+    if ((threads[started] = CreateThread(NULL, 0, lif_work, &b, 0, NULL)) == NULL)
+#else
+    if (pthread_create(&threads[started], NULL, lif_work, &b) != 0)
+#endif
+    {
+      break; // Those that did start (and this one) do them all
+    }
+    started++;
+  }
+  lif_work(&b);
+  for (i = 0; i < started; i++)
+  {
+#ifdef _WIN32
+    WaitForSingleObject(threads[i], INFINITE);
+    CloseHandle(threads[i]);
+#else
+    pthread_join(threads[i], NULL);
+#endif
+  }
+  return (size_t)b.Done;
+}
+
+//
+//Function: lif_result_error() returns the result of the last parse
+extern LIFAPI int lif_result_error(const struct LIF_RESULT * r)
+{
+  return (r == NULL) ? LIF_E_ARGS : r->Error;
+}
+
+//
+//Function: lif_strerror() describes an error
+extern LIFAPI const char * lif_strerror(int err)
+{
+  switch (err)
+  {
+  case 0:
+    return "Success";
+  case LIF_E_NOTLINK:
+    return "Not a link file";
+  case LIF_E_SHORT:
+    return "Too short to be a link file";
+  case LIF_E_DECODE:
+    return "The link file could not be decoded";
+  case LIF_E_NOMEM:
+    return "Out of memory";
+  case LIF_E_ARGS:
+    return "Invalid argument";
+  case LIF_E_NOTPARSED:
+    return "Nothing has been parsed";
+  case LIF_E_STOPPED:
+    return "Stopped by a callback";
+  default:
+    return "Unknown error";
+  }
+}
+
+//
+//Function: lif_number() returns a number field
+extern LIFAPI int64_t lif_number(const struct LIF_RESULT * r, int field)
+{
+  const struct LIF * lif;
+
+  if ((r == NULL) || (r->Error != 0))
+  {
+    return 0;
+  }
+  lif = &r->lif;
+  switch (field)
+  {
+  case LIF_N_FLAGS:
+    return lif->lh.Flags;
+  case LIF_N_ATTRIBUTES:
+    return lif->lh.Attr;
+  case LIF_N_CREATION_TIME:
+    return lif->lh.CrDate;
+  case LIF_N_ACCESS_TIME:
+    return lif->lh.AcDate;
+  case LIF_N_WRITE_TIME:
+    return lif->lh.WtDate;
+  case LIF_N_FILE_SIZE:
+    return lif->lh.Size;
+  case LIF_N_ICON_INDEX:
+    return lif->lh.IconIndex;
+  case LIF_N_SHOW_STATE:
+    return lif->lh.ShowState;
+  case LIF_N_HOTKEY:
+    return lif->lh.Hotkey.LowKey | (lif->lh.Hotkey.HighKey << 8);
+  case LIF_N_ITEMIDS:
+    return (lif->Sections & LIF_SEC_IDLIST) ? lif->lidl.NumItemIDs : 0;
+  }
+  if (lif->Sections & LIF_SEC_LINKINFO)
+  {
+    switch (field)
+    {
+    case LIF_N_LINKINFO_FLAGS:
+      return lif->li.Flags;
+    case LIF_N_DRIVE_TYPE:
+      return lif->li.VolID.DriveType;
+    case LIF_N_DRIVE_SERIAL:
+      return lif->li.VolID.DriveSN;
+    case LIF_N_NETWORK_PROVIDER:
+      return lif->li.CNR.NetworkProviderType;
+    }
+  }
+  switch (field)
+  {
+  case LIF_N_EXTRADATA:
+    return lif->led.edtypes;
+  case LIF_N_CODEPAGE:
+    return (lif->led.edtypes & CONSOLE_FE_PROPS) && (lif->Sections & LIF_SEC_ED(CONSOLE_FE_PROPS)) ?
+      lif->led.lcfep.CodePage : 0;
+  case LIF_N_SPECIAL_FOLDER:
+    return (lif->led.edtypes & SPECIAL_FOLDER_PROPS) && (lif->Sections & LIF_SEC_ED(SPECIAL_FOLDER_PROPS)) ?
+      lif->led.lsfp.SpecialFolderID : 0;
+  case LIF_N_TRACKER_TIME:
+    return (lif->led.edtypes & TRACKER_PROPS) && (lif->Sections & LIF_SEC_TRACKER) ?
+      get_uuid_time((struct LIF_CLSID *)&lif->led.ltp.Droid2) : 0;
+  }
+  return 0;
+}
+
+//
+//Function: lif_text() returns a text field
+extern LIFAPI const char * lif_text(struct LIF_RESULT * r, int field)
+{
+  if ((r == NULL) || (r->Error != 0) || (field < 0) || (field >= LIF_T_NUMFIELDS) ||
+    ((lif_text_fields[field].Section != 0) && !(r->lif.Sections & lif_text_fields[field].Section)) ||
+    (!r->Text && (lif_make_text(r) < 0)))
+  {
+    return "";
+  }
+  return (const char *)r->lif_a + lif_text_fields[field].Offset;
+}
+
+//
+//Function: lif_item_text() returns a text field of a shell item
+extern LIFAPI const char * lif_item_text(struct LIF_RESULT * r, int item, int field)
+{
+  if ((r == NULL) || (r->Error != 0) || !(r->lif.Sections & LIF_SEC_IDLIST) ||
+    (item < 0) || (item >= r->lif.lidl.NumItemIDs) || (item >= ITEMIDS) ||
+    (field < 0) || (field >= LIF_I_NUMFIELDS) ||
+    (!r->Text && (lif_make_text(r) < 0)))
+  {
+    return "";
+  }
+  return (const char *)&r->lif_a->lidla.Items[item] + lif_item_fields[field];
+}
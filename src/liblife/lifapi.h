@@ -0,0 +1,244 @@
+/***************************************************************
+**                                                            **
+**                    lifapi.h                                **
+**                                                            **
+**    The stable interface to liblife for programs that link  **
+** to it as a shared library (liblife.so, see INSTALLATION).  **
+** The LIF & LIF_A structures in liblife.h change whenever    **
+** more of a link file is decoded, so here they are hidden    **
+** behind handles and read with accessor functions: numbers   **
+** are asked for by LIF_N_* field and text (as lifer would    **
+** print it) by LIF_T_* field. New fields are only ever added **
+** to the end of the lists, within a major version a program  **
+** built against an older lifapi.h works with a newer library.**
+** Link files are parsed from memory, one at a time or a      **
+** batch at once, when the parser's threads share the work.   **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int lif_api_version(void)                                  **
+**      Returns the library's LIFAPI_VERSION (a program can   **
+**      check it has at least the minor version it was built  **
+**      against).                                             **
+**                                                            **
+** struct LIF_PARSER * lif_parser_new(uint32_t sections,      **
+**                                    uint32_t options,       **
+**                                    int threads)            **
+**      Returns a parser (NULL if out of memory) that decodes **
+**      the LIF_PARSE_* sections in 'sections' (the header is **
+**      always decoded), with the LIF_OPT_* 'options', using  **
+**      up to 'threads' threads for a batch (1 for none, 0    **
+**      for one per processor).                               **
+**                                                            **
+** void lif_parser_free(struct LIF_PARSER * p)                **
+**      Frees a parser.                                       **
+**                                                            **
+** struct LIF_RESULT * lif_result_new(void)                   **
+** void lif_result_free(struct LIF_RESULT * r)                **
+**      Allocate and free a result (a decoded link file, it   **
+**      is big, so reuse them). lif_result_new() returns NULL **
+**      if out of memory.                                     **
+**                                                            **
+** int lif_parse(struct LIF_PARSER * p, const void * buf,     **
+**               size_t size, struct LIF_RESULT * r)          **
+**      Decodes the link file in buf (size bytes) into r.     **
+**      Returns 0 if successful, a LIF_E_* error if not.      **
+**                                                            **
+** size_t lif_parse_batch(struct LIF_PARSER * p, size_t n,    **
+**                        const void * const bufs[],          **
+**                        const size_t sizes[],               **
+**                        struct LIF_RESULT * results[])      **
+**      As lif_parse() for each of the n buffers, into the    **
+**      result of the same index. Returns the number decoded  **
+**      successfully, lif_result_error() gives the error of   **
+**      each one that was not.                                **
+**                                                            **
+** int lif_result_error(const struct LIF_RESULT * r)          **
+**      Returns the result of the parse that filled r (0 or a **
+**      LIF_E_* error).                                       **
+**                                                            **
+** const char * lif_strerror(int err)                         **
+**      Returns a description of a LIF_E_* error.             **
+**                                                            **
+** int64_t lif_number(const struct LIF_RESULT * r, int field) **
+**      Returns the value of a LIF_N_* field, 0 if the link   **
+**      doesn't have it (or it was not decoded).              **
+**                                                            **
+** const char * lif_text(struct LIF_RESULT * r, int field)    **
+**      Returns the text of a LIF_T_* field, "" if there is   **
+**      none. The text is made the first time any is asked    **
+**      for (unless LIF_OPT_TEXT) and is valid until r is     **
+**      parsed into again or freed.                           **
+**                                                            **
+** const char * lif_item_text(struct LIF_RESULT * r,          **
+**                            int item, int field)            **
+**      As lif_text() for a LIF_I_* field of one of the       **
+**      LinkTargetIDList's shell items (0 to LIF_N_ITEMIDS-1).**
+**                                                            **
+** Handles are not locked: a result (or a parser) must only   **
+** be used by one thread at a time, different ones can be     **
+** used by different threads. Text is multibyte in the        **
+** caller's locale, as lifer's output is.                     **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIFAPI_H_
+#define _LIFAPI_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The version of this interface, major * 10000 + minor * 100 + patch. The
+// major version (the .so's number) changes only if something is taken away
+#define LIFAPI_VERSION_MAJOR  1
+#define LIFAPI_VERSION_MINOR  0
+#define LIFAPI_VERSION_PATCH  0
+#define LIFAPI_VERSION        ((LIFAPI_VERSION_MAJOR * 10000) + (LIFAPI_VERSION_MINOR * 100) + LIFAPI_VERSION_PATCH)
+
+// Only the functions below are exported from the shared library
+#if defined(_WIN32) && defined(LIFAPI_BUILD)
+#define LIFAPI __declspec(dllexport)
+#elif defined(__GNUC__)
+#define LIFAPI __attribute__((visibility("default")))
+#else
+#define LIFAPI
+#endif
+
+// Sections for lif_parser_new() (the same bits as liblife's LIF_SEC_*)
+#define LIF_PARSE_IDLIST      0x00000002
+#define LIF_PARSE_LINKINFO    0x00000004
+#define LIF_PARSE_STRINGDATA  0x00000008
+#define LIF_PARSE_EXTRADATA   0x0007FF00
+#define LIF_PARSE_ALL         0xFFFFFFFF
+
+// Options for lif_parser_new()
+#define LIF_OPT_TEXT          0x00000001 // Make the text when parsing (in the batch's threads)
+#define LIF_OPT_NUMERIC       0x00000002 // LIF_T_FLAGS & LIF_T_ATTRIBUTES are just the bit masks
+
+// Errors
+#define LIF_E_NOTLINK         -1 // Not a link file
+#define LIF_E_SHORT           -2 // Too short to be a link file (less than the 76 byte header)
+#define LIF_E_DECODE          -3 // A section could not be decoded
+#define LIF_E_NOMEM           -4 // Out of memory
+#define LIF_E_ARGS            -5 // A NULL handle or buffer, or a buffer of 2GiB or more
+#define LIF_E_NOTPARSED       -6 // The result hasn't been parsed into
+#define LIF_E_STOPPED         -7 // A lif_walk() callback stopped the walk
+
+// Number fields for lif_number()
+enum LIF_NUMBER
+{
+  LIF_N_FLAGS = 0,            // LinkFlags
+  LIF_N_ATTRIBUTES,           // FileAttributes of the target
+  LIF_N_CREATION_TIME,        // Target's times (FILETIMEs, 100ns since 1601-01-01 UTC)
+  LIF_N_ACCESS_TIME,
+  LIF_N_WRITE_TIME,
+  LIF_N_FILE_SIZE,            // Target's size
+  LIF_N_ICON_INDEX,
+  LIF_N_SHOW_STATE,
+  LIF_N_HOTKEY,               // Low byte the key, high byte the modifiers
+  LIF_N_ITEMIDS,              // Shell items in the LinkTargetIDList
+  LIF_N_LINKINFO_FLAGS,
+  LIF_N_DRIVE_TYPE,
+  LIF_N_DRIVE_SERIAL,
+  LIF_N_NETWORK_PROVIDER,
+  LIF_N_EXTRADATA,            // Mask of the ExtraData blocks present (liblife's EDTYPES)
+  LIF_N_CODEPAGE,             // ConsoleFEDataBlock
+  LIF_N_SPECIAL_FOLDER,       // SpecialFolderDataBlock's ID
+  LIF_N_TRACKER_TIME,         // FILETIME of the tracker's file droid
+  LIF_N_NUMFIELDS
+};
+
+// Text fields for lif_text()
+enum LIF_TEXT
+{
+  LIF_T_FLAGS = 0,
+  LIF_T_ATTRIBUTES,
+  LIF_T_CREATION_TIME,        // "yyyy-mm-dd hh:mm:ss (UTC)"
+  LIF_T_ACCESS_TIME,
+  LIF_T_WRITE_TIME,
+  LIF_T_SHOW_STATE,
+  LIF_T_HOTKEY,
+  LIF_T_NAME,                 // StringData
+  LIF_T_RELATIVE_PATH,
+  LIF_T_WORKING_DIR,
+  LIF_T_ARGUMENTS,
+  LIF_T_ICON_LOCATION,
+  LIF_T_LOCAL_BASE_PATH,      // LinkInfo
+  LIF_T_LOCAL_BASE_PATH_UNICODE,
+  LIF_T_COMMON_PATH_SUFFIX,
+  LIF_T_COMMON_PATH_SUFFIX_UNICODE,
+  LIF_T_DRIVE_TYPE,
+  LIF_T_VOLUME_LABEL,
+  LIF_T_VOLUME_LABEL_UNICODE,
+  LIF_T_NET_NAME,
+  LIF_T_DEVICE_NAME,
+  LIF_T_EXTRADATA,            // The ExtraData blocks present
+  LIF_T_ENV_TARGET,           // EnvironmentVariableDataBlock
+  LIF_T_ENV_TARGET_UNICODE,
+  LIF_T_ICON_ENV_TARGET_UNICODE,
+  LIF_T_DARWIN_UNICODE,
+  LIF_T_KNOWN_FOLDER,         // The KnownFolderID GUID
+  LIF_T_KNOWN_FOLDER_NAME,
+  LIF_T_SHIM_LAYER,
+  LIF_T_MACHINE_ID,           // TrackerDataBlock
+  LIF_T_VOLUME_DROID,
+  LIF_T_FILE_DROID,
+  LIF_T_NUMFIELDS
+};
+
+// Shell item fields for lif_item_text()
+enum LIF_ITEM
+{
+  LIF_I_TYPE = 0,             // e.g. "File entry"
+  LIF_I_NAME,                 // Drive, short name, network location or URI
+  LIF_I_LONG_NAME,
+  LIF_I_MODIFIED,
+  LIF_I_FILE_SIZE,
+  LIF_I_MFT_ENTRY,
+  LIF_I_NUMFIELDS
+};
+
+struct LIF_PARSER;
+struct LIF_RESULT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LIFAPI int lif_api_version(void);
+LIFAPI struct LIF_PARSER * lif_parser_new(uint32_t, uint32_t, int);
+LIFAPI void lif_parser_free(struct LIF_PARSER *);
+LIFAPI struct LIF_RESULT * lif_result_new(void);
+LIFAPI void lif_result_free(struct LIF_RESULT *);
+LIFAPI int lif_parse(struct LIF_PARSER *, const void *, size_t, struct LIF_RESULT *);
+LIFAPI size_t lif_parse_batch(struct LIF_PARSER *, size_t, const void * const [], const size_t [], struct LIF_RESULT * []);
+LIFAPI int lif_result_error(const struct LIF_RESULT *);
+LIFAPI const char * lif_strerror(int);
+LIFAPI int64_t lif_number(const struct LIF_RESULT *, int);
+LIFAPI const char * lif_text(struct LIF_RESULT *, int);
+LIFAPI const char * lif_item_text(struct LIF_RESULT *, int, int);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,225 @@
+// lifguids.h - generated by mkguids.c from guids.txt, do not edit.
+// Included by liblife.c only, see mkguids.c for the hashing scheme.
+
+struct LIF_GUID_NAME
+{
+  struct LIF_CLSID   Guid;
+  uint32_t           PID;   // Property ID (0 in the GUID table)
+  const char *       Name;
+};
+
+#define GUID_NAMES    138
+#define GUID_BUCKETS  69
+
+static const uint16_t guid_disp[GUID_BUCKETS] =
+{
+     12,    3,    2,    2,    0,   11,    3,    6,    2,    0,
+      3,    6,    4,   42,   13,    1,   42,    1,   32,    1,
+      0,    5,   22,    4,    0,    1,   24,    9,   24,    1,
+      1,    4,    3,    0,   55,    1,    3,    2,    6,    1,
+      1,    1,    2,   11,   12,   14,    3,    0,   33,    0,
+      5,   10,    5,    1,    2,   13,    5,    0,    2,    2,
+      7,   22,    6,   22,    3,    8,   37,  133,   26
+};
+
+static const struct LIF_GUID_NAME guid_names[GUID_NAMES] =
+{
+  { { 0x7C5A40EF, 0xA0FB, 0x4BFC, { 0x87, 0x4A }, { 0xC0, 0xF2, 0xE0, 0xB9, 0xFA, 0x8E } }, 0, "FOLDERID_ProgramFilesX86" },
+  { { 0x2C36C0AA, 0x5812, 0x4B87, { 0xBF, 0xD0 }, { 0x4C, 0xD0, 0xDF, 0xB1, 0x9B, 0x39 } }, 0, "FOLDERID_OriginalImages" },
+  { { 0xDFDF76A2, 0xC82A, 0x4D63, { 0x90, 0x6A }, { 0x56, 0x44, 0xAC, 0x45, 0x73, 0x85 } }, 0, "FOLDERID_Public" },
+  { { 0xED228FDF, 0x9EA8, 0x4870, { 0x83, 0xB1 }, { 0x96, 0xB0, 0x2C, 0xFE, 0x0D, 0x52 } }, 0, "Games Explorer" },
+  { { 0x26EE0668, 0xA00A, 0x44D7, { 0x93, 0x71 }, { 0xBE, 0xB0, 0x64, 0xC9, 0x86, 0x83 } }, 0, "Control Panel (Category View)" },
+  { { 0x374DE290, 0x123F, 0x4565, { 0x91, 0x64 }, { 0x39, 0xC4, 0x92, 0x5E, 0x46, 0x7B } }, 0, "FOLDERID_Downloads" },
+  { { 0x871C5380, 0x42A0, 0x1069, { 0xA2, 0xEA }, { 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D } }, 0, "Internet Explorer" },
+  { { 0xF38BF404, 0x1D43, 0x42F2, { 0x93, 0x05 }, { 0x67, 0xDE, 0x0B, 0x28, 0xFC, 0x23 } }, 0, "FOLDERID_Windows" },
+  { { 0xBCB5256F, 0x79F6, 0x4CEE, { 0xB7, 0x25 }, { 0xDC, 0x34, 0xE4, 0x02, 0xFD, 0x46 } }, 0, "FOLDERID_ImplicitAppShortcuts" },
+  { { 0xEE32E446, 0x31CA, 0x4ABA, { 0x81, 0x4F }, { 0xA5, 0xEB, 0xD2, 0xFD, 0x6D, 0x5E } }, 0, "FOLDERID_SEARCH_CSC" },
+  { { 0xA77F5D77, 0x2E2B, 0x44C3, { 0xA6, 0xA2 }, { 0xAB, 0xA6, 0x01, 0x05, 0x4A, 0x51 } }, 0, "FOLDERID_Programs" },
+  { { 0x724EF170, 0xA42D, 0x4FEF, { 0x9F, 0x26 }, { 0xB6, 0x0E, 0x84, 0x6F, 0xBA, 0x4F } }, 0, "FOLDERID_AdminTools" },
+  { { 0xA302545D, 0xDEFF, 0x464B, { 0xAB, 0xE8 }, { 0x61, 0xC8, 0x64, 0x8D, 0x93, 0x9B } }, 0, "FOLDERID_UsersLibraries" },
+  { { 0xE17D4FC0, 0x5564, 0x11D1, { 0x83, 0xF2 }, { 0x00, 0xA0, 0xC9, 0x0D, 0xC8, 0x49 } }, 0, "Search Results" },
+  { { 0x190337D1, 0xB8CA, 0x4121, { 0xA6, 0x39 }, { 0x6D, 0x47, 0x2D, 0x16, 0x97, 0x2A } }, 0, "FOLDERID_SearchHome" },
+  { { 0xA75D362E, 0x50FC, 0x4FB7, { 0xAC, 0x2C }, { 0xA8, 0xBE, 0xAA, 0x31, 0x44, 0x93 } }, 0, "FOLDERID_SidebarParts" },
+  { { 0xF3CE0F7C, 0x4901, 0x4ACC, { 0x86, 0x48 }, { 0xD5, 0xD4, 0x4B, 0x04, 0xEF, 0x8F } }, 0, "FOLDERID_UsersFiles" },
+  { { 0xB4FB3F98, 0xC1EA, 0x428D, { 0xA7, 0x8A }, { 0xD1, 0xF5, 0x65, 0x9C, 0xBA, 0x93 } }, 0, "Other Users Folder" },
+  { { 0x2A00375E, 0x224C, 0x49DE, { 0xB8, 0xD1 }, { 0x44, 0x0D, 0xF7, 0xEF, 0x3D, 0xDC } }, 0, "FOLDERID_LocalizedResourcesDir" },
+  { { 0x1777F761, 0x68AD, 0x4D8A, { 0x87, 0xBD }, { 0x30, 0xB7, 0x59, 0xFA, 0x33, 0xDD } }, 0, "FOLDERID_Favorites" },
+  { { 0x52528A6B, 0xB9E3, 0x4ADD, { 0xB6, 0x0D }, { 0x58, 0x8C, 0x2D, 0xBA, 0x84, 0x2D } }, 0, "FOLDERID_HomeGroup" },
+  { { 0xCAC52C1A, 0xB53D, 0x4EDC, { 0x92, 0xD7 }, { 0x6B, 0x2E, 0x8A, 0xC1, 0x94, 0x34 } }, 0, "FOLDERID_Games" },
+  { { 0xF1B32785, 0x6FBA, 0x4FCF, { 0x9D, 0x55 }, { 0x7B, 0x8E, 0x7F, 0x15, 0x70, 0x91 } }, 0, "FOLDERID_LocalAppData" },
+  { { 0xA52BBA46, 0xE9E1, 0x435F, { 0xB3, 0xD9 }, { 0x28, 0xDA, 0xA6, 0x48, 0xC0, 0xF6 } }, 0, "FOLDERID_SkyDrive" },
+  { { 0x018D5C66, 0x4533, 0x4307, { 0x9B, 0x53 }, { 0x22, 0x4D, 0xE2, 0xED, 0x1F, 0xE6 } }, 0, "OneDrive" },
+  { { 0x33E28130, 0x4E1E, 0x4676, { 0x83, 0x5A }, { 0x98, 0x39, 0x5C, 0x3B, 0xC3, 0xBB } }, 0, "FOLDERID_Pictures" },
+  { { 0x1AC14E77, 0x02E7, 0x4E5D, { 0xB7, 0x44 }, { 0x2E, 0xB1, 0xAE, 0x51, 0x98, 0xB7 } }, 0, "FOLDERID_System" },
+  { { 0x82A5EA35, 0xD9CD, 0x47C5, { 0x96, 0x29 }, { 0xE1, 0x5D, 0x2F, 0x71, 0x4E, 0x6E } }, 0, "FOLDERID_CommonStartup" },
+  { { 0x905E63B6, 0xC1BF, 0x494E, { 0xB2, 0x9C }, { 0x65, 0xB7, 0x32, 0xD3, 0xD2, 0x1A } }, 0, "FOLDERID_ProgramFiles" },
+  { { 0xF7F1ED05, 0x9F6D, 0x47A2, { 0xAA, 0xAE }, { 0x29, 0xD3, 0x17, 0xC6, 0xF0, 0x66 } }, 0, "FOLDERID_ProgramFilesCommon" },
+  { { 0x1F4DE370, 0xD627, 0x11D1, { 0xBA, 0x4F }, { 0x00, 0xA0, 0xC9, 0x1E, 0xED, 0xBA } }, 0, "Search Results - Computers" },
+  { { 0x69D2CF90, 0xFC33, 0x4FB7, { 0x9A, 0x0C }, { 0xEB, 0xB0, 0xF0, 0xFC, 0xB4, 0x3C } }, 0, "FOLDERID_PhotoAlbums" },
+  { { 0xC870044B, 0xF49E, 0x4126, { 0xA9, 0xC3 }, { 0xB5, 0x2A, 0x1F, 0xF4, 0x11, 0xE8 } }, 0, "FOLDERID_Ringtones" },
+  { { 0x679F85CB, 0x0220, 0x4080, { 0xB2, 0x9B }, { 0x55, 0x40, 0xCC, 0x05, 0xAA, 0xB6 } }, 0, "Quick Access" },
+  { { 0x3EB685DB, 0x65F9, 0x4CF6, { 0xA0, 0x3A }, { 0xE3, 0xEF, 0x65, 0x72, 0x9F, 0x3D } }, 0, "FOLDERID_RoamingAppData" },
+  { { 0x48DAF80B, 0xE6CF, 0x4F4E, { 0xB8, 0x00 }, { 0x0E, 0x69, 0xD8, 0x4E, 0xE3, 0x84 } }, 0, "FOLDERID_PublicLibraries" },
+  { { 0x008CA0B1, 0x55B4, 0x4C56, { 0xB8, 0xA8 }, { 0x4D, 0xE4, 0xB2, 0x99, 0xD3, 0xBE } }, 0, "FOLDERID_AccountPictures" },
+  { { 0x4234D49B, 0x0245, 0x4DF3, { 0xB7, 0x80 }, { 0x38, 0x93, 0x94, 0x34, 0x56, 0xE1 } }, 0, "Applications" },
+  { { 0xB97D20BB, 0xF46A, 0x4C97, { 0xBA, 0x10 }, { 0x5E, 0x36, 0x08, 0x43, 0x08, 0x54 } }, 0, "FOLDERID_Startup" },
+  { { 0x20D04FE0, 0x3AEA, 0x1069, { 0xA2, 0xD8 }, { 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D } }, 0, "My Computer" },
+  { { 0x352481E8, 0x33BE, 0x4251, { 0xBA, 0x85 }, { 0x60, 0x07, 0xCA, 0xED, 0xCF, 0x9D } }, 0, "FOLDERID_InternetCache" },
+  { { 0x2400183A, 0x6185, 0x49FB, { 0xA2, 0xD8 }, { 0x4A, 0x39, 0x2A, 0x60, 0x2B, 0xA3 } }, 0, "FOLDERID_PublicVideos" },
+  { { 0x5E6C858F, 0x0E22, 0x4760, { 0x9A, 0xFE }, { 0xEA, 0x33, 0x17, 0xB6, 0x71, 0x73 } }, 0, "FOLDERID_Profile" },
+  { { 0x4BD8D571, 0x6D19, 0x48D3, { 0xBE, 0x97 }, { 0x42, 0x22, 0x20, 0x08, 0x0E, 0x43 } }, 0, "FOLDERID_Music" },
+  { { 0x8983036C, 0x27C0, 0x404B, { 0x8F, 0x08 }, { 0x10, 0x2D, 0x10, 0xDC, 0xFD, 0x74 } }, 0, "FOLDERID_SendTo" },
+  { { 0x1B3EA5DC, 0xB587, 0x4786, { 0xB4, 0xEF }, { 0xBD, 0x1D, 0xC3, 0x32, 0xAE, 0xAE } }, 0, "FOLDERID_Libraries" },
+  { { 0xC1BAE2D0, 0x10DF, 0x4334, { 0xBE, 0xDD }, { 0x7A, 0xA2, 0x0B, 0x22, 0x7A, 0x9D } }, 0, "FOLDERID_CommonOEMLinks" },
+  { { 0xD20BEEC4, 0x5CA8, 0x4905, { 0xAE, 0x3B }, { 0xBF, 0x25, 0x1E, 0xA0, 0x9B, 0x53 } }, 0, "FOLDERID_NetworkFolder" },
+  { { 0x5E591A74, 0xDF96, 0x48D3, { 0x8D, 0x67 }, { 0x17, 0x33, 0xBC, 0xEE, 0x28, 0xBA } }, 0, "Delegate Folder" },
+  { { 0x24AD3AD4, 0xA569, 0x4530, { 0x98, 0xE1 }, { 0xAB, 0x02, 0xF9, 0x41, 0x7A, 0xA8 } }, 0, "Pictures (This PC)" },
+  { { 0x7B0DB17D, 0x9CD2, 0x4A93, { 0x97, 0x33 }, { 0x46, 0xCC, 0x89, 0x02, 0x2E, 0x7C } }, 0, "FOLDERID_DocumentsLibrary" },
+  { { 0x22877A6D, 0x37A1, 0x461A, { 0x91, 0xB0 }, { 0xDB, 0xDA, 0x5A, 0xAE, 0xBC, 0x99 } }, 0, "Recent Places" },
+  { { 0xBFB9D5E0, 0xC6A9, 0x404C, { 0xB2, 0xB2 }, { 0xAE, 0x6D, 0xB6, 0xAF, 0x49, 0x68 } }, 0, "FOLDERID_Links" },
+  { { 0x2227A280, 0x3AEA, 0x1069, { 0xA2, 0xDE }, { 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D } }, 0, "Printers" },
+  { { 0x031E4825, 0x7B94, 0x4DC3, { 0xB1, 0x31 }, { 0xE9, 0x46, 0xB4, 0x4C, 0x8D, 0xD5 } }, 0, "Libraries" },
+  { { 0x0139D44E, 0x6AFE, 0x49F2, { 0x86, 0x90 }, { 0x3D, 0xAF, 0xCA, 0xE6, 0xFF, 0xB8 } }, 0, "FOLDERID_CommonPrograms" },
+  { { 0x31C0DD25, 0x9439, 0x4F12, { 0xBF, 0x41 }, { 0x7F, 0xF4, 0xED, 0xA3, 0x87, 0x22 } }, 0, "FOLDERID_3DObjects" },
+  { { 0x59031A47, 0x3F72, 0x44A7, { 0x89, 0xC5 }, { 0x55, 0x95, 0xFE, 0x6B, 0x30, 0xEE } }, 0, "Users Files" },
+  { { 0xD9DC8A3B, 0xB784, 0x432E, { 0xA7, 0x81 }, { 0x5A, 0x11, 0x30, 0xA7, 0x59, 0x63 } }, 0, "FOLDERID_History" },
+  { { 0x6D809377, 0x6AF0, 0x444B, { 0x89, 0x57 }, { 0xA3, 0x77, 0x3F, 0x02, 0x20, 0x0E } }, 0, "FOLDERID_ProgramFilesX64" },
+  { { 0xD20EA4E1, 0x3957, 0x11D2, { 0xA4, 0x0B }, { 0x0C, 0x50, 0x20, 0x52, 0x41, 0x53 } }, 0, "Administrative Tools" },
+  { { 0x6365D5A7, 0x0F0D, 0x45E5, { 0x87, 0xF6 }, { 0x0D, 0xA5, 0x6B, 0x6A, 0x4F, 0x7D } }, 0, "FOLDERID_ProgramFilesCommonX64" },
+  { { 0xB6EBFB86, 0x6907, 0x413C, { 0x9A, 0xF7 }, { 0x4F, 0xC2, 0xAB, 0xF0, 0x7C, 0xC5 } }, 0, "FOLDERID_PublicPictures" },
+  { { 0x5CE4A5E9, 0xE4EB, 0x479D, { 0xB8, 0x9F }, { 0x13, 0x0C, 0x02, 0x88, 0x61, 0x55 } }, 0, "FOLDERID_DeviceMetadataStore" },
+  { { 0x1A6FDBA2, 0xF42D, 0x4358, { 0xA7, 0x98 }, { 0xB7, 0x4D, 0x74, 0x59, 0x26, 0xC5 } }, 0, "FOLDERID_RecordedTVLibrary" },
+  { { 0xDEBF2536, 0xE1A8, 0x4C59, { 0xB6, 0xA2 }, { 0x41, 0x45, 0x86, 0x47, 0x6A, 0xEA } }, 0, "FOLDERID_PublicGameTasks" },
+  { { 0x5CD7AEE2, 0x2219, 0x4A67, { 0xB8, 0x5D }, { 0x6C, 0x9C, 0xE1, 0x56, 0x60, 0xCB } }, 0, "FOLDERID_UserProgramFiles" },
+  { { 0x18989B1D, 0x99B5, 0x455B, { 0x84, 0x1C }, { 0xAB, 0x7C, 0x74, 0xE4, 0xDD, 0xFC } }, 0, "FOLDERID_Videos" },
+  { { 0x76FC4E2D, 0xD6AD, 0x4519, { 0xA6, 0x63 }, { 0x37, 0xBD, 0x56, 0x06, 0x81, 0x85 } }, 0, "FOLDERID_PrintersFolder" },
+  { { 0x859EAD94, 0x2E85, 0x48AD, { 0xA7, 0x1A }, { 0x09, 0x69, 0xCB, 0x56, 0xA6, 0xCD } }, 0, "FOLDERID_SampleVideos" },
+  { { 0xAE50C081, 0xEBD2, 0x438A, { 0x86, 0x55 }, { 0x8A, 0x09, 0x2E, 0x34, 0x98, 0x7A } }, 0, "FOLDERID_Recent" },
+  { { 0x3D644C9B, 0x1FB8, 0x4F30, { 0x9B, 0x45 }, { 0xF6, 0x70, 0x23, 0x5F, 0x79, 0xC0 } }, 0, "FOLDERID_PublicDownloads" },
+  { { 0xC4900540, 0x2379, 0x4C75, { 0x84, 0x4B }, { 0x64, 0xE6, 0xFA, 0xF8, 0x71, 0x6B } }, 0, "FOLDERID_SamplePictures" },
+  { { 0xA520A1A4, 0x1780, 0x4FF6, { 0xBD, 0x18 }, { 0x16, 0x73, 0x43, 0xC5, 0xAF, 0x16 } }, 0, "FOLDERID_LocalAppDataLow" },
+  { { 0x56784854, 0xC6CB, 0x462B, { 0x81, 0x69 }, { 0x88, 0xE3, 0x50, 0xAC, 0xB8, 0x82 } }, 0, "FOLDERID_Contacts" },
+  { { 0xC4AA340D, 0xF20F, 0x4863, { 0xAF, 0xEF }, { 0xF8, 0x7E, 0xF2, 0xE6, 0xBA, 0x25 } }, 0, "FOLDERID_PublicDesktop" },
+  { { 0x2112AB0A, 0xC86A, 0x4FFE, { 0xA3, 0x68 }, { 0x0D, 0xE9, 0x6E, 0x47, 0x01, 0x2E } }, 0, "FOLDERID_MusicLibrary" },
+  { { 0x43668BF8, 0xC14E, 0x49B2, { 0x97, 0xC9 }, { 0x74, 0x77, 0x84, 0xD7, 0x84, 0xB7 } }, 0, "FOLDERID_SyncManagerFolder" },
+  { { 0xA305CE99, 0xF527, 0x492B, { 0x8B, 0x1A }, { 0x7E, 0x76, 0xFA, 0x98, 0xD6, 0xE4 } }, 0, "FOLDERID_AppUpdates" },
+  { { 0x0AC0837C, 0xBBF8, 0x452A, { 0x85, 0x0D }, { 0x79, 0xD0, 0x8E, 0x66, 0x7C, 0xA7 } }, 0, "FOLDERID_ComputerFolder" },
+  { { 0x0762D272, 0xC50A, 0x4BB0, { 0xA3, 0x82 }, { 0x69, 0x7D, 0xCD, 0x72, 0x9B, 0x80 } }, 0, "FOLDERID_UserProfiles" },
+  { { 0x2B0F765D, 0xC0E9, 0x4171, { 0x90, 0x8E }, { 0x08, 0xA6, 0x11, 0xB8, 0x4F, 0xF6 } }, 0, "FOLDERID_Cookies" },
+  { { 0x9E3995AB, 0x1F9C, 0x4F13, { 0xB8, 0x27 }, { 0x48, 0xB2, 0x4B, 0x6C, 0x71, 0x74 } }, 0, "FOLDERID_UserPinned" },
+  { { 0x4BFEFB45, 0x347D, 0x4006, { 0xA5, 0xBE }, { 0xAC, 0x0C, 0xB0, 0x56, 0x71, 0x92 } }, 0, "FOLDERID_ConflictFolder" },
+  { { 0xB250C668, 0xF57D, 0x4EE1, { 0xA6, 0x3C }, { 0x29, 0x0E, 0xE7, 0xD1, 0xAA, 0x1F } }, 0, "FOLDERID_SampleMusic" },
+  { { 0x9343812E, 0x1C37, 0x4A49, { 0xA1, 0x2E }, { 0x4B, 0x2D, 0x81, 0x0D, 0x95, 0x6B } }, 0, "Search Home" },
+  { { 0xA63293E8, 0x664E, 0x48DB, { 0xA0, 0x79 }, { 0xDF, 0x75, 0x9E, 0x05, 0x09, 0xF7 } }, 0, "FOLDERID_Templates" },
+  { { 0x645FF040, 0x5081, 0x101B, { 0x9F, 0x08 }, { 0x00, 0xAA, 0x00, 0x2F, 0x95, 0x4E } }, 0, "Recycle Bin" },
+  { { 0xA990AE9F, 0xA03B, 0x4E80, { 0x94, 0xBC }, { 0x99, 0x12, 0xD7, 0x50, 0x41, 0x04 } }, 0, "FOLDERID_PicturesLibrary" },
+  { { 0xDE974D24, 0xD9C6, 0x4D3E, { 0xBF, 0x91 }, { 0xF4, 0x45, 0x51, 0x20, 0xB9, 0x17 } }, 0, "FOLDERID_ProgramFilesCommonX86" },
+  { { 0x9274BD8D, 0xCFD1, 0x41C3, { 0xB3, 0x5E }, { 0xB1, 0x3F, 0x55, 0xA7, 0x58, 0xF4 } }, 0, "FOLDERID_PrintHood" },
+  { { 0x3080F90E, 0xD7AD, 0x11D9, { 0xBD, 0x98 }, { 0x00, 0x00, 0x94, 0x7B, 0x02, 0x57 } }, 0, "Window Switcher" },
+  { { 0x7D1D3A04, 0xDEBB, 0x4115, { 0x95, 0xCF }, { 0x2F, 0x29, 0xDA, 0x29, 0x20, 0xDA } }, 0, "FOLDERID_SavedSearches" },
+  { { 0x0DB7E03F, 0xFC29, 0x4DC6, { 0x90, 0x20 }, { 0xFF, 0x41, 0xB5, 0x9E, 0x51, 0x3A } }, 0, "3D Objects (This PC)" },
+  { { 0xF02C1A0D, 0xBE21, 0x4350, { 0x88, 0xB0 }, { 0x73, 0x67, 0xFC, 0x96, 0xEF, 0x3C } }, 0, "Network" },
+  { { 0xAB5FB87B, 0x7CE2, 0x4F83, { 0x91, 0x5D }, { 0x55, 0x08, 0x46, 0xC9, 0x53, 0x7B } }, 0, "FOLDERID_CameraRoll" },
+  { { 0x3DFDF296, 0xDBEC, 0x4FB4, { 0x81, 0xD1 }, { 0x6A, 0x34, 0x38, 0xBC, 0xF4, 0xDE } }, 0, "Music (This PC)" },
+  { { 0x4D9F7874, 0x4E0C, 0x4904, { 0x96, 0x7B }, { 0x40, 0xB0, 0xD2, 0x0C, 0x3E, 0x4B } }, 0, "FOLDERID_InternetFolder" },
+  { { 0x054FAE61, 0x4DD8, 0x4787, { 0x80, 0xB6 }, { 0x09, 0x02, 0x20, 0xC4, 0xB7, 0x00 } }, 0, "FOLDERID_GameTasks" },
+  { { 0xB94237E7, 0x57AC, 0x4347, { 0x91, 0x51 }, { 0xB0, 0x8C, 0x6C, 0x32, 0xD1, 0xF7 } }, 0, "FOLDERID_CommonTemplates" },
+  { { 0xED4824AF, 0xDCE4, 0x45A8, { 0x81, 0xE2 }, { 0xFC, 0x79, 0x65, 0x08, 0x36, 0x34 } }, 0, "FOLDERID_PublicDocuments" },
+  { { 0x3214FAB5, 0x9757, 0x4298, { 0xBB, 0x61 }, { 0x92, 0xA9, 0xDE, 0xAA, 0x44, 0xFF } }, 0, "FOLDERID_PublicMusic" },
+  { { 0x21EC2020, 0x3AEA, 0x1069, { 0xA2, 0xDD }, { 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D } }, 0, "Control Panel" },
+  { { 0xB4BFCC3A, 0xDB2C, 0x424C, { 0xB0, 0x29 }, { 0x7F, 0xE9, 0x9A, 0x87, 0xC6, 0x41 } }, 0, "FOLDERID_Desktop" },
+  { { 0xDE61D971, 0x5EBC, 0x4F02, { 0xA3, 0xA9 }, { 0x6C, 0x82, 0x89, 0x5E, 0x5C, 0x04 } }, 0, "FOLDERID_AddNewPrograms" },
+  { { 0x3080F90D, 0xD7AD, 0x11D9, { 0xBD, 0x98 }, { 0x00, 0x00, 0x94, 0x7B, 0x02, 0x57 } }, 0, "Show Desktop" },
+  { { 0xD0384E7D, 0xBAC3, 0x4797, { 0x8F, 0x14 }, { 0xCB, 0xA2, 0x29, 0xB3, 0x92, 0xB5 } }, 0, "FOLDERID_CommonAdminTools" },
+  { { 0xB7534046, 0x3ECB, 0x4C18, { 0xBE, 0x4E }, { 0x64, 0xCD, 0x4C, 0xB7, 0xD6, 0xAC } }, 0, "FOLDERID_RecycleBinFolder" },
+  { { 0x088E3905, 0x0323, 0x4B02, { 0x98, 0x26 }, { 0x5D, 0x99, 0x42, 0x8E, 0x11, 0x5F } }, 0, "Downloads (This PC)" },
+  { { 0xC5ABBF53, 0xE17F, 0x4121, { 0x89, 0x00 }, { 0x86, 0x62, 0x6F, 0xC2, 0xC9, 0x73 } }, 0, "FOLDERID_NetHood" },
+  { { 0x4C5C32FF, 0xBB9D, 0x43B0, { 0xB5, 0xB4 }, { 0x2D, 0x72, 0xE5, 0x4E, 0xAA, 0xA4 } }, 0, "FOLDERID_SavedGames" },
+  { { 0x6F0CD92B, 0x2E97, 0x45D1, { 0x88, 0xFF }, { 0xB0, 0xD1, 0x86, 0xB8, 0xDE, 0xDD } }, 0, "FOLDERID_ConnectionsFolder" },
+  { { 0xA4115719, 0xD62E, 0x491D, { 0xAA, 0x7C }, { 0xE7, 0x4B, 0x8B, 0xE3, 0xB0, 0x67 } }, 0, "FOLDERID_CommonStartMenu" },
+  { { 0x450D8FBA, 0xAD25, 0x11D0, { 0x98, 0xA8 }, { 0x08, 0x00, 0x36, 0x1B, 0x11, 0x03 } }, 0, "My Documents" },
+  { { 0xB7BEDE81, 0xDF94, 0x4682, { 0xA7, 0xD8 }, { 0x57, 0xA5, 0x26, 0x20, 0xB8, 0x6F } }, 0, "FOLDERID_Screenshots" },
+  { { 0x15CA69B3, 0x30EE, 0x49C1, { 0xAC, 0xE1 }, { 0x6B, 0x5E, 0xC3, 0x72, 0xAF, 0xB5 } }, 0, "FOLDERID_SamplePlaylists" },
+  { { 0x491E922F, 0x5643, 0x4AF4, { 0xA7, 0xEB }, { 0x4E, 0x7A, 0x13, 0x8D, 0x81, 0x74 } }, 0, "FOLDERID_VideosLibrary" },
+  { { 0x625B53C3, 0xAB48, 0x4EC1, { 0xBA, 0x1F }, { 0xA1, 0xEF, 0x41, 0x46, 0xFC, 0x19 } }, 0, "FOLDERID_StartMenu" },
+  { { 0x82A74AEB, 0xAEB4, 0x465C, { 0xA0, 0x14 }, { 0xD0, 0x97, 0xEE, 0x34, 0x6D, 0x63 } }, 0, "FOLDERID_ControlPanelFolder" },
+  { { 0xFDD39AD0, 0x238F, 0x46AF, { 0xAD, 0xB4 }, { 0x6C, 0x85, 0x48, 0x03, 0x69, 0xC7 } }, 0, "FOLDERID_Documents" },
+  { { 0x9E52AB10, 0xF80D, 0x49DF, { 0xAC, 0xB8 }, { 0x43, 0x30, 0xF5, 0x68, 0x78, 0x55 } }, 0, "FOLDERID_CDBurning" },
+  { { 0x52A4F021, 0x7B75, 0x48A9, { 0x9F, 0x6B }, { 0x4B, 0x87, 0xA2, 0x10, 0xBC, 0x8F } }, 0, "FOLDERID_QuickLaunch" },
+  { { 0x8AD10C31, 0x2ADB, 0x4296, { 0xA8, 0xF7 }, { 0xE4, 0x70, 0x12, 0x32, 0xC9, 0x72 } }, 0, "FOLDERID_ResourceDir" },
+  { { 0xF86FA3AB, 0x70D2, 0x4FC7, { 0x9C, 0x99 }, { 0xFC, 0xBF, 0x05, 0x46, 0x7F, 0x3A } }, 0, "Videos (This PC)" },
+  { { 0x7B396E54, 0x9EC5, 0x4300, { 0xBE, 0x0A }, { 0x24, 0x82, 0xEB, 0xAE, 0x1A, 0x26 } }, 0, "FOLDERID_SidebarDefaultParts" },
+  { { 0xD65231B0, 0xB2F1, 0x4857, { 0xA4, 0xCE }, { 0xA8, 0xE7, 0xC6, 0xEA, 0x7D, 0x27 } }, 0, "FOLDERID_SystemX86" },
+  { { 0x04731B67, 0xD933, 0x450A, { 0x90, 0xE6 }, { 0x4A, 0xCD, 0x2E, 0x94, 0x08, 0xFE } }, 0, "Search Folder" },
+  { { 0xD3162B92, 0x9365, 0x467A, { 0x95, 0x6B }, { 0x92, 0x70, 0x3A, 0xCA, 0x08, 0xAF } }, 0, "Documents (This PC)" },
+  { { 0xDE92C1C7, 0x837F, 0x4F69, { 0xA3, 0xBB }, { 0x86, 0xE6, 0x31, 0x20, 0x4A, 0x23 } }, 0, "FOLDERID_Playlists" },
+  { { 0x0F214138, 0xB1D3, 0x4A90, { 0xBB, 0xA9 }, { 0x27, 0xCB, 0xC0, 0xC5, 0x38, 0x9A } }, 0, "FOLDERID_SyncSetupFolder" },
+  { { 0xFD228CB7, 0xAE11, 0x4AE3, { 0x86, 0x4C }, { 0x16, 0xF3, 0x91, 0x0A, 0xB8, 0xFE } }, 0, "FOLDERID_Fonts" },
+  { { 0x289A9A43, 0xBE44, 0x4057, { 0xA4, 0x1B }, { 0x58, 0x7A, 0x76, 0xD7, 0xE7, 0xF9 } }, 0, "FOLDERID_SyncResultsFolder" },
+  { { 0x62AB5D82, 0xFDC1, 0x4DC3, { 0xA9, 0xDD }, { 0x07, 0x0D, 0x1D, 0x49, 0x5D, 0x97 } }, 0, "FOLDERID_ProgramData" },
+  { { 0x98EC0E18, 0x2098, 0x4D44, { 0x86, 0x44 }, { 0x66, 0x97, 0x93, 0x15, 0xA2, 0x81 } }, 0, "FOLDERID_SEARCH_MAPI" },
+  { { 0x7007ACC7, 0x3202, 0x11D1, { 0xAA, 0xD2 }, { 0x00, 0x80, 0x5F, 0xC1, 0x27, 0x0E } }, 0, "Network Connections" },
+  { { 0xDF7266AC, 0x9274, 0x4867, { 0x8D, 0x55 }, { 0x3B, 0xD6, 0x61, 0xDE, 0x87, 0x2D } }, 0, "FOLDERID_ChangeRemovePrograms" },
+  { { 0xD34A6CA6, 0x62C2, 0x4C34, { 0x8A, 0x7C }, { 0x14, 0x70, 0x9C, 0x1A, 0xD9, 0x38 } }, 0, "Common Places" },
+  { { 0x208D2C60, 0x3AEA, 0x1069, { 0xA2, 0xD7 }, { 0x08, 0x00, 0x2B, 0x30, 0x30, 0x9D } }, 0, "My Network Places" }
+};
+
+#define PKEY_NAMES    45
+#define PKEY_BUCKETS  23
+
+static const uint16_t pkey_disp[PKEY_BUCKETS] =
+{
+      0,    1,    1,    9,    9,    6,    0,    4,    6,    3,
+     15,    0,    2,    5,    4,    3,    6,    1,   12,    1,
+     21,   48,   45
+};
+
+static const struct LIF_GUID_NAME pkey_names[PKEY_NAMES] =
+{
+  { { 0x446D16B1, 0x8DAD, 0x4870, { 0xA7, 0x48 }, { 0x40, 0x2E, 0xA4, 0x3D, 0x78, 0x8C } }, 100, "System.ThumbnailCacheId" },
+  { { 0xE3E0584C, 0xB788, 0x4A5A, { 0xBB, 0x20 }, { 0x7F, 0x5A, 0x44, 0xC9, 0xAC, 0xDD } }, 6, "System.ItemFolderPathDisplay" },
+  { { 0xF29F85E0, 0x4FF9, 0x1068, { 0xAB, 0x91 }, { 0x08, 0x00, 0x2B, 0x27, 0xB3, 0xD9 } }, 18, "System.ApplicationName" },
+  { { 0x41CF5AE0, 0xF75A, 0x4806, { 0xBD, 0x87 }, { 0x59, 0xC7, 0xD9, 0x24, 0x8E, 0xB9 } }, 100, "System.FileName" },
+  { { 0xDABD30ED, 0x0043, 0x4789, { 0xA7, 0xF8 }, { 0xD0, 0x13, 0xA4, 0x73, 0x66, 0x22 } }, 100, "System.ItemFolderPathDisplayNarrow" },
+  { { 0xF29F85E0, 0x4FF9, 0x1068, { 0xAB, 0x91 }, { 0x08, 0x00, 0x2B, 0x27, 0xB3, 0xD9 } }, 6, "System.Comment" },
+  { { 0x46588AE2, 0x4CBC, 0x4338, { 0xBB, 0xFC }, { 0x13, 0x93, 0x26, 0x98, 0x6D, 0xCE } }, 4, "SID" },
+  { { 0xB9B4B3FC, 0x2B51, 0x4A42, { 0xB5, 0xD8 }, { 0x32, 0x41, 0x46, 0xAF, 0xCF, 0x25 } }, 8, "System.Link.TargetSFGAOFlags" },
+  { { 0x28636AA6, 0x953D, 0x11D2, { 0xB5, 0xD6 }, { 0x00, 0xC0, 0x4F, 0xD9, 0x18, 0xD0 } }, 2, "System.DescriptionID" },
+  { { 0xE4F10A3C, 0x49E6, 0x405D, { 0x82, 0x88 }, { 0xA2, 0x3B, 0xD4, 0xEE, 0xAA, 0x6C } }, 100, "System.FileExtension" },
+  { { 0x1E3EE840, 0xBC2B, 0x476C, { 0x82, 0x37 }, { 0x2A, 0xCD, 0x1A, 0x83, 0x9B, 0x22 } }, 3, "System.Kind" },
+  { { 0x28636AA6, 0x953D, 0x11D2, { 0xB5, 0xD6 }, { 0x00, 0xC0, 0x4F, 0xD9, 0x18, 0xD0 } }, 25, "System.SFGAOFlags" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 10, "System.ItemNameDisplay" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 3, "System.AppUserModel.RelaunchIconResource" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 2, "System.AppUserModel.RelaunchCommand" },
+  { { 0xE3E0584C, 0xB788, 0x4A5A, { 0xBB, 0x20 }, { 0x7F, 0x5A, 0x44, 0xC9, 0xAC, 0xDD } }, 7, "System.ItemPathDisplay" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 5, "System.AppUserModel.ID" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 2, "System.ItemFolderNameDisplay" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 13, "System.FileAttributes" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 12, "System.AppUserModel.StartPinOption" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 4, "System.ItemTypeText" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 8, "System.AppUserModel.ExcludeFromShowInNewInstall" },
+  { { 0xF29F85E0, 0x4FF9, 0x1068, { 0xAB, 0x91 }, { 0x08, 0x00, 0x2B, 0x27, 0xB3, 0xD9 } }, 5, "System.Keywords" },
+  { { 0x446D16B1, 0x8DAD, 0x4870, { 0xA7, 0x48 }, { 0x40, 0x2E, 0xA4, 0x3D, 0x78, 0x8C } }, 104, "System.VolumeId" },
+  { { 0x28636AA6, 0x953D, 0x11D2, { 0xB5, 0xD6 }, { 0x00, 0xC0, 0x4F, 0xD9, 0x18, 0xD0 } }, 24, "System.ParsingName" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 12, "System.Size" },
+  { { 0x9B174B35, 0x40FF, 0x11D2, { 0xA2, 0x7E }, { 0x00, 0xC0, 0x4F, 0xC3, 0x08, 0x71 } }, 3, "System.Capacity" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 14, "System.DateModified" },
+  { { 0xF29F85E0, 0x4FF9, 0x1068, { 0xAB, 0x91 }, { 0x08, 0x00, 0x2B, 0x27, 0xB3, 0xD9 } }, 2, "System.Title" },
+  { { 0x9B174B35, 0x40FF, 0x11D2, { 0xA2, 0x7E }, { 0x00, 0xC0, 0x4F, 0xC3, 0x08, 0x71 } }, 2, "System.FreeSpace" },
+  { { 0xB9B4B3FC, 0x2B51, 0x4A42, { 0xB5, 0xD8 }, { 0x32, 0x41, 0x46, 0xAF, 0xCF, 0x25 } }, 2, "System.Link.TargetParsingPath" },
+  { { 0x9B174B35, 0x40FF, 0x11D2, { 0xA2, 0x7E }, { 0x00, 0xC0, 0x4F, 0xC3, 0x08, 0x71 } }, 4, "System.Volume.FileSystem" },
+  { { 0x9B174B35, 0x40FF, 0x11D2, { 0xA2, 0x7E }, { 0x00, 0xC0, 0x4F, 0xC3, 0x08, 0x71 } }, 7, "System.Computer.DecoratedFreeSpace" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 9, "System.AppUserModel.PreventPinning" },
+  { { 0xF29F85E0, 0x4FF9, 0x1068, { 0xAB, 0x91 }, { 0x08, 0x00, 0x2B, 0x27, 0xB3, 0xD9 } }, 4, "System.Author" },
+  { { 0x28636AA6, 0x953D, 0x11D2, { 0xB5, 0xD6 }, { 0x00, 0xC0, 0x4F, 0xD9, 0x18, 0xD0 } }, 11, "System.ItemType" },
+  { { 0x28636AA6, 0x953D, 0x11D2, { 0xB5, 0xD6 }, { 0x00, 0xC0, 0x4F, 0xD9, 0x18, 0xD0 } }, 30, "System.ParsingPath" },
+  { { 0x436F2667, 0x14E2, 0x4FEB, { 0xB3, 0x0A }, { 0x14, 0x6C, 0x53, 0xB5, 0xB6, 0x74 } }, 100, "System.Link.Arguments" },
+  { { 0xF29F85E0, 0x4FF9, 0x1068, { 0xAB, 0x91 }, { 0x08, 0x00, 0x2B, 0x27, 0xB3, 0xD9 } }, 3, "System.Subject" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 4, "System.AppUserModel.RelaunchDisplayNameResource" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 16, "System.DateAccessed" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 26, "System.AppUserModel.ToastActivatorCLSID" },
+  { { 0x9F4C2855, 0x9F79, 0x4B39, { 0xA8, 0xD0 }, { 0xE1, 0xD4, 0x2D, 0xE1, 0xD5, 0xF3 } }, 6, "System.AppUserModel.IsDestListSeparator" },
+  { { 0x5CBF2787, 0x48CF, 0x4208, { 0xB9, 0x0E }, { 0xEE, 0x5E, 0x5D, 0x42, 0x02, 0x94 } }, 2, "System.Link.TargetUrl" },
+  { { 0xB725F130, 0x47EF, 0x101A, { 0xA5, 0xF1 }, { 0x02, 0x60, 0x8C, 0x9E, 0xEB, 0xAC } }, 15, "System.DateCreated" }
+};
+
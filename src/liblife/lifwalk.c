@@ -0,0 +1,419 @@
+/***************************************************************
+**                                                            **
+**                    lifwalk.c                               **
+**                                                            **
+**    Calls back for each part of a link file held in memory. **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See lifwalk.h for the exported functions                   **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "./lifwalk.h"
+
+#define LW_HDRSIZE  0x4C
+
+// A callback, if there is one. Stops the walk if it returns non-zero.
+#define LW_CALL(w, cb, ...) \
+  if (((w)->Cb->cb != NULL) && ((w)->Cb->cb((w)->Ctx, __VA_ARGS__) != 0)) return LIF_E_STOPPED
+
+// The link being walked
+struct LW
+{
+  const unsigned char        * Buf;
+  size_t                       Size;
+  const struct LIF_CALLBACKS * Cb;
+  void                       * Ctx;
+};
+
+// The CLSID a link file's header must have, as stored
+static const unsigned char lw_clsid[16] =
+{
+  0x01, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46
+};
+
+// The format ID of property stores with string names, as stored
+static const unsigned char lw_strnames[16] =
+{
+  0x05, 0xD5, 0xCD, 0xD5, 0x9C, 0x2E, 0x1B, 0x10, 0x93, 0x97, 0x08, 0x00, 0x2B, 0x2C, 0xF9, 0xAE
+};
+
+//Local function declarations
+uint16_t lw_u16(const unsigned char *);
+uint32_t lw_u32(const unsigned char *);
+uint64_t lw_u64(const unsigned char *);
+void lw_view(struct LW *, size_t, size_t, struct LIF_VIEW *);
+void lw_str(struct LW *, size_t, size_t, int, struct LIF_VIEW *);
+int lw_itemids(struct LW *, int, size_t, size_t);
+int lw_linkinfo(struct LW *, size_t, size_t);
+int lw_propstores(struct LW *, size_t, size_t);
+
+//
+//Function: lw_u16(), lw_u32() & lw_u64() read little endian numbers
+uint16_t lw_u16(const unsigned char * p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+uint32_t lw_u32(const unsigned char * p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+uint64_t lw_u64(const unsigned char * p)
+{
+  return (uint64_t)lw_u32(p) | ((uint64_t)lw_u32(p + 4) << 32);
+}
+
+//
+//Function: lw_view() sets v to the 'size' bytes at 'posn' (which the caller
+//          has checked are in the buffer)
+void lw_view(struct LW * w, size_t posn, size_t size, struct LIF_VIEW * v)
+{
+  v->Data = w->Buf + posn;
+  v->Size = size;
+  v->Posn = posn;
+}
+
+//
+//Function: lw_str() sets v to the zero terminated string at 'posn', which
+//          must end before 'end' (an empty view if it doesn't, or posn is
+//          0 meaning there is no string). Unicode strings are UTF-16LE.
+void lw_str(struct LW * w, size_t posn, size_t end, int unicode, struct LIF_VIEW * v)
+{
+  size_t i;
+
+  memset(v, 0, sizeof(struct LIF_VIEW));
+  if ((posn == 0) || (posn >= end))
+  {
+    return;
+  }
+  if (unicode)
+  {
+    for (i = posn; (i + 1 < end) && ((w->Buf[i] != 0) || (w->Buf[i + 1] != 0)); i += 2)
+      ;
+    if (i + 1 >= end)
+    {
+      return;
+    }
+  }
+  else
+  {
+    for (i = posn; (i < end) && (w->Buf[i] != 0); i++)
+      ;
+    if (i >= end)
+    {
+      return;
+    }
+  }
+  lw_view(w, posn, i - posn, v);
+}
+
+//
+//Function: lw_itemids() calls back for each ItemID in the IDList from 'posn'
+//          to 'end' (after its IDListSize)
+int lw_itemids(struct LW * w, int list, size_t posn, size_t end)
+{
+  struct LIF_VIEW v;
+  uint16_t size;
+  int n = 0;
+
+  while (posn + 2 <= end)
+  {
+    if ((size = lw_u16(w->Buf + posn)) == 0) // TerminalID
+    {
+      return 0;
+    }
+    if ((size < 2) || (posn + size > end))
+    {
+      return LIF_E_DECODE;
+    }
+    lw_view(w, posn + 2, size - 2, &v);
+    LW_CALL(w, on_itemid, list, n++, &v);
+    posn += size;
+  }
+  return 0; // (A list without its TerminalID is taken to end at its size)
+}
+
+//
+//Function: lw_linkinfo() calls back with the LinkInfo at 'posn', 'size'
+//          bytes long (MS-SHLLINK 2.3)
+int lw_linkinfo(struct LW * w, size_t posn, size_t size)
+{
+  const unsigned char * li = w->Buf + posn;
+  struct LIF_WALK_LINKINFO info;
+  size_t end = posn + size, hdrsize, vol, cnr, off;
+
+  memset(&info, 0, sizeof(info));
+  if (size < 0x1C)
+  {
+    return LIF_E_DECODE;
+  }
+  lw_view(w, posn, size, &info.Raw);
+  hdrsize = lw_u32(li + 4);
+  info.Flags = lw_u32(li + 8);
+  if (info.Flags & 0x00000001) // VolumeIDAndLocalBasePath
+  {
+    vol = lw_u32(li + 12);
+    if ((vol < 0x1C) || (vol + 0x10 > size))
+    {
+      return LIF_E_DECODE;
+    }
+    info.DriveType = lw_u32(li + vol + 4);
+    info.DriveSerial = lw_u32(li + vol + 8);
+    off = lw_u32(li + vol + 12);
+    if ((off == 0x14) && (vol + 0x14 <= size))
+    {
+      off = lw_u32(li + vol + 16);
+      lw_str(w, posn + vol + off, end, 1, &info.VolumeLabelUnicode);
+    }
+    else
+    {
+      lw_str(w, posn + vol + off, end, 0, &info.VolumeLabel);
+    }
+    lw_str(w, posn + lw_u32(li + 16), end, 0, &info.LocalBasePath);
+    if ((hdrsize >= 0x24) && (size >= 0x24))
+    {
+      off = lw_u32(li + 28);
+      lw_str(w, off ? posn + off : 0, end, 1, &info.LocalBasePathUnicode);
+    }
+  }
+  if (info.Flags & 0x00000002) // CommonNetworkRelativeLinkAndPathSuffix
+  {
+    cnr = lw_u32(li + 20);
+    if ((cnr < 0x1C) || (cnr + 0x14 > size))
+    {
+      return LIF_E_DECODE;
+    }
+    info.CNRFlags = lw_u32(li + cnr + 4);
+    info.NetworkProviderType = lw_u32(li + cnr + 16);
+    off = lw_u32(li + cnr + 8);
+    lw_str(w, posn + cnr + off, end, 0, &info.NetName);
+    off = lw_u32(li + cnr + 12);
+    lw_str(w, off ? posn + cnr + off : 0, end, 0, &info.DeviceName);
+    if ((lw_u32(li + cnr + 8) > 0x14) && (cnr + 0x1C <= size))
+    {
+      off = lw_u32(li + cnr + 20);
+      lw_str(w, off ? posn + cnr + off : 0, end, 1, &info.NetNameUnicode);
+      off = lw_u32(li + cnr + 24);
+      lw_str(w, off ? posn + cnr + off : 0, end, 1, &info.DeviceNameUnicode);
+    }
+  }
+  off = lw_u32(li + 24);
+  lw_str(w, off ? posn + off : 0, end, 0, &info.CommonPathSuffix);
+  if ((hdrsize >= 0x24) && (size >= 0x24))
+  {
+    off = lw_u32(li + 32);
+    lw_str(w, off ? posn + off : 0, end, 1, &info.CommonPathSuffixUnicode);
+  }
+  LW_CALL(w, on_linkinfo, &info);
+  return 0;
+}
+
+//
+//Function: lw_propstores() calls back for each value in the serialized
+//          property stores from 'posn' to 'end' (MS-PROPSTORE 2.2)
+int lw_propstores(struct LW * w, size_t posn, size_t end)
+{
+  struct LIF_WALK_PROPERTY prop;
+  uint32_t storesize, valuesize, namesize;
+  size_t p, vend;
+  int names;
+
+  memset(&prop, 0, sizeof(prop));
+  while (posn + 4 <= end)
+  {
+    if ((storesize = lw_u32(w->Buf + posn)) == 0)
+    {
+      return 0;
+    }
+    if ((storesize < 24) || (storesize > end - posn))
+    {
+      return LIF_E_DECODE;
+    }
+    prop.FormatID = w->Buf + posn + 8;
+    names = (memcmp(prop.FormatID, lw_strnames, 16) == 0);
+    p = posn + 24;
+    while (p + 4 <= posn + storesize)
+    {
+      if ((valuesize = lw_u32(w->Buf + p)) == 0)
+      {
+        break;
+      }
+      vend = p + valuesize;
+      if ((valuesize < 13) || (vend > posn + storesize))
+      {
+        return LIF_E_DECODE;
+      }
+      memset(&prop.Name, 0, sizeof(prop.Name));
+      prop.ID = 0;
+      if (names)
+      {
+        namesize = lw_u32(w->Buf + p + 4);
+        if (namesize > valuesize - 13)
+        {
+          return LIF_E_DECODE;
+        }
+        lw_str(w, p + 9, p + 9 + namesize, 1, &prop.Name);
+        p += namesize;
+      }
+      else
+      {
+        prop.ID = lw_u32(w->Buf + p + 4);
+      }
+      prop.Type = lw_u16(w->Buf + p + 9);
+      lw_view(w, p + 13, vend - (p + 13), &prop.Value);
+      LW_CALL(w, on_property, &prop);
+      p = vend;
+    }
+    prop.Store++;
+    posn += storesize;
+  }
+  return 0;
+}
+
+//
+//Function: lif_walk() walks the link file's sections in turn
+extern LIFAPI int lif_walk(const void * buf, size_t size, const struct LIF_CALLBACKS * cb, void * ctx)
+{
+  struct LIF_WALK_HEADER hdr;
+  struct LIF_VIEW v;
+  struct LW w;
+  size_t posn, len;
+  uint32_t sig;
+  int i, ret;
+
+  if ((buf == NULL) || (cb == NULL))
+  {
+    return LIF_E_ARGS;
+  }
+  w.Buf = buf;
+  w.Size = size;
+  w.Cb = cb;
+  w.Ctx = ctx;
+  if (size < LW_HDRSIZE)
+  {
+    return LIF_E_SHORT;
+  }
+  if ((lw_u32(w.Buf) != LW_HDRSIZE) || (memcmp(w.Buf + 4, lw_clsid, 16) != 0))
+  {
+    return LIF_E_NOTLINK;
+  }
+
+  // 2.1 ShellLinkHeader
+  lw_view(&w, 0, LW_HDRSIZE, &hdr.Raw);
+  hdr.Flags = lw_u32(w.Buf + 20);
+  hdr.Attributes = lw_u32(w.Buf + 24);
+  hdr.CreationTime = (int64_t)lw_u64(w.Buf + 28);
+  hdr.AccessTime = (int64_t)lw_u64(w.Buf + 36);
+  hdr.WriteTime = (int64_t)lw_u64(w.Buf + 44);
+  hdr.FileSize = lw_u32(w.Buf + 52);
+  hdr.IconIndex = (int32_t)lw_u32(w.Buf + 56);
+  hdr.ShowState = lw_u32(w.Buf + 60);
+  hdr.Hotkey = lw_u16(w.Buf + 64);
+  LW_CALL(&w, on_header, &hdr);
+  posn = LW_HDRSIZE;
+
+  // 2.2 LinkTargetIDList
+  if (hdr.Flags & 0x00000001)
+  {
+    if (posn + 2 > size)
+    {
+      return LIF_E_DECODE;
+    }
+    len = lw_u16(w.Buf + posn);
+    posn += 2;
+    if (posn + len > size)
+    {
+      return LIF_E_DECODE;
+    }
+    if ((ret = lw_itemids(&w, LIF_WALK_IDLIST, posn, posn + len)) != 0)
+    {
+      return ret;
+    }
+    posn += len;
+  }
+
+  // 2.3 LinkInfo
+  if (hdr.Flags & 0x00000002)
+  {
+    if ((posn + 4 > size) || ((len = lw_u32(w.Buf + posn)) > size - posn))
+    {
+      return LIF_E_DECODE;
+    }
+    if ((ret = lw_linkinfo(&w, posn, len)) != 0)
+    {
+      return ret;
+    }
+    posn += len;
+  }
+
+  // 2.4 StringData, each string's flag is the next bit up from HasName
+  for (i = 0; i < 5; i++)
+  {
+    if (hdr.Flags & (0x00000004 << i))
+    {
+      if (posn + 2 > size)
+      {
+        return LIF_E_DECODE;
+      }
+      len = lw_u16(w.Buf + posn) * ((hdr.Flags & 0x00000080) ? 2 : 1);
+      posn += 2;
+      if (posn + len > size)
+      {
+        return LIF_E_DECODE;
+      }
+      lw_view(&w, posn, len, &v);
+      LW_CALL(&w, on_string, i, (hdr.Flags & 0x00000080) != 0, &v);
+      posn += len;
+    }
+  }
+
+  // 2.5 ExtraData, blocks until one of less than 4 bytes (or the end)
+  while (posn + 4 <= size)
+  {
+    if ((len = lw_u32(w.Buf + posn)) < 4)
+    {
+      break;
+    }
+    if ((len < 8) || (len > size - posn))
+    {
+      return LIF_E_DECODE;
+    }
+    sig = lw_u32(w.Buf + posn + 4);
+    lw_view(&w, posn, len, &v);
+    LW_CALL(&w, on_extradata_block, sig, &v);
+    ret = 0;
+    if (sig == 0xA0000009) // PropertyStoreDataBlock
+    {
+      ret = lw_propstores(&w, posn + 8, posn + len);
+    }
+    else if ((sig == 0xA000000C) || (sig == 0xA000000A)) // VistaAndAboveIDListDataBlock
+    {
+      ret = lw_itemids(&w, LIF_WALK_VISTA_IDLIST, posn + 8, posn + len);
+    }
+    if (ret != 0)
+    {
+      return ret;
+    }
+    posn += len;
+  }
+  return 0;
+}
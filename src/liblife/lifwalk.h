@@ -0,0 +1,144 @@
+/***************************************************************
+**                                                            **
+**                    lifwalk.h                               **
+**                                                            **
+**    Walks a link file held in memory and calls back as each **
+** part of it is found: the header, each ItemID, the LinkInfo,**
+** each StringData string, each ExtraData block and each      **
+** value in a property store. Nothing is copied, the callbacks**
+** are given views (LIF_VIEW) of the bytes in the caller's    **
+** buffer, with the few numbers needed to find the rest       **
+** already read. For programs that pass the fields on to      **
+** something else (lifer's '-o json') there is no LIF to fill **
+** & walk again. Every size is checked against the buffer: a  **
+** malformed link ends the walk with an error after the parts **
+** before it have been called back, it never asserts.         **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int lif_walk(const void * buf, size_t size,                **
+**              const struct LIF_CALLBACKS * cb, void * ctx)  **
+**      Walks the link file in buf (size bytes), calling the  **
+**      callbacks in cb (any may be NULL) with ctx as their   **
+**      first argument, in the order the parts are in the     **
+**      file. A callback returns 0 to carry on, anything else **
+**      stops the walk.                                       **
+**      Returns 0 if the whole link was walked, LIF_E_STOPPED **
+**      if a callback stopped it, or another LIF_E_* error    **
+**      (see lifapi.h).                                       **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIFWALK_H_
+#define _LIFWALK_H_
+
+#include "./lifapi.h"
+
+// Bytes in the caller's buffer. Text is as it is in the link file: ANSI
+// (code page) strings without their terminating zero, or UTF-16LE when the
+// view is a 'Unicode' one (Size is in bytes). An absent part is a view with
+// Data NULL and Size 0.
+struct LIF_VIEW
+{
+  const unsigned char * Data;
+  size_t                Size;
+  uint64_t              Posn;       // Offset of Data[0] in the buffer
+};
+
+struct LIF_WALK_HEADER
+{
+  struct LIF_VIEW       Raw;        // The 76 bytes
+  uint32_t              Flags;      // LinkFlags
+  uint32_t              Attributes;
+  int64_t               CreationTime; // FILETIMEs
+  int64_t               AccessTime;
+  int64_t               WriteTime;
+  uint32_t              FileSize;
+  int32_t               IconIndex;
+  uint32_t              ShowState;
+  uint16_t              Hotkey;     // Low byte the key, high byte the modifiers
+};
+
+// The lists on_itemid() is called for
+#define LIF_WALK_IDLIST       0     // LinkTargetIDList
+#define LIF_WALK_VISTA_IDLIST 1     // VistaAndAboveIDListDataBlock
+
+struct LIF_WALK_LINKINFO
+{
+  struct LIF_VIEW       Raw;        // The whole LinkInfo
+  uint32_t              Flags;      // LinkInfoFlags
+  uint32_t              DriveType;  // VolumeID
+  uint32_t              DriveSerial;
+  struct LIF_VIEW       VolumeLabel;
+  struct LIF_VIEW       VolumeLabelUnicode;
+  struct LIF_VIEW       LocalBasePath;
+  struct LIF_VIEW       LocalBasePathUnicode;
+  uint32_t              CNRFlags;   // CommonNetworkRelativeLink
+  uint32_t              NetworkProviderType;
+  struct LIF_VIEW       NetName;
+  struct LIF_VIEW       NetNameUnicode;
+  struct LIF_VIEW       DeviceName;
+  struct LIF_VIEW       DeviceNameUnicode;
+  struct LIF_VIEW       CommonPathSuffix;
+  struct LIF_VIEW       CommonPathSuffixUnicode;
+};
+
+// The StringData strings, in the order they are in the file
+#define LIF_WALK_NAME           0
+#define LIF_WALK_RELATIVE_PATH  1
+#define LIF_WALK_WORKING_DIR    2
+#define LIF_WALK_ARGUMENTS      3
+#define LIF_WALK_ICON_LOCATION  4
+
+// A value in a PropertyStoreDataBlock (MS-PROPSTORE)
+struct LIF_WALK_PROPERTY
+{
+  int                   Store;      // Which store in the block (from 0)
+  const unsigned char * FormatID;   // The store's 16 byte format ID, as stored
+  uint32_t              ID;         // The property ID if the store has integer names
+  struct LIF_VIEW       Name;       // Or the UTF-16LE name if it has string names
+  uint16_t              Type;       // The VT_* type
+  struct LIF_VIEW       Value;      // The value, after the type & padding
+};
+
+struct LIF_CALLBACKS
+{
+  int (*on_header)(void *, const struct LIF_WALK_HEADER *);
+  int (*on_itemid)(void *, int list, int index, const struct LIF_VIEW * data); // data is after the ItemIDSize,
+                                                                              // Posn - 2 is where the ItemID starts
+  int (*on_linkinfo)(void *, const struct LIF_WALK_LINKINFO *);
+  int (*on_string)(void *, int which, int unicode, const struct LIF_VIEW * s);
+  int (*on_extradata_block)(void *, uint32_t sig, const struct LIF_VIEW * block); // The whole block, from its BlockSize
+  int (*on_property)(void *, const struct LIF_WALK_PROPERTY *);
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+LIFAPI int lif_walk(const void *, size_t, const struct LIF_CALLBACKS *, void *);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
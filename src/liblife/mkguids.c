@@ -0,0 +1,348 @@
+/*********************************************************
+**                                                      **
+**                 mkguids.c                            **
+**                                                      **
+** Builds the perfect hash tables in lifguids.h from    **
+** the list of well known GUIDs in guids.txt            **
+**                                                      **
+**        Copyright 2026 the Lifer contributors         **
+**                                                      **
+*********************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+mkguids is NOT part of lifer, it is only needed when guids.txt changes.
+From the ./src/liblife directory:
+
+    gcc -Wall ./mkguids.c -o mkguids
+    ./mkguids ./guids.txt > ./lifguids.h
+
+Each table is a 'hash and displace' minimal perfect hash: a key is hashed
+with seed 0 to find its bucket, the bucket's displacement is then used as
+the seed for a second hash which gives the key's slot in the table. The
+generator tries displacements (largest buckets first) until every key has a
+slot of its own, so a lookup is always two hashes and one comparison.
+guid_hash() MUST stay identical to the one in liblife.c
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define MAXNAMES    1024
+#define MAXDISP     65535
+
+struct GUID_ENTRY
+{
+  uint32_t       Data1;
+  uint16_t       Data2;
+  uint16_t       Data3;
+  unsigned char  Data4[8];
+  uint32_t       PID;
+  char           Name[80];
+  unsigned char  Key[20];
+};
+
+struct GUID_TABLE
+{
+  int                 Num;
+  int                 Buckets;
+  struct GUID_ENTRY   Entries[MAXNAMES];
+  int                 Slot[MAXNAMES];   // Slot of entry i in the table
+  uint16_t            Disp[MAXNAMES];
+};
+
+uint32_t guid_hash(unsigned char[], uint32_t);
+int parse_line(char *, struct GUID_ENTRY *, int);
+int build_table(struct GUID_TABLE *);
+void print_table(struct GUID_TABLE *, const char *, const char *);
+
+struct GUID_TABLE guids, pkeys;
+
+int main(int argc, char *argv[])
+{
+  FILE  *fp;
+  char  line[256];
+  int   lineno = 0;
+
+  if (argc != 2)
+  {
+    fprintf(stderr, "Usage: %s guids.txt > lifguids.h\n", argv[0]);
+    return 1;
+  }
+  if ((fp = fopen(argv[1], "r")) == NULL)
+  {
+    fprintf(stderr, "Unable to open %s\n", argv[1]);
+    return 1;
+  }
+  while (fgets(line, sizeof(line), fp) != NULL)
+  {
+    lineno++;
+    line[strcspn(line, "\r\n")] = '\0';
+    if ((line[0] == 'G') && (guids.Num < MAXNAMES))
+    {
+      if (parse_line(line, &guids.Entries[guids.Num], 0) < 0)
+      {
+        fprintf(stderr, "%s:%d: bad GUID entry\n", argv[1], lineno);
+        return 1;
+      }
+      guids.Num++;
+    }
+    else if ((line[0] == 'P') && (pkeys.Num < MAXNAMES))
+    {
+      if (parse_line(line, &pkeys.Entries[pkeys.Num], 1) < 0)
+      {
+        fprintf(stderr, "%s:%d: bad property key entry\n", argv[1], lineno);
+        return 1;
+      }
+      pkeys.Num++;
+    }
+  }
+  fclose(fp);
+  if ((build_table(&guids) < 0) || (build_table(&pkeys) < 0))
+  {
+    return 1;
+  }
+
+  printf("// lifguids.h - generated by mkguids.c from guids.txt, do not edit.\n");
+  printf("// Included by liblife.c only, see mkguids.c for the hashing scheme.\n\n");
+  printf("struct LIF_GUID_NAME\n{\n");
+  printf("  struct LIF_CLSID   Guid;\n");
+  printf("  uint32_t           PID;   // Property ID (0 in the GUID table)\n");
+  printf("  const char *       Name;\n");
+  printf("};\n\n");
+  print_table(&guids, "GUID", "guid");
+  print_table(&pkeys, "PKEY", "pkey");
+  return 0;
+}
+
+//
+//Function: guid_hash() is 32 bit FNV-1a over the 20 byte key followed by a
+//final mix, seed 0 picks the bucket and the bucket's displacement the slot.
+uint32_t guid_hash(unsigned char key[], uint32_t seed)
+{
+  uint32_t  h = 0x811C9DC5 ^ (seed * 0x9E3779B9);
+  int       i;
+
+  for (i = 0; i < 20; i++)
+  {
+    h ^= key[i];
+    h *= 0x01000193;
+  }
+  h ^= h >> 16;
+  h *= 0x85EBCA6B;
+  h ^= h >> 13;
+  return h;
+}
+
+//
+//Function: parse_line() reads "G {GUID} Name" or "P {GUID} PID Name"
+int parse_line(char * line, struct GUID_ENTRY * e, int pkey)
+{
+  unsigned int  d[11];
+  int           n, i;
+
+  if (sscanf(line + 2, "{%8x-%4x-%4x-%2x%2x-%2x%2x%2x%2x%2x%2x}%n",
+    &d[0], &d[1], &d[2], &d[3], &d[4], &d[5], &d[6], &d[7], &d[8], &d[9], &d[10], &n) != 11)
+  {
+    return -1;
+  }
+  line += 2 + n;
+  e->PID = 0;
+  if (pkey)
+  {
+    if (sscanf(line, " %"SCNu32"%n", &e->PID, &n) != 1)
+    {
+      return -1;
+    }
+    line += n;
+  }
+  while (*line == ' ')
+  {
+    line++;
+  }
+  if ((*line == '\0') || (strlen(line) >= sizeof(e->Name)) || strchr(line, '"') || strchr(line, '\\'))
+  {
+    return -1;
+  }
+  snprintf(e->Name, sizeof(e->Name), "%s", line);
+  e->Data1 = d[0];
+  e->Data2 = (uint16_t)d[1];
+  e->Data3 = (uint16_t)d[2];
+  for (i = 0; i < 8; i++)
+  {
+    e->Data4[i] = (unsigned char)d[3 + i];
+  }
+  // The key is the GUID as it is stored on disk followed by the LE property ID
+  for (i = 0; i < 4; i++)
+  {
+    e->Key[i] = (unsigned char)(e->Data1 >> (8 * i));
+    e->Key[16 + i] = (unsigned char)(e->PID >> (8 * i));
+  }
+  e->Key[4] = (unsigned char)e->Data2;
+  e->Key[5] = (unsigned char)(e->Data2 >> 8);
+  e->Key[6] = (unsigned char)e->Data3;
+  e->Key[7] = (unsigned char)(e->Data3 >> 8);
+  memcpy(&e->Key[8], e->Data4, 8);
+  return 0;
+}
+
+//
+//Function: build_table() finds a displacement for every bucket, returns -1
+//if the keys contain a duplicate or no displacement could be found
+int build_table(struct GUID_TABLE * t)
+{
+  int       i, j, k, b, nb, order[MAXNAMES], members[MAXNAMES], nm, used[MAXNAMES];
+  int       size[MAXNAMES], slot[MAXNAMES];
+  uint32_t  d;
+
+  if (t->Num == 0)
+  {
+    fprintf(stderr, "A table has no entries\n");
+    return -1;
+  }
+  for (i = 0; i < t->Num; i++)
+  {
+    for (j = 0; j < i; j++)
+    {
+      if (memcmp(t->Entries[i].Key, t->Entries[j].Key, 20) == 0)
+      {
+        fprintf(stderr, "Duplicate entry: %s & %s\n", t->Entries[j].Name, t->Entries[i].Name);
+        return -1;
+      }
+    }
+  }
+  for (nb = (t->Num + 1) / 2; nb <= t->Num; nb++)
+  {
+    t->Buckets = nb;
+    memset(size, 0, sizeof(size));
+    memset(used, 0, sizeof(used));
+    for (i = 0; i < t->Num; i++)
+    {
+      size[guid_hash(t->Entries[i].Key, 0) % nb]++;
+    }
+    // Order the buckets largest first (simple selection, the tables are small)
+    for (b = 0; b < nb; b++)
+    {
+      order[b] = b;
+    }
+    for (i = 0; i < nb; i++)
+    {
+      for (j = i + 1; j < nb; j++)
+      {
+        if (size[order[j]] > size[order[i]])
+        {
+          k = order[i];
+          order[i] = order[j];
+          order[j] = k;
+        }
+      }
+    }
+    for (i = 0; i < nb; i++)
+    {
+      b = order[i];
+      t->Disp[b] = 0;
+      if (size[b] == 0)
+      {
+        continue;
+      }
+      nm = 0;
+      for (k = 0; k < t->Num; k++)
+      {
+        if ((int)(guid_hash(t->Entries[k].Key, 0) % nb) == b)
+        {
+          members[nm++] = k;
+        }
+      }
+      for (d = 1; d <= MAXDISP; d++)
+      {
+        for (k = 0; k < nm; k++)
+        {
+          slot[k] = guid_hash(t->Entries[members[k]].Key, d) % t->Num;
+          if (used[slot[k]])
+          {
+            break;
+          }
+          for (j = 0; j < k; j++)
+          {
+            if (slot[j] == slot[k])
+            {
+              break;
+            }
+          }
+          if (j < k)
+          {
+            break;
+          }
+        }
+        if (k == nm)
+        {
+          break;
+        }
+      }
+      if (d > MAXDISP)
+      {
+        break;
+      }
+      t->Disp[b] = (uint16_t)d;
+      for (k = 0; k < nm; k++)
+      {
+        used[slot[k]] = 1;
+        t->Slot[members[k]] = slot[k];
+      }
+    }
+    if (i == nb)
+    {
+      return 0;
+    }
+  }
+  fprintf(stderr, "Unable to build a perfect hash table\n");
+  return -1;
+}
+
+//
+//Function: print_table() writes the displacements and the entries in slot order
+void print_table(struct GUID_TABLE * t, const char * uc, const char * lc)
+{
+  int                  i, j;
+  struct GUID_ENTRY    *e;
+
+  printf("#define %s_NAMES    %d\n", uc, t->Num);
+  printf("#define %s_BUCKETS  %d\n\n", uc, t->Buckets);
+  printf("static const uint16_t %s_disp[%s_BUCKETS] =\n{", lc, uc);
+  for (i = 0; i < t->Buckets; i++)
+  {
+    printf("%s%5"PRIu16"%s", (i % 10) ? "" : "\n  ", t->Disp[i], (i < t->Buckets - 1) ? "," : "\n");
+  }
+  printf("};\n\n");
+  printf("static const struct LIF_GUID_NAME %s_names[%s_NAMES] =\n{\n", lc, uc);
+  for (i = 0; i < t->Num; i++)
+  {
+    for (j = 0; t->Slot[j] != i; j++)
+      ;
+    e = &t->Entries[j];
+    printf("  { { 0x%.8"PRIX32", 0x%.4"PRIX16", 0x%.4"PRIX16", { 0x%.2X, 0x%.2X }, "
+      "{ 0x%.2X, 0x%.2X, 0x%.2X, 0x%.2X, 0x%.2X, 0x%.2X } }, %"PRIu32", \"%s\" }%s\n",
+      e->Data1, e->Data2, e->Data3, e->Data4[0], e->Data4[1], e->Data4[2], e->Data4[3],
+      e->Data4[4], e->Data4[5], e->Data4[6], e->Data4[7], e->PID, e->Name,
+      (i < t->Num - 1) ? "," : "");
+  }
+  printf("};\n\n");
+}
@@ -0,0 +1,709 @@
+/***************************************************************
+**                                                            **
+**                    liblifedb.c                             **
+**                                                            **
+**    Writes decoded link files to an SQLite database         **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See liblifedb.h for the exported functions & tables        **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "./liblifedb.h"
+
+#ifdef HAVE_SQLITE3
+
+#include <string.h>
+#include <stddef.h>
+#include <wchar.h>
+#include <sqlite3.h>
+
+/*
+Loading is made quick by: preparing each INSERT once and re-binding it for
+every row, committing only every LDB_BATCH link files, not waiting for the
+disk (synchronous = OFF, the journal is kept in memory) and creating the
+indexes once everything is loaded. The database is a product of the link
+files so, if a run is interrupted, it should just be made again.
+*/
+
+static const char *ldb_tables =
+  "PRAGMA journal_mode = MEMORY;"
+  "PRAGMA synchronous = OFF;"
+  "CREATE TABLE IF NOT EXISTS linkfiles (id INTEGER PRIMARY KEY, name TEXT, size INTEGER,"
+  " atime INTEGER, mtime INTEGER, ctime INTEGER, hdr_clsid TEXT, hdr_flags INTEGER, hdr_attr INTEGER,"
+  " hdr_crtime INTEGER, hdr_actime INTEGER, hdr_wttime INTEGER, hdr_targetsize INTEGER,"
+  " hdr_iconindex INTEGER, hdr_showstate INTEGER, hdr_hotkey INTEGER, idlist_size INTEGER,"
+  " idlist_numitems INTEGER, li_flags INTEGER, li_drivetype TEXT, li_drivesn INTEGER, li_label TEXT,"
+  " li_lbp TEXT, li_cnr_flags INTEGER, li_providertype INTEGER, li_netname TEXT, li_devicename TEXT,"
+  " li_cps TEXT, sd_name TEXT, sd_relpath TEXT, sd_workdir TEXT, sd_args TEXT, sd_icon TEXT,"
+  " ed_types INTEGER);"
+  "CREATE TABLE IF NOT EXISTS itemids (id INTEGER PRIMARY KEY, linkfile INTEGER REFERENCES linkfiles(id),"
+  " list TEXT, num INTEGER, posn INTEGER, size INTEGER, class INTEGER, type TEXT, folder_id TEXT,"
+  " name TEXT, long_name TEXT, file_size INTEGER, file_attr INTEGER, mod_time TEXT, cr_time TEXT,"
+  " ac_time TEXT, mft_entry INTEGER, mft_seq INTEGER, data BLOB);"
+  "CREATE TABLE IF NOT EXISTS extradata (id INTEGER PRIMARY KEY, linkfile INTEGER REFERENCES linkfiles(id),"
+  " block TEXT, posn INTEGER, size INTEGER, sig INTEGER);"
+  "CREATE TABLE IF NOT EXISTS extradata_values (extradata INTEGER REFERENCES extradata(id),"
+  " name TEXT, value TEXT);"
+  "CREATE TABLE IF NOT EXISTS propvalues (linkfile INTEGER REFERENCES linkfiles(id),"
+  " extradata INTEGER REFERENCES extradata(id), itemid INTEGER REFERENCES itemids(id), store INTEGER,"
+  " format_id TEXT, prop_id INTEGER, prop_name TEXT, type TEXT, value TEXT, filetime INTEGER);";
+
+static const char *ldb_indexes[][2] =
+{
+  { "linkfiles_name", "linkfiles(name)" },
+  { "linkfiles_drivesn", "linkfiles(li_drivesn)" },
+  { "itemids_linkfile", "itemids(linkfile)" },
+  { "extradata_linkfile", "extradata(linkfile)" },
+  { "extradata_values_extradata", "extradata_values(extradata)" },
+  { "propvalues_linkfile", "propvalues(linkfile)" },
+  { "propvalues_prop_name", "propvalues(prop_name)" }
+};
+#define NUMINDEXES (sizeof(ldb_indexes) / sizeof(ldb_indexes[0]))
+
+enum LDB_STMTS { LINKFILE, ITEMID, EXTRADATA, EDVALUE, PROPVALUE, NUMSTMTS };
+
+static const char *ldb_inserts[NUMSTMTS] =
+{
+  "INSERT INTO linkfiles VALUES (NULL,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)",
+  "INSERT INTO itemids VALUES (NULL,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)",
+  "INSERT INTO extradata VALUES (NULL,?,?,?,?,?)",
+  "INSERT INTO extradata_values VALUES (?,?,?)",
+  "INSERT INTO propvalues VALUES (?,?,?,?,?,?,?,?,?,?)"
+};
+
+// The decoded fields of each ExtraData block that go in extradata_values (the
+// names are the same as the last part of the '-F' keys)
+struct LDB_EDVALUE
+{
+  enum EDTYPES  type;
+  const char *  name;
+  size_t        offset; // Offset of the string in struct LIF_EXTRA_DATA_A
+};
+#define ED_V(t, n, m) { t, n, offsetof(struct LIF_EXTRA_DATA_A, m) }
+
+static const struct LDB_EDVALUE ldb_edvalues[] =
+{
+  ED_V(CONSOLE_PROPS, "fillattr", lcpa.FillAttributes),
+  ED_V(CONSOLE_PROPS, "popupfillattr", lcpa.PopupFillAttributes),
+  ED_V(CONSOLE_PROPS, "scrbufsizex", lcpa.ScreenBufferSizeX),
+  ED_V(CONSOLE_PROPS, "scrbufsizey", lcpa.ScreenBufferSizeY),
+  ED_V(CONSOLE_PROPS, "windowsizex", lcpa.WindowSizeX),
+  ED_V(CONSOLE_PROPS, "windowsizey", lcpa.WindowSizeY),
+  ED_V(CONSOLE_PROPS, "windoworiginx", lcpa.WindowOriginX),
+  ED_V(CONSOLE_PROPS, "windoworiginy", lcpa.WindowOriginY),
+  ED_V(CONSOLE_PROPS, "unused1", lcpa.Unused1),
+  ED_V(CONSOLE_PROPS, "unused2", lcpa.Unused2),
+  ED_V(CONSOLE_PROPS, "fontheight", lcpa.FontHeight),
+  ED_V(CONSOLE_PROPS, "fontwidth", lcpa.FontWidth),
+  ED_V(CONSOLE_PROPS, "fontfamily", lcpa.FontFamily),
+  ED_V(CONSOLE_PROPS, "fontpitch", lcpa.FontPitch),
+  ED_V(CONSOLE_PROPS, "fontweight", lcpa.FontWeight),
+  ED_V(CONSOLE_PROPS, "facename", lcpa.FaceName),
+  ED_V(CONSOLE_PROPS, "cursorsize", lcpa.CursorSize),
+  ED_V(CONSOLE_PROPS, "fullscreen", lcpa.FullScreen),
+  ED_V(CONSOLE_PROPS, "quickedit", lcpa.QuickEdit),
+  ED_V(CONSOLE_PROPS, "insertmode", lcpa.InsertMode),
+  ED_V(CONSOLE_PROPS, "autoposition", lcpa.AutoPosition),
+  ED_V(CONSOLE_PROPS, "historybufsize", lcpa.HistoryBufferSize),
+  ED_V(CONSOLE_PROPS, "numhistorybuf", lcpa.NumberOfHistoryBuffers),
+  ED_V(CONSOLE_PROPS, "historynodup", lcpa.HistoryNoDup),
+  ED_V(CONSOLE_FE_PROPS, "codepage", lcfepa.CodePage),
+  ED_V(DARWIN_PROPS, "ansi", ldpa.DarwinDataAnsi),
+  ED_V(DARWIN_PROPS, "unicode", ldpa.DarwinDataUnicode),
+  ED_V(ENVIRONMENT_PROPS, "ansi", lepa.TargetAnsi),
+  ED_V(ENVIRONMENT_PROPS, "unicode", lepa.TargetUnicode),
+  ED_V(ICON_ENVIRONMENT_PROPS, "ansi", liepa.TargetAnsi),
+  ED_V(ICON_ENVIRONMENT_PROPS, "unicode", liepa.TargetUnicode),
+  ED_V(KNOWN_FOLDER_PROPS, "id", lkfpa.KFGUID.UUID),
+  ED_V(KNOWN_FOLDER_PROPS, "name", lkfpa.KFGUID.Name),
+  ED_V(KNOWN_FOLDER_PROPS, "offset", lkfpa.KFOffset),
+  ED_V(PROPERTY_STORE_PROPS, "numstores", lpspa.NumStores),
+  ED_V(SHIM_PROPS, "layername", lspa.LayerName),
+  ED_V(SPECIAL_FOLDER_PROPS, "id", lsfpa.SpecialFolderID),
+  ED_V(SPECIAL_FOLDER_PROPS, "offset", lsfpa.Offset),
+  ED_V(TRACKER_PROPS, "length", ltpa.Length),
+  ED_V(TRACKER_PROPS, "version", ltpa.Version),
+  ED_V(TRACKER_PROPS, "machineid", ltpa.MachineID),
+  ED_V(TRACKER_PROPS, "droid1", ltpa.Droid1.UUID),
+  ED_V(TRACKER_PROPS, "droid1.time", ltpa.Droid1.Time_long),
+  ED_V(TRACKER_PROPS, "droid1.node", ltpa.Droid1.Node),
+  ED_V(TRACKER_PROPS, "droid2", ltpa.Droid2.UUID),
+  ED_V(TRACKER_PROPS, "droid2.time", ltpa.Droid2.Time_long),
+  ED_V(TRACKER_PROPS, "droid2.node", ltpa.Droid2.Node),
+  ED_V(TRACKER_PROPS, "birth1", ltpa.DroidBirth1.UUID),
+  ED_V(TRACKER_PROPS, "birth1.time", ltpa.DroidBirth1.Time_long),
+  ED_V(TRACKER_PROPS, "birth1.node", ltpa.DroidBirth1.Node),
+  ED_V(TRACKER_PROPS, "birth2", ltpa.DroidBirth2.UUID),
+  ED_V(TRACKER_PROPS, "birth2.time", ltpa.DroidBirth2.Time_long),
+  ED_V(TRACKER_PROPS, "birth2.node", ltpa.DroidBirth2.Node),
+  ED_V(VISTA_AND_ABOVE_IDLIST_PROPS, "numitems", lvidlpa.NumItemIDs)
+};
+#define NUMEDVALUES (sizeof(ldb_edvalues) / sizeof(ldb_edvalues[0]))
+
+struct LDB_BLOCK // The common start of every ExtraData block
+{
+  enum EDTYPES  type;
+  const char *  name;
+  uint64_t      Posn;
+  uint32_t      Size;
+  uint32_t      sig;
+};
+
+static sqlite3       *ldb = NULL;
+static sqlite3_stmt  *ldb_stmt[NUMSTMTS];
+static unsigned int  ldb_count; // Link files in the current transaction
+
+//Local function declarations
+int ldb_exec(const char *);
+int ldb_step(enum LDB_STMTS);
+void ldb_int(enum LDB_STMTS, int *, int, int64_t);
+void ldb_str(enum LDB_STMTS, int *, int, const unsigned char *);
+void ldb_wstr(enum LDB_STMTS, int *, int, const wchar_t *);
+int ldb_items(sqlite3_int64, const char *, struct LIF_ITEMID *, struct LIF_ITEMID_A *, int);
+int ldb_props(sqlite3_int64, sqlite3_int64, sqlite3_int64, struct LIF_PROPERTY_STORE_PROPS *);
+int ldb_valid(const unsigned char *);
+void ldb_utf8(unsigned char *, size_t, uint32_t, size_t *);
+
+//
+//Function: ldb_open() opens the database, makes the tables & statements
+extern int ldb_open(const char * path)
+{
+  char          sql[200];
+  unsigned int  i;
+
+  if (sqlite3_open(path, &ldb) != SQLITE_OK)
+  {
+    fprintf(stderr, "Unable to open the database \'%s\': %s\n", path, sqlite3_errmsg(ldb));
+    sqlite3_close(ldb);
+    ldb = NULL;
+    return -1;
+  }
+  if (ldb_exec(ldb_tables) < 0)
+  {
+    return -1;
+  }
+  for (i = 0; i < NUMINDEXES; i++)
+  {
+    snprintf(sql, 200, "DROP INDEX IF EXISTS %s", ldb_indexes[i][0]);
+    if (ldb_exec(sql) < 0)
+    {
+      return -1;
+    }
+  }
+  for (i = 0; i < NUMSTMTS; i++)
+  {
+    if (sqlite3_prepare_v2(ldb, ldb_inserts[i], -1, &ldb_stmt[i], NULL) != SQLITE_OK)
+    {
+      fprintf(stderr, "SQLite error: %s\n", sqlite3_errmsg(ldb));
+      return -1;
+    }
+  }
+  ldb_count = 0;
+  return ldb_exec("BEGIN");
+}
+
+//
+//Function: ldb_add() inserts a link file and everything in it
+extern int ldb_add(struct LIF * lif, struct LIF_A * lif_a, char * fname, struct stat * st)
+{
+  struct LDB_BLOCK  blocks[11];
+  sqlite3_int64     id, ed;
+  unsigned char     name[20];
+  unsigned int      i, j, n = 0;
+  int               c = 0, li, volid, cnr;
+
+  li = (lif->lh.Flags & 0x00000002) != 0;        // HasLinkInfo
+  volid = li && (lif->li.Flags & 0x00000001);    // VolumeIDAndLocalBasePath
+  cnr = li && (lif->li.Flags & 0x00000002);      // CommonNetworkRelativeLinkAndPathSuffix
+
+  // The link file itself (as in the '-o arrow' output)
+  ldb_str(LINKFILE, &c, 1, (unsigned char *)fname);
+  ldb_int(LINKFILE, &c, 1, (int64_t)st->st_size);
+  ldb_int(LINKFILE, &c, 1, ((int64_t)st->st_atime + 11644473600LL) * 10000000);
+  ldb_int(LINKFILE, &c, 1, ((int64_t)st->st_mtime + 11644473600LL) * 10000000);
+  ldb_int(LINKFILE, &c, 1, ((int64_t)st->st_ctime + 11644473600LL) * 10000000);
+  ldb_str(LINKFILE, &c, 1, lif_a->lha.CLSID);
+  ldb_int(LINKFILE, &c, 1, lif->lh.Flags);
+  ldb_int(LINKFILE, &c, 1, lif->lh.Attr);
+  ldb_int(LINKFILE, &c, lif->lh.CrDate != 0, lif->lh.CrDate);
+  ldb_int(LINKFILE, &c, lif->lh.AcDate != 0, lif->lh.AcDate);
+  ldb_int(LINKFILE, &c, lif->lh.WtDate != 0, lif->lh.WtDate);
+  ldb_int(LINKFILE, &c, 1, lif->lh.Size);
+  ldb_int(LINKFILE, &c, 1, lif->lh.IconIndex);
+  ldb_int(LINKFILE, &c, 1, lif->lh.ShowState);
+  ldb_int(LINKFILE, &c, 1, lif->lh.Hotkey.LowKey | (lif->lh.Hotkey.HighKey << 8));
+  ldb_int(LINKFILE, &c, lif->lh.Flags & 0x00000001, lif->lidl.IDListSize);
+  ldb_int(LINKFILE, &c, lif->lh.Flags & 0x00000001, lif->lidl.NumItemIDs);
+  ldb_int(LINKFILE, &c, li, lif->li.Flags);
+  ldb_str(LINKFILE, &c, volid, lif_a->lia.VolID.DriveType);
+  ldb_int(LINKFILE, &c, volid, lif->li.VolID.DriveSN);
+  if (lif->li.HeaderSize < 0x00000024)
+  {
+    ldb_str(LINKFILE, &c, volid, lif->li.VolID.VolumeLabel);
+  }
+  else
+  {
+    ldb_wstr(LINKFILE, &c, volid, lif->li.VolID.VolumeLabelU);
+  }
+  if (lif->li.LBPOffsetU > 0)
+  {
+    ldb_wstr(LINKFILE, &c, volid, lif->li.LBPU);
+  }
+  else
+  {
+    ldb_str(LINKFILE, &c, volid, lif->li.LBP);
+  }
+  ldb_int(LINKFILE, &c, cnr, lif->li.CNR.Flags);
+  ldb_int(LINKFILE, &c, cnr && (lif->li.CNR.Flags & 0x00000002), lif->li.CNR.NetworkProviderType);
+  if (lif->li.CNR.NetNameOffsetU > 0)
+  {
+    ldb_wstr(LINKFILE, &c, cnr, lif->li.CNR.NetNameU);
+  }
+  else
+  {
+    ldb_str(LINKFILE, &c, cnr, lif->li.CNR.NetName);
+  }
+  if (lif->li.CNR.DeviceNameOffsetU > 0)
+  {
+    ldb_wstr(LINKFILE, &c, cnr && (lif->li.CNR.Flags & 0x00000001), lif->li.CNR.DeviceNameU);
+  }
+  else
+  {
+    ldb_str(LINKFILE, &c, cnr && (lif->li.CNR.Flags & 0x00000001), lif->li.CNR.DeviceName);
+  }
+  if (lif->li.CPSOffsetU > 0)
+  {
+    ldb_wstr(LINKFILE, &c, li, lif->li.CPSU);
+  }
+  else
+  {
+    ldb_str(LINKFILE, &c, li, lif->li.CPS);
+  }
+  for (i = 0; i < 5; i++)
+  {
+    ldb_str(LINKFILE, &c, lif->lh.Flags & (0x00000004 << i), lif->lsd.Data[i]);
+  }
+  ldb_int(LINKFILE, &c, 1, lif->led.edtypes);
+  if (ldb_step(LINKFILE) < 0)
+  {
+    return -1;
+  }
+  id = sqlite3_last_insert_rowid(ldb);
+
+  // ItemIDs (and any property stores in them)
+  if ((lif->lh.Flags & 0x00000001) && (ldb_items(id, "IDList", lif->lidl.Items, lif_a->lidla.Items, lif->lidl.NumItemIDs) < 0))
+  {
+    return -1;
+  }
+  if ((lif->led.edtypes & VISTA_AND_ABOVE_IDLIST_PROPS) &&
+    (ldb_items(id, "ED >= Vista IDList", lif->led.lvidlp.Items, lif_a->leda.lvidlpa.Items, lif->led.lvidlp.NumItemIDs) < 0))
+  {
+    return -1;
+  }
+
+  // ExtraData blocks, their values & the property values of a PropertyStore
+#define ED_BLOCK(t, s, m) if (lif->led.edtypes & t) { blocks[n].type = t; blocks[n].name = s; \
+  blocks[n].Posn = lif->led.m.Posn; blocks[n].Size = lif->led.m.Size; blocks[n++].sig = lif->led.m.sig; }
+  ED_BLOCK(CONSOLE_PROPS, "console", lcp);
+  ED_BLOCK(CONSOLE_FE_PROPS, "consolefe", lcfep);
+  ED_BLOCK(DARWIN_PROPS, "darwin", ldp);
+  ED_BLOCK(ENVIRONMENT_PROPS, "env", lep);
+  ED_BLOCK(ICON_ENVIRONMENT_PROPS, "iconenv", liep);
+  ED_BLOCK(KNOWN_FOLDER_PROPS, "knownfolder", lkfp);
+  ED_BLOCK(PROPERTY_STORE_PROPS, "propstore", lpsp);
+  ED_BLOCK(SHIM_PROPS, "shim", lsp);
+  ED_BLOCK(SPECIAL_FOLDER_PROPS, "specialfolder", lsfp);
+  ED_BLOCK(TRACKER_PROPS, "tracker", ltp);
+  ED_BLOCK(VISTA_AND_ABOVE_IDLIST_PROPS, "vista", lvidlp);
+#undef ED_BLOCK
+  for (i = 0; i < n; i++)
+  {
+    c = 0;
+    ldb_int(EXTRADATA, &c, 1, id);
+    ldb_str(EXTRADATA, &c, 1, (const unsigned char *)blocks[i].name);
+    ldb_int(EXTRADATA, &c, 1, (int64_t)blocks[i].Posn);
+    ldb_int(EXTRADATA, &c, 1, blocks[i].Size);
+    ldb_int(EXTRADATA, &c, 1, blocks[i].sig);
+    if (ldb_step(EXTRADATA) < 0)
+    {
+      return -1;
+    }
+    ed = sqlite3_last_insert_rowid(ldb);
+    for (j = 0; j < NUMEDVALUES; j++)
+    {
+      if (ldb_edvalues[j].type == blocks[i].type)
+      {
+        c = 0;
+        ldb_int(EDVALUE, &c, 1, ed);
+        ldb_str(EDVALUE, &c, 1, (const unsigned char *)ldb_edvalues[j].name);
+        ldb_str(EDVALUE, &c, 1, (unsigned char *)&lif_a->leda + ldb_edvalues[j].offset);
+        if (ldb_step(EDVALUE) < 0)
+        {
+          return -1;
+        }
+      }
+    }
+    if (blocks[i].type == CONSOLE_PROPS) // The 16 ColorTable entries
+    {
+      for (j = 0; j < 16; j++)
+      {
+        c = 0;
+        ldb_int(EDVALUE, &c, 1, ed);
+        snprintf((char *)name, 20, "colortable%u", j);
+        ldb_str(EDVALUE, &c, 1, name);
+        ldb_str(EDVALUE, &c, 1, lif_a->leda.lcpa.ColorTable[j]);
+        if (ldb_step(EDVALUE) < 0)
+        {
+          return -1;
+        }
+      }
+    }
+    if ((blocks[i].type == PROPERTY_STORE_PROPS) && (ldb_props(id, ed, 0, &lif->led.lpsp) < 0))
+    {
+      return -1;
+    }
+  }
+
+  // Start a new transaction every LDB_BATCH link files
+  if (++ldb_count == LDB_BATCH)
+  {
+    ldb_count = 0;
+    return ldb_exec("COMMIT; BEGIN");
+  }
+  return 0;
+}
+
+//
+//Function: ldb_close() commits, builds the indexes & closes the database
+extern int ldb_close()
+{
+  char          sql[200];
+  unsigned int  i;
+  int           result = 0;
+
+  if (ldb == NULL)
+  {
+    return -1;
+  }
+  for (i = 0; i < NUMSTMTS; i++)
+  {
+    sqlite3_finalize(ldb_stmt[i]);
+    ldb_stmt[i] = NULL;
+  }
+  if (ldb_exec("COMMIT") < 0)
+  {
+    result = -1;
+  }
+  for (i = 0; (result == 0) && (i < NUMINDEXES); i++)
+  {
+    snprintf(sql, 200, "CREATE INDEX %s ON %s", ldb_indexes[i][0], ldb_indexes[i][1]);
+    result = ldb_exec(sql);
+  }
+  if (sqlite3_close(ldb) != SQLITE_OK)
+  {
+    fprintf(stderr, "SQLite error: %s\n", sqlite3_errmsg(ldb));
+    result = -1;
+  }
+  ldb = NULL;
+  return result;
+}
+
+//
+//Function: ldb_items() inserts the ItemIDs of an IDList, 'list' names it
+int ldb_items(sqlite3_int64 id, const char * list, struct LIF_ITEMID * items, struct LIF_ITEMID_A * items_a, int num)
+{
+  struct LIF_PROPERTY_STORE_PROPS  psp;
+  struct LIF_SHELLITEM             *shi;
+  struct LIF_SHELLITEM_A           *shia;
+  int                              i, c, size, file;
+
+  for (i = 0; i < num; i++)
+  {
+    shi = &items[i].Shell;
+    shia = &items_a[i].Shell;
+    file = shi->Type == SHI_FILE_ENTRY;
+    size = (items[i].ItemIDSize > 2) ? items[i].ItemIDSize - 2 : 0;
+    if (size > MAXITEMIDSIZE)
+    {
+      size = MAXITEMIDSIZE;
+    }
+    c = 0;
+    ldb_int(ITEMID, &c, 1, id);
+    ldb_str(ITEMID, &c, 1, (const unsigned char *)list);
+    ldb_int(ITEMID, &c, 1, i + 1);
+    ldb_int(ITEMID, &c, 1, (int64_t)items[i].Posn);
+    ldb_int(ITEMID, &c, 1, items[i].ItemIDSize);
+    ldb_int(ITEMID, &c, 1, shi->Class);
+    ldb_str(ITEMID, &c, shi->Type != SHI_UNKNOWN, shia->Type);
+    ldb_str(ITEMID, &c, shi->Type == SHI_ROOT_FOLDER, shia->FolderID.UUID);
+    ldb_str(ITEMID, &c, (shi->Type != SHI_UNKNOWN) && (shi->Type != SHI_ROOT_FOLDER), shi->Name);
+    ldb_wstr(ITEMID, &c, file && (shi->ExtVersion > 0), shi->LongName);
+    ldb_int(ITEMID, &c, file, shi->FileSize);
+    ldb_int(ITEMID, &c, file, shi->FileAttr);
+    ldb_str(ITEMID, &c, file, shia->ModTime);
+    ldb_str(ITEMID, &c, file && (shi->ExtVersion > 0), shia->CrTime);
+    ldb_str(ITEMID, &c, file && (shi->ExtVersion > 0), shia->AcTime);
+    ldb_int(ITEMID, &c, file && (shi->ExtVersion >= 7), (int64_t)shi->MFTEntry);
+    ldb_int(ITEMID, &c, file && (shi->ExtVersion >= 7), shi->MFTSeq);
+    sqlite3_bind_blob(ldb_stmt[ITEMID], ++c, items[i].Data, size, SQLITE_STATIC);
+    if (ldb_step(ITEMID) < 0)
+    {
+      return -1;
+    }
+    if ((find_propstores(items[i].Data, items[i].ItemIDSize - 2, items[i].Posn + 2, &psp) == 0) &&
+      (ldb_props(id, 0, sqlite3_last_insert_rowid(ldb), &psp) < 0))
+    {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+//
+//Function: ldb_props() inserts the values in a set of property stores that
+//are in an ExtraData block (ed) or an ItemID (item), the other being 0
+int ldb_props(sqlite3_int64 id, sqlite3_int64 ed, sqlite3_int64 item, struct LIF_PROPERTY_STORE_PROPS * psp)
+{
+  struct LIF_SER_PROPSTORE_A  psa;
+  struct LIF_SER_PROPVALUE    *pv;
+  int64_t                     time;
+  int                         i, j, b, c;
+
+  for (i = 0; i < psp->NumStores; i++)
+  {
+    if (get_propstore_a(&psp->Stores[i], &psa) != 0)
+    {
+      continue;
+    }
+    for (j = 0; j < psp->Stores[i].NumValues; j++)
+    {
+      pv = &psp->Stores[i].PropValues[j];
+      if (pv->ValueSize == 0) // The end of the store
+      {
+        continue;
+      }
+      for (time = 0, b = 7; b >= 0; b--) // Little endian
+      {
+        time = (time << 8) | pv->Value[b];
+      }
+      c = 0;
+      ldb_int(PROPVALUE, &c, 1, id);
+      ldb_int(PROPVALUE, &c, ed != 0, ed);
+      ldb_int(PROPVALUE, &c, item != 0, item);
+      ldb_int(PROPVALUE, &c, 1, i + 1);
+      ldb_str(PROPVALUE, &c, 1, psa.FormatID.UUID);
+      ldb_int(PROPVALUE, &c, psp->Stores[i].NameType != 0, pv->NameSizeOrID);
+      ldb_str(PROPVALUE, &c, 1, (psp->Stores[i].NameType == 0) ? psa.PropValues[j].Name : psa.PropValues[j].KeyName);
+      ldb_str(PROPVALUE, &c, 1, psa.PropValues[j].PropertyType);
+      ldb_str(PROPVALUE, &c, 1, psa.PropValues[j].Value);
+      ldb_int(PROPVALUE, &c, pv->PropertyType == VT_FILETIME, time);
+      if (ldb_step(PROPVALUE) < 0)
+      {
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+//
+//Function: ldb_exec() runs SQL that returns no rows
+int ldb_exec(const char * sql)
+{
+  char *msg = NULL;
+
+  if (sqlite3_exec(ldb, sql, NULL, NULL, &msg) != SQLITE_OK)
+  {
+    fprintf(stderr, "SQLite error: %s\n", (msg != NULL) ? msg : sqlite3_errmsg(ldb));
+    sqlite3_free(msg);
+    return -1;
+  }
+  return 0;
+}
+
+//
+//Function: ldb_step() runs a bound INSERT and resets it for the next row
+int ldb_step(enum LDB_STMTS s)
+{
+  int rc = sqlite3_step(ldb_stmt[s]);
+
+  sqlite3_reset(ldb_stmt[s]);
+  if (rc != SQLITE_DONE)
+  {
+    fprintf(stderr, "SQLite error: %s\n", sqlite3_errmsg(ldb));
+    return -1;
+  }
+  return 0;
+}
+
+//
+//Functions: ldb_int(), ldb_str() & ldb_wstr() bind parameter *c + 1 of an
+//INSERT to the value if 'set' (or NULL if not) and move on to the next one.
+//Strings are stored as UTF-8: ANSI strings that are not valid UTF-8 are
+//taken to be Latin-1.
+void ldb_int(enum LDB_STMTS s, int * c, int set, int64_t v)
+{
+  (*c)++;
+  if (set)
+  {
+    sqlite3_bind_int64(ldb_stmt[s], *c, v);
+  }
+  else
+  {
+    sqlite3_bind_null(ldb_stmt[s], *c);
+  }
+}
+void ldb_str(enum LDB_STMTS s, int * c, int set, const unsigned char * str)
+{
+  unsigned char  buf[2048];
+  size_t         i, len = 0;
+
+  (*c)++;
+  if (!set)
+  {
+    sqlite3_bind_null(ldb_stmt[s], *c);
+    return;
+  }
+  if (ldb_valid(str))
+  {
+    sqlite3_bind_text(ldb_stmt[s], *c, (const char *)str, -1, SQLITE_TRANSIENT);
+    return;
+  }
+  for (i = 0; str[i] != 0; i++)
+  {
+    ldb_utf8(buf, sizeof(buf), str[i], &len);
+  }
+  sqlite3_bind_text(ldb_stmt[s], *c, (const char *)buf, (int)len, SQLITE_TRANSIENT);
+}
+void ldb_wstr(enum LDB_STMTS s, int * c, int set, const wchar_t * str)
+{
+  unsigned char  buf[2048];
+  size_t         i, len = 0;
+  uint32_t       ch;
+
+  (*c)++;
+  if (!set)
+  {
+    sqlite3_bind_null(ldb_stmt[s], *c);
+    return;
+  }
+  for (i = 0; str[i] != 0; i++)
+  {
+    ch = (uint32_t)str[i];
+    // Join UTF-16 surrogate pairs (where wchar_t is 16 bits)
+    if ((ch >= 0xD800) && (ch <= 0xDBFF) && ((uint32_t)str[i + 1] >= 0xDC00) && ((uint32_t)str[i + 1] <= 0xDFFF))
+    {
+      ch = 0x10000 + ((ch - 0xD800) << 10) + ((uint32_t)str[++i] - 0xDC00);
+    }
+    ldb_utf8(buf, sizeof(buf), ch, &len);
+  }
+  sqlite3_bind_text(ldb_stmt[s], *c, (const char *)buf, (int)len, SQLITE_TRANSIENT);
+}
+
+//
+//Function: ldb_valid() returns 1 if a string is valid UTF-8 (which includes
+//plain ASCII), 0 if not
+int ldb_valid(const unsigned char * str)
+{
+  int n, k;
+
+  while (*str != 0)
+  {
+    if (*str < 0x80)
+    {
+      str++;
+      continue;
+    }
+    n = ((*str >= 0xC2) && (*str <= 0xDF)) ? 1 : ((*str >= 0xE0) && (*str <= 0xEF)) ? 2 :
+      ((*str >= 0xF0) && (*str <= 0xF4)) ? 3 : 0;
+    if ((n == 0) || ((*str == 0xE0) && (str[1] < 0xA0)) || ((*str == 0xED) && (str[1] >= 0xA0)) ||
+      ((*str == 0xF0) && (str[1] < 0x90)) || ((*str == 0xF4) && (str[1] >= 0x90)))
+    {
+      return 0;
+    }
+    for (k = 1; k <= n; k++) // A terminating zero fails this
+    {
+      if ((str[k] & 0xC0) != 0x80)
+      {
+        return 0;
+      }
+    }
+    str += n + 1;
+  }
+  return 1;
+}
+
+//
+//Function: ldb_utf8() appends a character to buf as UTF-8
+void ldb_utf8(unsigned char * buf, size_t size, uint32_t ch, size_t * len)
+{
+  if (((ch >= 0xD800) && (ch <= 0xDFFF)) || (ch > 0x10FFFF))
+  {
+    ch = 0xFFFD; // Not a character
+  }
+  if (*len + 4 > size)
+  {
+    return;
+  }
+  if (ch < 0x80)
+  {
+    buf[(*len)++] = (unsigned char)ch;
+  }
+  else if (ch < 0x800)
+  {
+    buf[(*len)++] = (unsigned char)(0xC0 | (ch >> 6));
+    buf[(*len)++] = (unsigned char)(0x80 | (ch & 0x3F));
+  }
+  else if (ch < 0x10000)
+  {
+    buf[(*len)++] = (unsigned char)(0xE0 | (ch >> 12));
+    buf[(*len)++] = (unsigned char)(0x80 | ((ch >> 6) & 0x3F));
+    buf[(*len)++] = (unsigned char)(0x80 | (ch & 0x3F));
+  }
+  else
+  {
+    buf[(*len)++] = (unsigned char)(0xF0 | (ch >> 18));
+    buf[(*len)++] = (unsigned char)(0x80 | ((ch >> 12) & 0x3F));
+    buf[(*len)++] = (unsigned char)(0x80 | ((ch >> 6) & 0x3F));
+    buf[(*len)++] = (unsigned char)(0x80 | (ch & 0x3F));
+  }
+}
+
+#else
+
+//
+//Without SQLite there is no database output
+extern int ldb_open(const char * path)
+{
+  fprintf(stderr, "Sorry, this lifer was built without SQLite (build with -DHAVE_SQLITE3 and -lsqlite3)\n");
+  return -1;
+}
+extern int ldb_add(struct LIF * lif, struct LIF_A * lif_a, char * fname, struct stat * st)
+{
+  return -1;
+}
+extern int ldb_close()
+{
+  return -1;
+}
+
+#endif
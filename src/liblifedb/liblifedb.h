@@ -0,0 +1,78 @@
+/***************************************************************
+**                                                            **
+**                    liblifedb.h                             **
+**                                                            **
+**    Writes decoded link files to an SQLite database with    **
+** one table per kind of record (link files, ItemIDs,         **
+** property values, ExtraData blocks and their values).       **
+** Needs SQLite: compile with -DHAVE_SQLITE3 & link with      **
+** -lsqlite3, without it ldb_open() reports an error.         **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int ldb_open(const char * path)                            **
+**      Opens (or creates) the database & its tables and      **
+**      starts the first transaction. Any indexes are         **
+**      dropped so the load isn't slowed by updating them.    **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** int ldb_add(struct LIF * lif,                              **
+**             struct LIF_A * lif_a,                          **
+**             char * fname,                                  **
+**             struct stat * st)                              **
+**      Adds a link file (decoded with LIF_SEC_ALL), fname &  **
+**      st are the link file's name & stat details. A new     **
+**      transaction is started every LDB_BATCH files.         **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** int ldb_close()                                            **
+**      Commits the last transaction, builds the indexes and  **
+**      closes the database.                                  **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** Tables (times are FILETIMEs, missing values are NULL):     **
+** -------                                                    **
+** linkfiles        - one row per link file (id)              **
+** itemids          - LinkTargetIDList & Vista IDList items   **
+** extradata        - one row per ExtraData block             **
+** extradata_values - the decoded fields of each block        **
+** propvalues       - property store values, from the         **
+**                    PropertyStore block or an ItemID        **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBLIFEDB_H_
+#define _LIBLIFEDB_H_
+
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include "../liblife/liblife.h"
+
+#define LDB_BATCH  10000  // Link files per transaction
+
+extern int ldb_open(const char *);
+extern int ldb_add(struct LIF *, struct LIF_A *, char *, struct stat *);
+extern int ldb_close(void);
+
+#endif
@@ -0,0 +1,323 @@
+/***************************************************************
+**                                                            **
+**                    libpmc.c                                **
+**                                                            **
+**    Counts CPU events in each stage of reading link files   **
+** ('--perf').                                                **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libpmc.h for the exported functions                    **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "./libpmc.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define PMC_LINUX
+#endif
+
+static const char * pmc_names[PMC_NUMEVENTS] =
+{
+  "cycles", "instructions", "cache_misses", "branch_misses", "task_clock_ns", "page_faults"
+};
+static const char * pmc_stages[PMC_NUMSTAGES] =
+{
+  "other", "parse", "format"
+};
+
+static int        pmc_running = 0;
+static int        pmc_stage;
+static int        pmc_slot[PMC_NUMEVENTS];              // Where each counter is in a read of the group (-1 if not counted)
+static uint64_t   pmc_last[PMC_NUMEVENTS];              // The counters at the last lap
+static uint64_t   pmc_count[PMC_NUMSTAGES][PMC_NUMEVENTS];
+static uint64_t   pmc_enabled, pmc_ontime;              // Time the group was enabled & counting (ns)
+#ifdef PMC_LINUX
+static int        pmc_leader = -1;                      // The group's file descriptor
+static const char * pmc_why = NULL;                     // Why the hardware counters weren't opened
+#endif
+
+//Local function declarations
+int pmc_read(uint64_t[]);
+const char * pmc_error(int);
+void pmc_value(FILE *, int, int, double, uint64_t);
+
+#ifdef PMC_LINUX
+//
+//Function: pmc_error() explains why perf_event_open() failed
+const char * pmc_error(int err)
+{
+  switch (err)
+  {
+  case ENOENT:
+  case EOPNOTSUPP:
+    return "not supported by this processor or virtual machine";
+  case EACCES:
+  case EPERM:
+    return "not permitted, see /proc/sys/kernel/perf_event_paranoid";
+  case ENOSYS:
+    return "not supported by this kernel";
+  default:
+    return strerror(err);
+  }
+}
+
+//
+//Function: pmc_read() reads the group of counters into vals (by PMC_
+//          number). Returns 0 if successful, -1 if not.
+int pmc_read(uint64_t vals[])
+{
+  uint64_t buf[3 + PMC_NUMEVENTS]; // nr, time enabled, time running, values
+  int i;
+
+  if (read(pmc_leader, buf, sizeof(buf)) < (ssize_t)(3 * sizeof(uint64_t)))
+  {
+    return -1;
+  }
+  pmc_enabled = buf[1];
+  pmc_ontime = buf[2];
+  for (i = 0; i < PMC_NUMEVENTS; i++)
+  {
+    vals[i] = ((pmc_slot[i] >= 0) && ((uint64_t)pmc_slot[i] < buf[0])) ? buf[3 + pmc_slot[i]] : 0;
+  }
+  return 0;
+}
+#endif
+
+//
+//Function: pmc_start() opens the counters as a group and starts them
+extern int pmc_start(void)
+{
+#ifdef PMC_LINUX
+  static const uint32_t types[PMC_NUMEVENTS] =
+  {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+    PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE
+  };
+  static const uint64_t configs[PMC_NUMEVENTS] =
+  {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_SW_PAGE_FAULTS
+  };
+  struct perf_event_attr attr;
+  int i, fd, n = 0, hw = 0, err = 0;
+
+  if (pmc_running)
+  {
+    return 0;
+  }
+  for (i = 0; i < PMC_NUMEVENTS; i++)
+  {
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = types[i];
+    attr.config = configs[i];
+    attr.disabled = (pmc_leader < 0); // The group starts when the leader does
+    attr.exclude_kernel = 1;          // lifer's own work (and allowed at perf_event_paranoid 2)
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, pmc_leader, 0);
+    if (fd < 0)
+    {
+      if ((types[i] == PERF_TYPE_HARDWARE) && (err == 0))
+      {
+        err = errno;
+      }
+      pmc_slot[i] = -1;
+      continue;
+    }
+    if (pmc_leader < 0)
+    {
+      pmc_leader = fd;
+    }
+    hw += (types[i] == PERF_TYPE_HARDWARE);
+    pmc_slot[i] = n++;
+  }
+  if (n == 0)
+  {
+    fprintf(stderr, "--perf: no performance counters (%s), carrying on without\n", pmc_error(errno));
+    return 0;
+  }
+  if (hw < 4)
+  {
+    pmc_why = pmc_error(err);
+    fprintf(stderr, "--perf: %s hardware counters (%s)\n", (hw == 0) ? "no" : "only some", pmc_why);
+  }
+  ioctl(pmc_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(pmc_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  if (pmc_read(pmc_last) < 0)
+  {
+    fprintf(stderr, "--perf: unable to read the performance counters, carrying on without\n");
+    close(pmc_leader);
+    return 0;
+  }
+  memset(pmc_count, 0, sizeof(pmc_count));
+  pmc_stage = PMC_OTHER;
+  pmc_running = 1;
+  return n;
+#else
+  int i;
+
+  for (i = 0; i < PMC_NUMEVENTS; i++)
+  {
+    pmc_slot[i] = -1;
+  }
+  fprintf(stderr, "--perf: performance counters are only available in Linux, carrying on without\n");
+  return 0;
+#endif
+}
+
+//
+//Function: pmc_lap() charges the counts since the last lap to the current
+//          stage and starts 'stage'
+extern void pmc_lap(int stage)
+{
+#ifdef PMC_LINUX
+  uint64_t vals[PMC_NUMEVENTS];
+  int i;
+
+  if (!pmc_running || (stage == pmc_stage) || (pmc_read(vals) < 0))
+  {
+    return;
+  }
+  for (i = 0; i < PMC_NUMEVENTS; i++)
+  {
+    pmc_count[pmc_stage][i] += vals[i] - pmc_last[i];
+    pmc_last[i] = vals[i];
+  }
+  pmc_stage = stage;
+#else
+  (void)stage;
+#endif
+}
+
+//
+//Function: pmc_value() prints a counter for a stage (stage == PMC_NUMSTAGES
+//          for all of them) scaled and divided by files, or 'n/a'.
+void pmc_value(FILE * fp, int event, int stage, double scale, uint64_t files)
+{
+  uint64_t v = 0;
+  int i;
+
+  if (pmc_slot[event] < 0)
+  {
+    fprintf(fp, " %12s", "n/a");
+    return;
+  }
+  for (i = 0; i < PMC_NUMSTAGES; i++)
+  {
+    v += ((stage == i) || (stage == PMC_NUMSTAGES)) ? pmc_count[i][event] : 0;
+  }
+  fprintf(fp, " %12.1f", v * scale / files);
+}
+
+//
+//Function: pmc_report() prints the table and the JSON to fp
+extern void pmc_report(FILE * fp, uint64_t files)
+{
+  double scale, cyc, ins;
+  int i, s;
+
+  if (!pmc_running)
+  {
+    return;
+  }
+  pmc_lap(PMC_NUMSTAGES); // (an unused stage, to charge the last lap)
+  pmc_running = 0;
+  // If the counters had to share the hardware they counted only some of
+  // the time, scale them up as perf does
+  scale = ((pmc_ontime > 0) && (pmc_ontime < pmc_enabled)) ? (double)pmc_enabled / pmc_ontime : 1.0;
+
+  fprintf(fp, "\n{**PERFORMANCE COUNTERS**}\n");
+  fprintf(fp, "  %-14s", (files > 0) ? "Per file" : "In all");
+  for (s = 0; s < PMC_NUMSTAGES; s++)
+  {
+    fprintf(fp, " %12s", pmc_stages[s]);
+  }
+  fprintf(fp, " %12s\n", "total");
+  for (i = 0; i < PMC_NUMEVENTS; i++)
+  {
+    fprintf(fp, "  %-14s", pmc_names[i]);
+    for (s = 0; s <= PMC_NUMSTAGES; s++)
+    {
+      pmc_value(fp, i, s, scale, (files > 0) ? files : 1);
+    }
+    fprintf(fp, "\n");
+  }
+  fprintf(fp, "  %-14s", "IPC");
+  for (s = 0; s <= PMC_NUMSTAGES; s++)
+  {
+    cyc = ins = 0;
+    for (i = 0; i < PMC_NUMSTAGES; i++)
+    {
+      if ((s == i) || (s == PMC_NUMSTAGES))
+      {
+        cyc += pmc_count[i][PMC_CYCLES];
+        ins += pmc_count[i][PMC_INSTR];
+      }
+    }
+    if ((pmc_slot[PMC_CYCLES] >= 0) && (pmc_slot[PMC_INSTR] >= 0) && (cyc > 0))
+    {
+      fprintf(fp, " %12.2f", ins / cyc);
+    }
+    else
+    {
+      fprintf(fp, " %12s", "n/a");
+    }
+  }
+  fprintf(fp, "\n  Link files:    %"PRIu64"\n", files);
+  if (scale > 1.0)
+  {
+    fprintf(fp, "  (the counters were only running %.0f%% of the time, the counts are scaled up)\n", 100.0 / scale);
+  }
+#ifdef PMC_LINUX
+  if (pmc_why != NULL)
+  {
+    fprintf(fp, "  (n/a: %s)\n", pmc_why);
+  }
+#endif
+
+  fprintf(fp, "{\"perf\":{\"files\":%"PRIu64",\"scale\":%.4f", files, scale);
+  for (s = 0; s < PMC_NUMSTAGES; s++)
+  {
+    fprintf(fp, ",\"%s\":{", pmc_stages[s]);
+    for (i = 0; i < PMC_NUMEVENTS; i++)
+    {
+      if (pmc_slot[i] >= 0)
+      {
+        fprintf(fp, "%s\"%s\":%"PRIu64, (i == 0) ? "" : ",", pmc_names[i], pmc_count[s][i]);
+      }
+      else
+      {
+        fprintf(fp, "%s\"%s\":null", (i == 0) ? "" : ",", pmc_names[i]);
+      }
+    }
+    fprintf(fp, "}");
+  }
+  fprintf(fp, "}}\n");
+}
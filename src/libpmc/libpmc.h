@@ -0,0 +1,83 @@
+/***************************************************************
+**                                                            **
+**                    libpmc.h                                **
+**                                                            **
+**    Counts CPU events (cycles, instructions, cache misses   **
+** and branch misses) while lifer decodes and while it        **
+** formats the link files ('--perf'), using the performance   **
+** monitoring counters through Linux's perf_event_open(). The **
+** counters are opened as one group, read together at each    **
+** change of stage and the difference charged to the stage    **
+** that was running (as libstats does with time). Where the   **
+** hardware counters can't be had (virtual machines,          **
+** containers, perf_event_paranoid) the task clock & page     **
+** faults are still counted, and if nothing can be counted    **
+** lifer says so and carries on without.                      **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int pmc_start(void)                                        **
+**      Opens the counters (for this process, user space      **
+**      only) and starts the PMC_OTHER stage. Returns the     **
+**      number of counters opened, 0 if there are none        **
+**      (having written why to stderr), when pmc_lap() does   **
+**      nothing.                                              **
+**                                                            **
+** void pmc_lap(int stage)                                    **
+**      Reads the counters, charges what was counted since    **
+**      the last lap to the current stage and makes 'stage'   **
+**      (PMC_OTHER, PMC_PARSE or PMC_FORMAT) the current one. **
+**                                                            **
+** void pmc_report(FILE * fp, uint64_t files)                 **
+**      Ends the current stage and prints a table of each     **
+**      counter per file (for each stage and in all), the     **
+**      instructions per cycle, and the same as a line of     **
+**      JSON, to fp.                                          **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBPMC_H_
+#define _LIBPMC_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+// The stages
+#define PMC_OTHER      0 // Opening, testing & filtering files, reading directories etc.
+#define PMC_PARSE      1 // get_lif_at()
+#define PMC_FORMAT     2 // get_lif_a_opt() and formatting & writing the output
+#define PMC_NUMSTAGES  3
+
+// The counters
+#define PMC_CYCLES     0
+#define PMC_INSTR      1
+#define PMC_CACHEMISS  2
+#define PMC_BRANCHMISS 3
+#define PMC_TASKCLOCK  4 // ns (a software counter)
+#define PMC_PAGEFAULTS 5 // (a software counter)
+#define PMC_NUMEVENTS  6
+
+extern int pmc_start(void);
+extern void pmc_lap(int);
+extern void pmc_report(FILE *, uint64_t);
+
+#endif
@@ -0,0 +1,350 @@
+/***************************************************************
+**                                                            **
+**                    libprogress.c                           **
+**                                                            **
+**    Reports the progress, rate & ETA of a long run          **
+** ('--progress').                                            **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libprogress.h for the exported functions               **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "./libprogress.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include "../win/dirent.h"
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <unistd.h>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+#ifdef _MSC_VER
+#define PG_GET(field) _InterlockedCompareExchange64(&pg_counts->field, 0, 0)
+#else
+#define PG_GET(field) __atomic_load_n(&pg_counts->field, __ATOMIC_RELAXED)
+#endif
+
+#define PG_WIDTH  79 // Of a line that overwrites the last on a terminal
+
+static struct PG_COUNTS pg_local;
+struct PG_COUNTS * pg_counts = &pg_local;
+
+static int          pg_running = 0;
+static int          pg_interval;    // Seconds between lines
+static int          pg_tty;         // Standard error is a terminal
+static int          pg_nargs;
+static char      ** pg_args;
+static DIR        * pg_dir;         // The directory being counted (or NULL)
+static int64_t      pg_total = -1;  // Files to do (-1 until counted)
+static int64_t      pg_start_ns;
+#ifdef _WIN32
+static HANDLE       pg_thread;
+static HANDLE       pg_wake;
+#else
+static pid_t        pg_pid;
+static int          pg_pipe[2];     // Closed by pg_stop() (or lifer ending) to stop the reporter
+#endif
+
+//Local function declarations
+int64_t pg_now(void);
+int pg_wait(int);
+int pg_stopping(void);
+void pg_count(void);
+void pg_hms(int64_t, char *, size_t);
+void pg_line(int64_t, int64_t *, int64_t *, int);
+
+//
+//Function: pg_now() returns the monotonic clock in ns
+int64_t pg_now(void)
+{
+#ifdef _WIN32
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+
+  if (freq.QuadPart == 0)
+  {
+    QueryPerformanceFrequency(&freq);
+  }
+  QueryPerformanceCounter(&now);
+  return (int64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+#endif
+}
+
+//
+//Function: pg_wait() sleeps for 'secs' seconds or until pg_stop() is
+//          called. Returns 1 if it was, 0 if not.
+int pg_wait(int secs)
+{
+#ifdef _WIN32
+  return WaitForSingleObject(pg_wake, secs * 1000) == WAIT_OBJECT_0;
+#else
+  struct pollfd pfd = { 0, POLLIN, 0 };
+
+  pfd.fd = pg_pipe[0];
+  return poll(&pfd, 1, secs * 1000) > 0; // (Interrupted, it just reports early)
+#endif
+}
+
+//
+//Function: pg_stopping() returns 1 if pg_stop() has been called (without
+//          waiting)
+int pg_stopping(void)
+{
+#ifdef _WIN32
+  return WaitForSingleObject(pg_wake, 0) == WAIT_OBJECT_0;
+#else
+  return pg_wait(0);
+#endif
+}
+
+//
+//Function: pg_count() counts the files lifer has to read. For a directory
+//          the entries that are regular files (or might be, if readdir()
+//          doesn't say) are counted, for files every one that isn't a
+//          directory (lifer tries to read those that don't exist).
+void pg_count(void)
+{
+  struct dirent *entry;
+  struct stat statbuf;
+  int64_t n = 0;
+  int i;
+
+  if (pg_dir != NULL)
+  {
+    while (((entry = readdir(pg_dir)) != NULL) && ((n & 0xFFF) || !pg_stopping()))
+    {
+#ifdef _DIRENT_HAVE_D_TYPE
+      if ((entry->d_type == DT_REG) || (entry->d_type == DT_UNKNOWN))
+      {
+        n++;
+      }
+#else
+      if ((strcmp(entry->d_name, ".") != 0) && (strcmp(entry->d_name, "..") != 0))
+      {
+        n++;
+      }
+#endif
+    }
+    closedir(pg_dir);
+    pg_dir = NULL;
+  }
+  else
+  {
+    for (i = 0; i < pg_nargs; i++)
+    {
+      if ((stat(pg_args[i], &statbuf) != 0) || ((statbuf.st_mode & S_IFMT) != S_IFDIR))
+      {
+        n++;
+      }
+    }
+  }
+  pg_total = n;
+}
+
+//
+//Function: pg_hms() writes a number of seconds as h:mm:ss
+void pg_hms(int64_t secs, char * buf, size_t size)
+{
+  snprintf(buf, size, "%"PRId64":%02d:%02d", secs / 3600, (int)((secs / 60) % 60), (int)(secs % 60));
+}
+
+//
+//Function: pg_line() writes a progress line. The rates are since the last
+//          line (*files & *bytes are the counts then, updated here), the
+//          ETA is from the average rate since the start. If 'last' the
+//          totals and average rates for the whole run are written instead.
+void pg_line(int64_t now, int64_t * files, int64_t * bytes, int last)
+{
+  static int64_t then = 0;
+  int64_t f = PG_GET(Files), b = PG_GET(Bytes), e = PG_GET(Errors);
+  double secs, elapsed = (now - pg_start_ns) / 1e9;
+  char line[256], eta[32], took[32];
+  int n;
+
+  if (then == 0)
+  {
+    then = pg_start_ns;
+  }
+  secs = (now - then) / 1e9;
+  if (last || (secs <= 0))
+  {
+    secs = (elapsed > 0) ? elapsed : 1e-9;
+    *files = *bytes = 0;
+  }
+  if (pg_total < 0)
+  {
+    n = snprintf(line, sizeof(line), "Progress: %"PRId64" files", f);
+  }
+  else
+  {
+    n = snprintf(line, sizeof(line), "Progress: %"PRId64" of %"PRId64" files (%.1f%%)", f, pg_total,
+      (pg_total > 0) ? ((f < pg_total) ? f : pg_total) * 100.0 / pg_total : 100.0);
+  }
+  n += snprintf(line + n, sizeof(line) - n, ", %.0f files/sec, %.2f MB/sec, %"PRId64" errors",
+    (f - *files) / secs, (b - *bytes) / secs / 1048576, e);
+  if (last)
+  {
+    pg_hms((int64_t)elapsed, took, sizeof(took));
+    n += snprintf(line + n, sizeof(line) - n, ", took %s", took);
+  }
+  else if ((pg_total >= 0) && (f > 0))
+  {
+    pg_hms((pg_total > f) ? (int64_t)((pg_total - f) * (elapsed / f)) : 0, eta, sizeof(eta));
+    n += snprintf(line + n, sizeof(line) - n, ", ETA %s", eta);
+  }
+  else
+  {
+    n += snprintf(line + n, sizeof(line) - n, ", ETA ?");
+  }
+  if (pg_tty)
+  {
+    fprintf(stderr, "\r%-*s%s", PG_WIDTH, line, last ? "\n" : "");
+  }
+  else
+  {
+    fprintf(stderr, "%s\n", line);
+  }
+  fflush(stderr);
+  then = now;
+  *files = f;
+  *bytes = b;
+}
+
+//
+//Function: pg_report() is the reporter (a thread in Windows, a process
+//          otherwise)
+#ifdef _WIN32
+static DWORD WINAPI pg_report(LPVOID arg)
+#else
+static void * pg_report(void * arg)
+#endif
+{
+  int64_t files = 0, bytes = 0;
+
+  (void)arg;
+  pg_count();
+  while (!pg_wait(pg_interval))
+  {
+    pg_line(pg_now(), &files, &bytes, 0);
+  }
+  pg_line(pg_now(), &files, &bytes, 1);
+  return 0;
+}
+
+//
+//Function: pg_start() starts the reporter. In Windows it is a thread. Any
+//          other thread would make the C library lock stdout for each of
+//          lifer's many small writes (glibc doesn't while a program has only
+//          one) so elsewhere it is a child process, with the counters in
+//          memory shared with it.
+extern int pg_start(int interval, int nargs, char * args[])
+{
+  struct stat statbuf;
+
+  if (pg_running)
+  {
+    return 0;
+  }
+  pg_tty = isatty(fileno(stderr));
+  pg_interval = (interval > 0) ? interval : (pg_tty ? 1 : 10);
+  pg_nargs = nargs;
+  pg_args = args;
+  pg_dir = NULL;
+  // lifer reads one directory or some files. Open the directory now, lifer
+  // changes into it.
+  if ((nargs > 0) && (stat(args[0], &statbuf) == 0) && ((statbuf.st_mode & S_IFMT) == S_IFDIR))
+  {
+    pg_dir = opendir(args[0]);
+  }
+  pg_start_ns = pg_now();
+#ifdef _WIN32
+  if (((pg_wake = CreateEvent(NULL, TRUE, FALSE, NULL)) == NULL) ||
+    ((pg_thread = CreateThread(NULL, 0, pg_report, NULL, 0, NULL)) == NULL))
+#else
+  fflush(stderr);
+  if (((pg_counts = mmap(NULL, sizeof(struct PG_COUNTS), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED) ||
+    (pipe(pg_pipe) != 0) || ((pg_pid = fork()) < 0))
+#endif
+  {
+    fprintf(stderr, "Unable to start the progress reporter\n");
+    if (pg_dir != NULL)
+    {
+      closedir(pg_dir);
+    }
+    return -1;
+  }
+#ifndef _WIN32
+  if (pg_pid == 0)
+  {
+    // The reporter, until lifer closes its end of the pipe (or dies)
+    close(pg_pipe[1]);
+    pg_report(NULL);
+    _exit(0); // Not exit(), which would flush lifer's copy of stdout
+  }
+  close(pg_pipe[0]);
+  if (pg_dir != NULL)
+  {
+    closedir(pg_dir); // The reporter has its own
+  }
+#endif
+  pg_running = 1;
+  atexit(pg_stop);
+  return 0;
+}
+
+//
+//Function: pg_stop() stops the reporter, which writes the totals
+extern void pg_stop(void)
+{
+  if (!pg_running)
+  {
+    return;
+  }
+  pg_running = 0;
+#ifdef _WIN32
+  SetEvent(pg_wake);
+  WaitForSingleObject(pg_thread, INFINITE);
+  CloseHandle(pg_thread);
+  CloseHandle(pg_wake);
+#else
+  close(pg_pipe[1]);
+  waitpid(pg_pid, NULL, 0);
+#endif
+}
@@ -0,0 +1,83 @@
+/***************************************************************
+**                                                            **
+**                    libprogress.h                           **
+**                                                            **
+**    Reports how far a long run has got ('--progress'). The  **
+** thread reading the link files only adds to the counters in **
+** *pg_counts (with PG_ADD(), an atomic add). A reporter      **
+** counts the work to be done, then every few seconds reads   **
+** the counters and writes the files & bytes per second, the  **
+** errors and an estimate of the time left to standard error. **
+** The reporter is a child process sharing the counters (a    **
+** thread in Windows), see pg_start() in libprogress.c.       **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int pg_start(int interval, int nargs, char * args[])       **
+**      Starts the reporter, which writes a line every        **
+**      'interval' seconds (0 for every second if standard    **
+**      error is a terminal, when each line overwrites the    **
+**      last, or every 10 seconds if not). args are the files **
+**      or directory lifer was given: a directory is opened   **
+**      here (before lifer changes into it) and its regular   **
+**      files counted by the reporter (as are files). Until   **
+**      the count is done no ETA is shown. pg_stop() is       **
+**      registered with atexit(). Call it before opening any  **
+**      other files or pipes, the reporter process gets a     **
+**      copy of them.                                         **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** void pg_stop(void)                                         **
+**      Stops the reporter and writes a last line with the    **
+**      totals. Does nothing if pg_start() was not called     **
+**      (or pg_stop() already has been).                      **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBPROGRESS_H_
+#define _LIBPROGRESS_H_
+
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+struct PG_COUNTS
+{
+  volatile int64_t    Files;        // Files finished with
+  volatile int64_t    Bytes;        // Bytes of them read
+  volatile int64_t    Errors;       // Couldn't be opened, not link files or failed to decode
+};
+
+extern struct PG_COUNTS * pg_counts;
+
+// Add n to a counter (cheap enough to do whether '--progress' is on or not)
+#ifdef _MSC_VER
+#define PG_ADD(field, n) _InterlockedExchangeAdd64(&pg_counts->field, (int64_t)(n))
+#else
+#define PG_ADD(field, n) __atomic_fetch_add(&pg_counts->field, (int64_t)(n), __ATOMIC_RELAXED)
+#endif
+
+extern int pg_start(int, int, char *[]);
+extern void pg_stop(void);
+
+#endif
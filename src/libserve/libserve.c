@@ -0,0 +1,910 @@
+/***************************************************************
+**                                                            **
+**                    libserve.c                              **
+**                                                            **
+**    Serves link file requests over a UNIX domain socket.    **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libserve.h for the exported functions                  **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifdef __linux__
+#define _GNU_SOURCE // memfd_create(), accept4()
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "./libserve.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#define SRV_LINUX
+#endif
+
+#ifdef SRV_LINUX
+#define SRV_CLIENT_KIND 1
+#define SRV_WORKER_KIND 2
+#define SRV_MAXWORKERS  256
+#define SRV_EVENTS      64      // epoll events taken at a time
+
+// Client states
+#define SRV_IDLE        0       // No request being dealt with
+#define SRV_WAITING     1       // A request is waiting for a free worker
+#define SRV_SERVED      2       // A worker has the request
+
+struct SRV_CLIENT
+{
+  int                 Kind;     // SRV_CLIENT_KIND (epoll gives back a client or a worker)
+  int                 fd;
+  char              * Buf;      // Bytes read but not yet handed to a worker
+  size_t              Len;
+  size_t              Size;
+  int                 State;    // SRV_IDLE, SRV_WAITING or SRV_SERVED
+  int                 Eof;      // The client has stopped sending (or gone)
+  struct SRV_CLIENT * Prev;     // All the clients
+  struct SRV_CLIENT * Next;
+  struct SRV_CLIENT * Wait;     // The next client waiting for a worker
+};
+
+struct SRV_WORKER
+{
+  int                 Kind;     // SRV_WORKER_KIND
+  pid_t               pid;
+  int                 fd;       // The loop's end of the worker's socket pair (-1 if none)
+  struct SRV_CLIENT * Client;   // The client being served (NULL if the worker is free)
+};
+
+static int                 srv_epoll = -1;
+static int                 srv_listen = -1;
+static int                 srv_signal = -1;
+static struct SRV_WORKER   srv_workers[SRV_MAXWORKERS];
+static int                 srv_nworkers = 0;
+static struct SRV_CLIENT * srv_clients = NULL;
+static struct SRV_CLIENT * srv_wait_head = NULL; // The clients waiting for a worker, first come first served
+static struct SRV_CLIENT * srv_wait_tail = NULL;
+static SRV_RENDER          srv_render;
+static void              * srv_ctx;
+
+//Local function declarations
+int srv_open(const char *);
+int srv_spawn(int);
+void srv_worker(int);
+void srv_answer(int, char *, size_t);
+int srv_send(int, const char *, size_t);
+long srv_base64(const char *, size_t, unsigned char *);
+void srv_accept(void);
+void srv_read(struct SRV_CLIENT *, uint32_t);
+void srv_next(struct SRV_CLIENT *);
+void srv_give(struct SRV_WORKER *, struct SRV_CLIENT *);
+void srv_done(struct SRV_WORKER *);
+void srv_events(struct SRV_CLIENT *, uint32_t);
+void srv_close(struct SRV_CLIENT *);
+void srv_stop(void);
+
+//
+//Function: srv_open() makes the listening socket at path. A socket left by
+//          a daemon that has gone is replaced, one that is still answering
+//          is not. Returns the socket or -1.
+int srv_open(const char * path)
+{
+  struct sockaddr_un addr;
+  mode_t mask;
+  int fd;
+
+  if (strlen(path) >= sizeof(addr.sun_path))
+  {
+    fprintf(stderr, "Sorry, the socket path \'%s\' is too long\n", path);
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0)
+  {
+    perror("Error making the socket");
+    return -1;
+  }
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+  {
+    fprintf(stderr, "Sorry, lifer is already serving on \'%s\'\n", path);
+    close(fd);
+    return -1;
+  }
+  if (errno == ECONNREFUSED)
+  {
+    unlink(path); // (a stale socket)
+  }
+  mask = umask(0077); // Only this user can connect
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+  {
+    umask(mask);
+    perror("Error binding the socket");
+    fprintf(stderr, "whilst opening: \'%s\'\n", path);
+    close(fd);
+    return -1;
+  }
+  umask(mask);
+  if (listen(fd, SOMAXCONN) < 0)
+  {
+    perror("Error listening on the socket");
+    close(fd);
+    unlink(path);
+    return -1;
+  }
+  return fd;
+}
+
+//
+//Function: srv_spawn() starts worker i. Returns 0 or -1.
+int srv_spawn(int i)
+{
+  struct SRV_WORKER * w = &srv_workers[i];
+  struct SRV_CLIENT * c;
+  struct epoll_event ev;
+  sigset_t sigs;
+  int sv[2], j;
+
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) < 0)
+  {
+    perror("Error making a worker's socket pair");
+    return -1;
+  }
+  fflush(NULL); // (so the worker doesn't write what is buffered again)
+  if ((w->pid = fork()) < 0)
+  {
+    perror("Error starting a worker");
+    close(sv[0]);
+    close(sv[1]);
+    return -1;
+  }
+  if (w->pid == 0)
+  {
+    // The worker keeps only its end of the pair
+    close(sv[0]);
+    close(srv_epoll);
+    close(srv_listen);
+    close(srv_signal);
+    for (j = 0; j < srv_nworkers; j++)
+    {
+      if ((j != i) && (srv_workers[j].fd >= 0))
+      {
+        close(srv_workers[j].fd);
+      }
+    }
+    for (c = srv_clients; c != NULL; c = c->Next)
+    {
+      close(c->fd);
+    }
+    signal(SIGINT, SIG_IGN); // (Ctrl-C is for the loop, it stops the workers)
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    sigprocmask(SIG_UNBLOCK, &sigs, NULL);
+    srv_worker(sv[1]);
+    _exit(EXIT_SUCCESS);
+  }
+  close(sv[1]);
+  w->Kind = SRV_WORKER_KIND;
+  w->fd = sv[0];
+  w->Client = NULL;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.ptr = w;
+  if (epoll_ctl(srv_epoll, EPOLL_CTL_ADD, w->fd, &ev) < 0)
+  {
+    perror("Error adding a worker");
+    close(w->fd);
+    w->fd = -1;
+    kill(w->pid, SIGTERM);
+    waitpid(w->pid, NULL, 0);
+    return -1;
+  }
+  return 0;
+}
+
+//
+//Function: srv_worker() is a worker's loop. Each request comes as its length
+//          (with the client's socket) then the request, when it has been
+//          answered one byte goes back to say the worker is free.
+void srv_worker(int fd)
+{
+  char cbuf[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg;
+  struct cmsghdr * cmsg;
+  struct iovec iov;
+  uint32_t len;
+  char * line = NULL, * p;
+  size_t size = 0;
+  ssize_t n;
+  int cfd;
+
+  for (;;)
+  {
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = &len;
+    iov.iov_len = sizeof(len);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cbuf;
+    msg.msg_controllen = sizeof(cbuf);
+    if (recvmsg(fd, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC) != sizeof(len))
+    {
+      return; // The loop has gone
+    }
+    cmsg = CMSG_FIRSTHDR(&msg);
+    if ((cmsg == NULL) || (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS))
+    {
+      return;
+    }
+    memcpy(&cfd, CMSG_DATA(cmsg), sizeof(int));
+    if (len + 1 > size)
+    {
+      if ((p = realloc(line, len + 1)) == NULL)
+      {
+        return;
+      }
+      line = p;
+      size = len + 1;
+    }
+    if ((len > 0) && (recv(fd, line, len, MSG_WAITALL) != (ssize_t)len))
+    {
+      return;
+    }
+    srv_answer(cfd, line, len);
+    close(cfd);
+    do
+    {
+      n = write(fd, "", 1);
+    } while ((n < 0) && (errno == EINTR));
+    if (n != 1)
+    {
+      return;
+    }
+  }
+}
+
+//
+//Function: srv_answer() renders the link file of a request (its 'len' bytes
+//          at line, without the new line) and sends the answer to cfd
+void srv_answer(int cfd, char * line, size_t len)
+{
+  char head[300];
+  const char * why = NULL, * name;
+  unsigned char * data = NULL;
+  char * format, * src, * obuf = NULL;
+  size_t olen = 0;
+  FILE * fp = NULL, * out;
+  struct stat st;
+  long size;
+  int mfd, fd;
+
+  if ((len > 0) && (line[len - 1] == '\r'))
+  {
+    len--;
+  }
+  line[len] = 0;
+  format = line;
+  if ((src = strchr(line, ' ')) == NULL)
+  {
+    why = "Expected \'FORMAT PATH\' or \'FORMAT base64:DATA\'";
+  }
+  else
+  {
+    *src++ = 0;
+    if (strncmp(src, "base64:", 7) == 0)
+    {
+      // The bytes go in a memory file, so the renderer has a FILE to read
+      // (& fstat()) as it would a link file on disk
+      name = "-";
+      if ((data = malloc(strlen(src + 7) / 4 * 3 + 3)) == NULL)
+      {
+        why = "Out of memory";
+      }
+      else if ((size = srv_base64(src + 7, strlen(src + 7), data)) < 0)
+      {
+        why = "The data is not valid base64";
+      }
+      else if ((mfd = memfd_create("lifer", MFD_CLOEXEC)) < 0)
+      {
+        why = strerror(errno);
+      }
+      else if ((write(mfd, data, size) != size) || (lseek(mfd, 0, SEEK_SET) != 0) ||
+        ((fp = fdopen(mfd, "rb")) == NULL))
+      {
+        why = strerror(errno);
+        close(mfd);
+      }
+      free(data);
+    }
+    else
+    {
+      // Opened without blocking and checked before reading: a FIFO (or a
+      // device) would otherwise hold up the worker in fopen() for good
+      name = src;
+      if ((fd = open(src, O_RDONLY | O_NONBLOCK | O_CLOEXEC)) < 0)
+      {
+        why = strerror(errno);
+      }
+      else if (fstat(fd, &st) != 0)
+      {
+        why = strerror(errno);
+        close(fd);
+      }
+      else if (!S_ISREG(st.st_mode))
+      {
+        why = "Not a regular file";
+        close(fd);
+      }
+      else if ((fp = fdopen(fd, "rb")) == NULL)
+      {
+        why = strerror(errno);
+        close(fd);
+      }
+    }
+  }
+  if (why == NULL)
+  {
+    if ((out = open_memstream(&obuf, &olen)) == NULL)
+    {
+      why = "Out of memory";
+    }
+    else
+    {
+      why = srv_render(srv_ctx, format, name, fp, out);
+      fclose(out);
+    }
+  }
+  if (fp != NULL)
+  {
+    fclose(fp);
+  }
+  if (why != NULL)
+  {
+    snprintf(head, sizeof(head), "ERR %s\n", why);
+    srv_send(cfd, head, strlen(head));
+  }
+  else
+  {
+    snprintf(head, sizeof(head), "OK %lu\n", (unsigned long)olen);
+    if (srv_send(cfd, head, strlen(head)) == 0)
+    {
+      srv_send(cfd, obuf, olen);
+    }
+  }
+  free(obuf);
+}
+
+//
+//Function: srv_send() sends n bytes to a client, waiting (up to SRV_TIMEOUT)
+//          for it to take them. Returns 0 or -1 if it has gone or is stuck.
+int srv_send(int fd, const char * buf, size_t n)
+{
+  struct pollfd pfd;
+  ssize_t sent;
+
+  while (n > 0)
+  {
+    if ((sent = send(fd, buf, n, MSG_NOSIGNAL)) >= 0)
+    {
+      buf += sent;
+      n -= sent;
+    }
+    else if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+    {
+      // (the socket is non-blocking, it is the loop's too)
+      pfd.fd = fd;
+      pfd.events = POLLOUT;
+      if (poll(&pfd, 1, SRV_TIMEOUT) <= 0)
+      {
+        return -1;
+      }
+    }
+    else if (errno != EINTR)
+    {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+//
+//Function: srv_base64() decodes n characters of base64 (with or without the
+//          '=' padding) into out. Returns the number of bytes or -1.
+long srv_base64(const char * in, size_t n, unsigned char * out)
+{
+  uint32_t bits = 0;
+  long len = 0;
+  size_t i;
+  int nbits = 0, v;
+
+  while ((n > 0) && (in[n - 1] == '='))
+  {
+    n--;
+  }
+  for (i = 0; i < n; i++)
+  {
+    if ((in[i] >= 'A') && (in[i] <= 'Z'))
+      v = in[i] - 'A';
+    else if ((in[i] >= 'a') && (in[i] <= 'z'))
+      v = in[i] - 'a' + 26;
+    else if ((in[i] >= '0') && (in[i] <= '9'))
+      v = in[i] - '0' + 52;
+    else if (in[i] == '+')
+      v = 62;
+    else if (in[i] == '/')
+      v = 63;
+    else
+      return -1;
+    bits = (bits << 6) | v;
+    nbits += 6;
+    if (nbits >= 8)
+    {
+      nbits -= 8;
+      out[len++] = (unsigned char)(bits >> nbits);
+    }
+  }
+  return (nbits >= 6) ? -1 : len; // (one character left over can't be a byte)
+}
+
+//
+//Function: srv_accept() takes the new clients
+void srv_accept(void)
+{
+  struct SRV_CLIENT * c;
+  struct epoll_event ev;
+  int fd;
+
+  while ((fd = accept4(srv_listen, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+  {
+    if ((c = calloc(1, sizeof(struct SRV_CLIENT))) == NULL)
+    {
+      close(fd);
+      continue;
+    }
+    c->Kind = SRV_CLIENT_KIND;
+    c->fd = fd;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = c;
+    if (epoll_ctl(srv_epoll, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+      close(fd);
+      free(c);
+      continue;
+    }
+    c->Next = srv_clients;
+    if (srv_clients != NULL)
+    {
+      srv_clients->Prev = c;
+    }
+    srv_clients = c;
+  }
+}
+
+//
+//Function: srv_read() reads what a client has sent
+void srv_read(struct SRV_CLIENT * c, uint32_t events)
+{
+  char * p;
+  ssize_t n;
+
+  if (c->State != SRV_IDLE)
+  {
+    // Only a hang up is reported while a request is being dealt with, the
+    // client has gone so none of its requests will be answered
+    srv_close(c);
+    return;
+  }
+  if (c->Size - c->Len < 65536)
+  {
+    if ((p = realloc(c->Buf, c->Size + 65536)) == NULL)
+    {
+      srv_close(c);
+      return;
+    }
+    c->Buf = p;
+    c->Size += 65536;
+  }
+  n = read(c->fd, c->Buf + c->Len, c->Size - c->Len);
+  if (n > 0)
+  {
+    c->Len += n;
+  }
+  else if (n == 0)
+  {
+    c->Eof = 1;
+    epoll_ctl(srv_epoll, EPOLL_CTL_DEL, c->fd, NULL);
+  }
+  else if ((errno != EAGAIN) && (errno != EINTR))
+  {
+    srv_close(c);
+    return;
+  }
+  else if (events & (EPOLLHUP | EPOLLERR))
+  {
+    srv_close(c);
+    return;
+  }
+  srv_next(c);
+}
+
+//
+//Function: srv_next() starts on a client's next request, if it has sent all
+//          of one, or closes it if it has finished
+void srv_next(struct SRV_CLIENT * c)
+{
+  static const char * toolong = "ERR The request is too long\n";
+  int i;
+
+  if (c->State != SRV_IDLE)
+  {
+    return;
+  }
+  if (memchr(c->Buf, '\n', c->Len) != NULL)
+  {
+    for (i = 0; (i < srv_nworkers) && ((srv_workers[i].fd < 0) || (srv_workers[i].Client != NULL)); i++);
+    if ((i < srv_nworkers) && (srv_wait_head == NULL))
+    {
+      srv_give(&srv_workers[i], c);
+    }
+    else
+    {
+      c->State = SRV_WAITING;
+      if (srv_wait_tail != NULL)
+      {
+        srv_wait_tail->Wait = c;
+      }
+      else
+      {
+        srv_wait_head = c;
+      }
+      srv_wait_tail = c;
+    }
+    srv_events(c, 0); // Nothing more is read until it is answered
+  }
+  else if (c->Len > SRV_MAXLINE)
+  {
+    srv_send(c->fd, toolong, strlen(toolong));
+    srv_close(c);
+  }
+  else if (c->Eof)
+  {
+    srv_close(c);
+  }
+  else
+  {
+    srv_events(c, EPOLLIN);
+  }
+}
+
+//
+//Function: srv_give() gives a client's first request to a free worker
+void srv_give(struct SRV_WORKER * w, struct SRV_CLIENT * c)
+{
+  char cbuf[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg;
+  struct cmsghdr * cmsg;
+  struct iovec iov;
+  uint32_t len;
+  char * nl = memchr(c->Buf, '\n', c->Len);
+  size_t off;
+  ssize_t n;
+
+  len = (uint32_t)(nl - c->Buf);
+  memset(&msg, 0, sizeof(msg));
+  memset(cbuf, 0, sizeof(cbuf));
+  iov.iov_base = &len;
+  iov.iov_len = sizeof(len);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = cbuf;
+  msg.msg_controllen = sizeof(cbuf);
+  cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  memcpy(CMSG_DATA(cmsg), &c->fd, sizeof(int));
+  w->Client = c;
+  c->State = SRV_SERVED;
+  // The worker is waiting for it, so this doesn't hold up the loop for long.
+  // If the worker has gone srv_done() will find out and answer the client.
+  if (sendmsg(w->fd, &msg, MSG_NOSIGNAL) == sizeof(len))
+  {
+    for (off = 0; off < len; off += n)
+    {
+      if ((n = send(w->fd, c->Buf + off, len - off, MSG_NOSIGNAL)) < 0)
+      {
+        if (errno != EINTR)
+        {
+          break;
+        }
+        n = 0;
+      }
+    }
+  }
+  c->Len -= len + 1;
+  memmove(c->Buf, nl + 1, c->Len);
+}
+
+//
+//Function: srv_done() is called when a worker says it is free, or has died.
+//          A worker that has died is replaced and its client told.
+void srv_done(struct SRV_WORKER * w)
+{
+  static const char * died = "ERR The worker rendering the link file died\n";
+  struct SRV_CLIENT * c = w->Client, * next;
+  char b;
+  ssize_t n;
+  int i = (int)(w - srv_workers), status;
+
+  while (((n = read(w->fd, &b, 1)) < 0) && (errno == EINTR));
+  if (n <= 0)
+  {
+    epoll_ctl(srv_epoll, EPOLL_CTL_DEL, w->fd, NULL);
+    close(w->fd);
+    w->fd = -1;
+    waitpid(w->pid, &status, 0);
+    if (WIFSIGNALED(status))
+    {
+      fprintf(stderr, "lifer --serve: worker %d was killed by signal %d", (int)w->pid, WTERMSIG(status));
+    }
+    else
+    {
+      fprintf(stderr, "lifer --serve: worker %d exited (%d)", (int)w->pid, WEXITSTATUS(status));
+    }
+    fprintf(stderr, (c != NULL) ? ", it was serving a request\n" : "\n");
+    if (c != NULL)
+    {
+      srv_send(c->fd, died, strlen(died));
+    }
+    w->Client = NULL;
+    if (srv_spawn(i) < 0)
+    {
+      fprintf(stderr, "lifer --serve: carrying on with one worker fewer\n");
+    }
+  }
+  w->Client = NULL;
+  if (c != NULL)
+  {
+    c->State = SRV_IDLE;
+  }
+  // The clients that have been waiting go first
+  while ((w->fd >= 0) && (w->Client == NULL) && ((next = srv_wait_head) != NULL))
+  {
+    if ((srv_wait_head = next->Wait) == NULL)
+    {
+      srv_wait_tail = NULL;
+    }
+    next->Wait = NULL;
+    next->State = SRV_IDLE;
+    srv_give(w, next);
+  }
+  if (c != NULL)
+  {
+    srv_next(c);
+  }
+}
+
+//
+//Function: srv_events() sets the events wanted for a client
+void srv_events(struct SRV_CLIENT * c, uint32_t events)
+{
+  struct epoll_event ev;
+
+  if (!c->Eof)
+  {
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.ptr = c;
+    epoll_ctl(srv_epoll, EPOLL_CTL_MOD, c->fd, &ev);
+  }
+}
+
+//
+//Function: srv_close() closes a client's connection (once its request, if a
+//          worker has it, has been answered)
+void srv_close(struct SRV_CLIENT * c)
+{
+  struct SRV_CLIENT ** pp;
+
+  if (c->State == SRV_SERVED)
+  {
+    c->Eof = 1;
+    c->Len = 0;
+    epoll_ctl(srv_epoll, EPOLL_CTL_DEL, c->fd, NULL);
+    return;
+  }
+  if (c->State == SRV_WAITING)
+  {
+    for (pp = &srv_wait_head; *pp != c; pp = &(*pp)->Wait);
+    *pp = c->Wait;
+    if (srv_wait_tail == c)
+    {
+      for (srv_wait_tail = srv_wait_head; (srv_wait_tail != NULL) && (srv_wait_tail->Wait != NULL);
+        srv_wait_tail = srv_wait_tail->Wait);
+    }
+  }
+  close(c->fd); // (which takes it out of the epoll set)
+  if (c->Prev != NULL)
+  {
+    c->Prev->Next = c->Next;
+  }
+  else
+  {
+    srv_clients = c->Next;
+  }
+  if (c->Next != NULL)
+  {
+    c->Next->Prev = c->Prev;
+  }
+  free(c->Buf);
+  free(c);
+}
+
+//
+//Function: srv_stop() stops the workers and closes the clients
+void srv_stop(void)
+{
+  int i;
+
+  for (i = 0; i < srv_nworkers; i++)
+  {
+    if (srv_workers[i].fd >= 0)
+    {
+      close(srv_workers[i].fd);
+      kill(srv_workers[i].pid, SIGTERM);
+      waitpid(srv_workers[i].pid, NULL, 0);
+      srv_workers[i].fd = -1;
+      srv_workers[i].Client = NULL;
+    }
+  }
+  while (srv_clients != NULL)
+  {
+    srv_clients->State = SRV_IDLE;
+    srv_clients->Wait = NULL;
+    srv_close(srv_clients);
+  }
+  srv_wait_head = srv_wait_tail = NULL;
+  close(srv_signal);
+  close(srv_listen);
+  close(srv_epoll);
+}
+#endif
+
+//
+//Function: srv_serve() serves requests on the socket at path until stopped
+extern int srv_serve(const char * path, int workers, SRV_RENDER render, void * ctx)
+{
+#ifdef SRV_LINUX
+  struct epoll_event ev, events[SRV_EVENTS];
+  sigset_t sigs;
+  int i, n, running = 1;
+  void * p;
+
+  srv_render = render;
+  srv_ctx = ctx;
+  if (workers <= 0)
+  {
+    workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  srv_nworkers = (workers < 1) ? 1 : (workers > SRV_MAXWORKERS) ? SRV_MAXWORKERS : workers;
+  // SIGINT & SIGTERM are read from a signalfd in the loop, a client that
+  // goes before its answer is sent mustn't stop the daemon
+  sigemptyset(&sigs);
+  sigaddset(&sigs, SIGINT);
+  sigaddset(&sigs, SIGTERM);
+  sigprocmask(SIG_BLOCK, &sigs, NULL);
+  signal(SIGPIPE, SIG_IGN);
+  if ((srv_signal = signalfd(-1, &sigs, SFD_CLOEXEC)) < 0)
+  {
+    perror("Error making the signal descriptor");
+    return -1;
+  }
+  if ((srv_epoll = epoll_create1(EPOLL_CLOEXEC)) < 0)
+  {
+    perror("Error making the epoll set");
+    close(srv_signal);
+    return -1;
+  }
+  if ((srv_listen = srv_open(path)) < 0)
+  {
+    close(srv_epoll);
+    close(srv_signal);
+    return -1;
+  }
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.ptr = &srv_listen;
+  epoll_ctl(srv_epoll, EPOLL_CTL_ADD, srv_listen, &ev);
+  ev.data.ptr = &srv_signal;
+  epoll_ctl(srv_epoll, EPOLL_CTL_ADD, srv_signal, &ev);
+  for (i = 0; i < srv_nworkers; i++)
+  {
+    srv_workers[i].fd = -1;
+  }
+  for (i = 0; i < srv_nworkers; i++)
+  {
+    if (srv_spawn(i) < 0)
+    {
+      srv_stop();
+      unlink(path);
+      return -1;
+    }
+  }
+  fprintf(stderr, "lifer --serve: listening on \'%s\' with %d workers\n", path, srv_nworkers);
+
+  while (running)
+  {
+    if ((n = epoll_wait(srv_epoll, events, SRV_EVENTS, -1)) < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      perror("Error waiting for events");
+      break;
+    }
+    for (i = 0; i < n; i++)
+    {
+      p = events[i].data.ptr;
+      if (p == &srv_listen)
+      {
+        srv_accept();
+      }
+      else if (p == &srv_signal)
+      {
+        running = 0;
+      }
+      else if (*(int *)p == SRV_WORKER_KIND)
+      {
+        srv_done(p);
+      }
+      else
+      {
+        srv_read(p, events[i].events);
+      }
+    }
+  }
+  srv_stop();
+  unlink(path);
+  fprintf(stderr, "lifer --serve: stopped\n");
+  return 0;
+#else
+  (void)path;
+  (void)workers;
+  (void)render;
+  (void)ctx;
+  fprintf(stderr, "Sorry, '--serve' is only available in Linux\n");
+  return -1;
+#endif
+}
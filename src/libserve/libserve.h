@@ -0,0 +1,72 @@
+/***************************************************************
+**                                                            **
+**                    libserve.h                              **
+**                                                            **
+**    Serves requests to render link files over a UNIX domain **
+** socket ('lifer --serve'), so a program that wants one link **
+** file at a time doesn't start lifer for each. One epoll     **
+** loop accepts the clients and reads their requests, which   **
+** are handed (with the client's socket) to a pool of worker  **
+** processes forked at the start. A worker renders the link   **
+** file and answers the client itself, then tells the loop it **
+** is free. Workers are processes, not threads, because the   **
+** renderer writes to stdout & liblife may assert on a bad    **
+** link file: a worker that dies is replaced and its client   **
+** is told, the daemon carries on. Linux only.                **
+**                                                            **
+** The protocol, one request per line (a client can send many **
+** on one connection, they are answered in order):            **
+**      FORMAT PATH\n          a link file the daemon can read **
+**      FORMAT base64:DATA\n   the link file's bytes           **
+** and each answer is either                                  **
+**      OK LENGTH\n then LENGTH bytes of the rendered record   **
+**      ERR MESSAGE\n                                         **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int srv_serve(const char * path, int workers,              **
+**               SRV_RENDER render, void * ctx)               **
+**      Listens on the socket 'path' (only the user can       **
+**      connect to it) with 'workers' worker processes (0 for **
+**      one per processor) which call 'render' for each       **
+**      request. Returns 0 when stopped by SIGINT or SIGTERM  **
+**      (having removed the socket), -1 (having said why) if  **
+**      it can't start.                                       **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBSERVE_H_
+#define _LIBSERVE_H_
+
+#include <stdio.h>
+
+#define SRV_MAXLINE   (4 * 1024 * 1024)  // Longest request (a base64 link file of 3MB)
+#define SRV_TIMEOUT   30000              // ms a worker waits for a client to take its answer
+
+// Renders the link file open as fp (its name for the output is 'name') in
+// 'format' to out. Called in a worker process with srv_serve()'s ctx.
+// Returns NULL if successful, else why not (for the 'ERR' answer).
+typedef const char * (*SRV_RENDER)(void * ctx, const char * format, const char * name, FILE * fp, FILE * out);
+
+extern int srv_serve(const char *, int, SRV_RENDER, void *);
+
+#endif
@@ -0,0 +1,331 @@
+/***************************************************************
+**                                                            **
+**                    libstats.c                              **
+**                                                            **
+**    Times the stages of reading link files and counts what  **
+** was found ('--stats').                                     **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libstats.h for the exported functions                  **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // For fopencookie()
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "./libstats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#endif
+#if defined(__GLIBC__)
+#define ST_COOKIE // fopencookie()
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#define ST_FUNOPEN // funopen()
+#endif
+
+struct ST_SINK // Where a counting stream writes
+{
+  int                fd;
+  struct ST_STATS  * st;
+};
+
+static const char * st_names[ST_NUMSTAGES] =
+{
+  "other", "open", "test_link", "filter", "parse", "ascii", "output", "finish"
+};
+static const char * st_sections[ST_NUMSECTIONS] =
+{
+  "header", "idlist", "linkinfo", "stringdata", "extradata"
+};
+
+//Local function declarations
+int64_t st_now(void);
+uint64_t st_peak_rss(void);
+int st_write(struct ST_SINK *, const char *, size_t);
+
+//
+//Function: st_now() returns the monotonic clock in ns
+int64_t st_now(void)
+{
+#ifdef _WIN32
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+
+  if (freq.QuadPart == 0)
+  {
+    QueryPerformanceFrequency(&freq);
+  }
+  QueryPerformanceCounter(&now);
+  return (int64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((int64_t)ts.tv_sec * 1000000000) + ts.tv_nsec;
+#endif
+}
+
+//
+//Function: st_start() zeroes the counters and starts the clock
+extern void st_start(struct ST_STATS * st)
+{
+  memset(st, 0, sizeof(struct ST_STATS));
+  st->Running = 1;
+  st->Stage = ST_OTHER;
+  st->Start = st->Lap = st_now();
+}
+
+//
+//Function: st_lap() charges the time since the last lap to the current
+//          stage and starts 'stage'
+extern void st_lap(struct ST_STATS * st, int stage)
+{
+  int64_t now;
+
+  if (!st->Running || (stage == st->Stage))
+  {
+    return;
+  }
+  now = st_now();
+  st->Time[st->Stage] += now - st->Lap;
+  st->Lap = now;
+  st->Stage = stage;
+}
+
+//
+//Function: st_peak_rss() returns the most memory lifer has had resident
+//          (0 if it can't be found)
+uint64_t st_peak_rss(void)
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS pmc;
+
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+  {
+    return (uint64_t)pmc.PeakWorkingSetSize;
+  }
+  return 0;
+#else
+  struct rusage ru;
+
+  if (getrusage(RUSAGE_SELF, &ru) != 0)
+  {
+    return 0;
+  }
+#ifdef __APPLE__
+  return (uint64_t)ru.ru_maxrss; // bytes
+#else
+  return (uint64_t)ru.ru_maxrss * 1024; // KB
+#endif
+#endif
+}
+
+//
+//Function: st_pool() records a buffer's budget & high-water mark (replacing
+//          one of the same name)
+extern void st_pool(struct ST_STATS * st, const char * name, uint64_t budget, uint64_t peak)
+{
+  int i;
+
+  for (i = 0; (i < st->NumPools) && (strcmp(st->Pools[i].Name, name) != 0); i++);
+  if (i == ST_MAXPOOLS)
+  {
+    return;
+  }
+  st->Pools[i].Name = name;
+  st->Pools[i].Budget = budget;
+  st->Pools[i].Peak = peak;
+  if (i == st->NumPools)
+  {
+    st->NumPools++;
+  }
+}
+
+#if defined(ST_COOKIE) || defined(ST_FUNOPEN)
+//
+//Function: st_write() writes a counting stream's buffer to its file
+//          descriptor. Returns the number of bytes written, 0 on error.
+int st_write(struct ST_SINK * sink, const char * buf, size_t size)
+{
+  size_t done = 0;
+  ssize_t n;
+
+  while (done < size)
+  {
+    n = write(sink->fd, buf + done, size - done);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      break;
+    }
+    done += n;
+  }
+  sink->st->BytesWritten += done;
+  return (int)done;
+}
+#endif
+#ifdef ST_COOKIE
+static ssize_t st_cookie_write(void * cookie, const char * buf, size_t size)
+{
+  return st_write((struct ST_SINK *)cookie, buf, size);
+}
+#endif
+#ifdef ST_FUNOPEN
+static int st_funopen_write(void * cookie, const char * buf, int size)
+{
+  int n = st_write((struct ST_SINK *)cookie, buf, size);
+
+  return (n > 0 || size == 0) ? n : -1;
+}
+#endif
+
+//
+//Function: st_count() returns a stream that writes to fp's file descriptor
+//          counting the bytes, or fp if one can't be made
+extern FILE * st_count(FILE * fp, struct ST_STATS * st)
+{
+#if defined(ST_COOKIE) || defined(ST_FUNOPEN)
+  struct ST_SINK * sink;
+  FILE * cfp;
+#ifdef ST_COOKIE
+  cookie_io_functions_t io = { NULL, st_cookie_write, NULL, NULL };
+#endif
+
+  if ((sink = malloc(sizeof(struct ST_SINK))) == NULL)
+  {
+    return fp;
+  }
+  fflush(fp);
+  sink->fd = fileno(fp);
+  sink->st = st;
+#ifdef ST_COOKIE
+  cfp = fopencookie(sink, "w", io);
+#else
+  cfp = funopen(sink, NULL, st_funopen_write, NULL, NULL);
+#endif
+  if (cfp == NULL)
+  {
+    free(sink);
+    return fp;
+  }
+  st->Counted = 1;
+  return cfp; // sink lasts as long as lifer, as stdout does
+#else
+  return fp;
+#endif
+}
+
+//
+//Function: st_report() prints the table and the JSON to fp
+extern void st_report(FILE * fp, struct ST_STATS * st)
+{
+  int64_t total;
+  uint64_t errors = 0, rss;
+  double secs;
+  int i;
+
+  if (!st->Running)
+  {
+    return;
+  }
+  st_lap(st, ST_OTHER);
+  total = st_now() - st->Start;
+  secs = (total > 0) ? total / 1e9 : 1e-9;
+  if (!st->Counted)
+  {
+    long pos = ftell(stdout);
+
+    st->BytesWritten = (pos > 0) ? (uint64_t)pos : 0;
+  }
+  for (i = 0; i < ST_NUMSECTIONS; i++)
+  {
+    errors += st->ParseErrors[i];
+  }
+  rss = st_peak_rss();
+
+  fprintf(fp, "\n{**STATISTICS**}\n");
+  fprintf(fp, "  %-10s %12s %7s %12s\n", "Stage", "Time (s)", "%", "us per file");
+  for (i = 0; i < ST_NUMSTAGES; i++)
+  {
+    fprintf(fp, "  %-10s %12.6f %6.1f%% %12.3f\n", st_names[i], st->Time[i] / 1e9,
+      (total > 0) ? st->Time[i] * 100.0 / total : 0.0, st->Files ? st->Time[i] / 1e3 / st->Files : 0.0);
+  }
+  fprintf(fp, "  %-10s %12.6f\n", "total", secs);
+  fprintf(fp, "  Files seen:        %"PRIu64" (%.0f/sec)\n", st->Files, st->Files / secs);
+  fprintf(fp, "  Not a link file:   %"PRIu64"\n", st->NotLink);
+  fprintf(fp, "  Open errors:       %"PRIu64"\n", st->OpenErrors);
+  fprintf(fp, "  Filtered out:      %"PRIu64"\n", st->Filtered);
+  fprintf(fp, "  Link files:        %"PRIu64"\n", st->Links);
+  fprintf(fp, "  Parse errors:      %"PRIu64, errors);
+  for (i = 0; i < ST_NUMSECTIONS; i++)
+  {
+    fprintf(fp, "%s%s %"PRIu64, (i == 0) ? " (" : ", ", st_sections[i], st->ParseErrors[i]);
+  }
+  fprintf(fp, ")\n");
+  fprintf(fp, "  ASCII errors:      %"PRIu64"\n", st->AsciiErrors);
+  fprintf(fp, "  Bytes read:        %"PRIu64" (%.2f MB/sec)\n", st->BytesRead, st->BytesRead / secs / 1048576);
+  fprintf(fp, "  Bytes written:     %"PRIu64" (%.2f MB/sec)\n", st->BytesWritten, st->BytesWritten / secs / 1048576);
+  fprintf(fp, "  Peak RSS:          %.2f MB\n", rss / 1048576.0);
+  for (i = 0; i < st->NumPools; i++)
+  {
+    fprintf(fp, "  %-18s %.2f MB", (i == 0) ? "Buffers (peak):" : "", st->Pools[i].Peak / 1048576.0);
+    if (st->Pools[i].Budget > 0)
+    {
+      fprintf(fp, " of %.2f MB", st->Pools[i].Budget / 1048576.0);
+    }
+    fprintf(fp, " %s\n", st->Pools[i].Name);
+  }
+
+  fprintf(fp, "{\"stages_ns\":{");
+  for (i = 0; i < ST_NUMSTAGES; i++)
+  {
+    fprintf(fp, "%s\"%s\":%"PRId64, (i == 0) ? "" : ",", st_names[i], st->Time[i]);
+  }
+  fprintf(fp, "},\"total_ns\":%"PRId64",\"files\":%"PRIu64",\"not_link\":%"PRIu64",\"open_errors\":%"PRIu64
+    ",\"filtered\":%"PRIu64",\"links\":%"PRIu64",\"parse_errors\":{", total, st->Files, st->NotLink,
+    st->OpenErrors, st->Filtered, st->Links);
+  for (i = 0; i < ST_NUMSECTIONS; i++)
+  {
+    fprintf(fp, "%s\"%s\":%"PRIu64, (i == 0) ? "" : ",", st_sections[i], st->ParseErrors[i]);
+  }
+  fprintf(fp, "},\"ascii_errors\":%"PRIu64",\"bytes_read\":%"PRIu64",\"bytes_written\":%"PRIu64
+    ",\"peak_rss\":%"PRIu64",\"buffers\":{", st->AsciiErrors, st->BytesRead, st->BytesWritten, rss);
+  for (i = 0; i < st->NumPools; i++)
+  {
+    fprintf(fp, "%s\"%s\":{\"budget\":%"PRIu64",\"peak\":%"PRIu64"}", (i == 0) ? "" : ",", st->Pools[i].Name,
+      st->Pools[i].Budget, st->Pools[i].Peak);
+  }
+  fprintf(fp, "}}\n");
+}
@@ -0,0 +1,120 @@
+/***************************************************************
+**                                                            **
+**                    libstats.h                              **
+**                                                            **
+**    Times the stages of reading link files ('--stats') and  **
+** counts what was found. The time of a run is split between  **
+** the stages with a lap timer on the monotonic clock: each   **
+** call to st_lap() charges the time since the last one to    **
+** the stage that was running and starts the next. The       **
+** counters live in a struct ST_STATS owned by the thread     **
+** that does the reading, so nothing is locked or shared.     **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** void st_start(struct ST_STATS * st)                        **
+**      Zeroes the counters, starts the clock and the         **
+**      ST_OTHER stage. Until it is called st_lap() does      **
+**      nothing.                                              **
+**                                                            **
+** void st_lap(struct ST_STATS * st, int stage)               **
+**      Charges the time since the last lap to the current    **
+**      stage and makes 'stage' (ST_OPEN ... ST_FINISH) the   **
+**      current one.                                          **
+**                                                            **
+** FILE * st_count(FILE * fp, struct ST_STATS * st)           **
+**      Returns a stream that writes to fp's file descriptor  **
+**      and adds the bytes to st->BytesWritten (for lifer to  **
+**      use as stdout). Where the C library can't make one    **
+**      (Windows) fp is returned and st_report() takes the    **
+**      bytes written from its file position instead.         **
+**                                                            **
+** void st_pool(struct ST_STATS * st, const char * name,      **
+**              uint64_t budget, uint64_t peak)               **
+**      Records the budget (0 for none) and the most memory   **
+**      used by one of lifer's buffers (the timeline, the     **
+**      compressor etc.) for the report.                      **
+**                                                            **
+** void st_report(FILE * fp, struct ST_STATS * st)            **
+**      Ends the current stage and prints a table of the      **
+**      stages & counters, the peak resident set size and the **
+**      buffers to fp followed by the same as a line of JSON. **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBSTATS_H_
+#define _LIBSTATS_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+// The stages
+#define ST_OTHER      0 // Starting up, reading directories etc.
+#define ST_OPEN       1 // fopen() & stat() of each file
+#define ST_TEST       2 // test_link()
+#define ST_FILTER     3 // Decoding & testing the '--where' filter
+#define ST_PARSE      4 // get_lif_at()
+#define ST_ASCII      5 // get_lif_a_opt()
+#define ST_OUTPUT     6 // Formatting & writing the output
+#define ST_FINISH     7 // Sorting the timeline, closing the output etc.
+#define ST_NUMSTAGES  8
+
+// The sections get_lif_at() reports errors in (-1 to -5)
+#define ST_NUMSECTIONS 5
+
+#define ST_MAXPOOLS    8
+
+struct ST_POOL                               // Memory used by a buffer
+{
+  const char  * Name;
+  uint64_t      Budget;                      // Bytes it may use (0 for no limit)
+  uint64_t      Peak;                        // Most bytes it did use
+};
+
+struct ST_STATS
+{
+  int           Running;                     // st_start() has been called
+  int           Stage;                       // The current stage
+  int64_t       Lap;                         // When it started (ns)
+  int64_t       Start;                       // When st_start() was called (ns)
+  int64_t       Time[ST_NUMSTAGES];          // ns spent in each stage
+  uint64_t      Files;                       // Regular files looked at
+  uint64_t      NotLink;                     // Rejected as 'Not a Link File'
+  uint64_t      OpenErrors;                  // Files that couldn't be opened
+  uint64_t      Filtered;                    // Not matched by '--where'
+  uint64_t      Links;                       // Link files passed on to the output
+  uint64_t      ParseErrors[ST_NUMSECTIONS]; // get_lif_at() errors by section
+  uint64_t      AsciiErrors;                 // get_lif_a_opt() errors
+  uint64_t      BytesRead;                   // Size of the link files read
+  uint64_t      BytesWritten;                // Output (before any compression)
+  int           Counted;                     // BytesWritten is kept by st_count()
+  int           NumPools;
+  struct ST_POOL Pools[ST_MAXPOOLS];         // Set with st_pool()
+};
+
+extern void st_start(struct ST_STATS *);
+extern void st_lap(struct ST_STATS *, int);
+extern FILE * st_count(FILE *, struct ST_STATS *);
+extern void st_pool(struct ST_STATS *, const char *, uint64_t, uint64_t);
+extern void st_report(FILE *, struct ST_STATS *);
+
+#endif
@@ -0,0 +1,381 @@
+/***************************************************************
+**                                                            **
+**                    libtimeline.c                           **
+**                                                            **
+**    Collects timeline events (a FILETIME and a line of      **
+** text) and writes them out in time order.                   **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libtimeline.h for the exported functions               **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "./libtimeline.h"
+
+/*
+The events in memory are an array of TL_EVENTs whose text is kept in one
+arena (so a run costs two allocations however many events it holds). A run
+on disk is a sequence of records: time (8 bytes), sequence number (8 bytes),
+text length (2 bytes) and the text. All of the fields are written in the
+machine's own byte order as the runs never leave the process.
+*/
+
+struct TL_EVENT
+{
+  int64_t    Time;
+  uint64_t   Seq;   // Order of arrival, keeps the sort stable
+  size_t     Off;   // Offset of the text in the arena
+  uint16_t   Len;
+};
+
+struct TL_RUN // A run being merged
+{
+  FILE *     fp;
+  int64_t    Time;
+  uint64_t   Seq;
+  uint16_t   Len;
+  char       Text[TL_MAXTEXT];
+};
+
+static struct TL_EVENT  *tl_events = NULL;
+static size_t           tl_num, tl_max;   // Events in memory & room for
+static char             *tl_arena = NULL;
+static size_t           tl_used, tl_size; // Arena bytes used & size
+static size_t           tl_high = 0;      // Most bytes of events & text held
+static uint64_t         tl_seq;
+static FILE             *tl_runs[TL_MAXRUNS];
+static int              tl_nruns;
+
+//Local function declarations
+int tl_cmp(const void *, const void *);
+int tl_spill(void);
+void tl_mark(void);
+int tl_read(struct TL_RUN *);
+int tl_write(FILE *, int64_t, uint64_t, uint16_t, const char *);
+int tl_merge(FILE **, int, FILE *, int);
+void tl_free(void);
+
+//
+//Function: tl_init() allocates the event buffer
+extern int tl_init(size_t budget)
+{
+  tl_free();
+  if (budget == 0)
+  {
+    budget = TL_BUDGET;
+  }
+  // Make sure at least one longest event fits
+  if (budget < 4 * TL_MAXTEXT)
+  {
+    budget = 4 * TL_MAXTEXT;
+  }
+  // Share the budget between the events and the text, assuming ~100 bytes
+  // of text per event
+  tl_max = budget / (sizeof(struct TL_EVENT) + 100);
+  tl_size = budget - (tl_max * sizeof(struct TL_EVENT));
+  tl_events = malloc(tl_max * sizeof(struct TL_EVENT));
+  tl_arena = malloc(tl_size);
+  if ((tl_events == NULL) || (tl_arena == NULL))
+  {
+    fprintf(stderr, "Unable to allocate %u bytes for the timeline\n", (unsigned int)budget);
+    tl_free();
+    return -1;
+  }
+  tl_num = 0;
+  tl_used = 0;
+  tl_seq = 0;
+  tl_nruns = 0;
+  tl_high = 0;
+  return 0;
+}
+
+//
+//Function: tl_add() adds an event, spilling a run first if it won't fit
+extern int tl_add(int64_t time, const char * text)
+{
+  size_t len = strlen(text);
+
+  if (tl_events == NULL)
+  {
+    return -1;
+  }
+  if (len > TL_MAXTEXT)
+  {
+    len = TL_MAXTEXT;
+  }
+  if (((tl_num == tl_max) || (tl_used + len > tl_size)) && (tl_spill() < 0))
+  {
+    return -1;
+  }
+  tl_events[tl_num].Time = time;
+  tl_events[tl_num].Seq = tl_seq++;
+  tl_events[tl_num].Off = tl_used;
+  tl_events[tl_num].Len = (uint16_t)len;
+  memcpy(tl_arena + tl_used, text, len);
+  tl_used += len;
+  tl_num++;
+  return 0;
+}
+
+//
+//Function: tl_finish() writes the events in order. If nothing was spilled
+//the buffer is just sorted and printed, otherwise the last events become a
+//run of their own and all the runs are merged straight to 'out'.
+extern int tl_finish(FILE * out)
+{
+  size_t  i;
+  int     count = -1;
+
+  if (tl_events == NULL)
+  {
+    return -1;
+  }
+  tl_mark();
+  if (tl_nruns == 0)
+  {
+    qsort(tl_events, tl_num, sizeof(struct TL_EVENT), tl_cmp);
+    for (i = 0; i < tl_num; i++)
+    {
+      fprintf(out, "%.*s\n", (int)tl_events[i].Len, tl_arena + tl_events[i].Off);
+    }
+    count = (int)tl_num;
+  }
+  else if ((tl_num == 0) || (tl_spill() == 0))
+  {
+    count = tl_merge(tl_runs, tl_nruns, out, 1);
+    tl_nruns = 0; // tl_merge() closed them
+  }
+  tl_free();
+  return count;
+}
+
+//
+//Function: tl_peak() returns the most bytes of events held in memory
+extern size_t tl_peak(void)
+{
+  return tl_high;
+}
+
+//
+//Function: tl_mark() updates the high-water mark of the buffer
+void tl_mark(void)
+{
+  if ((tl_num * sizeof(struct TL_EVENT)) + tl_used > tl_high)
+  {
+    tl_high = (tl_num * sizeof(struct TL_EVENT)) + tl_used;
+  }
+}
+
+//
+//Function: tl_cmp() orders events by time then order of arrival
+int tl_cmp(const void * a, const void * b)
+{
+  const struct TL_EVENT *ea = a, *eb = b;
+
+  if (ea->Time != eb->Time)
+  {
+    return (ea->Time < eb->Time) ? -1 : 1;
+  }
+  return (ea->Seq < eb->Seq) ? -1 : (ea->Seq > eb->Seq);
+}
+
+//
+//Function: tl_spill() sorts the events in memory and writes them to a new
+//run. When the maximum number of runs is reached they are first merged into
+//one so that the number of open files stays bounded.
+int tl_spill()
+{
+  FILE    *fp;
+  size_t  i;
+
+  tl_mark();
+  if (tl_nruns == TL_MAXRUNS)
+  {
+    if ((fp = tmpfile()) == NULL)
+    {
+      perror("Error creating a timeline run");
+      return -1;
+    }
+    if (tl_merge(tl_runs, tl_nruns, fp, 0) < 0)
+    {
+      tl_nruns = 0;
+      fclose(fp);
+      return -1;
+    }
+    rewind(fp);
+    tl_runs[0] = fp;
+    tl_nruns = 1;
+  }
+  if ((fp = tmpfile()) == NULL)
+  {
+    perror("Error creating a timeline run");
+    return -1;
+  }
+  qsort(tl_events, tl_num, sizeof(struct TL_EVENT), tl_cmp);
+  for (i = 0; i < tl_num; i++)
+  {
+    if (tl_write(fp, tl_events[i].Time, tl_events[i].Seq, tl_events[i].Len, tl_arena + tl_events[i].Off) < 0)
+    {
+      perror("Error writing a timeline run");
+      fclose(fp);
+      return -1;
+    }
+  }
+  rewind(fp);
+  tl_runs[tl_nruns++] = fp;
+  tl_num = 0;
+  tl_used = 0;
+  return 0;
+}
+
+//
+//Function: tl_write() writes one run record
+int tl_write(FILE * fp, int64_t time, uint64_t seq, uint16_t len, const char * text)
+{
+  if ((fwrite(&time, sizeof(time), 1, fp) != 1) || (fwrite(&seq, sizeof(seq), 1, fp) != 1) ||
+    (fwrite(&len, sizeof(len), 1, fp) != 1) || (fwrite(text, 1, len, fp) != len))
+  {
+    return -1;
+  }
+  return 0;
+}
+
+//
+//Function: tl_read() reads the next record of a run, 0 at the end of it
+int tl_read(struct TL_RUN * run)
+{
+  if ((fread(&run->Time, sizeof(run->Time), 1, run->fp) != 1) ||
+    (fread(&run->Seq, sizeof(run->Seq), 1, run->fp) != 1) ||
+    (fread(&run->Len, sizeof(run->Len), 1, run->fp) != 1) ||
+    (run->Len > TL_MAXTEXT) || (fread(run->Text, 1, run->Len, run->fp) != run->Len))
+  {
+    return 0;
+  }
+  return 1;
+}
+
+//
+//Function: tl_merge() k-way merges 'n' runs using a binary min-heap of the
+//runs' current records. With 'text' set the event lines are written to
+//'out', otherwise 'out' gets a new run. The runs are closed (and so deleted)
+//whatever happens. Returns the number of events or -1 on an error.
+int tl_merge(FILE ** runs, int n, FILE * out, int text)
+{
+  struct TL_RUN  *heap[TL_MAXRUNS], *run, *tmp;
+  struct TL_RUN  *mem;
+  int            i, num = 0, count = 0, child, result = 0;
+
+  if ((mem = malloc(n * sizeof(struct TL_RUN))) == NULL)
+  {
+    fprintf(stderr, "Unable to allocate memory to merge the timeline\n");
+    for (i = 0; i < n; i++)
+    {
+      fclose(runs[i]);
+    }
+    return -1;
+  }
+  // Prime the heap with the first record of each run
+  for (i = 0; i < n; i++)
+  {
+    mem[i].fp = runs[i];
+    if (tl_read(&mem[i]))
+    {
+      heap[num] = &mem[i];
+      // Sift up
+      for (child = num++; child > 0; child = (child - 1) / 2)
+      {
+        run = heap[(child - 1) / 2];
+        if ((run->Time < heap[child]->Time) || ((run->Time == heap[child]->Time) && (run->Seq < heap[child]->Seq)))
+        {
+          break;
+        }
+        heap[(child - 1) / 2] = heap[child];
+        heap[child] = run;
+      }
+    }
+  }
+  while (num > 0)
+  {
+    run = heap[0];
+    if (text)
+    {
+      if (fprintf(out, "%.*s\n", (int)run->Len, run->Text) < 0)
+      {
+        result = -1;
+        break;
+      }
+    }
+    else if (tl_write(out, run->Time, run->Seq, run->Len, run->Text) < 0)
+    {
+      perror("Error writing a timeline run");
+      result = -1;
+      break;
+    }
+    count++;
+    // Replace the top with the run's next record (or the last run in the
+    // heap if this one is finished) and sift it down
+    if (!tl_read(run))
+    {
+      heap[0] = heap[--num];
+    }
+    for (i = 0; (child = 2 * i + 1) < num; i = child)
+    {
+      if ((child + 1 < num) && ((heap[child + 1]->Time < heap[child]->Time) ||
+        ((heap[child + 1]->Time == heap[child]->Time) && (heap[child + 1]->Seq < heap[child]->Seq))))
+      {
+        child++;
+      }
+      if ((heap[i]->Time < heap[child]->Time) || ((heap[i]->Time == heap[child]->Time) && (heap[i]->Seq < heap[child]->Seq)))
+      {
+        break;
+      }
+      tmp = heap[i];
+      heap[i] = heap[child];
+      heap[child] = tmp;
+    }
+  }
+  for (i = 0; i < n; i++)
+  {
+    fclose(runs[i]);
+  }
+  free(mem);
+  return (result < 0) ? -1 : count;
+}
+
+//
+//Function: tl_free() releases the buffer and any runs
+void tl_free()
+{
+  int i;
+
+  for (i = 0; i < tl_nruns; i++)
+  {
+    fclose(tl_runs[i]);
+  }
+  tl_nruns = 0;
+  free(tl_events);
+  free(tl_arena);
+  tl_events = NULL;
+  tl_arena = NULL;
+  tl_num = 0;
+  tl_used = 0;
+}
@@ -0,0 +1,71 @@
+/***************************************************************
+**                                                            **
+**                    libtimeline.h                           **
+**                                                            **
+**    Collects timeline events (a FILETIME and a line of      **
+** text) and writes them out in time order. Memory use is     **
+** bounded: when the buffer is full the events are sorted and **
+** spilled to a temporary file (a 'run') and the runs are     **
+** k-way merged at the end.                                   **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int tl_init(size_t budget)                                 **
+**      Starts a new timeline, 'budget' is the number of      **
+**      bytes of events to hold in memory before a run is     **
+**      spilled (0 for the default, TL_BUDGET).               **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** int tl_add(int64_t time, const char * text)                **
+**      Adds an event, 'text' is the whole output line        **
+**      (without a newline). Events with the same time keep   **
+**      the order they were added in.                         **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** int tl_finish(FILE * out)                                  **
+**      Writes all the events to 'out' in time order, one per **
+**      line, and frees everything.                           **
+**      Returns the number of events, -1 on an error.         **
+**                                                            **
+** size_t tl_peak(void)                                       **
+**      Returns the most bytes of events (and their text)     **
+**      that were held in memory by the last timeline.        **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBTIMELINE_H_
+#define _LIBTIMELINE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#define TL_BUDGET   (32 * 1024 * 1024) // Default in memory size of a run
+#define TL_MAXTEXT  1024               // Longest event line (longer is truncated)
+#define TL_MAXRUNS  64                 // Runs are merged together when there are this many
+
+extern int tl_init(size_t);
+extern int tl_add(int64_t, const char *);
+extern int tl_finish(FILE *);
+extern size_t tl_peak(void);
+
+#endif
@@ -0,0 +1,707 @@
+/***************************************************************
+**                                                            **
+**                      libwhere.c                            **
+**                                                            **
+**    A small filter language for selecting link files by     **
+** the values in their decoded (LIF) structure                **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libwhere.h for the exported functions and the syntax   **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <wchar.h>
+#include "./libwhere.h"
+
+//The fields that can be used in an expression. They are read straight from
+//the LIF so that files can be rejected before get_lif_a() is called.
+#define WF(k, t, s, m) { k, t, s, offsetof(struct LIF, m) }
+static const struct WHERE_FIELD where_fields[] =
+{
+  { "file.name", WT_FNAME, 0, 0 },
+  { "file.size", WT_FSIZE, 0, 0 },
+  WF("hdr.flags", WT_U32, LIF_SEC_HDR, lh.Flags),
+  WF("hdr.attr", WT_U32, LIF_SEC_HDR, lh.Attr),
+  WF("hdr.crtime", WT_TIME, LIF_SEC_HDR, lh.CrDate),
+  WF("hdr.actime", WT_TIME, LIF_SEC_HDR, lh.AcDate),
+  WF("hdr.wttime", WT_TIME, LIF_SEC_HDR, lh.WtDate),
+  WF("hdr.targetsize", WT_U32, LIF_SEC_HDR, lh.Size),
+  WF("hdr.iconindex", WT_I32, LIF_SEC_HDR, lh.IconIndex),
+  WF("hdr.showstate", WT_U32, LIF_SEC_HDR, lh.ShowState),
+  WF("idlist.size", WT_U16, LIF_SEC_HDR, lidl.IDListSize),
+  WF("idlist.numitems", WT_U16, LIF_SEC_IDLIST, lidl.NumItemIDs),
+  WF("li.flags", WT_U32, LIF_SEC_LINKINFO, li.Flags),
+  WF("li.volid.drivetype", WT_U32, LIF_SEC_LINKINFO, li.VolID.DriveType),
+  WF("li.volid.drivesn", WT_U32, LIF_SEC_LINKINFO, li.VolID.DriveSN),
+  WF("li.volid.label", WT_STR, LIF_SEC_LINKINFO, li.VolID.VolumeLabel),
+  WF("li.volid.labelu", WT_WSTR, LIF_SEC_LINKINFO, li.VolID.VolumeLabelU),
+  WF("li.lbp", WT_STR, LIF_SEC_LINKINFO, li.LBP),
+  WF("li.lbpu", WT_WSTR, LIF_SEC_LINKINFO, li.LBPU),
+  WF("li.cps", WT_STR, LIF_SEC_LINKINFO, li.CPS),
+  WF("li.cpsu", WT_WSTR, LIF_SEC_LINKINFO, li.CPSU),
+  WF("li.cnr.providertype", WT_U32, LIF_SEC_LINKINFO, li.CNR.NetworkProviderType),
+  WF("li.cnr.netname", WT_STR, LIF_SEC_LINKINFO, li.CNR.NetName),
+  WF("li.cnr.netnameu", WT_WSTR, LIF_SEC_LINKINFO, li.CNR.NetNameU),
+  WF("li.cnr.devicename", WT_STR, LIF_SEC_LINKINFO, li.CNR.DeviceName),
+  WF("li.cnr.devicenameu", WT_WSTR, LIF_SEC_LINKINFO, li.CNR.DeviceNameU),
+  WF("sd.name", WT_STR, LIF_SEC_STRINGDATA, lsd.Data[0]),
+  WF("sd.relpath", WT_STR, LIF_SEC_STRINGDATA, lsd.Data[1]),
+  WF("sd.workdir", WT_STR, LIF_SEC_STRINGDATA, lsd.Data[2]),
+  WF("sd.args", WT_STR, LIF_SEC_STRINGDATA, lsd.Data[3]),
+  WF("sd.icon", WT_STR, LIF_SEC_STRINGDATA, lsd.Data[4]),
+  WF("ed.types", WT_U32, LIF_SEC_HDR, led.edtypes),
+  WF("ed.consolefe.codepage", WT_U32, LIF_SEC_ED(CONSOLE_FE_PROPS), led.lcfep.CodePage),
+  WF("ed.darwin.ansi", WT_STR, LIF_SEC_ED(DARWIN_PROPS), led.ldp.DarwinDataAnsi),
+  WF("ed.darwin.unicode", WT_WSTR, LIF_SEC_ED(DARWIN_PROPS), led.ldp.DarwinDataUnicode),
+  WF("ed.env.ansi", WT_STR, LIF_SEC_ED(ENVIRONMENT_PROPS), led.lep.TargetAnsi),
+  WF("ed.env.unicode", WT_WSTR, LIF_SEC_ED(ENVIRONMENT_PROPS), led.lep.TargetUnicode),
+  WF("ed.iconenv.ansi", WT_STR, LIF_SEC_ED(ICON_ENVIRONMENT_PROPS), led.liep.TargetAnsi),
+  WF("ed.iconenv.unicode", WT_WSTR, LIF_SEC_ED(ICON_ENVIRONMENT_PROPS), led.liep.TargetUnicode),
+  WF("ed.specialfolder.id", WT_U32, LIF_SEC_ED(SPECIAL_FOLDER_PROPS), led.lsfp.SpecialFolderID),
+  WF("ed.tracker.version", WT_U32, LIF_SEC_TRACKER, led.ltp.Version),
+  WF("ed.tracker.machineid", WT_STR, LIF_SEC_TRACKER, led.ltp.MachineID)
+};
+#define NUMFIELDS (sizeof(where_fields) / sizeof(where_fields[0]))
+
+//Names that can be used in place of a number
+struct WHERE_CONST
+{
+  const char *  name;
+  uint32_t      value;
+};
+static const struct WHERE_CONST where_consts[] =
+{
+  // S_2.1.1 LinkFlags
+  { "HasLinkTargetIDList", 0x00000001 }, { "HasLinkInfo", 0x00000002 },
+  { "HasName", 0x00000004 }, { "HasRelativePath", 0x00000008 },
+  { "HasWorkingDir", 0x00000010 }, { "HasArguments", 0x00000020 },
+  { "HasIconLocation", 0x00000040 }, { "IsUnicode", 0x00000080 },
+  { "ForceNoLinkInfo", 0x00000100 }, { "HasExpString", 0x00000200 },
+  { "RunInSeparateProcess", 0x00000400 }, { "HasDarwinID", 0x00001000 },
+  { "RunAsUser", 0x00002000 }, { "HasExpIcon", 0x00004000 },
+  { "NoPidlAlias", 0x00008000 }, { "RunWithShimLayer", 0x00020000 },
+  { "ForceNoLinkTrack", 0x00040000 }, { "EnableTargetMetadata", 0x00080000 },
+  { "DisableLinkPathTracking", 0x00100000 }, { "DisableKnownFolderTracking", 0x00200000 },
+  { "DisableKnownFolderAlias", 0x00400000 }, { "AllowLinkToLink", 0x00800000 },
+  { "UnaliasOnSave", 0x01000000 }, { "PreferEnvironmentPath", 0x02000000 },
+  { "KeepLocalIDListForUNCTarget", 0x04000000 },
+  // S_2.1.2 FileAttributesFlags
+  { "FILE_ATTRIBUTE_READONLY", 0x0001 }, { "FILE_ATTRIBUTE_HIDDEN", 0x0002 },
+  { "FILE_ATTRIBUTE_SYSTEM", 0x0004 }, { "FILE_ATTRIBUTE_DIRECTORY", 0x0010 },
+  { "FILE_ATTRIBUTE_ARCHIVE", 0x0020 }, { "FILE_ATTRIBUTE_NORMAL", 0x0080 },
+  { "FILE_ATTRIBUTE_TEMPORARY", 0x0100 }, { "FILE_ATTRIBUTE_SPARSE_FILE", 0x0200 },
+  { "FILE_ATTRIBUTE_REPARSE_POINT", 0x0400 }, { "FILE_ATTRIBUTE_COMPRESSED", 0x0800 },
+  { "FILE_ATTRIBUTE_OFFLINE", 0x1000 }, { "FILE_ATTRIBUTE_NOT_CONTENT_INDEXED", 0x2000 },
+  { "FILE_ATTRIBUTE_ENCRYPTED", 0x4000 },
+  // S_2.3.1 VolumeID DriveType
+  { "DRIVE_UNKNOWN", 0 }, { "DRIVE_NO_ROOT_DIR", 1 }, { "DRIVE_REMOVABLE", 2 },
+  { "DRIVE_FIXED", 3 }, { "DRIVE_REMOTE", 4 }, { "DRIVE_CDROM", 5 },
+  { "DRIVE_RAMDISK", 6 },
+  // ExtraData structures (ed.types)
+  { "CONSOLE_PROPS", CONSOLE_PROPS }, { "CONSOLE_FE_PROPS", CONSOLE_FE_PROPS },
+  { "DARWIN_PROPS", DARWIN_PROPS }, { "ENVIRONMENT_PROPS", ENVIRONMENT_PROPS },
+  { "ICON_ENVIRONMENT_PROPS", ICON_ENVIRONMENT_PROPS }, { "KNOWN_FOLDER_PROPS", KNOWN_FOLDER_PROPS },
+  { "PROPERTY_STORE_PROPS", PROPERTY_STORE_PROPS }, { "SHIM_PROPS", SHIM_PROPS },
+  { "SPECIAL_FOLDER_PROPS", SPECIAL_FOLDER_PROPS }, { "TRACKER_PROPS", TRACKER_PROPS },
+  { "VISTA_AND_ABOVE_IDLIST_PROPS", VISTA_AND_ABOVE_IDLIST_PROPS }
+};
+#define NUMCONSTS (sizeof(where_consts) / sizeof(where_consts[0]))
+
+enum WHERE_TOKEN { T_END, T_LP, T_RP, T_AND, T_OR, T_NOT, T_OP, T_NAME, T_NUM, T_STR, T_BAD };
+
+struct WHERE_PARSER
+{
+  char *             expr;      // The whole expression (for error messages)
+  char *             p;         // Where the next token starts
+  char *             tstart;    // Where the current token started
+  enum WHERE_TOKEN   tok;
+  enum WHERE_OP      op;        // T_OP only
+  int64_t            num;       // T_NUM only
+  char               text[300]; // T_NAME & T_STR
+};
+
+//Local function declarations
+void where_next(struct WHERE_PARSER *);
+struct WHERE_NODE * where_expr(struct WHERE_PARSER *);
+struct WHERE_NODE * where_term(struct WHERE_PARSER *);
+struct WHERE_NODE * where_factor(struct WHERE_PARSER *);
+struct WHERE_NODE * where_compare(struct WHERE_PARSER *);
+struct WHERE_NODE * where_node(enum WHERE_OP, struct WHERE_NODE *, struct WHERE_NODE *);
+void where_error(struct WHERE_PARSER *, const char *);
+int where_time(char *, int64_t *);
+int where_wild(const unsigned char *, const unsigned char *);
+
+//
+//Function: where_compile() parses the expression into a predicate tree
+extern int where_compile(char * expr, struct WHERE_NODE ** tree)
+{
+  struct WHERE_PARSER wp;
+
+  wp.expr = expr;
+  wp.p = expr;
+  where_next(&wp);
+  *tree = where_expr(&wp);
+  if (*tree == NULL)
+  {
+    return -1;
+  }
+  if (wp.tok != T_END)
+  {
+    where_error(&wp, "unexpected text");
+    where_free(*tree);
+    *tree = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+//
+//Function: where_sections() is the union of the sections the fields need
+extern uint32_t where_sections(struct WHERE_NODE * n)
+{
+  if (n == NULL)
+  {
+    return 0;
+  }
+  if (n->field != NULL)
+  {
+    return n->field->sections;
+  }
+  return where_sections(n->left) | where_sections(n->right);
+}
+
+//
+//Function: where_match() evaluates the tree against a decoded link file
+extern int where_match(struct WHERE_NODE * n, struct LIF * lif, char * fname, uint64_t fsize)
+{
+  unsigned char  *base = (unsigned char *)lif;
+  unsigned char  buf[300];
+  const unsigned char  *s;
+  int64_t        v;
+
+  switch (n->op)
+  {
+  case W_AND:
+    return where_match(n->left, lif, fname, fsize) && where_match(n->right, lif, fname, fsize);
+  case W_OR:
+    return where_match(n->left, lif, fname, fsize) || where_match(n->right, lif, fname, fsize);
+  case W_NOT:
+    return !where_match(n->left, lif, fname, fsize);
+  default:
+    break;
+  }
+
+  switch (n->field->type)
+  {
+  case WT_STR:
+    s = base + n->field->offset;
+    break;
+  case WT_WSTR:
+    if (snprintf((char *)buf, 300, "%ls", (wchar_t *)(base + n->field->offset)) < 0)
+    {
+      buf[0] = 0;
+    }
+    s = buf;
+    break;
+  case WT_FNAME:
+    s = (unsigned char *)fname;
+    break;
+  default:
+    s = NULL;
+  }
+  if (s != NULL)
+  {
+    return where_wild(n->str, s) == (n->op == W_MATCH);
+  }
+
+  switch (n->field->type)
+  {
+  case WT_U16:
+    v = *(uint16_t *)(base + n->field->offset);
+    break;
+  case WT_I32:
+    v = *(int32_t *)(base + n->field->offset);
+    break;
+  case WT_TIME: // Compared to the second, FILETIMEs are in 100ns intervals
+    v = *(int64_t *)(base + n->field->offset) / 10000000;
+    break;
+  case WT_FSIZE:
+    v = (int64_t)fsize;
+    break;
+  case WT_U32:
+  default:
+    v = *(uint32_t *)(base + n->field->offset);
+  }
+  switch (n->op)
+  {
+  case W_EQ:
+    return v == n->num;
+  case W_NE:
+    return v != n->num;
+  case W_LT:
+    return v < n->num;
+  case W_LE:
+    return v <= n->num;
+  case W_GT:
+    return v > n->num;
+  case W_GE:
+    return v >= n->num;
+  case W_BITS:
+    return (v & n->num) == n->num;
+  default:
+    return 0;
+  }
+}
+
+//
+//Function: where_free() frees the tree
+extern void where_free(struct WHERE_NODE * n)
+{
+  if (n != NULL)
+  {
+    where_free(n->left);
+    where_free(n->right);
+    free(n);
+  }
+}
+
+//
+//Function: where_list() prints the field and constant names
+extern void where_list(FILE * fp)
+{
+  unsigned int i;
+  const char *types[] = { "number", "number", "number", "time", "string", "string", "string", "number" };
+
+  fprintf(fp, "Fields that can be used in a filter expression:\n");
+  for (i = 0; i < NUMFIELDS; i++)
+  {
+    fprintf(fp, "  %-32s%s\n", where_fields[i].key, types[where_fields[i].type]);
+  }
+  fprintf(fp, "\nNames that can be used in place of numbers:\n");
+  for (i = 0; i < NUMCONSTS; i++)
+  {
+    fprintf(fp, "  %-36s0x%.8"PRIX32"\n", where_consts[i].name, where_consts[i].value);
+  }
+}
+
+//
+//Function: where_next() reads the next token
+void where_next(struct WHERE_PARSER * wp)
+{
+  char   *p = wp->p, q;
+  int    i = 0;
+
+  while (isspace((unsigned char)*p))
+  {
+    p++;
+  }
+  wp->tstart = p;
+  wp->tok = T_OP;
+  if (*p == '\0')
+  {
+    wp->tok = T_END;
+  }
+  else if (*p == '(')
+  {
+    wp->tok = T_LP;
+    p++;
+  }
+  else if (*p == ')')
+  {
+    wp->tok = T_RP;
+    p++;
+  }
+  else if ((p[0] == '&') && (p[1] == '&'))
+  {
+    wp->tok = T_AND;
+    p += 2;
+  }
+  else if ((p[0] == '|') && (p[1] == '|'))
+  {
+    wp->tok = T_OR;
+    p += 2;
+  }
+  else if ((p[0] == '!') && (p[1] == '='))
+  {
+    wp->op = W_NE;
+    p += 2;
+  }
+  else if ((p[0] == '!') && (p[1] == '~'))
+  {
+    wp->op = W_NOMATCH;
+    p += 2;
+  }
+  else if (p[0] == '!')
+  {
+    wp->tok = T_NOT;
+    p++;
+  }
+  else if ((p[0] == '=') && (p[1] == '='))
+  {
+    wp->op = W_EQ;
+    p += 2;
+  }
+  else if (p[0] == '<')
+  {
+    wp->op = (p[1] == '=') ? W_LE : W_LT;
+    p += (p[1] == '=') ? 2 : 1;
+  }
+  else if (p[0] == '>')
+  {
+    wp->op = (p[1] == '=') ? W_GE : W_GT;
+    p += (p[1] == '=') ? 2 : 1;
+  }
+  else if (p[0] == '~')
+  {
+    wp->op = W_MATCH;
+    p++;
+  }
+  else if (p[0] == '&')
+  {
+    wp->op = W_BITS;
+    p++;
+  }
+  else if ((*p == '\'') || (*p == '\"'))
+  {
+    // A string runs to the matching quote, there are no escapes so that
+    // Windows paths can be written as they are
+    q = *p++;
+    while ((*p != q) && (*p != '\0') && (i < 299))
+    {
+      wp->text[i++] = *p++;
+    }
+    wp->text[i] = '\0';
+    wp->tok = (*p == q) ? T_STR : T_BAD;
+    if (*p == q)
+    {
+      p++;
+    }
+  }
+  else if (isdigit((unsigned char)*p) ||
+           ((*p == '-') && isdigit((unsigned char)p[1])))
+  {
+    wp->num = (int64_t)strtoll(p, &p, 0);
+    wp->tok = isalnum((unsigned char)*p) ? T_BAD : T_NUM;
+  }
+  else if (isalpha((unsigned char)*p) || (*p == '_'))
+  {
+    while ((isalnum((unsigned char)*p) || (*p == '_') || (*p == '.')) && (i < 299))
+    {
+      wp->text[i++] = *p++;
+    }
+    wp->text[i] = '\0';
+    wp->tok = T_NAME;
+    if ((strcmp(wp->text, "and") == 0) || (strcmp(wp->text, "AND") == 0))
+    {
+      wp->tok = T_AND;
+    }
+    else if ((strcmp(wp->text, "or") == 0) || (strcmp(wp->text, "OR") == 0))
+    {
+      wp->tok = T_OR;
+    }
+    else if ((strcmp(wp->text, "not") == 0) || (strcmp(wp->text, "NOT") == 0))
+    {
+      wp->tok = T_NOT;
+    }
+  }
+  else
+  {
+    wp->tok = T_BAD;
+  }
+  wp->p = p;
+}
+
+//
+//Function: where_expr() term { OR term }
+struct WHERE_NODE * where_expr(struct WHERE_PARSER * wp)
+{
+  struct WHERE_NODE *left, *right;
+
+  if ((left = where_term(wp)) == NULL)
+  {
+    return NULL;
+  }
+  while (wp->tok == T_OR)
+  {
+    where_next(wp);
+    if ((right = where_term(wp)) == NULL)
+    {
+      where_free(left);
+      return NULL;
+    }
+    left = where_node(W_OR, left, right);
+  }
+  return left;
+}
+
+//
+//Function: where_term() factor { AND factor }
+struct WHERE_NODE * where_term(struct WHERE_PARSER * wp)
+{
+  struct WHERE_NODE *left, *right;
+
+  if ((left = where_factor(wp)) == NULL)
+  {
+    return NULL;
+  }
+  while (wp->tok == T_AND)
+  {
+    where_next(wp);
+    if ((right = where_factor(wp)) == NULL)
+    {
+      where_free(left);
+      return NULL;
+    }
+    left = where_node(W_AND, left, right);
+  }
+  return left;
+}
+
+//
+//Function: where_factor() NOT factor | ( expr ) | compare
+struct WHERE_NODE * where_factor(struct WHERE_PARSER * wp)
+{
+  struct WHERE_NODE *n;
+
+  if (wp->tok == T_NOT)
+  {
+    where_next(wp);
+    if ((n = where_factor(wp)) == NULL)
+    {
+      return NULL;
+    }
+    return where_node(W_NOT, n, NULL);
+  }
+  if (wp->tok == T_LP)
+  {
+    where_next(wp);
+    if ((n = where_expr(wp)) == NULL)
+    {
+      return NULL;
+    }
+    if (wp->tok != T_RP)
+    {
+      where_error(wp, "expected \')\'");
+      where_free(n);
+      return NULL;
+    }
+    where_next(wp);
+    return n;
+  }
+  return where_compare(wp);
+}
+
+//
+//Function: where_compare() field op value
+struct WHERE_NODE * where_compare(struct WHERE_PARSER * wp)
+{
+  const struct WHERE_FIELD  *f = NULL;
+  struct WHERE_NODE         *n;
+  enum WHERE_OP             op;
+  unsigned int              i;
+  int                       isstr;
+
+  if (wp->tok == T_NAME)
+  {
+    for (i = 0; i < NUMFIELDS; i++)
+    {
+      if (strcmp(wp->text, where_fields[i].key) == 0)
+      {
+        f = &where_fields[i];
+        break;
+      }
+    }
+  }
+  if (f == NULL)
+  {
+    where_error(wp, "expected a field name");
+    return NULL;
+  }
+  where_next(wp);
+  if (wp->tok != T_OP)
+  {
+    where_error(wp, "expected a comparison operator");
+    return NULL;
+  }
+  op = wp->op;
+  isstr = (f->type == WT_STR) || (f->type == WT_WSTR) || (f->type == WT_FNAME);
+  // Strings are matched against a pattern, '==' and '!=' are just patterns
+  // without wildcards
+  if (isstr && ((op == W_EQ) || (op == W_NE)))
+  {
+    op = (op == W_EQ) ? W_MATCH : W_NOMATCH;
+  }
+  if (isstr != ((op == W_MATCH) || (op == W_NOMATCH)))
+  {
+    where_error(wp, isstr ? "only ~ !~ == != can be used with a string field"
+      : "~ and !~ can only be used with a string field");
+    return NULL;
+  }
+  if ((f->type == WT_TIME) && (op == W_BITS))
+  {
+    where_error(wp, "& cannot be used with a time field");
+    return NULL;
+  }
+  where_next(wp);
+
+  n = where_node(op, NULL, NULL);
+  n->field = f;
+  if (isstr && (wp->tok == T_STR))
+  {
+    snprintf((char *)n->str, 300, "%s", wp->text);
+  }
+  else if ((f->type == WT_TIME) && (wp->tok == T_STR))
+  {
+    if (where_time(wp->text, &n->num) < 0)
+    {
+      where_error(wp, "times must be 'YYYY-MM-DD' or 'YYYY-MM-DD HH:MM:SS'");
+      where_free(n);
+      return NULL;
+    }
+  }
+  else if (!isstr && (f->type != WT_TIME) && (wp->tok == T_NUM))
+  {
+    n->num = wp->num;
+  }
+  else if (!isstr && (f->type != WT_TIME) && (wp->tok == T_NAME))
+  {
+    for (i = 0; i < NUMCONSTS; i++)
+    {
+      if (strcmp(wp->text, where_consts[i].name) == 0)
+      {
+        n->num = where_consts[i].value;
+        break;
+      }
+    }
+    if (i == NUMCONSTS)
+    {
+      where_error(wp, "unknown name");
+      where_free(n);
+      return NULL;
+    }
+  }
+  else
+  {
+    where_error(wp, isstr ? "expected a quoted string" :
+      (f->type == WT_TIME) ? "expected a quoted time" : "expected a number or name");
+    where_free(n);
+    return NULL;
+  }
+  where_next(wp);
+  return n;
+}
+
+//
+//Function: where_node() allocates a node
+struct WHERE_NODE * where_node(enum WHERE_OP op, struct WHERE_NODE * left, struct WHERE_NODE * right)
+{
+  struct WHERE_NODE *n;
+
+  if ((n = calloc(1, sizeof(struct WHERE_NODE))) == NULL)
+  {
+    perror("Error in function where_node()");
+    exit(EXIT_FAILURE);
+  }
+  n->op = op;
+  n->left = left;
+  n->right = right;
+  return n;
+}
+
+//
+//Function: where_error() reports a syntax error and where it was found
+void where_error(struct WHERE_PARSER * wp, const char * msg)
+{
+  fprintf(stderr, "Filter error: %s at character %d\n", msg, (int)(wp->tstart - wp->expr) + 1);
+  fprintf(stderr, "  %s\n  %*s^\n", wp->expr, (int)(wp->tstart - wp->expr), "");
+}
+
+//
+//Function: where_time() converts 'YYYY-MM-DD[ HH:MM:SS]' (UTC) to seconds
+//since 1601-01-01, the epoch of a FILETIME. Returns 0 or -1 if not valid.
+int where_time(char * str, int64_t * secs)
+{
+  int      y, m, d, hh = 0, mm = 0, ss = 0, n = 0, t = 0;
+  int64_t  days;
+
+  if (sscanf(str, "%4d-%2d-%2d%n", &y, &m, &d, &n) != 3)
+  {
+    return -1;
+  }
+  if ((str[n] != '\0') && ((sscanf(str + n, " %2d:%2d:%2d%n", &hh, &mm, &ss, &t) != 3) || (str[n + t] != '\0')))
+  {
+    return -1;
+  }
+  if ((y < 1601) || (m < 1) || (m > 12) || (d < 1) || (d > 31) || (hh > 23) || (mm > 59) || (ss > 59))
+  {
+    return -1;
+  }
+  // Days from 1601-01-01 using a March based year so leap days come last
+  if (m <= 2)
+  {
+    y--;
+    m += 12;
+  }
+  days = 365 * (int64_t)(y - 1600) + (y - 1600) / 4 - (y - 1600) / 100 + (y - 1600) / 400
+    + (153 * (m - 3) + 2) / 5 + d - 1 - 306;
+  *secs = (((days * 24) + hh) * 60 + mm) * 60 + ss;
+  return 0;
+}
+
+//
+//Function: where_wild() matches a string against a pattern where '*' is any
+//number of characters and '?' is one character, ignoring case.
+int where_wild(const unsigned char * pat, const unsigned char * str)
+{
+  const unsigned char *star = NULL, *retry = NULL;
+
+  while (*str != '\0')
+  {
+    if (*pat == '*')
+    {
+      star = ++pat;
+      retry = str;
+    }
+    else if ((*pat == '?') || ((*pat != '\0') && (tolower(*pat) == tolower(*str))))
+    {
+      pat++;
+      str++;
+    }
+    else if (star != NULL)
+    {
+      pat = star;
+      str = ++retry;
+    }
+    else
+    {
+      return 0;
+    }
+  }
+  while (*pat == '*')
+  {
+    pat++;
+  }
+  return *pat == '\0';
+}
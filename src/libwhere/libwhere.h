@@ -0,0 +1,110 @@
+/***************************************************************
+**                                                            **
+**                      libwhere.h                            **
+**                                                            **
+**    A small filter language for selecting link files by     **
+** the values in their decoded (LIF) structure                **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int where_compile(char * expr, struct WHERE_NODE ** tree)  **
+**      Compiles the filter expression into a predicate tree  **
+**      Returns 0 if successful, -1 (with a message on        **
+**      stderr) if the expression is not valid.               **
+**                                                            **
+** uint32_t where_sections(struct WHERE_NODE * tree)          **
+**      Returns the LIF_SEC_* sections that get_lif_at() must **
+**      decode for the tree to be evaluated.                  **
+**                                                            **
+** int where_match(struct WHERE_NODE * tree,                  **
+**                 struct LIF * lif,                          **
+**                 char * fname,                              **
+**                 uint64_t fsize)                            **
+**      Returns 1 if the link file matches the filter, 0 if   **
+**      not. fname & fsize are the link file's name & size.   **
+**                                                            **
+** void where_free(struct WHERE_NODE * tree)                  **
+**      Frees a compiled tree.                                **
+**                                                            **
+** void where_list(FILE * fp)                                 **
+**      Prints the field and constant names to fp.            **
+**                                                            **
+** Syntax:                                                    **
+** -------                                                    **
+** expr    := term { ('||' | 'or') term }                     **
+** term    := factor { ('&&' | 'and') factor }                **
+** factor  := ('!' | 'not') factor | '(' expr ')' | compare   **
+** compare := field op value                                  **
+** op      := == != < <= > >= (numbers and times)             **
+**            &  (number has all the bits in value)           **
+**            ~ !~ (string matches/doesn't match a wildcard   **
+**            pattern using * and ?)                          **
+** value   := 123 | -1 | 0x7B | NAME | 'string' | "string"    **
+**            times are strings: 'YYYY-MM-DD[ HH:MM:SS]' UTC  **
+** String comparisons ignore case.                            **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBWHERE_H_
+#define _LIBWHERE_H_
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "../liblife/liblife.h"
+
+enum WHERE_OP
+{
+  W_AND, W_OR, W_NOT,                          // Logical nodes
+  W_EQ, W_NE, W_LT, W_LE, W_GT, W_GE, W_BITS,  // Number & time comparisons
+  W_MATCH, W_NOMATCH                           // String comparisons
+};
+
+enum WHERE_TYPE // How a field is stored in the LIF
+{
+  WT_U16, WT_U32, WT_I32, WT_TIME, WT_STR, WT_WSTR, WT_FNAME, WT_FSIZE
+};
+
+struct WHERE_FIELD
+{
+  const char *       key;      // The name used in an expression
+  enum WHERE_TYPE    type;
+  uint32_t           sections; // LIF_SEC_* sections the field is decoded in
+  size_t             offset;   // Offset of the field in struct LIF
+};
+
+struct WHERE_NODE
+{
+  enum WHERE_OP               op;
+  const struct WHERE_FIELD *  field;   // Comparisons only
+  int64_t                     num;     // Number, or time in seconds since 1601
+  unsigned char               str[300];// Wildcard pattern
+  struct WHERE_NODE *         left;    // Logical nodes only (NOT uses left)
+  struct WHERE_NODE *         right;
+};
+
+extern int where_compile(char *, struct WHERE_NODE **);
+extern uint32_t where_sections(struct WHERE_NODE *);
+extern int where_match(struct WHERE_NODE *, struct LIF *, char *, uint64_t);
+extern void where_free(struct WHERE_NODE *);
+extern void where_list(FILE *);
+
+#endif
@@ -0,0 +1,390 @@
+/***************************************************************
+**                                                            **
+**                    libxmlw.c                               **
+**                                                            **
+**    Writes well formed XML text.                            **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libxmlw.h for the exported functions                   **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "./libxmlw.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#define _isatty isatty
+#define _fileno fileno
+#endif
+
+// What xw_text() does with each byte
+#define XW_COPY   0 // Written as it is
+#define XW_ESC    1 // Written as an entity
+#define XW_CTRL   2 // Not allowed in XML, written as U+FFFD
+#define XW_HIGH   3 // Part of a UTF-8 sequence (or a Latin-1 character)
+#define XW_END    4 // The terminating zero
+
+static const unsigned char xw_class[256] =
+{
+  4, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 2, 2, 0, 2, 2, // 0x00 (TAB, LF & CR are allowed)
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, // 0x10
+  0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x20 '"' & '&'
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, // 0x30 '<' & '>'
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x40
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x50
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x60
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x70
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0x80
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0x90
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0xA0
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0xB0
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0xC0
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0xD0
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, // 0xE0
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3  // 0xF0
+};
+
+// Each call builds its text here and writes it with a single fwrite()
+static char             *xw_line = NULL;
+static size_t           xw_len, xw_size;
+
+//Local function declarations
+int xw_utf8len(const unsigned char *);
+int xw_need(size_t);
+void xw_esc(const char *, int);
+
+//
+//Function: xw_utf8len() returns the length of the valid UTF-8 sequence
+//          starting at p (which is >= 0x80), or 0 if it isn't one. Overlong
+//          forms, surrogates and U+FFFE/U+FFFF (not allowed in XML) are
+//          not valid.
+int xw_utf8len(const unsigned char * p)
+{
+  if (p[0] >= 0xC2 && p[0] <= 0xDF)
+  {
+    return ((p[1] & 0xC0) == 0x80) ? 2 : 0;
+  }
+  if (p[0] >= 0xE0 && p[0] <= 0xEF)
+  {
+    if ((p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80)
+      return 0;
+    if ((p[0] == 0xE0 && p[1] < 0xA0) || (p[0] == 0xED && p[1] > 0x9F))
+      return 0;
+    if (p[0] == 0xEF && p[1] == 0xBF && p[2] >= 0xBE)
+      return 0;
+    return 3;
+  }
+  if (p[0] >= 0xF0 && p[0] <= 0xF4)
+  {
+    if ((p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80)
+      return 0;
+    if ((p[0] == 0xF0 && p[1] < 0x90) || (p[0] == 0xF4 && p[1] > 0x8F))
+      return 0;
+    return 4;
+  }
+  return 0;
+}
+
+//
+//Function: xw_need() makes room for n more bytes in xw_line
+int xw_need(size_t n)
+{
+  char * p;
+  size_t size;
+
+  if (xw_len + n <= xw_size)
+  {
+    return 0;
+  }
+  size = (xw_size == 0) ? 1024 : xw_size;
+  while (size < xw_len + n)
+  {
+    size *= 2;
+  }
+  p = realloc(xw_line, size);
+  if (p == NULL)
+  {
+    fprintf(stderr, "Unable to allocate memory for the XML output\n");
+    return -1;
+  }
+  xw_line = p;
+  xw_size = size;
+  return 0;
+}
+
+//
+//Function: xw_esc() adds a string to xw_line as XML text. Runs of characters
+//          that need no change are found with the xw_class[] table and
+//          copied with a single memcpy(). In a CDATA section (cdata > 0)
+//          only the '>' of a ']]>' is changed, by ending the section and
+//          starting another.
+void xw_esc(const char * s, int cdata)
+{
+  const unsigned char *p = (const unsigned char *)s, *run;
+  const char *ent;
+  int n;
+
+  for (;;)
+  {
+    run = p;
+    while (xw_class[*p] == XW_COPY)
+    {
+      p++;
+    }
+    if (xw_need((p - run) + 13) < 0) // Room for the run and an entity
+    {
+      return;
+    }
+    memcpy(xw_line + xw_len, run, p - run);
+    xw_len += p - run;
+    switch (xw_class[*p])
+    {
+    case XW_ESC:
+      if (cdata > 0)
+      {
+        if (*p == '>' && xw_len >= 2 && xw_line[xw_len - 1] == ']' && xw_line[xw_len - 2] == ']')
+        {
+          memcpy(xw_line + xw_len, "]]><![CDATA[>", 13);
+          xw_len += 13;
+        }
+        else
+        {
+          xw_line[xw_len++] = (char)*p;
+        }
+        p++;
+        break;
+      }
+      switch (*p)
+      {
+      case '&':
+        ent = "&amp;";
+        break;
+      case '<':
+        ent = "&lt;";
+        break;
+      case '>':
+        ent = "&gt;";
+        break;
+      default:
+        ent = "&quot;";
+      }
+      n = strlen(ent);
+      memcpy(xw_line + xw_len, ent, n);
+      xw_len += n;
+      p++;
+      break;
+    case XW_CTRL:
+      memcpy(xw_line + xw_len, "\xEF\xBF\xBD", 3);
+      xw_len += 3;
+      p++;
+      break;
+    case XW_HIGH:
+      n = xw_utf8len(p);
+      if (n > 0)
+      {
+        memcpy(xw_line + xw_len, p, n);
+        xw_len += n;
+        p += n;
+      }
+      else
+      {
+        // Latin-1, which maps straight onto U+0080 to U+00FF
+        xw_line[xw_len++] = (char)(0xC0 | (*p >> 6));
+        xw_line[xw_len++] = (char)(0x80 | (*p & 0x3F));
+        p++;
+      }
+      break;
+    default: // XW_END
+      return;
+    }
+  }
+}
+
+//
+//Function: xw_text() writes a string as XML text
+extern void xw_text(FILE * fp, const char * s)
+{
+  xw_len = 0;
+  xw_esc(s, 0);
+  fwrite(xw_line, 1, xw_len, fp);
+}
+
+//
+//Function: xw_cdata() writes a string as a CDATA section
+extern void xw_cdata(FILE * fp, const char * s)
+{
+  xw_len = 0;
+  if (xw_need(9) < 0)
+  {
+    return;
+  }
+  memcpy(xw_line, "<![CDATA[", 9);
+  xw_len = 9;
+  xw_esc(s, 1);
+  if (xw_need(3) < 0)
+  {
+    return;
+  }
+  memcpy(xw_line + xw_len, "]]>", 3);
+  xw_len += 3;
+  fwrite(xw_line, 1, xw_len, fp);
+}
+
+//
+//Function: xw_printf() copies the literal parts of fmt, escapes the strings
+//          for '%s' and formats the other conversions one at a time (as
+//          long long so one snprintf() call does for all of them), then
+//          writes the lot with one fwrite().
+extern int xw_printf(FILE * fp, const char * fmt, ...)
+{
+  va_list ap;
+  const char *p, *run;
+  char spec[24];
+  size_t len;
+  int lng, n;
+  long long iv = 0;
+  unsigned long long uv = 0;
+
+  va_start(ap, fmt);
+  xw_len = 0;
+  p = fmt;
+  while (*p != '\0')
+  {
+    run = p;
+    while (*p != '\0' && *p != '%')
+    {
+      p++;
+    }
+    if (xw_need((p - run) + 1) < 0)
+    {
+      va_end(ap);
+      return -1;
+    }
+    memcpy(xw_line + xw_len, run, p - run);
+    xw_len += p - run;
+    if (*p == '\0')
+    {
+      break;
+    }
+    run = p++; // The start of the conversion
+    if (*p == '%')
+    {
+      xw_line[xw_len++] = '%';
+      p++;
+      continue;
+    }
+    p += strspn(p, "-+ #0123456789.");
+    len = p - run; // The '%', flags, width & precision
+    while (*p == 'h')
+    {
+      p++; // short & char arguments are passed as int anyway
+    }
+    lng = 0;
+    while (*p == 'l')
+    {
+      lng++;
+      p++;
+    }
+    if (len + 4 > sizeof(spec) || lng > 2)
+    {
+      va_end(ap);
+      return -1;
+    }
+    memcpy(spec, run, len);
+    switch (*p)
+    {
+    case 's':
+      xw_esc(va_arg(ap, const char *), 0);
+      p++;
+      continue;
+    case 'c':
+      spec[len++] = 'c';
+      iv = va_arg(ap, int);
+      break;
+    case 'd':
+    case 'i':
+      spec[len++] = 'l';
+      spec[len++] = 'l';
+      spec[len++] = *p;
+      if (lng == 0)
+        iv = va_arg(ap, int);
+      else if (lng == 1)
+        iv = va_arg(ap, long);
+      else
+        iv = va_arg(ap, long long);
+      break;
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+      spec[len++] = 'l';
+      spec[len++] = 'l';
+      spec[len++] = *p;
+      if (lng == 0)
+        uv = va_arg(ap, unsigned int);
+      else if (lng == 1)
+        uv = va_arg(ap, unsigned long);
+      else
+        uv = va_arg(ap, unsigned long long);
+      break;
+    default:
+      spec[len] = '\0';
+      fprintf(stderr, "xw_printf(): conversion \'%s%c\' is not supported\n", spec, *p);
+      va_end(ap);
+      return -1;
+    }
+    spec[len] = '\0';
+    do
+    {
+      if (*p == 'c')
+        n = snprintf(xw_line + xw_len, xw_size - xw_len, spec, (int)iv);
+      else if (*p == 'd' || *p == 'i')
+        n = snprintf(xw_line + xw_len, xw_size - xw_len, spec, iv);
+      else
+        n = snprintf(xw_line + xw_len, xw_size - xw_len, spec, uv);
+      if (n < 0 || xw_need(n + 1) < 0)
+      {
+        va_end(ap);
+        return -1;
+      }
+    } while (xw_len + n >= xw_size); // Until it fitted
+    xw_len += n;
+    p++;
+  }
+  va_end(ap);
+  fwrite(xw_line, 1, xw_len, fp);
+  return ferror(fp) ? -1 : 0;
+}
+
+//
+//Function: xw_buffer() sets up a large, fully buffered output buffer
+extern int xw_buffer(FILE * fp, size_t size)
+{
+  if (_isatty(_fileno(fp)))
+  {
+    return 0; // Leave a terminal line buffered
+  }
+  return (setvbuf(fp, NULL, _IOFBF, (size > 0) ? size : XW_BUFSIZE) == 0) ? 0 : -1;
+}
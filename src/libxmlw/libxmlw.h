@@ -0,0 +1,70 @@
+/***************************************************************
+**                                                            **
+**                    libxmlw.h                               **
+**                                                            **
+**    Writes well formed XML text. Strings are escaped as     **
+** they are written, characters that XML doesn't allow are    **
+** replaced and anything that isn't valid UTF-8 is taken to   **
+** be Latin-1, so the output is always valid UTF-8 XML.       **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** void xw_text(FILE * fp, const char * s)                    **
+**      Writes the zero terminated string s as XML text, safe **
+**      to use as element content or as an attribute value.   **
+**      '&', '<', '>' and '"' are written as entities and     **
+**      control characters other than TAB, LF and CR as       **
+**      U+FFFD.                                               **
+**                                                            **
+** void xw_cdata(FILE * fp, const char * s)                   **
+**      Writes s as a CDATA section, '<![CDATA[' s ']]>'. A   **
+**      ']]>' in s is split across two sections and control   **
+**      characters are replaced as they are by xw_text().     **
+**                                                            **
+** int xw_printf(FILE * fp, const char * fmt, ...)            **
+**      As fprintf() but the strings given for '%s' are       **
+**      written with xw_text(). Only %%, %s and %c, %d, %i,   **
+**      %o, %u, %x, %X (with flags, width, precision and the  **
+**      h, hh, l and ll modifiers) may be used.               **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** int xw_buffer(FILE * fp, size_t size)                      **
+**      Gives fp a 'size' byte output buffer (0 for           **
+**      XW_BUFSIZE) unless it is a terminal. Must be called   **
+**      before anything is written to fp.                     **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBXMLW_H_
+#define _LIBXMLW_H_
+
+#include <stdio.h>
+
+#define XW_BUFSIZE  (1 << 20) // Output buffer given by xw_buffer()
+
+extern void xw_text(FILE *, const char *);
+extern void xw_cdata(FILE *, const char *);
+extern int xw_printf(FILE *, const char *, ...);
+extern int xw_buffer(FILE *, size_t);
+
+#endif
@@ -0,0 +1,527 @@
+/***************************************************************
+**                                                            **
+**                    libzout.c                               **
+**                                                            **
+**    Compresses standard output in blocks on a pool of       **
+** threads.                                                   **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** See libzout.h for the exported functions                   **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "./libzout.h"
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#if !defined(_WIN32) && (defined(HAVE_ZLIB) || defined(HAVE_ZSTD))
+#include <fcntl.h>
+#include <errno.h>
+#include <pthread.h>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/*
+File descriptor 1 is replaced by the write end of a pipe so everything sent
+to stdout (printf(), fwrite() and all) arrives at the reader thread. It cuts
+the data into ZO_BLOCK sized blocks in a ring of slots, the workers compress
+the slots in any order and the writer thread writes them to the real output
+in the order they were read. A slot is only refilled once it has been
+written, so the ring bounds the memory used; while there is a free slot the
+reader keeps draining the pipe and the writes to stdout never wait for the
+compression.
+*/
+
+#define ZO_FREE     0 // Waiting to be filled by the reader
+#define ZO_FILLED   1 // Waiting to be (or being) compressed
+#define ZO_DONE     2 // Compressed, waiting to be written
+
+struct ZO_SLOT
+{
+  unsigned char *    In;
+  size_t             InLen;
+  unsigned char *    Out;
+  size_t             OutLen;
+  size_t             OutSize;
+  int                State;
+};
+
+static struct ZO_SLOT   *zo_slots = NULL;
+static int              zo_nslots, zo_nworkers;
+static pthread_t        zo_reader, zo_writer, zo_workers[ZO_MAXTHREADS];
+static pthread_mutex_t  zo_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   zo_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t         zo_filled, zo_taken, zo_written; // Blocks read, compressed & written
+static int              zo_eof, zo_error, zo_method;
+static int              zo_in = -1, zo_out = -1;        // Pipe read end & the real stdout
+static int              zo_running = 0;
+static size_t           zo_high = 0;                    // Bytes the slots grew to
+
+//Local function declarations
+void * zo_read(void *);
+void * zo_work(void *);
+void * zo_write(void *);
+int zo_compress(struct ZO_SLOT *);
+void zo_atexit(void);
+void zo_free(void);
+
+//
+//Function: zo_read() is the reader thread, it fills the slots from the pipe
+void * zo_read(void * arg)
+{
+  struct ZO_SLOT * slot;
+  size_t len;
+  ssize_t r = 1;
+
+  while (r > 0)
+  {
+    pthread_mutex_lock(&zo_lock);
+    slot = &zo_slots[zo_filled % zo_nslots];
+    while (slot->State != ZO_FREE)
+    {
+      pthread_cond_wait(&zo_cond, &zo_lock);
+    }
+    pthread_mutex_unlock(&zo_lock);
+
+    len = 0;
+    while (len < ZO_BLOCK)
+    {
+      r = read(zo_in, slot->In + len, ZO_BLOCK - len);
+      if (r < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if (r <= 0)
+      {
+        break; // End of the output (or an error reading the pipe)
+      }
+      len += r;
+    }
+
+    pthread_mutex_lock(&zo_lock);
+    if (len > 0 || zo_filled == 0) // (No output still needs an empty member)
+    {
+      slot->InLen = len;
+      slot->State = ZO_FILLED;
+      zo_filled++;
+    }
+    if (r <= 0)
+    {
+      zo_eof = 1;
+    }
+    pthread_cond_broadcast(&zo_cond);
+    pthread_mutex_unlock(&zo_lock);
+  }
+  return NULL;
+}
+
+//
+//Function: zo_work() is a worker thread, it compresses filled slots
+void * zo_work(void * arg)
+{
+  struct ZO_SLOT * slot;
+  int result;
+
+  for (;;)
+  {
+    pthread_mutex_lock(&zo_lock);
+    while (zo_taken == zo_filled && !zo_eof)
+    {
+      pthread_cond_wait(&zo_cond, &zo_lock);
+    }
+    if (zo_taken == zo_filled)
+    {
+      pthread_mutex_unlock(&zo_lock);
+      return NULL;
+    }
+    slot = &zo_slots[zo_taken++ % zo_nslots];
+    pthread_mutex_unlock(&zo_lock);
+
+    result = zo_compress(slot);
+
+    pthread_mutex_lock(&zo_lock);
+    if (result < 0)
+    {
+      zo_error = 1;
+    }
+    slot->State = ZO_DONE;
+    pthread_cond_broadcast(&zo_cond);
+    pthread_mutex_unlock(&zo_lock);
+  }
+}
+
+//
+//Function: zo_write() is the writer thread, it writes the compressed slots
+//          in order
+void * zo_write(void * arg)
+{
+  struct ZO_SLOT * slot;
+  size_t done;
+  ssize_t w;
+
+  for (;;)
+  {
+    pthread_mutex_lock(&zo_lock);
+    slot = &zo_slots[zo_written % zo_nslots];
+    while (slot->State != ZO_DONE && !(zo_eof && zo_written == zo_filled))
+    {
+      pthread_cond_wait(&zo_cond, &zo_lock);
+    }
+    pthread_mutex_unlock(&zo_lock);
+    if (slot->State != ZO_DONE)
+    {
+      return NULL;
+    }
+
+    done = 0;
+    while (done < slot->OutLen && !zo_error)
+    {
+      w = write(zo_out, slot->Out + done, slot->OutLen - done);
+      if (w < 0 && errno == EINTR)
+      {
+        continue;
+      }
+      if (w <= 0)
+      {
+        fprintf(stderr, "Error writing the compressed output\n");
+        zo_error = 1; // Carry on emptying the slots so the reader isn't stuck
+        break;
+      }
+      done += w;
+    }
+
+    pthread_mutex_lock(&zo_lock);
+    slot->State = ZO_FREE;
+    zo_written++;
+    pthread_cond_broadcast(&zo_cond);
+    pthread_mutex_unlock(&zo_lock);
+  }
+}
+
+//
+//Function: zo_compress() compresses a slot into a gzip member or zstd frame
+//          of its own
+int zo_compress(struct ZO_SLOT * slot)
+{
+  size_t bound = 0;
+  unsigned char * p;
+#ifdef HAVE_ZLIB
+  z_stream zs;
+#endif
+
+#ifdef HAVE_ZLIB
+  if (zo_method == ZO_GZIP)
+  {
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, ZO_GZLEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      fprintf(stderr, "Unable to start the gzip compressor\n");
+      return -1;
+    }
+    bound = deflateBound(&zs, slot->InLen);
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if (zo_method == ZO_ZSTD)
+  {
+    bound = ZSTD_compressBound(slot->InLen);
+  }
+#endif
+  if (bound > slot->OutSize)
+  {
+    p = realloc(slot->Out, bound);
+    if (p == NULL)
+    {
+      fprintf(stderr, "Unable to allocate memory for the compressed output\n");
+#ifdef HAVE_ZLIB
+      if (zo_method == ZO_GZIP)
+        deflateEnd(&zs);
+#endif
+      return -1;
+    }
+    slot->Out = p;
+    slot->OutSize = bound;
+  }
+#ifdef HAVE_ZLIB
+  if (zo_method == ZO_GZIP)
+  {
+    zs.next_in = slot->In;
+    zs.avail_in = (uInt)slot->InLen;
+    zs.next_out = slot->Out;
+    zs.avail_out = (uInt)slot->OutSize;
+    if (deflate(&zs, Z_FINISH) != Z_STREAM_END)
+    {
+      fprintf(stderr, "Error compressing the output (gzip)\n");
+      deflateEnd(&zs);
+      return -1;
+    }
+    slot->OutLen = zs.total_out;
+    deflateEnd(&zs);
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if (zo_method == ZO_ZSTD)
+  {
+    slot->OutLen = ZSTD_compress(slot->Out, slot->OutSize, slot->In, slot->InLen, ZO_ZSTDLEVEL);
+    if (ZSTD_isError(slot->OutLen))
+    {
+      fprintf(stderr, "Error compressing the output (zstd): %s\n", ZSTD_getErrorName(slot->OutLen));
+      slot->OutLen = 0;
+      return -1;
+    }
+  }
+#endif
+  return 0;
+}
+
+//
+//Function: zo_free() frees the slots
+void zo_free(void)
+{
+  int i;
+
+  if (zo_slots != NULL)
+  {
+    for (i = 0; i < zo_nslots; i++)
+    {
+      free(zo_slots[i].In);
+      free(zo_slots[i].Out);
+    }
+    free(zo_slots);
+    zo_slots = NULL;
+  }
+}
+
+//
+//Function: zo_atexit() finishes the stream if lifer exits without calling
+//          zo_close()
+void zo_atexit(void)
+{
+  zo_close();
+}
+
+//
+//Function: zo_open() puts the pipe in place of stdout and starts the threads
+extern int zo_open(int method, int threads)
+{
+  int fds[2], i;
+  static int registered = 0;
+
+#ifndef HAVE_ZLIB
+  if (method == ZO_GZIP)
+  {
+    fprintf(stderr, "Sorry, this lifer was built without gzip (build with -DHAVE_ZLIB and -lz -lpthread)\n");
+    return -1;
+  }
+#endif
+#ifndef HAVE_ZSTD
+  if (method == ZO_ZSTD)
+  {
+    fprintf(stderr, "Sorry, this lifer was built without zstd (build with -DHAVE_ZSTD and -lzstd -lpthread)\n");
+    return -1;
+  }
+#endif
+  if (zo_running || (method != ZO_GZIP && method != ZO_ZSTD))
+  {
+    return -1;
+  }
+  if (threads <= 0)
+  {
+    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  if (threads < 1)
+  {
+    threads = 1;
+  }
+  if (threads > ZO_MAXTHREADS)
+  {
+    threads = ZO_MAXTHREADS;
+  }
+  zo_method = method;
+  zo_nworkers = threads;
+  zo_nslots = (2 * threads) + 2; // Enough for every worker to have a block
+                                 // ready while others are read & written
+  zo_slots = calloc(zo_nslots, sizeof(struct ZO_SLOT));
+  if (zo_slots == NULL)
+  {
+    fprintf(stderr, "Unable to allocate memory for the compressed output\n");
+    return -1;
+  }
+  for (i = 0; i < zo_nslots; i++)
+  {
+    if ((zo_slots[i].In = malloc(ZO_BLOCK)) == NULL)
+    {
+      fprintf(stderr, "Unable to allocate memory for the compressed output\n");
+      zo_free();
+      return -1;
+    }
+  }
+  zo_filled = zo_taken = zo_written = 0;
+  zo_eof = zo_error = 0;
+
+  fflush(stdout);
+  if (pipe(fds) != 0)
+  {
+    fprintf(stderr, "Unable to create a pipe for the compressed output\n");
+    zo_free();
+    return -1;
+  }
+  zo_in = fds[0];
+  zo_out = dup(1);
+  if (zo_out < 0 || dup2(fds[1], 1) < 0)
+  {
+    fprintf(stderr, "Unable to redirect the output to the compressor\n");
+    close(fds[0]);
+    close(fds[1]);
+    zo_free();
+    return -1;
+  }
+  close(fds[1]);
+#ifdef F_SETPIPE_SZ
+  fcntl(1, F_SETPIPE_SZ, ZO_BLOCK); // (Linux) A bigger pipe, fewer waits for the reader
+#endif
+
+  if (pthread_create(&zo_reader, NULL, zo_read, NULL) != 0 ||
+    pthread_create(&zo_writer, NULL, zo_write, NULL) != 0)
+  {
+    fprintf(stderr, "Unable to start the compressor threads\n");
+    exit(EXIT_FAILURE); // Can't put stdout back safely with a thread reading it
+  }
+  for (i = 0; i < zo_nworkers; i++)
+  {
+    if (pthread_create(&zo_workers[i], NULL, zo_work, NULL) != 0)
+    {
+      if (i == 0)
+      {
+        fprintf(stderr, "Unable to start the compressor threads\n");
+        exit(EXIT_FAILURE);
+      }
+      zo_nworkers = i; // Make do with fewer
+      break;
+    }
+  }
+  zo_running = 1;
+  if (!registered)
+  {
+    atexit(zo_atexit);
+    registered = 1;
+  }
+  return 0;
+}
+
+//
+//Function: zo_close() ends the output, waits for the threads and puts
+//          stdout back
+extern int zo_close(void)
+{
+  int i;
+
+  if (!zo_running)
+  {
+    return 0;
+  }
+  zo_running = 0;
+  fflush(stdout);
+  dup2(zo_out, 1); // Closes the pipe's write end, the reader gets end of file
+  pthread_join(zo_reader, NULL);
+  for (i = 0; i < zo_nworkers; i++)
+  {
+    pthread_join(zo_workers[i], NULL);
+  }
+  pthread_join(zo_writer, NULL);
+  close(zo_in);
+  close(zo_out);
+  // The buffers only grow, what they came to is the most that was used
+  zo_high = zo_nslots * (size_t)ZO_BLOCK;
+  for (i = 0; i < zo_nslots; i++)
+  {
+    zo_high += zo_slots[i].OutSize;
+  }
+  zo_free();
+  return zo_error ? -1 : 0;
+}
+
+#else
+
+//Without threads or a compression library only the errors are left
+extern int zo_open(int method, int threads)
+{
+#ifdef _WIN32
+  fprintf(stderr, "Sorry, compressed output is not available on Windows\n");
+#else
+  fprintf(stderr, "Sorry, this lifer was built without compression (build with -DHAVE_ZLIB and -lz -lpthread)\n");
+#endif
+  return -1;
+}
+
+extern int zo_close(void)
+{
+  return 0;
+}
+
+#endif
+
+//
+//Function: zo_threads() returns the number of workers whose blocks fit in
+//          'budget' bytes (at most one per processor), 0 if not even one's
+//          do. Each of the 2 * workers + 2 slots holds a block and its
+//          compressed form, which can be a little bigger.
+extern int zo_threads(size_t budget)
+{
+  size_t slots = budget / ((2 * (size_t)ZO_BLOCK) + (ZO_BLOCK / 64));
+  int threads = 1;
+
+#ifndef _WIN32
+  threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  if (threads > ZO_MAXTHREADS)
+  {
+    threads = ZO_MAXTHREADS;
+  }
+  if (threads < 1)
+  {
+    threads = 1;
+  }
+  if (slots < 4)
+  {
+    return 0;
+  }
+  return ((int)((slots - 2) / 2) < threads) ? (int)((slots - 2) / 2) : threads;
+}
+
+//
+//Function: zo_peak() returns the bytes the last compressor's buffers used
+extern size_t zo_peak(void)
+{
+#if !defined(_WIN32) && (defined(HAVE_ZLIB) || defined(HAVE_ZSTD))
+  return zo_high;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,77 @@
+/***************************************************************
+**                                                            **
+**                    libzout.h                               **
+**                                                            **
+**    Compresses everything written to standard output with   **
+** gzip or zstd. The output is cut into blocks which are      **
+** compressed independently by a pool of threads (as pigz     **
+** does) and written in order as a concatenated stream of     **
+** gzip members or zstd frames that the usual tools read.     **
+** Needs POSIX threads, gzip needs zlib (-DHAVE_ZLIB & -lz)   **
+** and zstd needs libzstd (-DHAVE_ZSTD & -lzstd).             **
+**                                                            **
+**           Copyright 2026 the Lifer contributors            **
+**                                                            **
+** Exported Functions:                                        **
+** -------------------                                        **
+** int zo_open(int method, int threads)                       **
+**      Sends standard output (file descriptor 1) through a   **
+**      pipe to the compressor and starts 'threads' workers   **
+**      (0 for one per processor). method is ZO_GZIP or       **
+**      ZO_ZSTD. Must be called before anything is written    **
+**      to stdout. zo_close() is registered with atexit() so  **
+**      the stream is complete even if lifer exits early.     **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** int zo_close(void)                                         **
+**      Flushes stdout, compresses and writes the last block  **
+**      and stops the threads. Does nothing if zo_open() was  **
+**      not called (or zo_close() already has been).          **
+**      Returns 0 if successful, -1 if not.                   **
+**                                                            **
+** int zo_threads(size_t budget)                              **
+**      Returns the most workers (up to one per processor)    **
+**      whose buffers fit in 'budget' bytes, for zo_open().   **
+**      Returns 0 if the budget is too small for one.         **
+**                                                            **
+** size_t zo_peak(void)                                       **
+**      Returns the bytes of buffers the last compressor      **
+**      used (once zo_close() has been called).               **
+**                                                            **
+***************************************************************/
+
+/*
+This file is part of Lifer.
+
+    Lifer is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Lifer is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Lifer.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _LIBZOUT_H_
+#define _LIBZOUT_H_
+
+#include <stdio.h>
+
+#define ZO_GZIP       1
+#define ZO_ZSTD       2
+#define ZO_BLOCK      (1 << 20) // Uncompressed bytes in a block
+#define ZO_MAXTHREADS 64
+#define ZO_GZLEVEL    6         // Same as gzip's default
+#define ZO_ZSTDLEVEL  3         // Same as zstd's default
+
+extern int zo_open(int, int);
+extern int zo_close(void);
+extern int zo_threads(size_t);
+extern size_t zo_peak(void);
+
+#endif
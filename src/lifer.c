@@ -9,6 +9,15 @@
 ** Usage:                                               **
 ** lifer [-vh]                                          **
 ** lifer [-s] [-o csv|tsv|txt] dir|file(s)              **
+** lifer -F field,... [-o csv|tsv|txt|xml] dir|file(s)  **
+** lifer --where filter [-s] [-o ...] dir|file(s)       **
+** lifer -o arrow [--batch-size rows] dir|file(s)       **
+** lifer -o sqlite:FILE dir|file(s)                     **
+** lifer --compress gzip|zstd [-o ...] dir|file(s)      **
+** lifer --stats [-o ...] dir|file(s)                   **
+** lifer --progress[=secs] [-o ...] dir|file(s)         **
+** lifer --perf [-o ...] dir|file(s)                    **
+** lifer --max-memory size [-o ...] dir|file(s)         **
 **                                                      **
 *********************************************************/
 
@@ -37,15 +46,30 @@ This file is part of lifer.
 #include <sys/types.h>
 #include <time.h>
 #include <wchar.h>
+#include <stddef.h>
 // local headers
 #include "./liblife/liblife.h"
+#include "./liblife/lifwalk.h"
 #include "./version.h"
 #include "./libbin2hex/libbin2hex.h"
+#include "./libwhere/libwhere.h"
+#include "./libtimeline/libtimeline.h"
+#include "./libarrowipc/libarrowipc.h"
+#include "./liblifedb/liblifedb.h"
+#include "./libxmlw/libxmlw.h"
+#include "./libjsonw/libjsonw.h"
+#include "./libzout/libzout.h"
+#include "./libstats/libstats.h"
+#include "./libprogress/libprogress.h"
+#include "./libpmc/libpmc.h"
+#include "./libserve/libserve.h"
+#include "./libisolate/libisolate.h"
 
 //Conditional includes and definitions dependant on OS
 #ifdef _WIN32
 // Windows 
 #include <io.h>
+#include <fcntl.h>
 #include "./win/dirent.h"
 #include "./win/getopt.h"
 #include <direct.h>
@@ -54,14 +78,48 @@ This file is part of lifer.
 // *nix 
 #include <unistd.h>
 #include <dirent.h>
+#include <getopt.h>
 #define _getcwd getcwd  // _getcwd() is Windows, getcwd() is *nix
 #define _chdir chdir    // same issue here
 #endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h> // SSE2, used to scan CSV fields 16 bytes at a time
+#define CSV_SSE2
+#endif
 
 //Global stuff
-enum otype { csv, tsv, txt, xml };
+enum otype { csv, tsv, txt, xml, timeline, arrow, sqlite, json };
+struct RENDER_OPTS                     // The options that apply to each link file a worker renders
+{
+  int less;
+  int idlist;
+};
 enum otype output_type;
 int filecount;
+struct WHERE_NODE * where_tree = NULL; // The compiled '--where' filter
+uint32_t where_mask = 0;               // The sections that it needs
+struct AIPC_WRITER * arrow_writer = NULL; // The '-o arrow' stream
+int arrow_rows = 0;                    // Rows per record batch ('--batch-size')
+char * sqlite_file = NULL;             // The '-o sqlite:FILE' database
+int compress_method = 0;               // ZO_GZIP or ZO_ZSTD ('--compress')
+uint32_t lif_a_opts = 0;               // LIF_A_NUMERIC for '--numeric-flags'
+char * serve_path = NULL;              // The '--serve' socket
+int workers = 0;                       // Worker processes ('--workers', 0 for one per processor)
+int isolate = 0;                       // Give the link files to worker processes ('--isolate')
+FILE * quarantine_fp = NULL;           // The '--quarantine' list of files a worker died over
+struct ST_STATS stats;                 // Timings & counts for '--stats'
+size_t max_memory = 0;                 // '--max-memory' budget (0 for none)
+int compress_threads = 0;              // Compressor workers (0 for one per processor)
+size_t timeline_budget = 0;            // Timeline buffer (0 for TL_BUDGET)
+size_t xml_bufsize = 0;                // XML output buffer (0 for XW_BUFSIZE)
+size_t arrow_budget = 0;               // Arrow batch buffers (0 for no limit)
+size_t compress_budget = 0;            // Compressor buffers (0 for no limit)
+
+// '--max-memory' is shared out between lifer's buffers after MEM_BASE for
+// the program, the C library & the structs each link file is decoded into
+// (over 300 KB of them, on the stack)
+#define MEM_BASE        (8 * 1024 * 1024)
+#define ARROW_ROW_BYTES 1024    // Arrow batch buffers per row (~750 bytes measured)
 
 //Function help_message() prints a help message to stdout
 void help_message()
@@ -70,14 +128,74 @@ void help_message()
   printf("\nlifer - A Windows link file (a.k.a. shortcut) analyser\n");
   printf("Version: %u.%u.%u\n\n", _MAJOR, _MINOR, _BUILD);
   printf("Usage: lifer  [-vhs] [-o csv|tsv|txt|xml] file(s)|directory\n");
-  printf("       lifer   -i    [-o txt|xml]         file(s)|directory\n\n");
+  printf("       lifer   -i    [-o txt|xml]         file(s)|directory\n");
+  printf("       lifer   -o timeline                file(s)|directory\n");
+  printf("       lifer   -o arrow [--batch-size rows] file(s)|directory\n");
+  printf("       lifer   -o sqlite:FILE             file(s)|directory\n");
+  printf("       lifer   -o json                    file(s)|directory\n");
+  printf("       lifer   -F field,... [-o csv|tsv|txt|xml] file(s)|directory\n");
+  printf("       lifer   --compress gzip|zstd [-o ...] file(s)|directory\n");
+  printf("       lifer   --numeric-flags [-o csv|tsv|txt|xml] file(s)|directory\n");
+  printf("       lifer   --stats [-o ...]           file(s)|directory\n");
+  printf("       lifer   --progress[=secs] [-o ...] file(s)|directory\n");
+  printf("       lifer   --perf [-o ...]            file(s)|directory\n");
+  printf("       lifer   --max-memory size [-o ...] file(s)|directory\n");
+  printf("       lifer   --isolate [--workers n] [--quarantine FILE] [-o csv|tsv|txt|xml|json]\n");
+  printf("                                          file(s)|directory\n");
+  printf("       lifer   --serve socket [--workers n] [-s] [-i] [-F ...]\n\n");
   printf("Options:\n");
   printf("  -v    print version number\n");
   printf("  -h    print this help\n");
   printf("  -s    shortened output (default is to output all fields)\n");
-  printf("  -o    output type (choose from csv, tsv, txt or xml). \n");
-  printf("        The default is txt.\n");
-  printf("  -i    print idlist information (only with output type: 'txt' or 'xml')\n\n");
+  printf("  -o    output type (choose from csv, tsv, txt, xml, timeline or arrow). \n");
+  printf("        The default is txt. A timeline lists every time stamp of every\n");
+  printf("        link file in time order. Arrow is a typed, binary Apache Arrow IPC\n");
+  printf("        stream for loading straight into pandas, DuckDB etc.\n");
+  printf("        'sqlite:FILE' adds the link files to the SQLite database FILE.\n");
+  printf("        'json' writes each link file as a line of JSON, as it is read.\n");
+  printf("  -i    print idlist information (only with output type: 'txt' or 'xml')\n");
+  printf("  -F    output only the named fields, in the order given ('-F list' shows\n");
+  printf("        the field names), e.g. -F file.name,hdr.crtime,li.lbp\n");
+  printf("  -w, --where filter\n");
+  printf("        output only the link files that match the filter ('--where list'\n");
+  printf("        shows the field names), e.g.\n");
+  printf("        --where \"li.volid.drivetype == DRIVE_REMOVABLE && hdr.wttime >= '2017-01-01'\"\n");
+  printf("  --batch-size rows\n");
+  printf("        the number of rows in each Arrow record batch (default %i)\n", AIPC_ROWS);
+  printf("  --compress gzip|zstd\n");
+  printf("        compress the output, in blocks on all processors at once\n");
+  printf("  --numeric-flags\n");
+  printf("        print the header flags & file attributes as bit masks only,\n");
+  printf("        without their names\n");
+  printf("  --stats\n");
+  printf("        print how long each stage of reading the link files took and\n");
+  printf("        counts of the files & errors (as a table and as JSON) to\n");
+  printf("        standard error at the end\n");
+  printf("  --progress[=secs]\n");
+  printf("        print the files done (of how many), files & MB per second, errors\n");
+  printf("        and the time left to standard error every 'secs' seconds (default\n");
+  printf("        1 on a terminal, 10 if not)\n");
+  printf("  --perf\n");
+  printf("        count the CPU cycles, instructions, cache & branch misses per\n");
+  printf("        file while decoding and while formatting the link files and print\n");
+  printf("        them, with the instructions per cycle, to standard error at the\n");
+  printf("        end (Linux only)\n");
+  printf("  --max-memory size\n");
+  printf("        keep lifer's buffers (the timeline, Arrow batches, XML output\n");
+  printf("        buffer and compressor) within size bytes (e.g. 64M, 1G) by using\n");
+  printf("        smaller buffers and fewer compressor threads\n");
+  printf("  --serve socket\n");
+  printf("        run as a daemon answering requests on the UNIX socket 'socket',\n");
+  printf("        each a line of 'FORMAT PATH' or 'FORMAT base64:DATA' (FORMAT is csv,\n");
+  printf("        tsv, txt, xml or json), with the link file rendered (Linux only)\n");
+  printf("  --isolate\n");
+  printf("        render the link files in worker processes, so one that crashes\n");
+  printf("        (or hangs) lifer is reported and the rest are still output, in\n");
+  printf("        the same order (not in Windows)\n");
+  printf("  --quarantine FILE\n");
+  printf("        with '--isolate', add the link files a worker died over to FILE\n");
+  printf("  --workers n\n");
+  printf("        the number of worker processes (default one per processor)\n\n");
   printf("Output is to standard output, therefore to send to a file, use the\n");
   printf("redirection operator '>'.\n\n");
   printf("Example:\n  lifer -o csv {DIRECTORY} > Links.csv\n\n");
@@ -89,588 +207,1355 @@ void help_message()
 
 
 //
-//Function: replace_comma(unsigned char * str, int len)
-//          Takes a zero terminated string 'str' of length 'len' max
-//          and substitutes semi-colons for commas.
-//          Return value is the number of substitutions.
-//          This function is useful for CSV output so that strings don't mess 
-//          up the formatting
-int replace_comma(unsigned char * str, uint16_t len)
+//Function: csv_scan(const unsigned char * str) returns the offset of the first
+//          character in the zero terminated string 'str' that needs a CSV field
+//          to be quoted (',', '"', CR or LF) or of the terminating zero.
+#ifdef CSV_SSE2
+size_t csv_scan(const unsigned char * str)
 {
-  int result = 0, i;
-  for (i = 0; (i < len); i++)
+  const __m128i comma = _mm_set1_epi8(','), quote = _mm_set1_epi8('"');
+  const __m128i cr = _mm_set1_epi8('\r'), lf = _mm_set1_epi8('\n');
+  const __m128i nul = _mm_setzero_si128();
+  const unsigned char * p;
+  __m128i v;
+  unsigned int hits;
+  size_t n;
+
+  // Aligned loads never cross into the next page so it is safe to read a
+  // little past the end of the string, the first block is shifted so any
+  // bytes before 'str' are ignored
+  p = (const unsigned char *)((uintptr_t)str & ~(uintptr_t)15);
+  v = _mm_load_si128((const __m128i *)p);
+  hits = (unsigned int)_mm_movemask_epi8(_mm_or_si128(
+    _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+    _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)),
+      _mm_cmpeq_epi8(v, nul)))) >> (str - p);
+  n = 0;
+  while (hits == 0)
   {
-    if (str[i] == ',')
-    {
-      str[i] = ';';
-      result++;
-    }
+    p += 16;
+    n = p - str;
+    v = _mm_load_si128((const __m128i *)p);
+    hits = (unsigned int)_mm_movemask_epi8(_mm_or_si128(
+      _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+      _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)),
+        _mm_cmpeq_epi8(v, nul))));
+  }
+  while ((hits & 1) == 0)
+  {
+    hits >>= 1;
+    n++;
   }
-  return result;
+  return n;
 }
+#else
+size_t csv_scan(const unsigned char * str)
+{
+  return strcspn((const char *)str, ",\"\r\n");
+}
+#endif
 
 //
-//Function: sv_out(FILE * fp) processes the link file and outputs the csv or tsv
-//          version of the decoded data.
-void sv_out(FILE* fp, char* fname, int less, char sep)
+//Function: sv_field(const unsigned char * str, char sep) prints the string
+//          'str' as one CSV or TSV field followed by the separator 'sep'.
+//          CSV fields containing a comma, double quote, CR or LF are put in
+//          double quotes with any double quotes doubled (RFC 4180), all
+//          other fields are copied straight through.
+void sv_field(const unsigned char * str, char sep)
 {
-  struct LIF   lif;
-  struct LIF_A lif_a;
-  struct stat statbuf;
-  char buf[40];
-  int  i, j;
+  size_t n;
 
-
-  // Get the stat info for the file itself
-  stat(fname, &statbuf);
-
-  if (get_lif(fp, statbuf.st_size, &lif) < 0)
+  if (output_type != csv)
   {
-    fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
+    fputs((const char *)str, stdout);
+    putchar(sep);
     return;
   }
-  if (get_lif_a(&lif, &lif_a))
+  n = csv_scan(str);
+  if (str[n] == '\0')
   {
-    fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
+    fwrite(str, 1, n, stdout);
+    putchar(sep);
     return;
   }
-  //Now print the header if needed
-  if (filecount == 0)
+  putchar('"');
+  fwrite(str, 1, n, stdout);
+  for (str += n; *str != '\0'; str++)
   {
-    printf("File Name%c", sep);
-    if (less == 0)
+    if (*str == '"')
     {
-      printf("Link File Size%c", sep);
+      putchar('"');
     }
-    printf("Link File Last Accessed%cLink File Last Modified%c", sep, sep);
-    printf("Link File Last Changed%c", sep);
-    if (less == 0)
-    {
-      printf("Hdr Size%cHdr CLSID%cHdr Flags%c", sep, sep, sep);
-    }
-    printf("Hdr Attributes%c", sep);
-    printf("Hdr FileCreate%cHdr FileAccess%c", sep, sep);
-    printf("Hdr FileWrite%c", sep);
-    printf("Hdr TargetSize%c", sep);
-    if (less == 0)
-    {
-      printf("Hdr IconIndex%cHdr WindowState%cHdr HotKeys%c", sep, sep, sep);
-      printf("Hdr Reserved1%cHdr Reserved2%cHdr Reserved3%c", sep, sep, sep);
-      printf("IDList Size%c", sep);
-      printf("IDList No Items%c", sep);
-      printf("LinkInfo Size%c", sep);
-      printf("LinkInfo Hdr Size%c", sep);
-      printf("LinkInfo Flags%c", sep);
-      printf("LinkInfo VolID Offset%c", sep);
-      printf("LinkInfo Base Path Offset%c", sep);
-      printf("LinkInfo CNR Offset%c", sep);
-      printf("LinkInfo CPS Offset%c", sep);
-      printf("LinkInfo LBP Offset Unicode%c", sep);
-      printf("LinkInfo CPS Offset Unicode%c", sep);
-      printf("LinkInfo VolID Size%c", sep);
-    }
-    printf("LinkInfo VolID Drive Type%c", sep);
-    printf("LinkInfo VolID Drive Ser No%c", sep);
-    if (less == 0)
+    putchar(*str);
+  }
+  putchar('"');
+  putchar(sep);
+}
+
+//
+//Column projection ('-F'): every column that sv_out() can print has an entry
+//in the columns[] table below. The requested keys are looked up once by
+//build_plan() and each record then just runs through the plan, which also
+//supplies the section decode mask so unwanted sections are never parsed.
+struct REC // What a column value can be made from
+{
+  char *            fname;
+  struct stat *     st;
+  struct LIF *      lif;
+  struct LIF_A *    lif_a;
+  unsigned char     buf[300]; // Scratch space for formatted values
+};
+
+struct COLUMN
+{
+  const char *      key;      // The name used with '-F'
+  const char *      header;   // The CSV/TSV header (as in the full output)
+  uint32_t          sections; // LIF_SEC_* sections the value needs
+  unsigned char *   (*value)(struct REC *, const struct COLUMN *);
+  size_t            offset;   // Offset of the string in struct LIF_A (col_lif_a)
+};
+
+unsigned char * col_lif_a(struct REC *, const struct COLUMN *);
+unsigned char * col_fname(struct REC *, const struct COLUMN *);
+unsigned char * col_fsize(struct REC *, const struct COLUMN *);
+unsigned char * col_stime(struct REC *, const struct COLUMN *);
+unsigned char * col_colors(struct REC *, const struct COLUMN *);
+
+#define COL_A(k, h, s, m)  { k, h, s, col_lif_a, offsetof(struct LIF_A, m) }
+#define COL_F(k, h, s, f, o) { k, h, s, f, o }
+#define SEC_HDR   LIF_SEC_HDR
+#define SEC_LI    LIF_SEC_LINKINFO
+#define SEC_SD    LIF_SEC_STRINGDATA
+
+static const struct COLUMN columns[] =
+{
+  COL_F("file.name", "File Name", 0, col_fname, 0),
+  COL_F("file.size", "Link File Size", 0, col_fsize, 0),
+  COL_F("file.atime", "Link File Last Accessed", 0, col_stime, 0),
+  COL_F("file.mtime", "Link File Last Modified", 0, col_stime, 1),
+  COL_F("file.ctime", "Link File Last Changed", 0, col_stime, 2),
+  COL_A("hdr.size", "Hdr Size", SEC_HDR, lha.H_size),
+  COL_A("hdr.clsid", "Hdr CLSID", SEC_HDR, lha.CLSID),
+  COL_A("hdr.flags", "Hdr Flags", SEC_HDR, lha.Flags),
+  COL_A("hdr.attr", "Hdr Attributes", SEC_HDR, lha.Attr),
+  COL_A("hdr.crtime", "Hdr FileCreate", SEC_HDR, lha.CrDate_long),
+  COL_A("hdr.actime", "Hdr FileAccess", SEC_HDR, lha.AcDate_long),
+  COL_A("hdr.wttime", "Hdr FileWrite", SEC_HDR, lha.WtDate_long),
+  COL_A("hdr.crtime.short", "Hdr FileCreate", SEC_HDR, lha.CrDate),
+  COL_A("hdr.actime.short", "Hdr FileAccess", SEC_HDR, lha.AcDate),
+  COL_A("hdr.wttime.short", "Hdr FileWrite", SEC_HDR, lha.WtDate),
+  COL_A("hdr.targetsize", "Hdr TargetSize", SEC_HDR, lha.Size),
+  COL_A("hdr.iconindex", "Hdr IconIndex", SEC_HDR, lha.IconIndex),
+  COL_A("hdr.showstate", "Hdr WindowState", SEC_HDR, lha.ShowState),
+  COL_A("hdr.hotkey", "Hdr HotKeys", SEC_HDR, lha.Hotkey),
+  COL_A("hdr.reserved1", "Hdr Reserved1", SEC_HDR, lha.Reserved1),
+  COL_A("hdr.reserved2", "Hdr Reserved2", SEC_HDR, lha.Reserved2),
+  COL_A("hdr.reserved3", "Hdr Reserved3", SEC_HDR, lha.Reserved3),
+  COL_A("idlist.size", "IDList Size", SEC_HDR, lidla.IDListSize),
+  COL_A("idlist.numitems", "IDList No Items", LIF_SEC_IDLIST, lidla.NumItemIDs),
+  COL_A("li.size", "LinkInfo Size", SEC_LI, lia.Size),
+  COL_A("li.hdrsize", "LinkInfo Hdr Size", SEC_LI, lia.HeaderSize),
+  COL_A("li.flags", "LinkInfo Flags", SEC_LI, lia.Flags),
+  COL_A("li.volidoffset", "LinkInfo VolID Offset", SEC_LI, lia.IDOffset),
+  COL_A("li.lbpoffset", "LinkInfo Base Path Offset", SEC_LI, lia.LBPOffset),
+  COL_A("li.cnroffset", "LinkInfo CNR Offset", SEC_LI, lia.CNRLOffset),
+  COL_A("li.cpsoffset", "LinkInfo CPS Offset", SEC_LI, lia.CPSOffset),
+  COL_A("li.lbpoffsetu", "LinkInfo LBP Offset Unicode", SEC_LI, lia.LBPOffsetU),
+  COL_A("li.cpsoffsetu", "LinkInfo CPS Offset Unicode", SEC_LI, lia.CPSOffsetU),
+  COL_A("li.volid.size", "LinkInfo VolID Size", SEC_LI, lia.VolID.Size),
+  COL_A("li.volid.drivetype", "LinkInfo VolID Drive Type", SEC_LI, lia.VolID.DriveType),
+  COL_A("li.volid.drivesn", "LinkInfo VolID Drive Ser No", SEC_LI, lia.VolID.DriveSN),
+  COL_A("li.volid.vloffset", "LinkInfo VolID VLOffset", SEC_LI, lia.VolID.VLOffset),
+  COL_A("li.volid.vloffsetu", "LinkInfo VolID VLOffsetU", SEC_LI, lia.VolID.VLOffsetU),
+  COL_A("li.volid.label", "LinkInfo VolID Vol Label", SEC_LI, lia.VolID.VolumeLabel),
+  COL_A("li.volid.labelu", "LinkInfo VolID Vol LabelU", SEC_LI, lia.VolID.VolumeLabelU),
+  COL_A("li.lbp", "LinkInfo Local Base Path", SEC_LI, lia.LBP),
+  COL_A("li.cnr.size", "LinkInfo CNR Size", SEC_LI, lia.CNR.Size),
+  COL_A("li.cnr.flags", "LinkInfo CNR Flags", SEC_LI, lia.CNR.Flags),
+  COL_A("li.cnr.netnameoffset", "LinkInfo CNR NetNameOffset", SEC_LI, lia.CNR.NetNameOffset),
+  COL_A("li.cnr.devicenameoffset", "LinkInfo CNR DeviceNameOffset", SEC_LI, lia.CNR.DeviceNameOffset),
+  COL_A("li.cnr.providertype", "LinkInfo CNR NetwkProviderType", SEC_LI, lia.CNR.NetworkProviderType),
+  COL_A("li.cnr.netnameoffsetu", "LinkInfo CNR NetNameOffsetU", SEC_LI, lia.CNR.NetNameOffsetU),
+  COL_A("li.cnr.devicenameoffsetu", "LinkInfo CNR DeviceNameOffsetU", SEC_LI, lia.CNR.DeviceNameOffsetU),
+  COL_A("li.cnr.netname", "LinkInfo CNR NetName", SEC_LI, lia.CNR.NetName),
+  COL_A("li.cnr.devicename", "LinkInfo CNR DeviceName", SEC_LI, lia.CNR.DeviceName),
+  COL_A("li.cnr.netnameu", "LinkInfo CNR NetNameU", SEC_LI, lia.CNR.NetNameU),
+  COL_A("li.cnr.devicenameu", "LinkInfo CNR DeviceNameU", SEC_LI, lia.CNR.DeviceNameU),
+  COL_A("li.cps", "LinkInfo Common Path Suffix", SEC_LI, lia.CPS),
+  COL_A("li.lbpu", "LinkInfo Local Base Path Unicode", SEC_LI, lia.LBPU),
+  COL_A("li.cpsu", "LinkInfo Common Path Suffix Unicode", SEC_LI, lia.CPSU),
+  COL_A("sd.size", "StrData Total Size (bytes)", SEC_HDR, lsda.Size),
+  COL_A("sd.name.chars", "StrData Name Num Chars", SEC_HDR, lsda.CountChars[0]),
+  COL_A("sd.name", "StrData - Name", SEC_SD, lsda.Data[0]),
+  COL_A("sd.relpath.chars", "StrData Rel Path Num Chars", SEC_HDR, lsda.CountChars[1]),
+  COL_A("sd.relpath", "StrData Relative Path", SEC_SD, lsda.Data[1]),
+  COL_A("sd.workdir.chars", "StrData Working Dir Num Chars", SEC_HDR, lsda.CountChars[2]),
+  COL_A("sd.workdir", "StrData Working Dir", SEC_SD, lsda.Data[2]),
+  COL_A("sd.args.chars", "StrData Cmd Line Args Num Chars", SEC_HDR, lsda.CountChars[3]),
+  COL_A("sd.args", "StrData Cmd Line Args", SEC_SD, lsda.Data[3]),
+  COL_A("sd.icon.chars", "StrData Icon Loc Num Chars", SEC_HDR, lsda.CountChars[4]),
+  COL_A("sd.icon", "StrData Icon Location", SEC_SD, lsda.Data[4]),
+  COL_A("ed.size", "ExtraData Total Size (bytes)", SEC_HDR, leda.Size),
+  COL_A("ed.types", "ExtraData Structures", SEC_HDR, leda.edtypes),
+  COL_A("ed.console.posn", "ED CDB File Offset (bytes)", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.Posn),
+  COL_A("ed.console.size", "ED CDB Size (bytes)", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.Size),
+  COL_A("ed.console.sig", "ED CDB Signature", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.sig),
+  COL_A("ed.console.fillattr", "ED CDB FillAttributes", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FillAttributes),
+  COL_A("ed.console.popupfillattr", "ED CDB PopupFillAttr", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.PopupFillAttributes),
+  COL_A("ed.console.scrbufsizex", "ED CDB ScrBufSizeX", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.ScreenBufferSizeX),
+  COL_A("ed.console.scrbufsizey", "ED CDB ScrBufSizeY", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.ScreenBufferSizeY),
+  COL_A("ed.console.windowsizex", "ED CDB WindowSizeX", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.WindowSizeX),
+  COL_A("ed.console.windowsizey", "ED CDB WindowSizeY", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.WindowSizeY),
+  COL_A("ed.console.windoworiginx", "ED CDB WindowOriginX", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.WindowOriginX),
+  COL_A("ed.console.windoworiginy", "ED CDB WindowOriginY", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.WindowOriginY),
+  COL_A("ed.console.unused1", "ED CDB Unused1", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.Unused1),
+  COL_A("ed.console.unused2", "ED CDB Unused2", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.Unused2),
+  COL_A("ed.console.fontheight", "ED CDB FontHeight", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FontHeight),
+  COL_A("ed.console.fontwidth", "ED CDB FontWidth", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FontWidth),
+  COL_A("ed.console.fontfamily", "ED CDB FontFamily", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FontFamily),
+  COL_A("ed.console.fontpitch", "ED CDB FontPitch", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FontPitch),
+  COL_A("ed.console.fontweight", "ED CDB FontWeight", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FontWeight),
+  COL_A("ed.console.facename", "ED CDB FaceName", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FaceName),
+  COL_A("ed.console.cursorsize", "ED CDB CursorSize", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.CursorSize),
+  COL_A("ed.console.fullscreen", "ED CDB FullScreen", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.FullScreen),
+  COL_A("ed.console.quickedit", "ED CDB QuickEdit", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.QuickEdit),
+  COL_A("ed.console.insertmode", "ED CDB InsertMode", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.InsertMode),
+  COL_A("ed.console.autoposition", "ED CDB AutoPosition", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.AutoPosition),
+  COL_A("ed.console.historybufsize", "ED CDB HistoryBufSize", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.HistoryBufferSize),
+  COL_A("ed.console.numhistorybuf", "ED CDB NumHistoryBuf", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.NumberOfHistoryBuffers),
+  COL_A("ed.console.historynodup", "ED CDB HistoryNoDup", LIF_SEC_ED(CONSOLE_PROPS), leda.lcpa.HistoryNoDup),
+  COL_F("ed.console.colortable", "ED CDB ColorTable", LIF_SEC_ED(CONSOLE_PROPS), col_colors, 0),
+  COL_A("ed.consolefe.posn", "ED CFEDB File Offset (bytes)", LIF_SEC_ED(CONSOLE_FE_PROPS), leda.lcfepa.Posn),
+  COL_A("ed.consolefe.size", "ED CFEDB Size (bytes)", LIF_SEC_ED(CONSOLE_FE_PROPS), leda.lcfepa.Size),
+  COL_A("ed.consolefe.sig", "ED CFEDB Signature", LIF_SEC_ED(CONSOLE_FE_PROPS), leda.lcfepa.sig),
+  COL_A("ed.consolefe.codepage", "ED CFEDB CodePage", LIF_SEC_ED(CONSOLE_FE_PROPS), leda.lcfepa.CodePage),
+  COL_A("ed.darwin.posn", "ED DDB File Offset (bytes)", LIF_SEC_ED(DARWIN_PROPS), leda.ldpa.Posn),
+  COL_A("ed.darwin.size", "ED DDB Size (bytes)", LIF_SEC_ED(DARWIN_PROPS), leda.ldpa.Size),
+  COL_A("ed.darwin.sig", "ED DDB Signature", LIF_SEC_ED(DARWIN_PROPS), leda.ldpa.sig),
+  COL_A("ed.darwin.ansi", "ED DDB DarwinDataAnsi", LIF_SEC_ED(DARWIN_PROPS), leda.ldpa.DarwinDataAnsi),
+  COL_A("ed.darwin.unicode", "ED DDB DarwinDataUnicode", LIF_SEC_ED(DARWIN_PROPS), leda.ldpa.DarwinDataUnicode),
+  COL_A("ed.env.posn", "ED EVDB File Offset (bytes)", LIF_SEC_ED(ENVIRONMENT_PROPS), leda.lepa.Posn),
+  COL_A("ed.env.size", "ED EVDB Size (bytes)", LIF_SEC_ED(ENVIRONMENT_PROPS), leda.lepa.Size),
+  COL_A("ed.env.sig", "ED EVDB Signature", LIF_SEC_ED(ENVIRONMENT_PROPS), leda.lepa.sig),
+  COL_A("ed.env.ansi", "ED EVDB TargetAnsi", LIF_SEC_ED(ENVIRONMENT_PROPS), leda.lepa.TargetAnsi),
+  COL_A("ed.env.unicode", "ED EVDB TargetUnicode", LIF_SEC_ED(ENVIRONMENT_PROPS), leda.lepa.TargetUnicode),
+  COL_A("ed.iconenv.posn", "ED IEDB File Offset (bytes)", LIF_SEC_ED(ICON_ENVIRONMENT_PROPS), leda.liepa.Posn),
+  COL_A("ed.iconenv.size", "ED IEDB Size (bytes)", LIF_SEC_ED(ICON_ENVIRONMENT_PROPS), leda.liepa.Size),
+  COL_A("ed.iconenv.sig", "ED IEDB Signature", LIF_SEC_ED(ICON_ENVIRONMENT_PROPS), leda.liepa.sig),
+  COL_A("ed.iconenv.ansi", "ED IEDB TargetAnsi", LIF_SEC_ED(ICON_ENVIRONMENT_PROPS), leda.liepa.TargetAnsi),
+  COL_A("ed.iconenv.unicode", "ED IEDB TargetUnicode", LIF_SEC_ED(ICON_ENVIRONMENT_PROPS), leda.liepa.TargetUnicode),
+  COL_A("ed.knownfolder.posn", "ED KFDB File Offset (bytes)", LIF_SEC_ED(KNOWN_FOLDER_PROPS), leda.lkfpa.Posn),
+  COL_A("ed.knownfolder.size", "ED KFDB Size (bytes)", LIF_SEC_ED(KNOWN_FOLDER_PROPS), leda.lkfpa.Size),
+  COL_A("ed.knownfolder.sig", "ED KFDB Signature", LIF_SEC_ED(KNOWN_FOLDER_PROPS), leda.lkfpa.sig),
+  COL_A("ed.knownfolder.id", "ED KFDB KnownFolderID", LIF_SEC_ED(KNOWN_FOLDER_PROPS), leda.lkfpa.KFGUID.UUID),
+  COL_A("ed.knownfolder.name", "ED KFDB KnownFolderName", LIF_SEC_ED(KNOWN_FOLDER_PROPS), leda.lkfpa.KFGUID.Name),
+  COL_A("ed.knownfolder.offset", "ED KFDB Offset", LIF_SEC_ED(KNOWN_FOLDER_PROPS), leda.lkfpa.KFOffset),
+  COL_A("ed.propstore.posn", "ED PS File Offset (bytes)", LIF_SEC_ED(PROPERTY_STORE_PROPS), leda.lpspa.Posn),
+  COL_A("ed.propstore.size", "ED PS Size (bytes)", LIF_SEC_ED(PROPERTY_STORE_PROPS), leda.lpspa.Size),
+  COL_A("ed.propstore.sig", "ED PS Signature", LIF_SEC_ED(PROPERTY_STORE_PROPS), leda.lpspa.sig),
+  COL_A("ed.propstore.numstores", "ED PS Number of Stores ", LIF_SEC_ED(PROPERTY_STORE_PROPS), leda.lpspa.NumStores),
+  COL_A("ed.specialfolder.posn", "ED SFolderData File Offset (bytes)", LIF_SEC_ED(SPECIAL_FOLDER_PROPS), leda.lsfpa.Posn),
+  COL_A("ed.specialfolder.size", "ED SFolderData Size (bytes)", LIF_SEC_ED(SPECIAL_FOLDER_PROPS), leda.lsfpa.Size),
+  COL_A("ed.specialfolder.sig", "ED SFolderData Signature", LIF_SEC_ED(SPECIAL_FOLDER_PROPS), leda.lsfpa.sig),
+  COL_A("ed.specialfolder.id", "ED SFolderData ID", LIF_SEC_ED(SPECIAL_FOLDER_PROPS), leda.lsfpa.SpecialFolderID),
+  COL_A("ed.specialfolder.offset", "ED SFolderData Offset", LIF_SEC_ED(SPECIAL_FOLDER_PROPS), leda.lsfpa.Offset),
+  COL_A("ed.tracker.posn", "ED TrackerData File Offset (bytes)", LIF_SEC_TRACKER, leda.ltpa.Posn),
+  COL_A("ed.tracker.size", "ED TrackerData Size (bytes)", LIF_SEC_TRACKER, leda.ltpa.Size),
+  COL_A("ed.tracker.sig", "ED TrackerData Signature", LIF_SEC_TRACKER, leda.ltpa.sig),
+  COL_A("ed.tracker.length", "ED TrackerData Length", LIF_SEC_TRACKER, leda.ltpa.Length),
+  COL_A("ed.tracker.version", "ED TrackerData Version", LIF_SEC_TRACKER, leda.ltpa.Version),
+  COL_A("ed.tracker.machineid", "ED TrackerData MachineID", LIF_SEC_TRACKER, leda.ltpa.MachineID),
+  COL_A("ed.tracker.droid1", "ED TrackerData Droid1", LIF_SEC_TRACKER, leda.ltpa.Droid1.UUID),
+  COL_A("ed.tracker.droid1.version", "ED TD Droid1 Version", LIF_SEC_TRACKER, leda.ltpa.Droid1.Version),
+  COL_A("ed.tracker.droid1.variant", "ED TD Droid1 Variant", LIF_SEC_TRACKER, leda.ltpa.Droid1.Variant),
+  COL_A("ed.tracker.droid1.time", "ED TD Droid1 Time", LIF_SEC_TRACKER, leda.ltpa.Droid1.Time_long),
+  COL_A("ed.tracker.droid1.time.short", "ED TD Droid1 Time", LIF_SEC_TRACKER, leda.ltpa.Droid1.Time),
+  COL_A("ed.tracker.droid1.clockseq", "ED TD Droid1 Clock Seq", LIF_SEC_TRACKER, leda.ltpa.Droid1.ClockSeq),
+  COL_A("ed.tracker.droid1.node", "ED TD Droid1 Node", LIF_SEC_TRACKER, leda.ltpa.Droid1.Node),
+  COL_A("ed.tracker.droid2", "ED TrackerData Droid2", LIF_SEC_TRACKER, leda.ltpa.Droid2.UUID),
+  COL_A("ed.tracker.droid2.version", "ED TD Droid2 Version", LIF_SEC_TRACKER, leda.ltpa.Droid2.Version),
+  COL_A("ed.tracker.droid2.variant", "ED TD Droid2 Variant", LIF_SEC_TRACKER, leda.ltpa.Droid2.Variant),
+  COL_A("ed.tracker.droid2.time", "ED TD Droid2 Time", LIF_SEC_TRACKER, leda.ltpa.Droid2.Time_long),
+  COL_A("ed.tracker.droid2.time.short", "ED TD Droid2 Time", LIF_SEC_TRACKER, leda.ltpa.Droid2.Time),
+  COL_A("ed.tracker.droid2.clockseq", "ED TD Droid2 Clock Seq", LIF_SEC_TRACKER, leda.ltpa.Droid2.ClockSeq),
+  COL_A("ed.tracker.droid2.node", "ED TD Droid2 Node", LIF_SEC_TRACKER, leda.ltpa.Droid2.Node),
+  COL_A("ed.tracker.birth1", "ED TrackerData DroidBirth1", LIF_SEC_TRACKER, leda.ltpa.DroidBirth1.UUID),
+  COL_A("ed.tracker.birth1.version", "ED TD DroidBirth1 Version", LIF_SEC_TRACKER, leda.ltpa.DroidBirth1.Version),
+  COL_A("ed.tracker.birth1.variant", "ED TD DroidBirth1 Variant", LIF_SEC_TRACKER, leda.ltpa.DroidBirth1.Variant),
+  COL_A("ed.tracker.birth1.time", "ED TD DroidBirth1 Time", LIF_SEC_TRACKER, leda.ltpa.DroidBirth1.Time_long),
+  COL_A("ed.tracker.birth1.time.short", "ED TD DroidBirth1 Time", LIF_SEC_TRACKER, leda.ltpa.DroidBirth1.Time),
+  COL_A("ed.tracker.birth1.clockseq", "ED TD DroidBirth1 Clock Seq", LIF_SEC_TRACKER, leda.ltpa.DroidBirth1.ClockSeq),
+  COL_A("ed.tracker.birth1.node", "ED TD DroidBirth1 Node", LIF_SEC_TRACKER, leda.ltpa.DroidBirth1.Node),
+  COL_A("ed.tracker.birth2", "ED TrackerData DroidBirth2", LIF_SEC_TRACKER, leda.ltpa.DroidBirth2.UUID),
+  COL_A("ed.tracker.birth2.version", "ED TD DroidBirth2 Version", LIF_SEC_TRACKER, leda.ltpa.DroidBirth2.Version),
+  COL_A("ed.tracker.birth2.variant", "ED TD DroidBirth2 Variant", LIF_SEC_TRACKER, leda.ltpa.DroidBirth2.Variant),
+  COL_A("ed.tracker.birth2.time", "ED TD DroidBirth2 Time", LIF_SEC_TRACKER, leda.ltpa.DroidBirth2.Time_long),
+  COL_A("ed.tracker.birth2.time.short", "ED TD DroidBirth2 Time", LIF_SEC_TRACKER, leda.ltpa.DroidBirth2.Time),
+  COL_A("ed.tracker.birth2.clockseq", "ED TD DroidBirth2 Clock Seq", LIF_SEC_TRACKER, leda.ltpa.DroidBirth2.ClockSeq),
+  COL_A("ed.tracker.birth2.node", "ED TD DroidBirth2 Node", LIF_SEC_TRACKER, leda.ltpa.DroidBirth2.Node),
+  COL_A("ed.vista.posn", "ED >= Vista IDList File Offset (bytes)", LIF_SEC_ED(VISTA_AND_ABOVE_IDLIST_PROPS), leda.lvidlpa.Posn),
+  COL_A("ed.vista.size", "ED >= Vista IDList Size", LIF_SEC_ED(VISTA_AND_ABOVE_IDLIST_PROPS), leda.lvidlpa.Size),
+  COL_A("ed.vista.sig", "ED >= Vista IDList Signature", LIF_SEC_ED(VISTA_AND_ABOVE_IDLIST_PROPS), leda.lvidlpa.sig),
+  COL_A("ed.vista.numitems", "ED >= Vista IDList Num Items", LIF_SEC_ED(VISTA_AND_ABOVE_IDLIST_PROPS), leda.lvidlpa.NumItemIDs)
+};
+#define NUMCOLUMNS (sizeof(columns) / sizeof(columns[0]))
+
+const struct COLUMN * plan[NUMCOLUMNS]; // The columns chosen with '-F' in order
+int                   plan_len = 0;
+uint32_t              plan_mask = 0;    // The sections that the plan needs
+
+//
+//Function: build_plan() turns the comma separated list of keys given with
+//'-F' into the output plan. Returns 0 on success, -1 (having said why) if a
+//key is not known.
+int build_plan(char * keys)
+{
+  char          *key;
+  unsigned int  i;
+
+  plan_len = 0;
+  plan_mask = LIF_SEC_HDR;
+  for (key = strtok(keys, ","); key != NULL; key = strtok(NULL, ","))
+  {
+    for (i = 0; i < NUMCOLUMNS; i++)
     {
-      printf("LinkInfo VolID VLOffset%c", sep);
-      printf("LinkInfo VolID VLOffsetU%c", sep);
+      if (strcmp(key, columns[i].key) == 0)
+      {
+        break;
+      }
     }
-    printf("LinkInfo VolID Vol Label%c", sep);
-    printf("LinkInfo VolID Vol LabelU%c", sep);
-    printf("LinkInfo Local Base Path%c", sep);
-    if (less == 0)
+    if (i == NUMCOLUMNS)
     {
-      printf("LinkInfo CNR Size%c", sep);
-      printf("LinkInfo CNR Flags%c", sep);
-      printf("LinkInfo CNR NetNameOffset%c", sep);
-      printf("LinkInfo CNR DeviceNameOffset%c", sep);
+      fprintf(stderr, "Unknown field \'%s\' (use \'-F list\' to see the fields)\n", key);
+      return -1;
     }
-    printf("LinkInfo CNR NetwkProviderType%c", sep);
-    if (less == 0)
+    if (plan_len < (int)NUMCOLUMNS)
     {
-      printf("LinkInfo CNR NetNameOffsetU%c", sep);
-      printf("LinkInfo CNR DeviceNameOffsetU%c", sep);
+      plan[plan_len++] = &columns[i];
+      plan_mask |= columns[i].sections;
     }
-    printf("LinkInfo CNR NetName%c", sep);
-    printf("LinkInfo CNR DeviceName%c", sep);
-    printf("LinkInfo CNR NetNameU%c", sep);
-    printf("LinkInfo CNR DeviceNameU%c", sep);
+  }
+  if (plan_len == 0)
+  {
+    fprintf(stderr, "No fields given with \'-F\'\n");
+    return -1;
+  }
+  return 0;
+}
 
-    printf("LinkInfo Common Path Suffix%c", sep);
-    printf("LinkInfo Local Base Path Unicode%c", sep);
-    printf("LinkInfo Common Path Suffix Unicode%c", sep);
+//
+//Function: list_columns() prints the keys that can be used with '-F'
+void list_columns()
+{
+  unsigned int i;
 
-    if (less == 0)
+  printf("Fields that can be used with '-F' (and their CSV/TSV headers):\n");
+  for (i = 0; i < NUMCOLUMNS; i++)
+  {
+    printf("  %-32s%s\n", columns[i].key, columns[i].header);
+  }
+}
+
+//
+//Column value functions: each returns the column's value as a string
+unsigned char * col_lif_a(struct REC * rec, const struct COLUMN * col)
+{
+  return (unsigned char *)rec->lif_a + col->offset;
+}
+unsigned char * col_fname(struct REC * rec, const struct COLUMN * col)
+{
+  return (unsigned char *)rec->fname;
+}
+unsigned char * col_fsize(struct REC * rec, const struct COLUMN * col)
+{
+  snprintf((char *)rec->buf, 300, "%u", (unsigned int)rec->st->st_size);
+  return rec->buf;
+}
+unsigned char * col_stime(struct REC * rec, const struct COLUMN * col)
+{
+  // The offset picks the time: 0 = accessed, 1 = modified, 2 = changed
+  time_t t = (col->offset == 0) ? rec->st->st_atime : (col->offset == 1) ? rec->st->st_mtime : rec->st->st_ctime;
+
+  strftime((char *)rec->buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&t));
+  return rec->buf;
+}
+unsigned char * col_colors(struct REC * rec, const struct COLUMN * col)
+{
+  int j;
+
+  // 16 consecutive ColorTable entries separated by semi-colons
+  rec->buf[0] = 0;
+  for (j = 0; j < 16; j++)
+  {
+    strcat((char *)rec->buf, (char *)rec->lif_a->leda.lcpa.ColorTable[j]);
+    if (j < 15)
     {
-      printf("StrData Total Size (bytes)%c", sep);
-      printf("StrData Name Num Chars%c", sep);
+      strcat((char *)rec->buf, ";");
     }
-    printf("StrData - Name%c", sep);
-    if (less == 0)
+  }
+  return rec->buf;
+}
+
+//
+//Function: decode_lif() is get_lif_at() for the output functions, for
+//'--stats' it times the decoding and counts the errors by section (and for
+//'--perf' counts the CPU events)
+int decode_lif(FILE* fp, int size, uint32_t mask, struct LIF* lif)
+{
+  int ret;
+
+  st_lap(&stats, ST_PARSE);
+  pmc_lap(PMC_PARSE);
+  if ((ret = get_lif_at(fp, 0, size, mask, lif)) < 0)
+  {
+    stats.ParseErrors[-ret - 1]++;
+    PG_ADD(Errors, 1);
+  }
+  pmc_lap(PMC_FORMAT);
+  st_lap(&stats, ST_OUTPUT);
+  return ret;
+}
+
+//
+//Function: ascii_lif() is get_lif_a_opt() for the output functions, timed
+//for '--stats'
+int ascii_lif(struct LIF* lif, struct LIF_A* lif_a, uint32_t opts)
+{
+  int ret;
+
+  st_lap(&stats, ST_ASCII);
+  if ((ret = get_lif_a_opt(lif, lif_a, opts)) != 0)
+  {
+    stats.AsciiErrors++;
+  }
+  st_lap(&stats, ST_OUTPUT);
+  return ret;
+}
+
+//
+//Function: plan_header() prints the header line of the '-F' columns
+void plan_header(char sep)
+{
+  int i;
+
+  for (i = 0; i < plan_len; i++)
+  {
+    printf("%s%c", plan[i]->header, sep);
+  }
+  printf("\n");
+}
+
+//
+//Function: xml_header() starts the XML document
+void xml_header(void)
+{
+  xw_printf(stdout, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n");
+  xw_printf(stdout, "<!-- lifer, a Windows link file analyser. Version %i.%i.%i -->\n", _MAJOR, _MINOR, _BUILD);
+  xw_printf(stdout, "<LinkFiles>\n");
+}
+
+//
+//Function: plan_out() decodes just the sections needed by the '-F' plan and
+//prints the chosen columns as CSV/TSV (sep), XML or text.
+void plan_out(FILE* fp, char* fname, char sep)
+{
+  struct LIF     lif;
+  struct LIF_A   lif_a;
+  struct stat    statbuf;
+  struct REC     rec;
+  int            i;
+
+  fstat(fileno(fp), &statbuf);
+  if (decode_lif(fp, statbuf.st_size, plan_mask, &lif) < 0)
+  {
+    fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
+    return;
+  }
+  if (ascii_lif(&lif, &lif_a, lif_a_opts))
+  {
+    fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
+    return;
+  }
+  rec.fname = fname;
+  rec.st = &statbuf;
+  rec.lif = &lif;
+  rec.lif_a = &lif_a;
+
+  switch (output_type)
+  {
+  case csv:
+  case tsv:
+    if (filecount == 0)
     {
-      printf("StrData Rel Path Num Chars%c", sep);
+      plan_header(sep);
     }
-    printf("StrData Relative Path%c", sep);
-    if (less == 0)
+    for (i = 0; i < plan_len; i++)
     {
-      printf("StrData Working Dir Num Chars%c", sep);
+      sv_field(plan[i]->value(&rec, plan[i]), sep);
     }
-    printf("StrData Working Dir%c", sep);
-    if (less == 0)
+    printf("\n");
+    break;
+  case xml:
+    if (filecount == 0)
     {
-      printf("StrData Cmd Line Args Num Chars%c", sep);
+      xml_header();
     }
-    printf("StrData Cmd Line Args%c", sep);
-    if (less == 0)
+    xw_printf(stdout, "<LinkFile>\n");
+    for (i = 0; i < plan_len; i++)
     {
-      printf("StrData Icon Loc Num Chars%c", sep);
+      xw_printf(stdout, "<Field Name=\"%s\">%s</Field>\n", plan[i]->key, plan[i]->value(&rec, plan[i]));
     }
-    printf("StrData Icon Location%c", sep);
-    // S2.5 ExtraData structures
-    if (less == 0)
+    xw_printf(stdout, "</LinkFile>\n");
+    break;
+  case txt:
+  default:
+    for (i = 0; i < plan_len; i++)
     {
-      printf("ExtraData Total Size (bytes)%c", sep);
+      printf("%-32s%s\n", plan[i]->key, plan[i]->value(&rec, plan[i]));
     }
-    printf("ExtraData Structures%c", sep);
+    printf("\n");
+  }
+}
 
-    // S2.5.1 ConsoleDataBlock
-    if (less == 0)
+//
+//Function: decode_mask() works out which sections of a link file the chosen
+//output actually prints so that get_lif_at() can step over the rest.
+//None of the short ('-s') outputs print the LinkTargetIDList, the text and
+//separated value ones only need the TrackerDataBlock from the ExtraData
+//(and the presence of the others) but XML shows every block's offset & size.
+uint32_t decode_mask(int less)
+{
+  if (less == 0)
+  {
+    return LIF_SEC_ALL;
+  }
+  if (output_type == xml)
+  {
+    return LIF_SEC_HDR | LIF_SEC_LINKINFO | LIF_SEC_STRINGDATA | LIF_SEC_EXTRADATA;
+  }
+  return LIF_SEC_HDR | LIF_SEC_LINKINFO | LIF_SEC_STRINGDATA | LIF_SEC_TRACKER;
+}
+
+//
+//Function: text_shellitem() prints the typed fields of a decoded shell item
+void text_shellitem(struct LIF_SHELLITEM * shi, struct LIF_SHELLITEM_A * shia, int indent)
+{
+  printf("%*sShell Item Type:   %s [Class %s]\n", indent, "", shia->Type, shia->Class);
+  switch (shi->Type)
+  {
+  case SHI_ROOT_FOLDER:
+    printf("%*sSort Index:        %s\n", indent, "", shia->SortIndex);
+    printf("%*sShell Folder ID:   %s\n", indent, "", shia->FolderID.UUID);
+    printf("%*sShell Folder:      %s\n", indent, "", shia->FolderID.Name);
+    break;
+  case SHI_VOLUME:
+    printf("%*sVolume Name:       %s\n", indent, "", shia->Name);
+    if (shi->FolderID.Data1 != 0)
     {
-      printf("ED CDB File Offset (bytes)%c", sep);
-      printf("ED CDB Size (bytes)%c", sep);
-      printf("ED CDB Signature%c", sep);
-      printf("ED CDB FillAttributes%c", sep);
-      printf("ED CDB PopupFillAttr%c", sep);
-      printf("ED CDB ScrBufSizeX%c", sep);
-      printf("ED CDB ScrBufSizeY%c", sep);
-      printf("ED CDB WindowSizeX%c", sep);
-      printf("ED CDB WindowSizeY%c", sep);
-      printf("ED CDB WindowOriginX%c", sep);
-      printf("ED CDB WindowOriginY%c", sep);
-      printf("ED CDB Unused1%c", sep);
-      printf("ED CDB Unused2%c", sep);
-      printf("ED CDB FontHeight%c", sep);
-      printf("ED CDB FontWidth%c", sep);
-      printf("ED CDB FontFamily%c", sep);
-      printf("ED CDB FontPitch%c", sep);
-      printf("ED CDB FontWeight%c", sep);
-      printf("ED CDB FaceName%c", sep);
-      printf("ED CDB CursorSize%c", sep);
-      printf("ED CDB FullScreen%c", sep);
-      printf("ED CDB QuickEdit%c", sep);
-      printf("ED CDB InsertMode%c", sep);
-      printf("ED CDB AutoPosition%c", sep);
-      printf("ED CDB HistoryBufSize%c", sep);
-      printf("ED CDB NumHistoryBuf%c", sep);
-      printf("ED CDB HistoryNoDup%c", sep);
-      printf("ED CDB ColorTable%c", sep);
-    }
-    // S2.5.2 ConsoleFEDataBlock
-    if (less == 0)
+      printf("%*sShell Folder ID:   %s\n", indent, "", shia->FolderID.UUID);
+      printf("%*sShell Folder:      %s\n", indent, "", shia->FolderID.Name);
+    }
+    break;
+  case SHI_FILE_ENTRY:
+    printf("%*sFile Size:         %s bytes\n", indent, "", shia->FileSize);
+    printf("%*sModified Time:     %s\n", indent, "", shia->ModTime);
+    printf("%*sAttributes:        %s\n", indent, "", shia->FileAttr);
+    printf("%*sPrimary Name:      %s\n", indent, "", shia->Name);
+    if (shi->ExtVersion > 0)
     {
-      printf("ED CFEDB File Offset (bytes)%c", sep);
-      printf("ED CFEDB Size (bytes)%c", sep);
-      printf("ED CFEDB Signature%c", sep);
-      printf("ED CFEDB CodePage%c", sep);
+      printf("%*s{Extension Block 0xBEEF0004}\n", indent, "");
+      printf("%*s  Version:         %s\n", indent, "", shia->ExtVersion);
+      printf("%*s  Creation Time:   %s\n", indent, "", shia->CrTime);
+      printf("%*s  Access Time:     %s\n", indent, "", shia->AcTime);
+      printf("%*s  MFT Entry:       %s\n", indent, "", shia->MFTEntry);
+      printf("%*s  MFT Sequence:    %s\n", indent, "", shia->MFTSeq);
+      printf("%*s  Long Name:       %s\n", indent, "", shia->LongName);
     }
-    // S2.5.3 DarwinDataBlock
-    if (less == 0)
+    break;
+  case SHI_NETWORK:
+    printf("%*sLocation:          %s\n", indent, "", shia->Name);
+    if (shi->Description[0] != 0)
     {
-      printf("ED DDB File Offset (bytes)%c", sep);
-      printf("ED DDB Size (bytes)%c", sep);
-      printf("ED DDB Signature%c", sep);
-      printf("ED DDB DarwinDataAnsi%c", sep);
-      printf("ED DDB DarwinDataUnicode%c", sep);
+      printf("%*sDescription:       %s\n", indent, "", shia->Description);
     }
-    // S2.5.4 EnvironmentVariableDataBlock
-    if (less == 0)
+    if (shi->Comments[0] != 0)
     {
-      printf("ED EVDB File Offset (bytes)%c", sep);
-      printf("ED EVDB Size (bytes)%c", sep);
-      printf("ED EVDB Signature%c", sep);
-      printf("ED EVDB TargetAnsi%c", sep);
-      printf("ED EVDB TargetUnicode%c", sep);
+      printf("%*sComments:          %s\n", indent, "", shia->Comments);
     }
-    // S2.5.5 IconEnvironmentDataBlock
-    if (less == 0)
+    break;
+  case SHI_URI:
+    printf("%*sURI:               %s\n", indent, "", shia->Name);
+    break;
+  default:
+    break;
+  }
+}
+
+//
+//Function: xml_shellitem() prints the typed fields of a decoded shell item
+void xml_shellitem(struct LIF_SHELLITEM * shi, struct LIF_SHELLITEM_A * shia)
+{
+  xw_printf(stdout, "<ShellItem Class=\"%s\" Type=\"%s\">\n", shia->Class, shia->Type);
+  switch (shi->Type)
+  {
+  case SHI_ROOT_FOLDER:
+    xw_printf(stdout, "<SortIndex>%s</SortIndex>\n", shia->SortIndex);
+    xw_printf(stdout, "<ShellFolderID Name=\"%s\">%s</ShellFolderID>\n", shia->FolderID.Name, shia->FolderID.UUID);
+    break;
+  case SHI_VOLUME:
+    xw_printf(stdout, "<VolumeName>%s</VolumeName>\n", shia->Name);
+    if (shi->FolderID.Data1 != 0)
     {
-      printf("ED IEDB File Offset (bytes)%c", sep);
-      printf("ED IEDB Size (bytes)%c", sep);
-      printf("ED IEDB Signature%c", sep);
-      printf("ED IEDB TargetAnsi%c", sep);
-      printf("ED IEDB TargetUnicode%c", sep);
+      xw_printf(stdout, "<ShellFolderID Name=\"%s\">%s</ShellFolderID>\n", shia->FolderID.Name, shia->FolderID.UUID);
     }
-    // S2.5.6 KnownFolderDataBlock
-    if (less == 0)
+    break;
+  case SHI_FILE_ENTRY:
+    xw_printf(stdout, "<FileSize>%s</FileSize>\n", shia->FileSize);
+    xw_printf(stdout, "<ModifiedTime>%s</ModifiedTime>\n", shia->ModTime);
+    xw_printf(stdout, "<Attributes>%s</Attributes>\n", shia->FileAttr);
+    xw_printf(stdout, "<PrimaryName>%s</PrimaryName>\n", shia->Name);
+    if (shi->ExtVersion > 0)
     {
-      printf("ED KFDB File Offset (bytes)%c", sep);
-      printf("ED KFDB Size (bytes)%c", sep);
-      printf("ED KFDB Signature%c", sep);
-      printf("ED KFDB KnownFolderID%c", sep);
-      printf("ED KFDB Offset%c", sep);
+      xw_printf(stdout, "<ExtensionBlock Signature=\"0xBEEF0004\" Version=\"%s\">\n", shia->ExtVersion);
+      xw_printf(stdout, "<CreationTime>%s</CreationTime>\n", shia->CrTime);
+      xw_printf(stdout, "<AccessTime>%s</AccessTime>\n", shia->AcTime);
+      xw_printf(stdout, "<MFTEntry>%s</MFTEntry>\n", shia->MFTEntry);
+      xw_printf(stdout, "<MFTSequence>%s</MFTSequence>\n", shia->MFTSeq);
+      xw_printf(stdout, "<LongName>%s</LongName>\n", shia->LongName);
+      xw_printf(stdout, "</ExtensionBlock>\n");
     }
-    // S2.5.7 PropertyStoreDataBlock
-    if (less == 0)
+    break;
+  case SHI_NETWORK:
+    xw_printf(stdout, "<Location>%s</Location>\n", shia->Name);
+    if (shi->Description[0] != 0)
     {
-      printf("ED PS File Offset (bytes)%c", sep);
-      printf("ED PS Size (bytes)%c", sep);
-      printf("ED PS Signature%c", sep);
-      printf("ED PS Number of Stores %c", sep);
+      xw_printf(stdout, "<Description>%s</Description>\n", shia->Description);
     }
-    // S2.5.9 SpecialFolderDataBlock
-    if (less == 0)
+    if (shi->Comments[0] != 0)
     {
-      printf("ED SFolderData File Offset (bytes)%c", sep);
-      printf("ED SFolderData Size (bytes)%c", sep);
-      printf("ED SFolderData Signature%c", sep);
-      printf("ED SFolderData ID%c", sep);
-      printf("ED SFolderData Offset%c", sep);
+      xw_printf(stdout, "<Comments>%s</Comments>\n", shia->Comments);
     }
-    // S 2.5.10 TrackerDataBlock
-    if (less == 0)
+    break;
+  case SHI_URI:
+    xw_printf(stdout, "<URI>%s</URI>\n", shia->Name);
+    break;
+  default:
+    break;
+  }
+  xw_printf(stdout, "</ShellItem>\n");
+}
+
+//
+//Function: text_itemids() prints 'num' ItemIDs (from the LinkTargetIDList or
+//          a VistaAndAboveIDListDataBlock) in text form, 'indent' is the
+//          number of spaces before each ItemID heading.
+void text_itemids(struct LIF_ITEMID * items, struct LIF_ITEMID_A * items_a, int num, int indent)
+{
+  int            i, j, k;
+  struct LIF_PROPERTY_STORE_PROPS  psp;
+  struct LIF_SER_PROPSTORE_A  psa;
+
+  for (i = 0; i < num; i++)
+  {
+    printf("%*s{ItemID %i}\n", indent, "", i + 1);
+    printf("%*s  ItemID  Size:      %s bytes\n", indent, "", items_a[i].ItemIDSize);
+    if (items[i].Shell.Type != SHI_UNKNOWN)
     {
-      printf("ED TrackerData File Offset (bytes)%c", sep);
-      printf("ED TrackerData Size (bytes)%c", sep);
-      printf("ED TrackerData Signature%c", sep);
-      printf("ED TrackerData Length%c", sep);
-      printf("ED TrackerData Version%c", sep);
+      text_shellitem(&items[i].Shell, &items_a[i].Shell, indent + 2);
     }
-    printf("ED TrackerData MachineID%c", sep);
-    printf("ED TrackerData Droid1%c", sep);
-    if (less == 0)
+    if (find_propstores(items[i].Data, items[i].ItemIDSize - 2, items[i].Posn + 2, &psp) == 0)
     {
-      printf("ED TD Droid1 Version%c", sep);
-      printf("ED TD Droid1 Variant%c", sep);
+      // If PropStoreProps exist:
+      printf("%*s  [Property Stores found within this ItemID]\n", indent, "");
+      printf("%*s  Propstores Size:   %u bytes\n", indent, "", psp.Size);
+      printf("%*s  File Offset:       %"PRIu64" bytes\n", indent, "", psp.Posn);
+      printf("%*s  No of Prop Stores: %u\n", indent, "", psp.NumStores);
+      for (j = 0; j < psp.NumStores; j++)
+      {
+        if (get_propstore_a(&psp.Stores[j], &psa) == 0)
+        {
+          printf("%*s  {ItemID %u Property Store %u}\n", indent, "", i + 1, j + 1);
+          printf("%*s    Store Size:      %s bytes\n", indent, "", psa.StorageSize);
+          printf("%*s    Version:         %s\n", indent, "", psa.Version);
+          printf("%*s    Format ID:       %s\n", indent, "", psa.FormatID.UUID);
+          printf("%*s    Name Type:       %s\n", indent, "", psa.NameType);
+          printf("%*s    No of Values:    %s\n", indent, "", psa.NumValues);
+          for (k = 0; k < psp.Stores[j].NumValues; k++)
+          {
+            printf("%*s    {Item ID %u Property Store %u Property Value %u}\n", indent, "", i + 1, j + 1, k + 1);
+            printf("%*s      Value Size:    %s bytes\n", indent, "", psa.PropValues[k].ValueSize);
+            if (psp.Stores[j].PropValues[k].ValueSize > 0)
+            {
+              if (psp.Stores[j].NameType == 0)
+              {
+                printf("%*s      Name Size:     %s bytes\n", indent, "", psa.PropValues[k].NameSizeOrID);
+                printf("%*s      Name:          %s\n", indent, "", psa.PropValues[k].Name);
+              }
+              else
+              {
+                printf("%*s      ID:            %s\n", indent, "", psa.PropValues[k].NameSizeOrID);
+                printf("%*s      Key Name:      %s\n", indent, "", psa.PropValues[k].KeyName);
+              }
+              printf("%*s      Property Type: %s\n", indent, "", psa.PropValues[k].PropertyType);
+              printf("%*s      Value:         %s\n", indent, "", psa.PropValues[k].Value);
+
+            }
+          }
+        }
+        else
+        {
+          printf("%*s    [Unable to interpret Property Store %u]\n", indent, "", j);
+        }
+      }
     }
-    printf("ED TD Droid1 Time%c", sep);
-    printf("ED TD Droid1 Clock Seq%c", sep);
-    printf("ED TD Droid1 Node%c", sep);
-    printf("ED TrackerData Droid2%c", sep);
-    if (less == 0)
+    else if (items[i].Shell.Type == SHI_UNKNOWN)
     {
-      printf("ED TD Droid2 Version%c", sep);
-      printf("ED TD Droid2 Variant%c", sep);
+      printf("%*s  [No Property Stores found in this ITemID. Here is the raw data:]\n", indent, "");
+      bin2hex(items[i].Data, items[i].ItemIDSize - 2, 1, 16, indent + 2, 1, 1);
     }
-    printf("ED TD Droid2 Time%c", sep);
-    printf("ED TD Droid2 Clock Seq%c", sep);
-    printf("ED TD Droid2 Node%c", sep);
-    printf("ED TrackerData DroidBirth1%c", sep);
-    if (less == 0)
+  }
+}
+
+//
+//Function: xml_itemids() prints 'num' ItemIDs (from the LinkTargetIDList or
+//          a VistaAndAboveIDListDataBlock) as XML elements.
+void xml_itemids(struct LIF_ITEMID * items, struct LIF_ITEMID_A * items_a, int num)
+{
+  int            i, j, k;
+  size_t         len;
+  char           *dump;
+  struct LIF_PROPERTY_STORE_PROPS  psp;
+  struct LIF_SER_PROPSTORE_A  psa;
+
+  for (i = 0; i < num; i++)
+  {
+    xw_printf(stdout, "<ItemID Num=\"%i\" Size=\"%s\" FileOffset=\"%"PRIu64"\">\n", i + 1, items_a[i].ItemIDSize, items[i].Posn);
+    if (items[i].Shell.Type != SHI_UNKNOWN)
     {
-      printf("ED TD DroidBirth1 Version%c", sep);
-      printf("ED TD DroidBirth1 Variant%c", sep);
+      xml_shellitem(&items[i].Shell, &items_a[i].Shell);
     }
-    printf("ED TD DroidBirth1 Time%c", sep);
-    printf("ED TD DroidBirth1 Clock Seq%c", sep);
-    printf("ED TD DroidBirth1 Node%c", sep);
-    printf("ED TrackerData DroidBirth2%c", sep);
-    if (less == 0)
+    if (find_propstores(items[i].Data, items[i].ItemIDSize - 2, items[i].Posn + 2, &psp) == 0)
     {
-      printf("ED TD DroidBirth2 Version%c", sep);
-      printf("ED TD DroidBirth2 Variant%c", sep);
+      // If PropStoreProps exist:
+      xw_printf(stdout, "<PropStoreProps Size=\"%u\" FileOffset=\"%"PRIu64"\" NumStores=\"%u\">\n", psp.Size, psp.Posn, psp.NumStores);
+      for (j = 0; j < psp.NumStores; j++)
+      {
+        if (get_propstore_a(&psp.Stores[j], &psa) == 0)
+        {
+          xw_printf(stdout, "<PropertyStore Num=\"%u\" Size=\"%s\">\n", j + 1, psa.StorageSize);
+          xw_printf(stdout, "<Version>%s</Version>\n", psa.Version);
+          xw_printf(stdout, "<FormatID>%s</FormatID>\n", psa.FormatID.UUID);
+          xw_printf(stdout, "<NameType>%s</NameType>\n", psa.NameType);
+          xw_printf(stdout, "<PropValues NumValues=\"%s\">\n", psa.NumValues);
+          for (k = 0; k < psp.Stores[j].NumValues; k++)
+          {
+            xw_printf(stdout, "<Value Num=\"%u\" Size=\"%s\">\n", k + 1, psa.PropValues[k].ValueSize);
+            if (psp.Stores[j].PropValues[k].ValueSize > 0)
+            {
+              if (psp.Stores[j].NameType == 0)
+              {
+                xw_printf(stdout, "<NameSize>%s</NameSize>\n", psa.PropValues[k].NameSizeOrID);
+                xw_printf(stdout, "<Name>%s</Name>\n", psa.PropValues[k].Name);
+              }
+              else
+              {
+                xw_printf(stdout, "<ID>%s</ID>\n", psa.PropValues[k].NameSizeOrID);
+                xw_printf(stdout, "<KeyName>%s</KeyName>\n", psa.PropValues[k].KeyName);
+              }
+              xw_printf(stdout, "<Type>%s</Type>\n", psa.PropValues[k].PropertyType);
+              xw_printf(stdout, "<Content>%s</Content>\n", psa.PropValues[k].Value);
+            }
+            xw_printf(stdout, "</Value>\n");
+          }
+          xw_printf(stdout, "</PropValues>\n");
+          xw_printf(stdout, "</PropertyStore>\n");
+        }
+        else
+        {
+          xw_printf(stdout, "<!-- Unable to interpret Property Store %i -->\n", j);
+        }
+      }
+      xw_printf(stdout, "</PropStoreProps>\n");
     }
-    printf("ED TD DroidBirth2 Time%c", sep);
-    printf("ED TD DroidBirth2 Clock Seq%c", sep);
-    printf("ED TD DroidBirth2 Node%c", sep);
-    //ED Vista & above IDList
-    if (less == 0)
+    else if (items[i].Shell.Type == SHI_UNKNOWN)
     {
-      printf("ED >= Vista IDList File Offset (bytes)%c", sep);
-      printf("ED >= Vista IDList Size%c", sep);
-      printf("ED >= Vista IDList Signature%c", sep);
-      printf("ED >= Vista IDList Num Items%c", sep);
+      xw_printf(stdout, "<!-- No Property Stores found in this ITemID. Here is the raw data -->\n");
+      // Render the dump after a newline and write it with xw_cdata() so that
+      // a ']]>' in the ANSI column can't end the section early
+      len = bin2hex_buf(NULL, 0, items[i].Data, items[i].ItemIDSize - 2, 1, 16, 0, 1, 0);
+      dump = malloc(len + 2);
+      if (dump == NULL)
+      {
+        fprintf(stderr, "Unable to allocate memory for an ItemID dump\n");
+      }
+      else
+      {
+        dump[0] = '\n';
+        bin2hex_buf(dump + 1, len + 1, items[i].Data, items[i].ItemIDSize - 2, 1, 16, 0, 1, 0);
+        xw_cdata(stdout, dump);
+        xw_printf(stdout, "\n");
+        free(dump);
+      }
     }
-    printf("\n");
+    xw_printf(stdout, "</ItemID>\n");
   }
-  //Print a record
-  printf("%s%c", fname, sep);
+}
+
+//
+//Function: sv_header() prints the csv or tsv header line
+void sv_header(int less, char sep)
+{
+  printf("File Name%c", sep);
   if (less == 0)
   {
-    printf("%u%c", (unsigned int)statbuf.st_size, sep);
+    printf("Link File Size%c", sep);
   }
-  strftime(buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&statbuf.st_atime));
-  printf("%s%c", buf, sep);
-  strftime(buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&statbuf.st_mtime));
-  printf("%s%c", buf, sep);
-  strftime(buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&statbuf.st_ctime));
-  printf("%s%c", buf, sep);
+  printf("Link File Last Accessed%cLink File Last Modified%c", sep, sep);
+  printf("Link File Last Changed%c", sep);
   if (less == 0)
   {
-    printf("%s%c%s%c", lif_a.lha.H_size, sep, lif_a.lha.CLSID, sep);
-    printf("%s%c", lif_a.lha.Flags, sep);
+    printf("Hdr Size%cHdr CLSID%cHdr Flags%c", sep, sep, sep);
   }
-  printf("%s%c", lif_a.lha.Attr, sep);
+  printf("Hdr Attributes%c", sep);
+  printf("Hdr FileCreate%cHdr FileAccess%c", sep, sep);
+  printf("Hdr FileWrite%c", sep);
+  printf("Hdr TargetSize%c", sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.lha.CrDate_long, sep);
-    printf("%s%c%s%c", lif_a.lha.AcDate_long, sep, lif_a.lha.WtDate_long, sep);
+    printf("Hdr IconIndex%cHdr WindowState%cHdr HotKeys%c", sep, sep, sep);
+    printf("Hdr Reserved1%cHdr Reserved2%cHdr Reserved3%c", sep, sep, sep);
+    printf("IDList Size%c", sep);
+    printf("IDList No Items%c", sep);
+    printf("LinkInfo Size%c", sep);
+    printf("LinkInfo Hdr Size%c", sep);
+    printf("LinkInfo Flags%c", sep);
+    printf("LinkInfo VolID Offset%c", sep);
+    printf("LinkInfo Base Path Offset%c", sep);
+    printf("LinkInfo CNR Offset%c", sep);
+    printf("LinkInfo CPS Offset%c", sep);
+    printf("LinkInfo LBP Offset Unicode%c", sep);
+    printf("LinkInfo CPS Offset Unicode%c", sep);
+    printf("LinkInfo VolID Size%c", sep);
   }
-  else
+  printf("LinkInfo VolID Drive Type%c", sep);
+  printf("LinkInfo VolID Drive Ser No%c", sep);
+  if (less == 0)
   {
-    printf("%s%c", lif_a.lha.CrDate, sep);
-    printf("%s%c%s%c", lif_a.lha.AcDate, sep, lif_a.lha.WtDate, sep);
+    printf("LinkInfo VolID VLOffset%c", sep);
+    printf("LinkInfo VolID VLOffsetU%c", sep);
   }
-  printf("%s%c", lif_a.lha.Size, sep);
+  printf("LinkInfo VolID Vol Label%c", sep);
+  printf("LinkInfo VolID Vol LabelU%c", sep);
+  printf("LinkInfo Local Base Path%c", sep);
   if (less == 0)
   {
-    printf("%s%c%s%c", lif_a.lha.IconIndex, sep, lif_a.lha.ShowState, sep);
-    printf("%s%c%s%c", lif_a.lha.Hotkey, sep, lif_a.lha.Reserved1, sep);
-    printf("%s%c%s%c", lif_a.lha.Reserved2, sep, lif_a.lha.Reserved3, sep);
-    printf("%s%c", lif_a.lidla.IDListSize, sep);
-    printf("%s%c", lif_a.lidla.NumItemIDs, sep);
-    printf("%s%c", lif_a.lia.Size, sep);
-    printf("%s%c", lif_a.lia.HeaderSize, sep);
-    printf("%s%c", lif_a.lia.Flags, sep);
-    printf("%s%c", lif_a.lia.IDOffset, sep);
-    printf("%s%c", lif_a.lia.LBPOffset, sep);
-    printf("%s%c", lif_a.lia.CNRLOffset, sep);
-    printf("%s%c", lif_a.lia.CPSOffset, sep);
-    printf("%s%c", lif_a.lia.LBPOffsetU, sep);
-    printf("%s%c", lif_a.lia.CPSOffsetU, sep);
-    printf("%s%c", lif_a.lia.VolID.Size, sep);
-  }
-  printf("%s%c", lif_a.lia.VolID.DriveType, sep);
-  printf("%s%c", lif_a.lia.VolID.DriveSN, sep);
+    printf("LinkInfo CNR Size%c", sep);
+    printf("LinkInfo CNR Flags%c", sep);
+    printf("LinkInfo CNR NetNameOffset%c", sep);
+    printf("LinkInfo CNR DeviceNameOffset%c", sep);
+  }
+  printf("LinkInfo CNR NetwkProviderType%c", sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.lia.VolID.VLOffset, sep);
-    printf("%s%c", lif_a.lia.VolID.VLOffsetU, sep);
+    printf("LinkInfo CNR NetNameOffsetU%c", sep);
+    printf("LinkInfo CNR DeviceNameOffsetU%c", sep);
   }
-  printf("%s%c", lif_a.lia.VolID.VolumeLabel, sep);
-  printf("%s%c", lif_a.lia.VolID.VolumeLabelU, sep);
+  printf("LinkInfo CNR NetName%c", sep);
+  printf("LinkInfo CNR DeviceName%c", sep);
+  printf("LinkInfo CNR NetNameU%c", sep);
+  printf("LinkInfo CNR DeviceNameU%c", sep);
+
+  printf("LinkInfo Common Path Suffix%c", sep);
+  printf("LinkInfo Local Base Path Unicode%c", sep);
+  printf("LinkInfo Common Path Suffix Unicode%c", sep);
 
-  printf("%s%c", lif_a.lia.LBP, sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.lia.CNR.Size, sep);
-    printf("%s%c", lif_a.lia.CNR.Flags, sep);
-    printf("%s%c", lif_a.lia.CNR.NetNameOffset, sep);
-    printf("%s%c", lif_a.lia.CNR.DeviceNameOffset, sep);
+    printf("StrData Total Size (bytes)%c", sep);
+    printf("StrData Name Num Chars%c", sep);
   }
-  printf("%s%c", lif_a.lia.CNR.NetworkProviderType, sep);
+  printf("StrData - Name%c", sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.lia.CNR.NetNameOffsetU, sep);
-    printf("%s%c", lif_a.lia.CNR.DeviceNameOffsetU, sep);
+    printf("StrData Rel Path Num Chars%c", sep);
   }
-  printf("%s%c", lif_a.lia.CNR.NetName, sep);
-  printf("%s%c", lif_a.lia.CNR.DeviceName, sep);
-  printf("%s%c", lif_a.lia.CNR.NetNameU, sep);
-  printf("%s%c", lif_a.lia.CNR.DeviceNameU, sep);
-  printf("%s%c", lif_a.lia.CPS, sep);
-  printf("%s%c", lif_a.lia.LBPU, sep);
-  printf("%s%c", lif_a.lia.CPSU, sep);
-
+  printf("StrData Relative Path%c", sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.lsda.Size, sep);
+    printf("StrData Working Dir Num Chars%c", sep);
   }
-  for (i = 0; i < 5; i++)
+  printf("StrData Working Dir%c", sep);
+  if (less == 0)
   {
-    if (less == 0)
-    {
-      printf("%s%c", lif_a.lsda.CountChars[i], sep);
-    }
-    //If csv output then replace a comma in the string with a semi-colon
-    if (output_type == csv)
-    {
-      replace_comma(lif_a.lsda.Data[i], lif.lsd.CountChars[i]);
-    }
-    printf("%s%c", lif_a.lsda.Data[i], sep);
+    printf("StrData Cmd Line Args Num Chars%c", sep);
   }
-  // S2.5 ExtraData
+  printf("StrData Cmd Line Args%c", sep);
+  if (less == 0)
+  {
+    printf("StrData Icon Loc Num Chars%c", sep);
+  }
+  printf("StrData Icon Location%c", sep);
+  // S2.5 ExtraData structures
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.Size, sep);
+    printf("ExtraData Total Size (bytes)%c", sep);
   }
-  printf("%s%c", lif_a.leda.edtypes, sep);
+  printf("ExtraData Structures%c", sep);
 
   // S2.5.1 ConsoleDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.lcpa.Posn, sep);
-    printf("%s%c", lif_a.leda.lcpa.Size, sep);
-    printf("%s%c", lif_a.leda.lcpa.sig, sep);
-    printf("%s%c", lif_a.leda.lcpa.FillAttributes, sep);
-    printf("%s%c", lif_a.leda.lcpa.PopupFillAttributes, sep);
-    printf("%s%c", lif_a.leda.lcpa.ScreenBufferSizeX, sep);
-    printf("%s%c", lif_a.leda.lcpa.ScreenBufferSizeY, sep);
-    printf("%s%c", lif_a.leda.lcpa.WindowSizeX, sep);
-    printf("%s%c", lif_a.leda.lcpa.WindowSizeY, sep);
-    printf("%s%c", lif_a.leda.lcpa.WindowOriginX, sep);
-    printf("%s%c", lif_a.leda.lcpa.WindowOriginY, sep);
-    printf("%s%c", lif_a.leda.lcpa.Unused1, sep);
-    printf("%s%c", lif_a.leda.lcpa.Unused2, sep);
-    printf("%s%c", lif_a.leda.lcpa.FontHeight, sep);
-    printf("%s%c", lif_a.leda.lcpa.FontWidth, sep);
-    printf("%s%c", lif_a.leda.lcpa.FontFamily, sep);
-    printf("%s%c", lif_a.leda.lcpa.FontPitch, sep);
-    printf("%s%c", lif_a.leda.lcpa.FontWeight, sep);
-    printf("%s%c", lif_a.leda.lcpa.FaceName, sep);
-    printf("%s%c", lif_a.leda.lcpa.CursorSize, sep);
-    printf("%s%c", lif_a.leda.lcpa.FullScreen, sep);
-    printf("%s%c", lif_a.leda.lcpa.QuickEdit, sep);
-    printf("%s%c", lif_a.leda.lcpa.InsertMode, sep);
-    printf("%s%c", lif_a.leda.lcpa.AutoPosition, sep);
-    printf("%s%c", lif_a.leda.lcpa.HistoryBufferSize, sep);
-    printf("%s%c", lif_a.leda.lcpa.NumberOfHistoryBuffers, sep);
-    printf("%s%c", lif_a.leda.lcpa.HistoryNoDup, sep);
-    for (j = 0; j < 15; j++)
-    {
-      //15 consecutive ColorTable Entries
-      printf("%s%c", lif_a.leda.lcpa.ColorTable[j], ';');
-    }
-    // And the last one terminated with the field separator
-    printf("%s%c", lif_a.leda.lcpa.ColorTable[j], sep);
+    printf("ED CDB File Offset (bytes)%c", sep);
+    printf("ED CDB Size (bytes)%c", sep);
+    printf("ED CDB Signature%c", sep);
+    printf("ED CDB FillAttributes%c", sep);
+    printf("ED CDB PopupFillAttr%c", sep);
+    printf("ED CDB ScrBufSizeX%c", sep);
+    printf("ED CDB ScrBufSizeY%c", sep);
+    printf("ED CDB WindowSizeX%c", sep);
+    printf("ED CDB WindowSizeY%c", sep);
+    printf("ED CDB WindowOriginX%c", sep);
+    printf("ED CDB WindowOriginY%c", sep);
+    printf("ED CDB Unused1%c", sep);
+    printf("ED CDB Unused2%c", sep);
+    printf("ED CDB FontHeight%c", sep);
+    printf("ED CDB FontWidth%c", sep);
+    printf("ED CDB FontFamily%c", sep);
+    printf("ED CDB FontPitch%c", sep);
+    printf("ED CDB FontWeight%c", sep);
+    printf("ED CDB FaceName%c", sep);
+    printf("ED CDB CursorSize%c", sep);
+    printf("ED CDB FullScreen%c", sep);
+    printf("ED CDB QuickEdit%c", sep);
+    printf("ED CDB InsertMode%c", sep);
+    printf("ED CDB AutoPosition%c", sep);
+    printf("ED CDB HistoryBufSize%c", sep);
+    printf("ED CDB NumHistoryBuf%c", sep);
+    printf("ED CDB HistoryNoDup%c", sep);
+    printf("ED CDB ColorTable%c", sep);
   }
   // S2.5.2 ConsoleFEDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.lcfepa.Posn, sep);
-    printf("%s%c", lif_a.leda.lcfepa.Size, sep);
-    printf("%s%c", lif_a.leda.lcfepa.sig, sep);
-    printf("%s%c", lif_a.leda.lcfepa.CodePage, sep);
+    printf("ED CFEDB File Offset (bytes)%c", sep);
+    printf("ED CFEDB Size (bytes)%c", sep);
+    printf("ED CFEDB Signature%c", sep);
+    printf("ED CFEDB CodePage%c", sep);
   }
   // S2.5.3 DarwinDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.ldpa.Posn, sep);
-    printf("%s%c", lif_a.leda.ldpa.Size, sep);
-    printf("%s%c", lif_a.leda.ldpa.sig, sep);
-    if (output_type == csv)
-    {
-      replace_comma(lif_a.leda.ldpa.DarwinDataAnsi, 260);
-      replace_comma(lif_a.leda.ldpa.DarwinDataUnicode, 520);
-    }
-
-    printf("%s%c", lif_a.leda.ldpa.DarwinDataAnsi, sep);
-    printf("%s%c", lif_a.leda.ldpa.DarwinDataUnicode, sep);
+    printf("ED DDB File Offset (bytes)%c", sep);
+    printf("ED DDB Size (bytes)%c", sep);
+    printf("ED DDB Signature%c", sep);
+    printf("ED DDB DarwinDataAnsi%c", sep);
+    printf("ED DDB DarwinDataUnicode%c", sep);
   }
   // S2.5.4 EnvironmentVariableDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.lepa.Posn, sep);
-    printf("%s%c", lif_a.leda.lepa.Size, sep);
-    printf("%s%c", lif_a.leda.lepa.sig, sep);
-    if (output_type == csv)
+    printf("ED EVDB File Offset (bytes)%c", sep);
+    printf("ED EVDB Size (bytes)%c", sep);
+    printf("ED EVDB Signature%c", sep);
+    printf("ED EVDB TargetAnsi%c", sep);
+    printf("ED EVDB TargetUnicode%c", sep);
+  }
+  // S2.5.5 IconEnvironmentDataBlock
+  if (less == 0)
+  {
+    printf("ED IEDB File Offset (bytes)%c", sep);
+    printf("ED IEDB Size (bytes)%c", sep);
+    printf("ED IEDB Signature%c", sep);
+    printf("ED IEDB TargetAnsi%c", sep);
+    printf("ED IEDB TargetUnicode%c", sep);
+  }
+  // S2.5.6 KnownFolderDataBlock
+  if (less == 0)
+  {
+    printf("ED KFDB File Offset (bytes)%c", sep);
+    printf("ED KFDB Size (bytes)%c", sep);
+    printf("ED KFDB Signature%c", sep);
+    printf("ED KFDB KnownFolderID%c", sep);
+    printf("ED KFDB KnownFolderName%c", sep);
+    printf("ED KFDB Offset%c", sep);
+  }
+  // S2.5.7 PropertyStoreDataBlock
+  if (less == 0)
+  {
+    printf("ED PS File Offset (bytes)%c", sep);
+    printf("ED PS Size (bytes)%c", sep);
+    printf("ED PS Signature%c", sep);
+    printf("ED PS Number of Stores %c", sep);
+  }
+  // S2.5.9 SpecialFolderDataBlock
+  if (less == 0)
+  {
+    printf("ED SFolderData File Offset (bytes)%c", sep);
+    printf("ED SFolderData Size (bytes)%c", sep);
+    printf("ED SFolderData Signature%c", sep);
+    printf("ED SFolderData ID%c", sep);
+    printf("ED SFolderData Offset%c", sep);
+  }
+  // S 2.5.10 TrackerDataBlock
+  if (less == 0)
+  {
+    printf("ED TrackerData File Offset (bytes)%c", sep);
+    printf("ED TrackerData Size (bytes)%c", sep);
+    printf("ED TrackerData Signature%c", sep);
+    printf("ED TrackerData Length%c", sep);
+    printf("ED TrackerData Version%c", sep);
+  }
+  printf("ED TrackerData MachineID%c", sep);
+  printf("ED TrackerData Droid1%c", sep);
+  if (less == 0)
+  {
+    printf("ED TD Droid1 Version%c", sep);
+    printf("ED TD Droid1 Variant%c", sep);
+  }
+  printf("ED TD Droid1 Time%c", sep);
+  printf("ED TD Droid1 Clock Seq%c", sep);
+  printf("ED TD Droid1 Node%c", sep);
+  printf("ED TrackerData Droid2%c", sep);
+  if (less == 0)
+  {
+    printf("ED TD Droid2 Version%c", sep);
+    printf("ED TD Droid2 Variant%c", sep);
+  }
+  printf("ED TD Droid2 Time%c", sep);
+  printf("ED TD Droid2 Clock Seq%c", sep);
+  printf("ED TD Droid2 Node%c", sep);
+  printf("ED TrackerData DroidBirth1%c", sep);
+  if (less == 0)
+  {
+    printf("ED TD DroidBirth1 Version%c", sep);
+    printf("ED TD DroidBirth1 Variant%c", sep);
+  }
+  printf("ED TD DroidBirth1 Time%c", sep);
+  printf("ED TD DroidBirth1 Clock Seq%c", sep);
+  printf("ED TD DroidBirth1 Node%c", sep);
+  printf("ED TrackerData DroidBirth2%c", sep);
+  if (less == 0)
+  {
+    printf("ED TD DroidBirth2 Version%c", sep);
+    printf("ED TD DroidBirth2 Variant%c", sep);
+  }
+  printf("ED TD DroidBirth2 Time%c", sep);
+  printf("ED TD DroidBirth2 Clock Seq%c", sep);
+  printf("ED TD DroidBirth2 Node%c", sep);
+  //ED Vista & above IDList
+  if (less == 0)
+  {
+    printf("ED >= Vista IDList File Offset (bytes)%c", sep);
+    printf("ED >= Vista IDList Size%c", sep);
+    printf("ED >= Vista IDList Signature%c", sep);
+    printf("ED >= Vista IDList Num Items%c", sep);
+  }
+  printf("\n");
+}
+
+//
+//Function: sv_out(FILE * fp) processes the link file and outputs the csv or tsv
+//          version of the decoded data.
+void sv_out(FILE* fp, char* fname, int less, char sep)
+{
+  struct LIF   lif;
+  struct LIF_A lif_a;
+  struct stat statbuf;
+  char buf[40];
+  int  i, j;
+
+
+  // Get the stat info for the file itself
+  fstat(fileno(fp), &statbuf);
+
+  if (decode_lif(fp, statbuf.st_size, decode_mask(less), &lif) < 0)
+  {
+    fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
+    return;
+  }
+  if (ascii_lif(&lif, &lif_a, lif_a_opts))
+  {
+    fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
+    return;
+  }
+  //Now print the header if needed
+  if (filecount == 0)
+  {
+    sv_header(less, sep);
+  }
+  //Print a record
+  sv_field((unsigned char *)fname, sep);
+  if (less == 0)
+  {
+    printf("%u%c", (unsigned int)statbuf.st_size, sep);
+  }
+  strftime(buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&statbuf.st_atime));
+  sv_field((unsigned char *)buf, sep);
+  strftime(buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&statbuf.st_mtime));
+  sv_field((unsigned char *)buf, sep);
+  strftime(buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&statbuf.st_ctime));
+  sv_field((unsigned char *)buf, sep);
+  if (less == 0)
+  {
+    sv_field(lif_a.lha.H_size, sep);
+    sv_field(lif_a.lha.CLSID, sep);
+    sv_field(lif_a.lha.Flags, sep);
+  }
+  sv_field(lif_a.lha.Attr, sep);
+  if (less == 0)
+  {
+    sv_field(lif_a.lha.CrDate_long, sep);
+    sv_field(lif_a.lha.AcDate_long, sep);
+    sv_field(lif_a.lha.WtDate_long, sep);
+  }
+  else
+  {
+    sv_field(lif_a.lha.CrDate, sep);
+    sv_field(lif_a.lha.AcDate, sep);
+    sv_field(lif_a.lha.WtDate, sep);
+  }
+  sv_field(lif_a.lha.Size, sep);
+  if (less == 0)
+  {
+    sv_field(lif_a.lha.IconIndex, sep);
+    sv_field(lif_a.lha.ShowState, sep);
+    sv_field(lif_a.lha.Hotkey, sep);
+    sv_field(lif_a.lha.Reserved1, sep);
+    sv_field(lif_a.lha.Reserved2, sep);
+    sv_field(lif_a.lha.Reserved3, sep);
+    sv_field(lif_a.lidla.IDListSize, sep);
+    sv_field(lif_a.lidla.NumItemIDs, sep);
+    sv_field(lif_a.lia.Size, sep);
+    sv_field(lif_a.lia.HeaderSize, sep);
+    sv_field(lif_a.lia.Flags, sep);
+    sv_field(lif_a.lia.IDOffset, sep);
+    sv_field(lif_a.lia.LBPOffset, sep);
+    sv_field(lif_a.lia.CNRLOffset, sep);
+    sv_field(lif_a.lia.CPSOffset, sep);
+    sv_field(lif_a.lia.LBPOffsetU, sep);
+    sv_field(lif_a.lia.CPSOffsetU, sep);
+    sv_field(lif_a.lia.VolID.Size, sep);
+  }
+  sv_field(lif_a.lia.VolID.DriveType, sep);
+  sv_field(lif_a.lia.VolID.DriveSN, sep);
+  if (less == 0)
+  {
+    sv_field(lif_a.lia.VolID.VLOffset, sep);
+    sv_field(lif_a.lia.VolID.VLOffsetU, sep);
+  }
+  sv_field(lif_a.lia.VolID.VolumeLabel, sep);
+  sv_field(lif_a.lia.VolID.VolumeLabelU, sep);
+
+  sv_field(lif_a.lia.LBP, sep);
+  if (less == 0)
+  {
+    sv_field(lif_a.lia.CNR.Size, sep);
+    sv_field(lif_a.lia.CNR.Flags, sep);
+    sv_field(lif_a.lia.CNR.NetNameOffset, sep);
+    sv_field(lif_a.lia.CNR.DeviceNameOffset, sep);
+  }
+  sv_field(lif_a.lia.CNR.NetworkProviderType, sep);
+  if (less == 0)
+  {
+    sv_field(lif_a.lia.CNR.NetNameOffsetU, sep);
+    sv_field(lif_a.lia.CNR.DeviceNameOffsetU, sep);
+  }
+  sv_field(lif_a.lia.CNR.NetName, sep);
+  sv_field(lif_a.lia.CNR.DeviceName, sep);
+  sv_field(lif_a.lia.CNR.NetNameU, sep);
+  sv_field(lif_a.lia.CNR.DeviceNameU, sep);
+  sv_field(lif_a.lia.CPS, sep);
+  sv_field(lif_a.lia.LBPU, sep);
+  sv_field(lif_a.lia.CPSU, sep);
+
+  if (less == 0)
+  {
+    sv_field(lif_a.lsda.Size, sep);
+  }
+  for (i = 0; i < 5; i++)
+  {
+    if (less == 0)
     {
-      replace_comma(lif_a.leda.lepa.TargetAnsi, 260);
-      replace_comma(lif_a.leda.lepa.TargetUnicode, 520);
+      sv_field(lif_a.lsda.CountChars[i], sep);
     }
-
-    printf("%s%c", lif_a.leda.lepa.TargetAnsi, sep);
-    printf("%s%c", lif_a.leda.lepa.TargetUnicode, sep);
+    sv_field(lif_a.lsda.Data[i], sep);
   }
-  // S2.5.5 IconEnvironmentDataBlock
+  // S2.5 ExtraData
+  if (less == 0)
+  {
+    sv_field(lif_a.leda.Size, sep);
+  }
+  sv_field(lif_a.leda.edtypes, sep);
+
+  // S2.5.1 ConsoleDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.liepa.Posn, sep);
-    printf("%s%c", lif_a.leda.liepa.Size, sep);
-    printf("%s%c", lif_a.leda.liepa.sig, sep);
-    if (output_type == csv)
+    sv_field(lif_a.leda.lcpa.Posn, sep);
+    sv_field(lif_a.leda.lcpa.Size, sep);
+    sv_field(lif_a.leda.lcpa.sig, sep);
+    sv_field(lif_a.leda.lcpa.FillAttributes, sep);
+    sv_field(lif_a.leda.lcpa.PopupFillAttributes, sep);
+    sv_field(lif_a.leda.lcpa.ScreenBufferSizeX, sep);
+    sv_field(lif_a.leda.lcpa.ScreenBufferSizeY, sep);
+    sv_field(lif_a.leda.lcpa.WindowSizeX, sep);
+    sv_field(lif_a.leda.lcpa.WindowSizeY, sep);
+    sv_field(lif_a.leda.lcpa.WindowOriginX, sep);
+    sv_field(lif_a.leda.lcpa.WindowOriginY, sep);
+    sv_field(lif_a.leda.lcpa.Unused1, sep);
+    sv_field(lif_a.leda.lcpa.Unused2, sep);
+    sv_field(lif_a.leda.lcpa.FontHeight, sep);
+    sv_field(lif_a.leda.lcpa.FontWidth, sep);
+    sv_field(lif_a.leda.lcpa.FontFamily, sep);
+    sv_field(lif_a.leda.lcpa.FontPitch, sep);
+    sv_field(lif_a.leda.lcpa.FontWeight, sep);
+    sv_field(lif_a.leda.lcpa.FaceName, sep);
+    sv_field(lif_a.leda.lcpa.CursorSize, sep);
+    sv_field(lif_a.leda.lcpa.FullScreen, sep);
+    sv_field(lif_a.leda.lcpa.QuickEdit, sep);
+    sv_field(lif_a.leda.lcpa.InsertMode, sep);
+    sv_field(lif_a.leda.lcpa.AutoPosition, sep);
+    sv_field(lif_a.leda.lcpa.HistoryBufferSize, sep);
+    sv_field(lif_a.leda.lcpa.NumberOfHistoryBuffers, sep);
+    sv_field(lif_a.leda.lcpa.HistoryNoDup, sep);
+    for (j = 0; j < 15; j++)
     {
-      replace_comma(lif_a.leda.liepa.TargetAnsi, 260);
-      replace_comma(lif_a.leda.liepa.TargetUnicode, 520);
+      //15 consecutive ColorTable Entries
+      printf("%s%c", lif_a.leda.lcpa.ColorTable[j], ';');
     }
-    printf("%s%c", lif_a.leda.liepa.TargetAnsi, sep);
-    printf("%s%c", lif_a.leda.liepa.TargetUnicode, sep);
+    // And the last one terminated with the field separator
+    sv_field(lif_a.leda.lcpa.ColorTable[j], sep);
+  }
+  // S2.5.2 ConsoleFEDataBlock
+  if (less == 0)
+  {
+    sv_field(lif_a.leda.lcfepa.Posn, sep);
+    sv_field(lif_a.leda.lcfepa.Size, sep);
+    sv_field(lif_a.leda.lcfepa.sig, sep);
+    sv_field(lif_a.leda.lcfepa.CodePage, sep);
+  }
+  // S2.5.3 DarwinDataBlock
+  if (less == 0)
+  {
+    sv_field(lif_a.leda.ldpa.Posn, sep);
+    sv_field(lif_a.leda.ldpa.Size, sep);
+    sv_field(lif_a.leda.ldpa.sig, sep);
+    sv_field(lif_a.leda.ldpa.DarwinDataAnsi, sep);
+    sv_field(lif_a.leda.ldpa.DarwinDataUnicode, sep);
+  }
+  // S2.5.4 EnvironmentVariableDataBlock
+  if (less == 0)
+  {
+    sv_field(lif_a.leda.lepa.Posn, sep);
+    sv_field(lif_a.leda.lepa.Size, sep);
+    sv_field(lif_a.leda.lepa.sig, sep);
+    sv_field(lif_a.leda.lepa.TargetAnsi, sep);
+    sv_field(lif_a.leda.lepa.TargetUnicode, sep);
+  }
+  // S2.5.5 IconEnvironmentDataBlock
+  if (less == 0)
+  {
+    sv_field(lif_a.leda.liepa.Posn, sep);
+    sv_field(lif_a.leda.liepa.Size, sep);
+    sv_field(lif_a.leda.liepa.sig, sep);
+    sv_field(lif_a.leda.liepa.TargetAnsi, sep);
+    sv_field(lif_a.leda.liepa.TargetUnicode, sep);
   }
   // S2.5.7 PropertyStoreDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.lkfpa.Posn, sep);
-    printf("%s%c", lif_a.leda.lkfpa.Size, sep);
-    printf("%s%c", lif_a.leda.lkfpa.sig, sep);
-    printf("%s%c", lif_a.leda.lkfpa.KFGUID.UUID, sep);
-    printf("%s%c", lif_a.leda.lkfpa.KFOffset, sep);
+    sv_field(lif_a.leda.lkfpa.Posn, sep);
+    sv_field(lif_a.leda.lkfpa.Size, sep);
+    sv_field(lif_a.leda.lkfpa.sig, sep);
+    sv_field(lif_a.leda.lkfpa.KFGUID.UUID, sep);
+    sv_field(lif_a.leda.lkfpa.KFGUID.Name, sep);
+    sv_field(lif_a.leda.lkfpa.KFOffset, sep);
   }
   // S2.5.7 PropertyStoreDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.lpspa.Posn, sep);
-    printf("%s%c", lif_a.leda.lpspa.Size, sep);
-    printf("%s%c", lif_a.leda.lpspa.sig, sep);
-    printf("%s%c", lif_a.leda.lpspa.NumStores, sep);
+    sv_field(lif_a.leda.lpspa.Posn, sep);
+    sv_field(lif_a.leda.lpspa.Size, sep);
+    sv_field(lif_a.leda.lpspa.sig, sep);
+    sv_field(lif_a.leda.lpspa.NumStores, sep);
   }
   // S2.5.9 SpecialFolderDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.lsfpa.Posn, sep);
-    printf("%s%c", lif_a.leda.lsfpa.Size, sep);
-    printf("%s%c", lif_a.leda.lsfpa.sig, sep);
-    printf("%s%c", lif_a.leda.lsfpa.SpecialFolderID, sep);
-    printf("%s%c", lif_a.leda.lsfpa.Offset, sep);
+    sv_field(lif_a.leda.lsfpa.Posn, sep);
+    sv_field(lif_a.leda.lsfpa.Size, sep);
+    sv_field(lif_a.leda.lsfpa.sig, sep);
+    sv_field(lif_a.leda.lsfpa.SpecialFolderID, sep);
+    sv_field(lif_a.leda.lsfpa.Offset, sep);
   }
   // S2.5.10 TrackerDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.ltpa.Posn, sep);
-    printf("%s%c", lif_a.leda.ltpa.Size, sep);
-    printf("%s%c", lif_a.leda.ltpa.sig, sep);
-    printf("%s%c", lif_a.leda.ltpa.Length, sep);
-    printf("%s%c", lif_a.leda.ltpa.Version, sep);
+    sv_field(lif_a.leda.ltpa.Posn, sep);
+    sv_field(lif_a.leda.ltpa.Size, sep);
+    sv_field(lif_a.leda.ltpa.sig, sep);
+    sv_field(lif_a.leda.ltpa.Length, sep);
+    sv_field(lif_a.leda.ltpa.Version, sep);
   }
-  printf("%s%c", lif_a.leda.ltpa.MachineID, sep);
-  printf("%s%c", lif_a.leda.ltpa.Droid1.UUID, sep);
+  sv_field(lif_a.leda.ltpa.MachineID, sep);
+  sv_field(lif_a.leda.ltpa.Droid1.UUID, sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.ltpa.Droid1.Version, sep);
-    printf("%s%c", lif_a.leda.ltpa.Droid1.Variant, sep);
-    printf("%s%c", lif_a.leda.ltpa.Droid1.Time_long, sep);
+    sv_field(lif_a.leda.ltpa.Droid1.Version, sep);
+    sv_field(lif_a.leda.ltpa.Droid1.Variant, sep);
+    sv_field(lif_a.leda.ltpa.Droid1.Time_long, sep);
   }
   else
   {
-    printf("%s%c", lif_a.leda.ltpa.Droid1.Time, sep);
+    sv_field(lif_a.leda.ltpa.Droid1.Time, sep);
   }
-  printf("%s%c", lif_a.leda.ltpa.Droid1.ClockSeq, sep);
-  printf("%s%c", lif_a.leda.ltpa.Droid1.Node, sep);
-  printf("%s%c", lif_a.leda.ltpa.Droid2.UUID, sep);
+  sv_field(lif_a.leda.ltpa.Droid1.ClockSeq, sep);
+  sv_field(lif_a.leda.ltpa.Droid1.Node, sep);
+  sv_field(lif_a.leda.ltpa.Droid2.UUID, sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.ltpa.Droid2.Version, sep);
-    printf("%s%c", lif_a.leda.ltpa.Droid2.Variant, sep);
-    printf("%s%c", lif_a.leda.ltpa.Droid2.Time_long, sep);
+    sv_field(lif_a.leda.ltpa.Droid2.Version, sep);
+    sv_field(lif_a.leda.ltpa.Droid2.Variant, sep);
+    sv_field(lif_a.leda.ltpa.Droid2.Time_long, sep);
   }
   else
   {
-    printf("%s%c", lif_a.leda.ltpa.Droid2.Time, sep);
+    sv_field(lif_a.leda.ltpa.Droid2.Time, sep);
   }
-  printf("%s%c", lif_a.leda.ltpa.Droid2.ClockSeq, sep);
-  printf("%s%c", lif_a.leda.ltpa.Droid2.Node, sep);
-  printf("%s%c", lif_a.leda.ltpa.DroidBirth1.UUID, sep);
+  sv_field(lif_a.leda.ltpa.Droid2.ClockSeq, sep);
+  sv_field(lif_a.leda.ltpa.Droid2.Node, sep);
+  sv_field(lif_a.leda.ltpa.DroidBirth1.UUID, sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth1.Version, sep);
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth1.Variant, sep);
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth1.Time_long, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth1.Version, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth1.Variant, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth1.Time_long, sep);
   }
   else
   {
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth1.Time, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth1.Time, sep);
   }
-  printf("%s%c", lif_a.leda.ltpa.DroidBirth1.ClockSeq, sep);
-  printf("%s%c", lif_a.leda.ltpa.DroidBirth1.Node, sep);
-  printf("%s%c", lif_a.leda.ltpa.DroidBirth2.UUID, sep);
+  sv_field(lif_a.leda.ltpa.DroidBirth1.ClockSeq, sep);
+  sv_field(lif_a.leda.ltpa.DroidBirth1.Node, sep);
+  sv_field(lif_a.leda.ltpa.DroidBirth2.UUID, sep);
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth2.Version, sep);
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth2.Variant, sep);
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth2.Time_long, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth2.Version, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth2.Variant, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth2.Time_long, sep);
   }
   else
   {
-    printf("%s%c", lif_a.leda.ltpa.DroidBirth2.Time, sep);
+    sv_field(lif_a.leda.ltpa.DroidBirth2.Time, sep);
   }
-  printf("%s%c", lif_a.leda.ltpa.DroidBirth2.ClockSeq, sep);
-  printf("%s%c", lif_a.leda.ltpa.DroidBirth2.Node, sep);
+  sv_field(lif_a.leda.ltpa.DroidBirth2.ClockSeq, sep);
+  sv_field(lif_a.leda.ltpa.DroidBirth2.Node, sep);
   // S2.5.11 VistaAndAboveIDListDataBlock
   if (less == 0)
   {
-    printf("%s%c", lif_a.leda.lvidlpa.Posn, sep);
-    printf("%s%c", lif_a.leda.lvidlpa.Size, sep);
-    printf("%s%c", lif_a.leda.lvidlpa.sig, sep);
-    printf("%s%c", lif_a.leda.lvidlpa.NumItemIDs, sep);
+    sv_field(lif_a.leda.lvidlpa.Posn, sep);
+    sv_field(lif_a.leda.lvidlpa.Size, sep);
+    sv_field(lif_a.leda.lvidlpa.sig, sep);
+    sv_field(lif_a.leda.lvidlpa.NumItemIDs, sep);
   }
   printf("\n");
 }
@@ -684,19 +1569,17 @@ void text_out(FILE* fp, char* fname, int less, int itemid)
   struct LIF_A   lif_a;
   struct stat    statbuf;
   char           buf[200];
-  int            i, j, k, idpos = 0;
-  struct LIF_PROPERTY_STORE_PROPS  psp;
-  struct LIF_SER_PROPSTORE_A  psa;
+  int            i, j;
 
   // Get the stat info for the file itself
-  stat(fname, &statbuf);
+  fstat(fileno(fp), &statbuf);
 
-  if (get_lif(fp, statbuf.st_size, &lif) < 0)
+  if (decode_lif(fp, statbuf.st_size, decode_mask(less), &lif) < 0)
   {
     fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
     return;
   }
-  if (get_lif_a(&lif, &lif_a))
+  if (ascii_lif(&lif, &lif_a, lif_a_opts))
   {
     fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
     return;
@@ -756,65 +1639,10 @@ void text_out(FILE* fp, char* fname, int less, int itemid)
         lif.lidl.IDListSize + 2);
       if (itemid > 0) // If the '-i' option is switched on
       {
-        idpos = lif.lh.H_size;
         printf("    IDList Size:         %s bytes\n",
           lif_a.lidla.IDListSize);
         printf("    Number of ItemIDs    %s\n", lif_a.lidla.NumItemIDs);
-        for (i = 0; i < lif.lidl.NumItemIDs; i++)
-        {
-          printf("    {ItemID %i}\n", i + 1);
-          printf("      ItemID  Size:      %s bytes\n", lif_a.lidla.Items[i].ItemIDSize);
-          if (find_propstores((unsigned char*)&lif.lidl.Items[i].Data, lif.lidl.Items[i].ItemIDSize, idpos, &psp) == 0)
-          {
-            // If PropStoreProps exist:
-            printf("      [Property Stores found within this ItemID]\n");
-            printf("      Propstores Size:   %u bytes\n", psp.Size);
-            printf("      File Offset:       %u bytes\n", psp.Posn);
-            printf("      No of Prop Stores: %u\n", psp.NumStores);
-            for (j = 0; j < psp.NumStores; j++)
-            {
-              if (get_propstore_a(&psp.Stores[j], &psa) == 0)
-              {
-                printf("      {ItemID %u Property Store %u}\n", i + 1, j + 1);
-                printf("        Store Size:      %s bytes\n", psa.StorageSize);
-                printf("        Version:         %s\n", psa.Version);
-                printf("        Format ID:       %s\n", psa.FormatID.UUID);
-                printf("        Name Type:       %s\n", psa.NameType);
-                printf("        No of Values:    %s\n", psa.NumValues);
-                for (k = 0; k < psp.Stores[j].NumValues; k++)
-                {
-                  printf("        {Item ID %u Property Store %u Property Value %u}\n", i + 1, j + 1, k + 1);
-                  printf("          Value Size:    %s bytes\n", psa.PropValues[k].ValueSize);
-                  if (psp.Stores[j].PropValues[k].ValueSize > 0)
-                  {
-                    if (psp.Stores[j].NameType == 0)
-                    {
-                      printf("          Name Size:     %s bytes\n", psa.PropValues[k].NameSizeOrID);
-                      printf("          Name:          %s\n", psa.PropValues[k].Name);
-                    }
-                    else
-                    {
-                      printf("          ID:            %s\n", psa.PropValues[k].NameSizeOrID);
-                    }
-                    printf("          Property Type: %s\n", psa.PropValues[k].PropertyType);
-                    printf("          Value:         %s\n", psa.PropValues[k].Value);
-
-                  }
-                }
-              }
-              else
-              {
-                printf("        [Unable to interpret Property Store %u]\n", j);
-              }
-            }
-            idpos += lif.lidl.Items[i].ItemIDSize; // point idpos at the start of the next ItemID
-          }
-          else
-          {
-            printf("      [No Property Stores found in this ITemID. Here is the raw data:]\n");
-            bin2hex((unsigned char*)&lif.lidl.Items[i].Data, lif.lidl.Items[i].ItemIDSize, 1, 16, 6, 1, 1);
-          }
-        }
+        text_itemids(lif.lidl.Items, lif_a.lidla.Items, lif.lidl.NumItemIDs, 4);
         printf("    IDList Terminator    2 bytes\n");
       }
       else
@@ -1239,6 +2067,7 @@ void text_out(FILE* fp, char* fname, int less, int itemid)
       printf("      BlockSize:         %s bytes\n", lif_a.leda.lkfpa.Size);
       printf("      BlockSignature:    %s\n", lif_a.leda.lkfpa.sig);
       printf("      KnownFolderID:     %s\n", lif_a.leda.lkfpa.KFGUID.UUID);
+      printf("      KnownFolderName:   %s\n", lif_a.leda.lkfpa.KFGUID.Name);
       printf("      Offset:            %s\n", lif_a.leda.lkfpa.KFOffset);
     }
   }
@@ -1273,6 +2102,7 @@ void text_out(FILE* fp, char* fname, int less, int itemid)
             else
             {
               printf("          ID:              %s\n", lif_a.leda.lpspa.Stores[i].PropValues[j].NameSizeOrID);
+              printf("          Key Name:        %s\n", lif_a.leda.lpspa.Stores[i].PropValues[j].KeyName);
             }
             printf("          Property Type:   %s\n", lif_a.leda.lpspa.Stores[i].PropValues[j].PropertyType);
             printf("          Value:           %s\n", lif_a.leda.lpspa.Stores[i].PropValues[j].Value);
@@ -1433,6 +2263,15 @@ void text_out(FILE* fp, char* fname, int less, int itemid)
       printf("      BlockSize:         %s bytes\n", lif_a.leda.lvidlpa.Size);
       printf("      BlockSignature:    %s\n", lif_a.leda.lvidlpa.sig);
       printf("      Number of Items:     %s\n", lif_a.leda.lvidlpa.NumItemIDs);
+      if (itemid > 0) // If the '-i' option is switched on
+      {
+        text_itemids(lif.led.lvidlp.Items, lif_a.leda.lvidlpa.Items, lif.led.lvidlp.NumItemIDs, 6);
+        printf("      IDList Terminator    2 bytes\n");
+      }
+      else
+      {
+        printf("      (Use the '-i' option to see the contents)\n");
+      }
     }
   }
   printf("\n");
@@ -1447,19 +2286,17 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
   struct LIF_A   lif_a;
   struct stat    statbuf;
   char           buf[200];
-  int            i, j, k, idpos = 0;
-  struct LIF_PROPERTY_STORE_PROPS  psp;
-  struct LIF_SER_PROPSTORE_A  psa;
+  int            i, j;
 
   // Get the stat info for the file itself
-  stat(fname, &statbuf);
+  fstat(fileno(fp), &statbuf);
 
-  if (get_lif(fp, statbuf.st_size, &lif) < 0)
+  if (decode_lif(fp, statbuf.st_size, decode_mask(less), &lif) < 0)
   {
     fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
     return;
   }
-  if (get_lif_a(&lif, &lif_a))
+  if (ascii_lif(&lif, &lif_a, lif_a_opts))
   {
     fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
     return;
@@ -1468,251 +2305,193 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
   if (filecount == 0)
   {
     //Print the header
-    printf("<?xml version=\"1.0\" ?>\n");
-    printf("<!-- lifer, a Windows link file analyser. Version %i.%i.%i -->\n", _MAJOR, _MINOR, _BUILD);
-    printf("<LinkFiles>\n");
+    xml_header();
   }
   // Now deal with individual link files
 
-  printf("<LinkFile>\n");
+  xw_printf(stdout, "<LinkFile>\n");
   // stat data
-  printf("<FileSystemInfo FileName=\"%s\" LinkFileSize=\"%u\">\n", fname, (unsigned int)statbuf.st_size);
-  printf("<FileTimes>\n");
-  printf("<!-- All times are UTC -->\n");
+  xw_printf(stdout, "<FileSystemInfo FileName=\"%s\" LinkFileSize=\"%u\">\n", fname, (unsigned int)statbuf.st_size);
+  xw_printf(stdout, "<FileTimes>\n");
+  xw_printf(stdout, "<!-- All times are UTC -->\n");
   strftime(buf, 29, "%Y-%m-%d %H:%M:%S", gmtime(&statbuf.st_atime));
-  printf("<LastAccessed>%s</LastAccessed>\n", buf);
+  xw_printf(stdout, "<LastAccessed>%s</LastAccessed>\n", buf);
   strftime(buf, 29, "%Y-%m-%d %H:%M:%S", gmtime(&statbuf.st_mtime));
-  printf("<LastModified>%s</LastModified>\n", buf);
+  xw_printf(stdout, "<LastModified>%s</LastModified>\n", buf);
   strftime(buf, 29, "%Y-%m-%d %H:%M:%S", gmtime(&statbuf.st_ctime));
-  printf("<LastChanged>%s</LastChanged>\n", buf);
-  printf("</FileTimes>\n");
-  printf("</FileSystemInfo>\n");
+  xw_printf(stdout, "<LastChanged>%s</LastChanged>\n", buf);
+  xw_printf(stdout, "</FileTimes>\n");
+  xw_printf(stdout, "</FileSystemInfo>\n");
 
-  printf("<EmbeddedInfo>\n");
+  xw_printf(stdout, "<EmbeddedInfo>\n");
   //ShellLinkHeader
-  printf("<ShellLinkHeader Size=\"%s\">\n", lif_a.lha.H_size);
+  xw_printf(stdout, "<ShellLinkHeader Size=\"%s\">\n", lif_a.lha.H_size);
   if (less == 0)
   {
-    printf("<CLSID>%s</CLSID>\n", lif_a.lha.CLSID);
-    printf("<Flags>%s</Flags>\n", lif_a.lha.Flags);
+    xw_printf(stdout, "<CLSID>%s</CLSID>\n", lif_a.lha.CLSID);
+    xw_printf(stdout, "<Flags>%s</Flags>\n", lif_a.lha.Flags);
   }
-  printf("<Attributes>%s</Attributes>\n", lif_a.lha.Attr);
-  printf("<TargetTimes>\n");
-  printf("<!-- Times are UTC -->\n");
+  xw_printf(stdout, "<Attributes>%s</Attributes>\n", lif_a.lha.Attr);
+  xw_printf(stdout, "<TargetTimes>\n");
+  xw_printf(stdout, "<!-- Times are UTC -->\n");
   if (less == 0)
   {
-    printf("<Created>%s</Created>\n", lif_a.lha.CrDate_long);
-    printf("<Accessed>%s</Accessed>\n", lif_a.lha.AcDate_long);
-    printf("<LastWritten>%s</LastWritten>\n", lif_a.lha.WtDate_long);
+    xw_printf(stdout, "<Created>%s</Created>\n", lif_a.lha.CrDate_long);
+    xw_printf(stdout, "<Accessed>%s</Accessed>\n", lif_a.lha.AcDate_long);
+    xw_printf(stdout, "<LastWritten>%s</LastWritten>\n", lif_a.lha.WtDate_long);
   }
   else
   {
-    printf("<Created>%s</Created>\n", lif_a.lha.CrDate);
-    printf("<Accessed>%s</Accessed>\n", lif_a.lha.AcDate);
-    printf("<LastWritten>%s</LastWritten>\n", lif_a.lha.WtDate);
+    xw_printf(stdout, "<Created>%s</Created>\n", lif_a.lha.CrDate);
+    xw_printf(stdout, "<Accessed>%s</Accessed>\n", lif_a.lha.AcDate);
+    xw_printf(stdout, "<LastWritten>%s</LastWritten>\n", lif_a.lha.WtDate);
   }
-  printf("</TargetTimes>\n");
-  printf("<TargetFileSize>%s</TargetFileSize>\n", lif_a.lha.Size);
+  xw_printf(stdout, "</TargetTimes>\n");
+  xw_printf(stdout, "<TargetFileSize>%s</TargetFileSize>\n", lif_a.lha.Size);
   if (less == 0) //omit this stuff if short info required
   {
-    printf("<IconIndex>%s</IconIndex>\n", lif_a.lha.IconIndex);
-    printf("<WindowState>%s</WindowState>\n", lif_a.lha.ShowState);
-    printf("<HotKeys>%s</HotKeys>\n", lif_a.lha.Hotkey);
-    printf("<Reserved1>%s</Reserved1>\n", lif_a.lha.Reserved1);
-    printf("<Reserved2>%s</Reserved2>\n", lif_a.lha.Reserved2);
-    printf("<Reserved3>%s</Reserved3>\n", lif_a.lha.Reserved3);
+    xw_printf(stdout, "<IconIndex>%s</IconIndex>\n", lif_a.lha.IconIndex);
+    xw_printf(stdout, "<WindowState>%s</WindowState>\n", lif_a.lha.ShowState);
+    xw_printf(stdout, "<HotKeys>%s</HotKeys>\n", lif_a.lha.Hotkey);
+    xw_printf(stdout, "<Reserved1>%s</Reserved1>\n", lif_a.lha.Reserved1);
+    xw_printf(stdout, "<Reserved2>%s</Reserved2>\n", lif_a.lha.Reserved2);
+    xw_printf(stdout, "<Reserved3>%s</Reserved3>\n", lif_a.lha.Reserved3);
   }
-  printf("</ShellLinkHeader>\n");
+  xw_printf(stdout, "</ShellLinkHeader>\n");
 
   // ItemIDList
   if (lif.lh.Flags & 0x00000001) //If there is an ItemIDList
   {
     if (less == 0) //IDLists are not printed if the option is for shortened output
     {
-      printf("<LinkTargetIDList Size=\"%u\" NumItemIDs=\"%u\">\n", lif.lidl.IDListSize, lif.lidl.NumItemIDs);
+      xw_printf(stdout, "<LinkTargetIDList Size=\"%u\" NumItemIDs=\"%u\">\n", lif.lidl.IDListSize, lif.lidl.NumItemIDs);
       if (itemid > 0) // If the '-i' option is switched on
       {
-        idpos = lif.lh.H_size;
-        for (i = 0; i < lif.lidl.NumItemIDs; i++)
-        {
-          printf("<ItemID Num=\"%i\" Size=\"%s\">\n", i + 1, lif_a.lidla.Items[i].ItemIDSize);
-          if (find_propstores((unsigned char*)&lif.lidl.Items[i].Data, lif.lidl.Items[i].ItemIDSize, idpos, &psp) == 0)
-          {
-            // If PropStoreProps exist:
-            printf("<PropStoreProps Size=\"%u\" FileOffset=\"%u\" NumStores=\"%u\">\n", psp.Size, psp.Posn, psp.NumStores);
-            for (j = 0; j < psp.NumStores; j++)
-            {
-              if (get_propstore_a(&psp.Stores[j], &psa) == 0)
-              {
-                printf("<PropertyStore Num=\"%u\" Size=\"%s\">\n", j + 1, psa.StorageSize);
-                printf("<Version>%s</Version>\n", psa.Version);
-                printf("<FormatID>%s</FormatID>\n", psa.FormatID.UUID);
-                printf("<NameType>%s</NameType>\n", psa.NameType);
-                printf("<PropValues NumValues=\"%s\">\n", psa.NumValues);
-                for (k = 0; k < psp.Stores[j].NumValues; k++)
-                {
-                  printf("<Value Num=\"%u\" Size=\"%s\">\n", k + 1, psa.PropValues[k].ValueSize);
-                  if (psp.Stores[j].PropValues[k].ValueSize > 0)
-                  {
-                    if (psp.Stores[j].NameType == 0)
-                    {
-                      printf("<NameSize>%s</NameSize>\n", psa.PropValues[k].NameSizeOrID);
-                      printf("<Name>%s</Name>\n", psa.PropValues[k].Name);
-                    }
-                    else
-                    {
-                      printf("<ID>%s</ID>\n", psa.PropValues[k].NameSizeOrID);
-                    }
-                    printf("<Type>%s</Type>\n", psa.PropValues[k].PropertyType);
-                    printf("<Content><![CDATA[%s]]></Content>\n", psa.PropValues[k].Value);
-                  }
-                  printf("</Value>\n");
-                }
-                printf("</PropValues>\n");
-                printf("</PropertyStore>\n");
-              }
-              else
-              {
-                printf("<!-- Unable to interpret Property Store %i -->\n", j);
-              }
-            }
-            printf("</PropStoreProps>\n");
-            idpos += lif.lidl.Items[i].ItemIDSize; // point idpos at the start of the next ItemID
-          }
-          else
-          {
-            printf("<!-- No Property Stores found in this ITemID. Here is the raw data -->\n");
-            printf("<![CDATA[\n");
-            bin2hex((unsigned char*)&lif.lidl.Items[i].Data, lif.lidl.Items[i].ItemIDSize, 1, 16, 0, 1, 0);
-            printf("]]>\n");
-            idpos += lif.lidl.Items[i].ItemIDSize; // point idpos at the start of the next ItemID
-          }
-          printf("</ItemID>\n");
-        }
-        printf("<IDListTerminator Size=\"2\"></IDListTerminator>\n");
+        xml_itemids(lif.lidl.Items, lif_a.lidla.Items, lif.lidl.NumItemIDs);
+        xw_printf(stdout, "<IDListTerminator Size=\"2\"></IDListTerminator>\n");
       }
-      printf("</LinkTargetIDList>\n");
+      xw_printf(stdout, "</LinkTargetIDList>\n");
     }
   }
 
   //LinkInfo
   if (lif.lh.Flags & 0x00000002) //If there is a LinkInfo
   {
-    printf("<LinkInfo Size=\"%s\">\n", lif_a.lia.Size);
+    xw_printf(stdout, "<LinkInfo Size=\"%s\">\n", lif_a.lia.Size);
     if (less == 0)
     {
-      printf("<LinkInfoHeader Size=\"%s\">\n", lif_a.lia.HeaderSize);
-      printf("<Flags>%s</Flags>\n", lif_a.lia.Flags);
-      printf("<VolumeIDOffset>%s</VolumeIDOffset>\n", lif_a.lia.IDOffset);
-      printf("<BasePathOffset>%s</BasePathOffset>\n", lif_a.lia.LBPOffset);
-      printf("<CNRLinkOffset>%s</CNRLinkOffset>\n", lif_a.lia.CNRLOffset);
-      printf("<CPSOffset>%s</CPSOffset>\n", lif_a.lia.CPSOffset);
-      printf("<LBPOffsetUnicode>%s</LBPOffsetUnicode>\n", lif_a.lia.LBPOffsetU);
-      printf("<CPSOffsetUnicode>%s</CPSOffsetUnicode>\n", lif_a.lia.CPSOffsetU);
-      printf("</LinkInfoHeader>\n");
+      xw_printf(stdout, "<LinkInfoHeader Size=\"%s\">\n", lif_a.lia.HeaderSize);
+      xw_printf(stdout, "<Flags>%s</Flags>\n", lif_a.lia.Flags);
+      xw_printf(stdout, "<VolumeIDOffset>%s</VolumeIDOffset>\n", lif_a.lia.IDOffset);
+      xw_printf(stdout, "<BasePathOffset>%s</BasePathOffset>\n", lif_a.lia.LBPOffset);
+      xw_printf(stdout, "<CNRLinkOffset>%s</CNRLinkOffset>\n", lif_a.lia.CNRLOffset);
+      xw_printf(stdout, "<CPSOffset>%s</CPSOffset>\n", lif_a.lia.CPSOffset);
+      xw_printf(stdout, "<LBPOffsetUnicode>%s</LBPOffsetUnicode>\n", lif_a.lia.LBPOffsetU);
+      xw_printf(stdout, "<CPSOffsetUnicode>%s</CPSOffsetUnicode>\n", lif_a.lia.CPSOffsetU);
+      xw_printf(stdout, "</LinkInfoHeader>\n");
     }
     //There is a Volume ID structure (& LBP)
     if (lif.li.Flags & 0x00000001)
     {
-      printf("<VolumeID Size=\"%s\">\n", lif_a.lia.VolID.Size);
-      printf("<DriveType>%s</DriveType>\n", lif_a.lia.VolID.DriveType);
-      printf("<DriveSerialNo>%s</DriveSerialNo>\n", lif_a.lia.VolID.DriveSN);
+      xw_printf(stdout, "<VolumeID Size=\"%s\">\n", lif_a.lia.VolID.Size);
+      xw_printf(stdout, "<DriveType>%s</DriveType>\n", lif_a.lia.VolID.DriveType);
+      xw_printf(stdout, "<DriveSerialNo>%s</DriveSerialNo>\n", lif_a.lia.VolID.DriveSN);
       if (less == 0)
       {
         if (!(lif.li.HeaderSize >= 0x00000024))//Which to use?
                                                //ANSI or Unicode versions
         {
-          printf("<VolLabelOffset>%s</VolLabelOffset>\n", lif_a.lia.VolID.VLOffset);
+          xw_printf(stdout, "<VolLabelOffset>%s</VolLabelOffset>\n", lif_a.lia.VolID.VLOffset);
         }
         else
         {
-          printf("<VolLabelOffsetUnicode>%s</VolLabelOffsetUnicode>\n", lif_a.lia.VolID.VLOffsetU);
+          xw_printf(stdout, "<VolLabelOffsetUnicode>%s</VolLabelOffsetUnicode>\n", lif_a.lia.VolID.VLOffsetU);
         }
       }
       if (!(lif.li.HeaderSize >= 0x00000024))
       {
-        printf("<VolumeLabel>%s</VolumeLabel>\n", lif_a.lia.VolID.VolumeLabel);
+        xw_printf(stdout, "<VolumeLabel>%s</VolumeLabel>\n", lif_a.lia.VolID.VolumeLabel);
       }
       else
       {
-        printf("<VolumeLabelUnicode>%s</VolumeLabelUnicode>\n", lif_a.lia.VolID.VolumeLabelU);
+        xw_printf(stdout, "<VolumeLabelUnicode>%s</VolumeLabelUnicode>\n", lif_a.lia.VolID.VolumeLabelU);
       }
-      printf("<LocalBasePath>%s</LocalBasePath>\n", lif_a.lia.LBP);
-      printf("</VolumeID>\n");
+      xw_printf(stdout, "<LocalBasePath>%s</LocalBasePath>\n", lif_a.lia.LBP);
+      xw_printf(stdout, "</VolumeID>\n");
     }//End of VolumeID
      //CommonNetworkRelativeLink
     if (lif.li.Flags & 0x00000002)
     {
-      printf("<CommonNetworkRelativeLink Size=\"%s\">\n", lif_a.lia.CNR.Size);
+      xw_printf(stdout, "<CommonNetworkRelativeLink Size=\"%s\">\n", lif_a.lia.CNR.Size);
       if (less == 0)
       {
-        printf("<Flags>%s</Flags>\n", lif_a.lia.CNR.Flags);
-        printf("<NetNameOffset>%s</NetNameOffset>\n", lif_a.lia.CNR.NetNameOffset);
-        printf("<DeviceNameOffset>%s</DeviceNameOffset>\n", lif_a.lia.CNR.DeviceNameOffset);
+        xw_printf(stdout, "<Flags>%s</Flags>\n", lif_a.lia.CNR.Flags);
+        xw_printf(stdout, "<NetNameOffset>%s</NetNameOffset>\n", lif_a.lia.CNR.NetNameOffset);
+        xw_printf(stdout, "<DeviceNameOffset>%s</DeviceNameOffset>\n", lif_a.lia.CNR.DeviceNameOffset);
       }
-      printf("<NetProviderType>%s</NetProviderType>\n", lif_a.lia.CNR.NetworkProviderType);
+      xw_printf(stdout, "<NetProviderType>%s</NetProviderType>\n", lif_a.lia.CNR.NetworkProviderType);
       if ((less == 0) && (lif.li.CNR.NetNameOffset > 0x00000014))
       {
-        printf("<NetNameOffsetUnicode>%s</NetNameOffsetUnicode>\n", lif_a.lia.CNR.NetNameOffsetU);
-        printf("<DeviceNameOffsetUnicode>%s</DeviceNameOffsetUnicode>\n", lif_a.lia.CNR.DeviceNameOffsetU);
+        xw_printf(stdout, "<NetNameOffsetUnicode>%s</NetNameOffsetUnicode>\n", lif_a.lia.CNR.NetNameOffsetU);
+        xw_printf(stdout, "<DeviceNameOffsetUnicode>%s</DeviceNameOffsetUnicode>\n", lif_a.lia.CNR.DeviceNameOffsetU);
       }
-      printf("<NetName>%s</NetName>\n", lif_a.lia.CNR.NetName);
-      printf("<DeviceName>%s</DeviceName>\n", lif_a.lia.CNR.DeviceName);
+      xw_printf(stdout, "<NetName>%s</NetName>\n", lif_a.lia.CNR.NetName);
+      xw_printf(stdout, "<DeviceName>%s</DeviceName>\n", lif_a.lia.CNR.DeviceName);
       if (lif.li.CNR.NetNameOffset > 0x00000014)
       {
-        printf("<NetNameUnicode>%s</NetNameUnicode>\n", lif_a.lia.CNR.NetNameU);
-        printf("<DeviceNameUnicode>%s</DeviceNameUnicode>\n", lif_a.lia.CNR.DeviceNameU);
+        xw_printf(stdout, "<NetNameUnicode>%s</NetNameUnicode>\n", lif_a.lia.CNR.NetNameU);
+        xw_printf(stdout, "<DeviceNameUnicode>%s</DeviceNameUnicode>\n", lif_a.lia.CNR.DeviceNameU);
       }
-      printf("<CommonPathSuffix>%s</CommonPathSuffix>\n", lif_a.lia.CPS);
+      xw_printf(stdout, "<CommonPathSuffix>%s</CommonPathSuffix>\n", lif_a.lia.CPS);
 
-      printf("</CommonNetworkRelativeLink>\n");
+      xw_printf(stdout, "</CommonNetworkRelativeLink>\n");
     }
     if (lif.li.LBPOffsetU > 0)
     {
-      printf("<LocalBasePathUnicode>%s\n", lif_a.lia.LBPU);
+      xw_printf(stdout, "<LocalBasePathUnicode>%s</LocalBasePathUnicode>\n", lif_a.lia.LBPU);
     }
     if (lif.li.CPSOffsetU > 0)
     {
-      printf("<CommonPathSuffixUnicode>%s</CommonPathSuffixUnicode>\n", lif_a.lia.CPSU);
+      xw_printf(stdout, "<CommonPathSuffixUnicode>%s</CommonPathSuffixUnicode>\n", lif_a.lia.CPSU);
     }
-    printf("</LinkInfo>\n");
+    xw_printf(stdout, "</LinkInfo>\n");
   }//End of Link Info
 
    //STRINGDATA
   if (lif.lh.Flags & 0x0000007C)
   {
-    printf("<StringData Size=\"%s\">\n", lif_a.lsda.Size);
+    xw_printf(stdout, "<StringData Size=\"%s\">\n", lif_a.lsda.Size);
     if (lif.lh.Flags & 0x00000004)
     {
-      printf("<NAME_STRING Characters=\"%s\">%s</NAME_STRING>\n", lif_a.lsda.CountChars[0], lif_a.lsda.Data[0]);
+      xw_printf(stdout, "<NAME_STRING Characters=\"%s\">%s</NAME_STRING>\n", lif_a.lsda.CountChars[0], lif_a.lsda.Data[0]);
     }
     if (lif.lh.Flags & 0x00000008)
     {
-      printf("<RELATIVE_PATH Characters=\"%s\">%s</RELATIVE_PATH>\n", lif_a.lsda.CountChars[1], lif_a.lsda.Data[1]);
+      xw_printf(stdout, "<RELATIVE_PATH Characters=\"%s\">%s</RELATIVE_PATH>\n", lif_a.lsda.CountChars[1], lif_a.lsda.Data[1]);
     }
     if (lif.lh.Flags & 0x00000010)
     {
-      printf("<WORKING_DIR Characters=\"%s\">%s</WORKING_DIR>\n", lif_a.lsda.CountChars[2], lif_a.lsda.Data[2]);
+      xw_printf(stdout, "<WORKING_DIR Characters=\"%s\">%s</WORKING_DIR>\n", lif_a.lsda.CountChars[2], lif_a.lsda.Data[2]);
     }
     if (lif.lh.Flags & 0x00000020)
     {
-      printf("<COMMAND_LINE_ARGUMENTS Characters=\"%s\">%s</COMMAND_LINE_ARGUMENTS>\n", lif_a.lsda.CountChars[3], lif_a.lsda.Data[3]);
+      xw_printf(stdout, "<COMMAND_LINE_ARGUMENTS Characters=\"%s\">%s</COMMAND_LINE_ARGUMENTS>\n", lif_a.lsda.CountChars[3], lif_a.lsda.Data[3]);
     }
     if (lif.lh.Flags & 0x00000040)
     {
-      printf("<ICON_LOCATION Characters=\"%s\">%s</ICON_LOCATION>\n", lif_a.lsda.CountChars[4], lif_a.lsda.Data[4]);
+      xw_printf(stdout, "<ICON_LOCATION Characters=\"%s\">%s</ICON_LOCATION>\n", lif_a.lsda.CountChars[4], lif_a.lsda.Data[4]);
     }
-    printf("</StringData>\n");
+    xw_printf(stdout, "</StringData>\n");
   }// End of STRINGDATA
 
   //EXTRADATA
-  printf("<ExtraData Size=\"%s\" EDStructures=\"%s\">\n", lif_a.leda.Size, lif_a.leda.edtypes);
+  xw_printf(stdout, "<ExtraData Size=\"%s\" EDStructures=\"%s\">\n", lif_a.leda.Size, lif_a.leda.edtypes);
   if (lif.led.edtypes & CONSOLE_PROPS)
   {
-    printf("<ConsoleDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lcpa.Posn, lif_a.leda.lcpa.Size);
+    xw_printf(stdout, "<ConsoleDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lcpa.Posn, lif_a.leda.lcpa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lcpa.sig);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lcpa.sig);
       //Build the FillAttributes string
       buf[0] = (char)0;
       if (lif.led.lcp.FillAttributes & 0x0001) strncat(buf, "FOREGROUND_BLUE | ", 18);
@@ -1732,7 +2511,7 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         snprintf(buf, 300, "[NONE]");
       }
-      printf("<FillAttributes>%s  %s</FillAttributes>\n", lif_a.leda.lcpa.FillAttributes, buf);
+      xw_printf(stdout, "<FillAttributes>%s  %s</FillAttributes>\n", lif_a.leda.lcpa.FillAttributes, buf);
       buf[0] = (char)0;
       if (lif.led.lcp.PopupFillAttributes & 0x0001) strncat(buf, "FOREGROUND_BLUE | ", 18);
       if (lif.led.lcp.PopupFillAttributes & 0x0002) strncat(buf, "FOREGROUND_GREEN | ", 19);
@@ -1751,17 +2530,17 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         snprintf(buf, 300, "[NONE]");
       }
-      printf("<PopupFillAttributes>%s  %s</PopupFillAttributes>\n", lif_a.leda.lcpa.PopupFillAttributes, buf);
-      printf("<ScreenBufSizeX>%s</ScreenBufSizeX>\n", lif_a.leda.lcpa.ScreenBufferSizeX);
-      printf("<ScreenBufSizeY>%s</ScreenBufSizeY>\n", lif_a.leda.lcpa.ScreenBufferSizeY);
-      printf("<WindowSizeX>%s</WindowSizeX>\n", lif_a.leda.lcpa.WindowSizeX);
-      printf("<WindowSizeY>%s</WindowSizeY>\n", lif_a.leda.lcpa.WindowSizeY);
-      printf("<WindowOriginX>%s</WindowOriginX>\n", lif_a.leda.lcpa.WindowOriginX);
-      printf("<WindowOriginY>%s</WindowOriginY>\n", lif_a.leda.lcpa.WindowOriginY);
-      printf("<Unused1>%s</Unused1>\n", lif_a.leda.lcpa.Unused1);
-      printf("<Unused2>%s</Unused2>\n", lif_a.leda.lcpa.Unused2);
-      printf("<FontHeight>%s</FontHeight>\n", lif_a.leda.lcpa.FontHeight);
-      printf("<FontWidth>%s</FontWidth>\n", lif_a.leda.lcpa.FontWidth);
+      xw_printf(stdout, "<PopupFillAttributes>%s  %s</PopupFillAttributes>\n", lif_a.leda.lcpa.PopupFillAttributes, buf);
+      xw_printf(stdout, "<ScreenBufSizeX>%s</ScreenBufSizeX>\n", lif_a.leda.lcpa.ScreenBufferSizeX);
+      xw_printf(stdout, "<ScreenBufSizeY>%s</ScreenBufSizeY>\n", lif_a.leda.lcpa.ScreenBufferSizeY);
+      xw_printf(stdout, "<WindowSizeX>%s</WindowSizeX>\n", lif_a.leda.lcpa.WindowSizeX);
+      xw_printf(stdout, "<WindowSizeY>%s</WindowSizeY>\n", lif_a.leda.lcpa.WindowSizeY);
+      xw_printf(stdout, "<WindowOriginX>%s</WindowOriginX>\n", lif_a.leda.lcpa.WindowOriginX);
+      xw_printf(stdout, "<WindowOriginY>%s</WindowOriginY>\n", lif_a.leda.lcpa.WindowOriginY);
+      xw_printf(stdout, "<Unused1>%s</Unused1>\n", lif_a.leda.lcpa.Unused1);
+      xw_printf(stdout, "<Unused2>%s</Unused2>\n", lif_a.leda.lcpa.Unused2);
+      xw_printf(stdout, "<FontHeight>%s</FontHeight>\n", lif_a.leda.lcpa.FontHeight);
+      xw_printf(stdout, "<FontWidth>%s</FontWidth>\n", lif_a.leda.lcpa.FontWidth);
       buf[0] = (char)0;
       switch (lif.led.lcp.FontFamily_Family)
       {
@@ -1786,7 +2565,7 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       default:
         strncat(buf, "UNKNOWN (Not allowed in specification)", 39);
       }
-      printf("<FontFamily>%s  %s</FontFamily>\n", lif_a.leda.lcpa.FontFamily, buf);
+      xw_printf(stdout, "<FontFamily>%s  %s</FontFamily>\n", lif_a.leda.lcpa.FontFamily, buf);
       buf[0] = (char)0;
       if (lif.led.lcp.FontFamily_Pitch == 0x0000) strncat(buf, "TMPF_NONE | ", 12);
       else
@@ -1809,7 +2588,7 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         snprintf(buf, 300, "Unknown");
       }
-      printf("<FontPitch>%s  %s</FontPitch>\n", lif_a.leda.lcpa.FontPitch, buf);
+      xw_printf(stdout, "<FontPitch>%s  %s</FontPitch>\n", lif_a.leda.lcpa.FontPitch, buf);
       buf[0] = (char)0;
       if (lif.led.lcp.FontWeight < 700)
       {
@@ -1819,8 +2598,8 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         strncat(buf, "A bold font", 11);
       }
-      printf("<FontWeight>%s  %s</FontWeight>\n", lif_a.leda.lcpa.FontWeight, buf);
-      printf("<FaceName>%s</FaceName>\n", lif_a.leda.lcpa.FaceName);
+      xw_printf(stdout, "<FontWeight>%s  %s</FontWeight>\n", lif_a.leda.lcpa.FontWeight, buf);
+      xw_printf(stdout, "<FaceName>%s</FaceName>\n", lif_a.leda.lcpa.FaceName);
       buf[0] = (char)0;
       if (lif.led.lcp.CursorSize <= 25)
       {
@@ -1838,7 +2617,7 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         strncat(buf, "An undefined cursor size", 25);
       }
-      printf("<CursorSize>%s  %s</CursorSize>\n", lif_a.leda.lcpa.CursorSize, buf);
+      xw_printf(stdout, "<CursorSize>%s  %s</CursorSize>\n", lif_a.leda.lcpa.CursorSize, buf);
       buf[0] = (char)0;
       if (lif.led.lcp.FullScreen == 0)
       {
@@ -1848,7 +2627,7 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         strncat(buf, "On", 2);
       }
-      printf("<FullScreen>%s  %s</FullScreen>\n", lif_a.leda.lcpa.FullScreen, buf);
+      xw_printf(stdout, "<FullScreen>%s  %s</FullScreen>\n", lif_a.leda.lcpa.FullScreen, buf);
       buf[0] = (char)0;
       if (lif.led.lcp.QuickEdit == 0)
       {
@@ -1858,7 +2637,7 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         strncat(buf, "On", 2);
       }
-      printf("<QuickEdit>%s  %s</QuickEdit>\n", lif_a.leda.lcpa.QuickEdit, buf);
+      xw_printf(stdout, "<QuickEdit>%s  %s</QuickEdit>\n", lif_a.leda.lcpa.QuickEdit, buf);
       buf[0] = (char)0;
       if (lif.led.lcp.InsertMode == 0)
       {
@@ -1868,7 +2647,7 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         strncat(buf, "Enabled", 7);
       }
-      printf("<InsertMode>%s  %s</InsertMode>\n", lif_a.leda.lcpa.InsertMode, buf);
+      xw_printf(stdout, "<InsertMode>%s  %s</InsertMode>\n", lif_a.leda.lcpa.InsertMode, buf);
       buf[0] = (char)0;
       if (lif.led.lcp.AutoPosition == 0)
       {
@@ -1878,9 +2657,9 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         strncat(buf, "On", 19);
       }
-      printf("<AutoPosition>%s  %s</AutoPosition>\n", lif_a.leda.lcpa.AutoPosition, buf);
-      printf("<HistoryBufferSize>%s</HistoryBufferSize>\n", lif_a.leda.lcpa.HistoryBufferSize);
-      printf("<NumberOfHistoryBuffers>%s</NumberOfHistoryBuffers>\n", lif_a.leda.lcpa.NumberOfHistoryBuffers);
+      xw_printf(stdout, "<AutoPosition>%s  %s</AutoPosition>\n", lif_a.leda.lcpa.AutoPosition, buf);
+      xw_printf(stdout, "<HistoryBufferSize>%s</HistoryBufferSize>\n", lif_a.leda.lcpa.HistoryBufferSize);
+      xw_printf(stdout, "<NumberOfHistoryBuffers>%s</NumberOfHistoryBuffers>\n", lif_a.leda.lcpa.NumberOfHistoryBuffers);
       buf[0] = (char)0;
       if (lif.led.lcp.HistoryNoDup == 0)
       {
@@ -1890,343 +2669,1465 @@ void xml_out(FILE* fp, char* fname, int less, int itemid)
       {
         strncat(buf, "Duplicates allowed", 18);
       }
-      printf("<HistoryNoDuplicates>%s  %s</HistoryNoDuplicates>\n", lif_a.leda.lcpa.HistoryNoDup, buf);
-      printf("<ColorTable>\n");
-      printf("%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[0],
+      xw_printf(stdout, "<HistoryNoDuplicates>%s  %s</HistoryNoDuplicates>\n", lif_a.leda.lcpa.HistoryNoDup, buf);
+      xw_printf(stdout, "<ColorTable>\n");
+      xw_printf(stdout, "%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[0],
         lif_a.leda.lcpa.ColorTable[1],
         lif_a.leda.lcpa.ColorTable[2],
         lif_a.leda.lcpa.ColorTable[3]);
-      printf("%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[4],
+      xw_printf(stdout, "%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[4],
         lif_a.leda.lcpa.ColorTable[5],
         lif_a.leda.lcpa.ColorTable[6],
         lif_a.leda.lcpa.ColorTable[7]);
-      printf("%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[8],
+      xw_printf(stdout, "%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[8],
         lif_a.leda.lcpa.ColorTable[9],
         lif_a.leda.lcpa.ColorTable[10],
         lif_a.leda.lcpa.ColorTable[11]);
-      printf("%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[12],
+      xw_printf(stdout, "%s %s %s %s\n", lif_a.leda.lcpa.ColorTable[12],
         lif_a.leda.lcpa.ColorTable[13],
         lif_a.leda.lcpa.ColorTable[14],
         lif_a.leda.lcpa.ColorTable[15]);
-      printf("</ColorTable>\n");
+      xw_printf(stdout, "</ColorTable>\n");
     }
-    printf("</ConsoleDataBlock>\n");
+    xw_printf(stdout, "</ConsoleDataBlock>\n");
   }
   if (lif.led.edtypes & CONSOLE_FE_PROPS)
   {
-    printf("<ConsoleFEDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lcfepa.Posn, lif_a.leda.lcfepa.Size);
+    xw_printf(stdout, "<ConsoleFEDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lcfepa.Posn, lif_a.leda.lcfepa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lcfepa.sig);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lcfepa.sig);
     }
-    printf("<CodePage>%s</CodePage>\n", lif_a.leda.lcfepa.CodePage);
-    printf("</ConsoleFEDataBlock>\n");
+    xw_printf(stdout, "<CodePage>%s</CodePage>\n", lif_a.leda.lcfepa.CodePage);
+    xw_printf(stdout, "</ConsoleFEDataBlock>\n");
   }
   if (lif.led.edtypes & DARWIN_PROPS)
   {
-    printf("<DarwinDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.ldpa.Posn, lif_a.leda.ldpa.Size);
+    xw_printf(stdout, "<DarwinDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.ldpa.Posn, lif_a.leda.ldpa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.ldpa.sig);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.ldpa.sig);
     }
-    printf("<DarwinDataAnsi><![CDATA[%s]]></DarwinDataAnsi>\n", lif_a.leda.ldpa.DarwinDataAnsi);
-    printf("<DarwinDataUnicode><![CDATA[%s]]></DarwinDataUnicode>\n", lif_a.leda.ldpa.DarwinDataUnicode);
-    printf("</DarwinDataBlock>\n");
+    xw_printf(stdout, "<DarwinDataAnsi>%s</DarwinDataAnsi>\n", lif_a.leda.ldpa.DarwinDataAnsi);
+    xw_printf(stdout, "<DarwinDataUnicode>%s</DarwinDataUnicode>\n", lif_a.leda.ldpa.DarwinDataUnicode);
+    xw_printf(stdout, "</DarwinDataBlock>\n");
   }
   if (lif.led.edtypes & ENVIRONMENT_PROPS)
   {
-    printf("<EnvironmentVariableDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lepa.Posn, lif_a.leda.lepa.Size);
+    xw_printf(stdout, "<EnvironmentVariableDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lepa.Posn, lif_a.leda.lepa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lepa.sig);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lepa.sig);
     }
-    printf("<TargetAnsi><![CDATA[%s]]></TargetAnsi>\n", lif_a.leda.lepa.TargetAnsi);
-    printf("<TargetUnicode><![CDATA[%s]]></TargetUnicode>\n", lif_a.leda.lepa.TargetUnicode);
-    printf("</EnvironmentVariableDataBlock>\n");
+    xw_printf(stdout, "<TargetAnsi>%s</TargetAnsi>\n", lif_a.leda.lepa.TargetAnsi);
+    xw_printf(stdout, "<TargetUnicode>%s</TargetUnicode>\n", lif_a.leda.lepa.TargetUnicode);
+    xw_printf(stdout, "</EnvironmentVariableDataBlock>\n");
   }
   if (lif.led.edtypes & ICON_ENVIRONMENT_PROPS)
   {
-    printf("<IconEnvironmentDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.liepa.Posn, lif_a.leda.liepa.Size);
+    xw_printf(stdout, "<IconEnvironmentDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.liepa.Posn, lif_a.leda.liepa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.liepa.sig);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.liepa.sig);
     }
-    printf("<TargetAnsi><![CDATA[%s]]></TargetAnsi>\n", lif_a.leda.liepa.TargetAnsi);
-    printf("<TargetUnicode><![CDATA[%s]]></TargetUnicode>\n", lif_a.leda.liepa.TargetUnicode);
-    printf("</IconEnvironmentDataBlock>\n");
+    xw_printf(stdout, "<TargetAnsi>%s</TargetAnsi>\n", lif_a.leda.liepa.TargetAnsi);
+    xw_printf(stdout, "<TargetUnicode>%s</TargetUnicode>\n", lif_a.leda.liepa.TargetUnicode);
+    xw_printf(stdout, "</IconEnvironmentDataBlock>\n");
   }
   if (lif.led.edtypes & KNOWN_FOLDER_PROPS)
   {
     //printf("<KnownFolderDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lkfpa.Posn, lif_a.leda.lkfpa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lkfpa.sig);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lkfpa.sig);
     }
-    printf("<KnownFolderID><![CDATA[%s]]></KnownFolderID>\n", lif_a.leda.lkfpa.KFGUID.UUID);
+    xw_printf(stdout, "<KnownFolderID>%s</KnownFolderID>\n", lif_a.leda.lkfpa.KFGUID.UUID);
+    xw_printf(stdout, "<KnownFolderName>%s</KnownFolderName>\n", lif_a.leda.lkfpa.KFGUID.Name);
     if (less == 0)
     {
-      printf("<LocalOffset>%s</LocalOffset>\n", lif_a.leda.lkfpa.KFOffset);
+      xw_printf(stdout, "<LocalOffset>%s</LocalOffset>\n", lif_a.leda.lkfpa.KFOffset);
     }
   }
   if (lif.led.edtypes & PROPERTY_STORE_PROPS)
   {
-    printf("<PropertyStoreDataBlock FileOffset=\"%s\" Size=\"%s\" NumStores=\"%s\">\n", lif_a.leda.lpspa.Posn, lif_a.leda.lpspa.Size, lif_a.leda.lpspa.NumStores);
+    xw_printf(stdout, "<PropertyStoreDataBlock FileOffset=\"%s\" Size=\"%s\" NumStores=\"%s\">\n", lif_a.leda.lpspa.Posn, lif_a.leda.lpspa.Size, lif_a.leda.lpspa.NumStores);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lpspa.sig);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lpspa.sig);
       for (i = 0; i < lif.led.lpsp.NumStores; i++)
       {
-        printf("<PropertyStore Size=\"%s\" NumValues=\"%s\">\n", lif_a.leda.lpspa.Stores[i].StorageSize, lif_a.leda.lpspa.Stores[i].NumValues);
-        printf("<Version>%s</Version>\n", lif_a.leda.lpspa.Stores[i].Version);
-        printf("<FormatID>%s</FormatID>\n", lif_a.leda.lpspa.Stores[i].FormatID.UUID);
-        printf("<NameType>%s</NameType>\n", lif_a.leda.lpspa.Stores[i].NameType);
+        xw_printf(stdout, "<PropertyStore Size=\"%s\" NumValues=\"%s\">\n", lif_a.leda.lpspa.Stores[i].StorageSize, lif_a.leda.lpspa.Stores[i].NumValues);
+        xw_printf(stdout, "<Version>%s</Version>\n", lif_a.leda.lpspa.Stores[i].Version);
+        xw_printf(stdout, "<FormatID>%s</FormatID>\n", lif_a.leda.lpspa.Stores[i].FormatID.UUID);
+        xw_printf(stdout, "<NameType>%s</NameType>\n", lif_a.leda.lpspa.Stores[i].NameType);
         for (j = 0; j < lif.led.lpsp.Stores[i].NumValues; j++)
         {
-          printf("<PropertyValue Size=\"%s\">\n", lif_a.leda.lpspa.Stores[i].PropValues[j].ValueSize);
+          xw_printf(stdout, "<PropertyValue Size=\"%s\">\n", lif_a.leda.lpspa.Stores[i].PropValues[j].ValueSize);
           if (lif.led.lpsp.Stores[i].PropValues[j].ValueSize > 0)
           {
             if (lif.led.lpsp.Stores[i].NameType == 0)
             {
-              printf("<NameSize>%s</NameSize>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].NameSizeOrID);
-              printf("<Name>%s</Name>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].Name);
+              xw_printf(stdout, "<NameSize>%s</NameSize>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].NameSizeOrID);
+              xw_printf(stdout, "<Name>%s</Name>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].Name);
             }
             else
             {
-              printf("<ID>%s</ID>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].NameSizeOrID);
+              xw_printf(stdout, "<ID>%s</ID>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].NameSizeOrID);
+              xw_printf(stdout, "<KeyName>%s</KeyName>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].KeyName);
             }
-            printf("<PropertyType>%s</PropertyType>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].PropertyType);
-            printf("<Value><![CDATA[%s]]></Value>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].Value);
+            xw_printf(stdout, "<PropertyType>%s</PropertyType>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].PropertyType);
+            xw_printf(stdout, "<Value>%s</Value>\n", lif_a.leda.lpspa.Stores[i].PropValues[j].Value);
           }
-          printf("</PropertyValue>\n");
+          xw_printf(stdout, "</PropertyValue>\n");
         }
-        printf("</PropertyStore>\n");
+        xw_printf(stdout, "</PropertyStore>\n");
       }
     }
-    printf("</PropertyStoreDataBlock>");
+    xw_printf(stdout, "</PropertyStoreDataBlock>");
   }
 
   if (lif.led.edtypes & SHIM_PROPS)
   {
-    printf("<ShimDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lspa.Posn, lif_a.leda.lspa.Size);
+    xw_printf(stdout, "<ShimDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lspa.Posn, lif_a.leda.lspa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lspa.sig);
-      printf("<LayerName>%s</LayerName>\n", lif_a.leda.lspa.LayerName);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lspa.sig);
+      xw_printf(stdout, "<LayerName>%s</LayerName>\n", lif_a.leda.lspa.LayerName);
     }
-    printf("</ShimDataBlock>\n");
+    xw_printf(stdout, "</ShimDataBlock>\n");
   }
 
   if (lif.led.edtypes & SPECIAL_FOLDER_PROPS)
   {
-    printf("<SpecialFolderDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lsfpa.Posn, lif_a.leda.lsfpa.Size);
+    xw_printf(stdout, "<SpecialFolderDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lsfpa.Posn, lif_a.leda.lsfpa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lsfpa.sig);
-      printf("<FolderID>%s</FolderID>\n", lif_a.leda.lsfpa.SpecialFolderID);
-      printf("<Offset>%s</Offset>\n", lif_a.leda.lsfpa.Offset);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lsfpa.sig);
+      xw_printf(stdout, "<FolderID>%s</FolderID>\n", lif_a.leda.lsfpa.SpecialFolderID);
+      xw_printf(stdout, "<Offset>%s</Offset>\n", lif_a.leda.lsfpa.Offset);
     }
-    printf("</SpecialFolderDataBlock>\n");
+    xw_printf(stdout, "</SpecialFolderDataBlock>\n");
   }
 
   if (lif.led.edtypes & TRACKER_PROPS)
   {
-    printf("<TrackerDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.ltpa.Posn, lif_a.leda.ltpa.Size);
+    xw_printf(stdout, "<TrackerDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.ltpa.Posn, lif_a.leda.ltpa.Size);
     if (less == 0)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.ltpa.sig);
-      printf("<Length>%s</Length>\n", lif_a.leda.ltpa.Length);
-      printf("<Version>%s</Version>\n", lif_a.leda.ltpa.Version);
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.ltpa.sig);
+      xw_printf(stdout, "<Length>%s</Length>\n", lif_a.leda.ltpa.Length);
+      xw_printf(stdout, "<Version>%s</Version>\n", lif_a.leda.ltpa.Version);
     }
-    printf("<MachineID>%s</MachineID>\n", lif_a.leda.ltpa.MachineID);
-    printf("<Droid1>\n");
-    printf("<UUID>\n%s\n", lif_a.leda.ltpa.Droid1.UUID);
+    xw_printf(stdout, "<MachineID>%s</MachineID>\n", lif_a.leda.ltpa.MachineID);
+    xw_printf(stdout, "<Droid1>\n");
+    xw_printf(stdout, "<UUID>\n%s\n", lif_a.leda.ltpa.Droid1.UUID);
     if (less == 0)
     {
-      printf("<Version>%s</Version>\n", lif_a.leda.ltpa.Droid1.Version);
-      printf("<Variant>%s</Variant>\n", lif_a.leda.ltpa.Droid1.Variant);
+      xw_printf(stdout, "<Version>%s</Version>\n", lif_a.leda.ltpa.Droid1.Version);
+      xw_printf(stdout, "<Variant>%s</Variant>\n", lif_a.leda.ltpa.Droid1.Variant);
     }
     if ((lif_a.leda.ltpa.Droid1.Version[0] == '1')
       & (lif_a.leda.ltpa.Droid1.Version[1] == ' '))
     {
-      printf("<Sequence>%s</Sequence>\n",
+      xw_printf(stdout, "<Sequence>%s</Sequence>\n",
         lif_a.leda.ltpa.Droid1.ClockSeq);
       if (less == 0)
       {
-        printf("<Time>%s</Time>\n",
+        xw_printf(stdout, "<Time>%s</Time>\n",
           lif_a.leda.ltpa.Droid1.Time_long);
       }
       else
       {
-        printf("<Time>%s</Time>\n", lif_a.leda.ltpa.Droid1.Time);
+        xw_printf(stdout, "<Time>%s</Time>\n", lif_a.leda.ltpa.Droid1.Time);
       }
-      printf("<Node><!-- Mac Address -->%s</Node>\n",
+      xw_printf(stdout, "<Node><!-- Mac Address -->%s</Node>\n",
         lif_a.leda.ltpa.Droid1.Node);
     }
-    printf("</UUID>\n");
-    printf("</Droid1>\n");
+    xw_printf(stdout, "</UUID>\n");
+    xw_printf(stdout, "</Droid1>\n");
 
-    printf("<Droid2>\n");
-    printf("<UUID>\n%s\n", lif_a.leda.ltpa.Droid2.UUID);
+    xw_printf(stdout, "<Droid2>\n");
+    xw_printf(stdout, "<UUID>\n%s\n", lif_a.leda.ltpa.Droid2.UUID);
     if (less == 0)
     {
-      printf("<Version>%s</Version>\n", lif_a.leda.ltpa.Droid2.Version);
-      printf("<Variant>%s</Variant>\n", lif_a.leda.ltpa.Droid2.Variant);
+      xw_printf(stdout, "<Version>%s</Version>\n", lif_a.leda.ltpa.Droid2.Version);
+      xw_printf(stdout, "<Variant>%s</Variant>\n", lif_a.leda.ltpa.Droid2.Variant);
     }
     if ((lif_a.leda.ltpa.Droid2.Version[0] == '1')
       & (lif_a.leda.ltpa.Droid2.Version[1] == ' '))
     {
-      printf("<Sequence>%s</Sequence>\n",
+      xw_printf(stdout, "<Sequence>%s</Sequence>\n",
         lif_a.leda.ltpa.Droid2.ClockSeq);
       if (less == 0)
       {
-        printf("<Time>%s</Time>\n",
+        xw_printf(stdout, "<Time>%s</Time>\n",
           lif_a.leda.ltpa.Droid2.Time_long);
       }
       else
       {
-        printf("<Time>%s</Time>\n", lif_a.leda.ltpa.Droid2.Time);
+        xw_printf(stdout, "<Time>%s</Time>\n", lif_a.leda.ltpa.Droid2.Time);
       }
-      printf("<Node><!-- Mac Address -->%s</Node>\n",
+      xw_printf(stdout, "<Node><!-- Mac Address -->%s</Node>\n",
         lif_a.leda.ltpa.Droid2.Node);
     }
-    printf("</UUID>\n");
-    printf("</Droid2>\n");
+    xw_printf(stdout, "</UUID>\n");
+    xw_printf(stdout, "</Droid2>\n");
 
     //Rather a simplistic test to see if the two sets of Droids are the same
     if (!((lif.led.ltp.Droid1.Data1 == lif.led.ltp.DroidBirth1.Data1)
       & (lif.led.ltp.Droid2.Data1 == lif.led.ltp.DroidBirth2.Data1)
       & (less != 0)))
     {
-      printf("<DroidBirth1>\n");
-      printf("<UUID>\n%s\n", lif_a.leda.ltpa.DroidBirth1.UUID);
+      xw_printf(stdout, "<DroidBirth1>\n");
+      xw_printf(stdout, "<UUID>\n%s\n", lif_a.leda.ltpa.DroidBirth1.UUID);
       if (less == 0)
       {
-        printf("<Version>%s</Version>\n", lif_a.leda.ltpa.DroidBirth1.Version);
-        printf("<Variant>%s</Variant>\n", lif_a.leda.ltpa.DroidBirth1.Variant);
+        xw_printf(stdout, "<Version>%s</Version>\n", lif_a.leda.ltpa.DroidBirth1.Version);
+        xw_printf(stdout, "<Variant>%s</Variant>\n", lif_a.leda.ltpa.DroidBirth1.Variant);
       }
       if ((lif_a.leda.ltpa.DroidBirth1.Version[0] == '1')
         & (lif_a.leda.ltpa.DroidBirth1.Version[1] == ' '))
       {
-        printf("<Sequence>%s</Sequence>\n",
+        xw_printf(stdout, "<Sequence>%s</Sequence>\n",
           lif_a.leda.ltpa.DroidBirth1.ClockSeq);
         if (less == 0)
         {
-          printf("<Time>%s</Time>\n",
+          xw_printf(stdout, "<Time>%s</Time>\n",
             lif_a.leda.ltpa.DroidBirth1.Time_long);
         }
         else
         {
-          printf("<Time>%s</Time>\n", lif_a.leda.ltpa.DroidBirth1.Time);
+          xw_printf(stdout, "<Time>%s</Time>\n", lif_a.leda.ltpa.DroidBirth1.Time);
         }
-        printf("<Node><!-- Mac Address -->%s</Node>\n",
+        xw_printf(stdout, "<Node><!-- Mac Address -->%s</Node>\n",
           lif_a.leda.ltpa.DroidBirth1.Node);
       }
-      printf("</UUID>\n");
-      printf("</DroidBirth1>\n");
+      xw_printf(stdout, "</UUID>\n");
+      xw_printf(stdout, "</DroidBirth1>\n");
 
-      printf("<DroidBirth2>\n");
-      printf("<UUID>\n%s\n", lif_a.leda.ltpa.DroidBirth2.UUID);
+      xw_printf(stdout, "<DroidBirth2>\n");
+      xw_printf(stdout, "<UUID>\n%s\n", lif_a.leda.ltpa.DroidBirth2.UUID);
       if (less == 0)
       {
-        printf("<Version>%s</Version>\n", lif_a.leda.ltpa.DroidBirth2.Version);
-        printf("<Variant>%s</Variant>\n", lif_a.leda.ltpa.DroidBirth2.Variant);
+        xw_printf(stdout, "<Version>%s</Version>\n", lif_a.leda.ltpa.DroidBirth2.Version);
+        xw_printf(stdout, "<Variant>%s</Variant>\n", lif_a.leda.ltpa.DroidBirth2.Variant);
       }
       if ((lif_a.leda.ltpa.DroidBirth2.Version[0] == '1')
         & (lif_a.leda.ltpa.DroidBirth2.Version[1] == ' '))
       {
-        printf("<Sequence>%s</Sequence>\n",
+        xw_printf(stdout, "<Sequence>%s</Sequence>\n",
           lif_a.leda.ltpa.DroidBirth2.ClockSeq);
         if (less == 0)
         {
-          printf("<Time>%s</Time>\n",
+          xw_printf(stdout, "<Time>%s</Time>\n",
             lif_a.leda.ltpa.DroidBirth2.Time_long);
         }
         else
         {
-          printf("<Time>%s</Time>\n", lif_a.leda.ltpa.DroidBirth2.Time);
+          xw_printf(stdout, "<Time>%s</Time>\n", lif_a.leda.ltpa.DroidBirth2.Time);
         }
-        printf("<Node><!-- Mac Address -->%s</Node>\n",
+        xw_printf(stdout, "<Node><!-- Mac Address -->%s</Node>\n",
           lif_a.leda.ltpa.DroidBirth2.Node);
       }
-      printf("</UUID>\n");
-      printf("</DroidBirth2>\n");
+      xw_printf(stdout, "</UUID>\n");
+      xw_printf(stdout, "</DroidBirth2>\n");
     }
-    printf("</TrackerDataBlock>\n");
+    xw_printf(stdout, "</TrackerDataBlock>\n");
   }
 
   if (lif.led.edtypes & VISTA_AND_ABOVE_IDLIST_PROPS)
   {
-    printf("<VistaAndAboveIDListDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lvidlpa.Posn, lif_a.leda.lvidlpa.Size);
-    if (less == 0)
+    xw_printf(stdout, "<VistaAndAboveIDListDataBlock FileOffset=\"%s\" Size=\"%s\">\n", lif_a.leda.lvidlpa.Posn, lif_a.leda.lvidlpa.Size);
+    if (less == 0)
+    {
+      xw_printf(stdout, "<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lvidlpa.sig);
+      xw_printf(stdout, "<NumItems>%s</NumItems>\n", lif_a.leda.lvidlpa.NumItemIDs);
+      if (itemid > 0) // If the '-i' option is switched on
+      {
+        xml_itemids(lif.led.lvidlp.Items, lif_a.leda.lvidlpa.Items, lif.led.lvidlp.NumItemIDs);
+        xw_printf(stdout, "<IDListTerminator Size=\"2\"></IDListTerminator>\n");
+      }
+    }
+    xw_printf(stdout, "</VistaAndAboveIDListDataBlock>\n");
+  }
+  xw_printf(stdout, "</ExtraData>\n");
+
+  xw_printf(stdout, "</EmbeddedInfo>\n");
+  xw_printf(stdout, "</LinkFile>\n");
+}
+
+//
+//Function: filetime() converts an operating system time (seconds since 1970)
+//to a FILETIME
+int64_t filetime(time_t t)
+{
+  return ((int64_t)t + 11644473600LL) * 10000000;
+}
+
+//
+//Function: tl_event() formats a timeline line and adds it to the timeline
+void tl_event(int64_t time, unsigned char * timestr, const char * event, char * fname, char * target)
+{
+  char line[TL_MAXTEXT + 1];
+
+  snprintf(line, TL_MAXTEXT + 1, "%s|%s|%s|%s", timestr, event, fname, target);
+  if (tl_add(time, line) < 0)
+  {
+    fprintf(stderr, "Unable to add to the timeline\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+//
+//Function: tl_propstores() adds the FILETIME values in a set of property
+//stores to the timeline, 'where' names the stores' location.
+void tl_propstores(struct LIF_PROPERTY_STORE_PROPS * psp, const char * where, char * fname, char * target)
+{
+  struct LIF_SER_PROPSTORE_A  psa;
+  char                        event[400];
+  int64_t                     time;
+  int                         j, k, b;
+
+  for (j = 0; j < psp->NumStores; j++)
+  {
+    if (get_propstore_a(&psp->Stores[j], &psa) != 0)
+    {
+      continue;
+    }
+    for (k = 0; k < psp->Stores[j].NumValues; k++)
+    {
+      if ((psp->Stores[j].PropValues[k].ValueSize > 0) && (psp->Stores[j].PropValues[k].PropertyType == VT_FILETIME))
+      {
+        snprintf(event, 400, "%s %s", where, (psp->Stores[j].NameType == 0) ?
+          psa.PropValues[k].Name : psa.PropValues[k].KeyName);
+        for (time = 0, b = 7; b >= 0; b--) // Little endian
+        {
+          time = (time << 8) | psp->Stores[j].PropValues[k].Value[b];
+        }
+        tl_event(time, psa.PropValues[k].Value, event, fname, target);
+      }
+    }
+  }
+}
+
+//
+//Function: tl_itemids() adds the FILETIMEs in the property stores of an
+//IDList's items to the timeline
+void tl_itemids(struct LIF_ITEMID items[], int num, const char * list, char * fname, char * target)
+{
+  struct LIF_PROPERTY_STORE_PROPS  psp;
+  char                             where[40];
+  int                              i;
+
+  for (i = 0; i < num; i++)
+  {
+    if (find_propstores(items[i].Data, items[i].ItemIDSize - 2, items[i].Posn + 2, &psp) == 0)
+    {
+      snprintf(where, 40, "%s ItemID %i PS", list, i + 1);
+      tl_propstores(&psp, where, fname, target);
+    }
+  }
+}
+
+//
+//Function: timeline_out() adds an event for every time stamp in the link
+//file to the timeline, which is sorted and printed once all the files have
+//been read.
+void timeline_out(FILE* fp, char* fname)
+{
+  struct LIF         lif;
+  struct LIF_A       lif_a;
+  struct stat        statbuf;
+  unsigned char      buf[40];
+  char               target[700], cps[300];
+  struct LIF_CLSID   *droid[4];
+  unsigned char      *droid_time[4];
+  const char         *droid_name[4] = { "ED TD Droid1 Time", "ED TD Droid2 Time", "ED TD DroidBirth1 Time", "ED TD DroidBirth2 Time" };
+  const char         *stat_name[3] = { "Link File Last Accessed", "Link File Last Modified", "Link File Last Changed" };
+  time_t             stat_time[3];
+  int                i;
+
+  fstat(fileno(fp), &statbuf);
+  if (decode_lif(fp, statbuf.st_size, LIF_SEC_HDR | LIF_SEC_IDLIST | LIF_SEC_LINKINFO | LIF_SEC_STRINGDATA |
+    LIF_SEC_TRACKER | LIF_SEC_ED(PROPERTY_STORE_PROPS | VISTA_AND_ABOVE_IDLIST_PROPS), &lif) < 0)
+  {
+    fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
+    return;
+  }
+  if (ascii_lif(&lif, &lif_a, LIF_A_NUMERIC))
+  {
+    fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
+    return;
+  }
+  // The target of the link gives each event some context: the local path,
+  // the network path or, failing those, the relative path
+  if (lif.li.CPSOffsetU > 0)
+  {
+    snprintf(cps, 300, "%.*ls", 299, lif.li.CPSU);
+  }
+  else
+  {
+    snprintf(cps, 300, "%s", lif.li.CPS);
+  }
+  if ((lif.lh.Flags & 0x00000002) && (lif.li.Flags & 0x00000001) && (lif.li.LBPOffsetU > 0))
+  {
+    snprintf(target, 700, "%.*ls%s", 399, lif.li.LBPU, cps);
+  }
+  else if ((lif.lh.Flags & 0x00000002) && (lif.li.Flags & 0x00000001))
+  {
+    snprintf(target, 700, "%s%s", lif.li.LBP, cps);
+  }
+  else if ((lif.lh.Flags & 0x00000002) && (lif.li.Flags & 0x00000002))
+  {
+    snprintf(target, 700, "%s%s%s", lif.li.CNR.NetName, (cps[0] != 0) ? "\\" : "", cps);
+  }
+  else if (lif.lh.Flags & 0x00000008)
+  {
+    snprintf(target, 700, "%s", lif_a.lsda.Data[1]);
+  }
+  else
+  {
+    snprintf(target, 700, "[N/A]");
+  }
+
+  // Operating system times
+  stat_time[0] = statbuf.st_atime;
+  stat_time[1] = statbuf.st_mtime;
+  stat_time[2] = statbuf.st_ctime;
+  for (i = 0; i < 3; i++)
+  {
+    strftime((char *)buf, 29, "%Y-%m-%d %H:%M:%S (UTC)", gmtime(&stat_time[i]));
+    tl_event(filetime(stat_time[i]), buf, stat_name[i], fname, target);
+  }
+  // Header times (unset ones are 0)
+  if (lif.lh.CrDate != 0)
+  {
+    tl_event(lif.lh.CrDate, lif_a.lha.CrDate_long, "Hdr FileCreate", fname, target);
+  }
+  if (lif.lh.AcDate != 0)
+  {
+    tl_event(lif.lh.AcDate, lif_a.lha.AcDate_long, "Hdr FileAccess", fname, target);
+  }
+  if (lif.lh.WtDate != 0)
+  {
+    tl_event(lif.lh.WtDate, lif_a.lha.WtDate_long, "Hdr FileWrite", fname, target);
+  }
+  // Tracker droids that are time based (version 1) UUIDs
+  if (lif.led.edtypes & TRACKER_PROPS)
+  {
+    droid[0] = &lif.led.ltp.Droid1;
+    droid[1] = &lif.led.ltp.Droid2;
+    droid[2] = &lif.led.ltp.DroidBirth1;
+    droid[3] = &lif.led.ltp.DroidBirth2;
+    droid_time[0] = lif_a.leda.ltpa.Droid1.Time_long;
+    droid_time[1] = lif_a.leda.ltpa.Droid2.Time_long;
+    droid_time[2] = lif_a.leda.ltpa.DroidBirth1.Time_long;
+    droid_time[3] = lif_a.leda.ltpa.DroidBirth2.Time_long;
+    for (i = 0; i < 4; i++)
+    {
+      if (get_uuid_time(droid[i]) != 0)
+      {
+        tl_event(get_uuid_time(droid[i]), droid_time[i], droid_name[i], fname, target);
+      }
+    }
+  }
+  // FILETIME property values
+  if (lif.led.edtypes & PROPERTY_STORE_PROPS)
+  {
+    tl_propstores(&lif.led.lpsp, "ED PS", fname, target);
+  }
+  tl_itemids(lif.lidl.Items, lif.lidl.NumItemIDs, "IDList", fname, target);
+  if (lif.led.edtypes & VISTA_AND_ABOVE_IDLIST_PROPS)
+  {
+    tl_itemids(lif.led.lvidlp.Items, lif.led.lvidlp.NumItemIDs, "ED >= Vista IDList", fname, target);
+  }
+}
+
+//
+//Arrow output ('-o arrow'): the columns of the stream, which arrow_out() sets
+//in this order. The names are the '-F' keys where there is one; times are
+//FILETIMEs (100ns intervals since 1601-01-01 UTC) and the strings are the
+//Unicode versions where the link file has them. Values that a link file
+//doesn't have are null.
+static const struct AIPC_FIELD arrow_fields[] =
+{
+  { "file.name", AIPC_UTF8 },
+  { "file.size", AIPC_UINT64 },
+  { "file.atime", AIPC_INT64 },
+  { "file.mtime", AIPC_INT64 },
+  { "file.ctime", AIPC_INT64 },
+  { "hdr.clsid", AIPC_DICT },
+  { "hdr.flags", AIPC_UINT32 },
+  { "hdr.attr", AIPC_UINT32 },
+  { "hdr.crtime", AIPC_INT64 },
+  { "hdr.actime", AIPC_INT64 },
+  { "hdr.wttime", AIPC_INT64 },
+  { "hdr.targetsize", AIPC_UINT32 },
+  { "hdr.iconindex", AIPC_INT32 },
+  { "hdr.showstate", AIPC_UINT32 },
+  { "hdr.hotkey", AIPC_UINT16 },
+  { "idlist.size", AIPC_UINT16 },
+  { "idlist.numitems", AIPC_UINT16 },
+  { "li.flags", AIPC_UINT32 },
+  { "li.volid.drivetype", AIPC_DICT },
+  { "li.volid.drivesn", AIPC_UINT32 },
+  { "li.volid.label", AIPC_UTF8 },
+  { "li.lbp", AIPC_UTF8 },
+  { "li.cnr.flags", AIPC_UINT32 },
+  { "li.cnr.providertype", AIPC_UINT32 },
+  { "li.cnr.netname", AIPC_UTF8 },
+  { "li.cnr.devicename", AIPC_UTF8 },
+  { "li.cps", AIPC_UTF8 },
+  { "sd.name", AIPC_UTF8 },
+  { "sd.relpath", AIPC_UTF8 },
+  { "sd.workdir", AIPC_UTF8 },
+  { "sd.args", AIPC_UTF8 },
+  { "sd.icon", AIPC_UTF8 },
+  { "ed.types", AIPC_UINT32 },
+  { "ed.consolefe.codepage", AIPC_UINT32 },
+  { "ed.darwin.data", AIPC_UTF8 },
+  { "ed.env.target", AIPC_UTF8 },
+  { "ed.iconenv.target", AIPC_UTF8 },
+  { "ed.knownfolder.id", AIPC_UTF8 },
+  { "ed.knownfolder.name", AIPC_DICT },
+  { "ed.specialfolder.id", AIPC_UINT32 },
+  { "ed.tracker.machineid", AIPC_DICT },
+  { "ed.tracker.droid1", AIPC_UTF8 },
+  { "ed.tracker.droid1.time", AIPC_INT64 },
+  { "ed.tracker.droid2", AIPC_UTF8 },
+  { "ed.tracker.droid2.time", AIPC_INT64 },
+  { "ed.tracker.droid2.node", AIPC_DICT },
+  { "ed.tracker.birth1", AIPC_UTF8 },
+  { "ed.tracker.birth1.time", AIPC_INT64 },
+  { "ed.tracker.birth2", AIPC_UTF8 },
+  { "ed.tracker.birth2.time", AIPC_INT64 },
+  { "ed.vista.numitems", AIPC_UINT16 }
+};
+#define NUMARROW (sizeof(arrow_fields) / sizeof(arrow_fields[0]))
+
+//
+//Functions: arrow_int(), arrow_str() & arrow_wstr() set column *c of the
+//current row if 'set' (leaving it null if not) and move on to the next column
+void arrow_int(int * c, int set, int64_t v)
+{
+  if (set)
+  {
+    aipc_int(arrow_writer, *c, v);
+  }
+  (*c)++;
+}
+void arrow_str(int * c, int set, unsigned char * s)
+{
+  if (set)
+  {
+    aipc_str(arrow_writer, *c, (char *)s);
+  }
+  (*c)++;
+}
+void arrow_wstr(int * c, int set, wchar_t * s)
+{
+  if (set)
+  {
+    aipc_wstr(arrow_writer, *c, s);
+  }
+  (*c)++;
+}
+
+//
+//Function: arrow_out() adds a row for the link file to the Arrow stream
+void arrow_out(FILE* fp, char* fname)
+{
+  struct LIF         lif;
+  struct LIF_A       lif_a;
+  struct stat        statbuf;
+  struct LIF_CLSID   *droid[4];
+  struct LIF_CLSID_A *droid_a[4];
+  int                c = 0, i, li, volid, cnr, ed;
+
+  fstat(fileno(fp), &statbuf);
+  if (decode_lif(fp, statbuf.st_size, LIF_SEC_HDR | LIF_SEC_IDLIST | LIF_SEC_LINKINFO | LIF_SEC_STRINGDATA |
+    LIF_SEC_ED(CONSOLE_FE_PROPS | DARWIN_PROPS | ENVIRONMENT_PROPS | ICON_ENVIRONMENT_PROPS | KNOWN_FOLDER_PROPS |
+    SPECIAL_FOLDER_PROPS | TRACKER_PROPS | VISTA_AND_ABOVE_IDLIST_PROPS), &lif) < 0)
+  {
+    fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
+    return;
+  }
+  if (ascii_lif(&lif, &lif_a, LIF_A_NUMERIC))
+  {
+    fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
+    return;
+  }
+  li = (lif.lh.Flags & 0x00000002) != 0;              // HasLinkInfo
+  volid = li && (lif.li.Flags & 0x00000001);          // VolumeIDAndLocalBasePath
+  cnr = li && (lif.li.Flags & 0x00000002);            // CommonNetworkRelativeLinkAndPathSuffix
+  ed = lif.led.edtypes;
+
+  arrow_str(&c, 1, (unsigned char *)fname);
+  arrow_int(&c, 1, (int64_t)statbuf.st_size);
+  arrow_int(&c, 1, filetime(statbuf.st_atime));
+  arrow_int(&c, 1, filetime(statbuf.st_mtime));
+  arrow_int(&c, 1, filetime(statbuf.st_ctime));
+  arrow_str(&c, 1, lif_a.lha.CLSID);
+  arrow_int(&c, 1, lif.lh.Flags);
+  arrow_int(&c, 1, lif.lh.Attr);
+  arrow_int(&c, lif.lh.CrDate != 0, lif.lh.CrDate); // Unset times are 0
+  arrow_int(&c, lif.lh.AcDate != 0, lif.lh.AcDate);
+  arrow_int(&c, lif.lh.WtDate != 0, lif.lh.WtDate);
+  arrow_int(&c, 1, lif.lh.Size);
+  arrow_int(&c, 1, lif.lh.IconIndex);
+  arrow_int(&c, 1, lif.lh.ShowState);
+  arrow_int(&c, 1, lif.lh.Hotkey.LowKey | (lif.lh.Hotkey.HighKey << 8));
+  arrow_int(&c, lif.lh.Flags & 0x00000001, lif.lidl.IDListSize); // HasLinkTargetIDList
+  arrow_int(&c, lif.lh.Flags & 0x00000001, lif.lidl.NumItemIDs);
+  arrow_int(&c, li, lif.li.Flags);
+  arrow_str(&c, volid, lif_a.lia.VolID.DriveType);
+  arrow_int(&c, volid, lif.li.VolID.DriveSN);
+  if (lif.li.HeaderSize < 0x00000024) // As get_lif() decides
+  {
+    arrow_str(&c, volid, lif.li.VolID.VolumeLabel);
+  }
+  else
+  {
+    arrow_wstr(&c, volid, lif.li.VolID.VolumeLabelU);
+  }
+  if (lif.li.LBPOffsetU > 0)
+  {
+    arrow_wstr(&c, volid, lif.li.LBPU);
+  }
+  else
+  {
+    arrow_str(&c, volid, lif.li.LBP);
+  }
+  arrow_int(&c, cnr, lif.li.CNR.Flags);
+  arrow_int(&c, cnr && (lif.li.CNR.Flags & 0x00000002), lif.li.CNR.NetworkProviderType); // ValidNetType
+  if (lif.li.CNR.NetNameOffsetU > 0)
+  {
+    arrow_wstr(&c, cnr, lif.li.CNR.NetNameU);
+  }
+  else
+  {
+    arrow_str(&c, cnr, lif.li.CNR.NetName);
+  }
+  if (lif.li.CNR.DeviceNameOffsetU > 0)
+  {
+    arrow_wstr(&c, cnr && (lif.li.CNR.Flags & 0x00000001), lif.li.CNR.DeviceNameU); // ValidDevice
+  }
+  else
+  {
+    arrow_str(&c, cnr && (lif.li.CNR.Flags & 0x00000001), lif.li.CNR.DeviceName);
+  }
+  if (lif.li.CPSOffsetU > 0)
+  {
+    arrow_wstr(&c, li, lif.li.CPSU);
+  }
+  else
+  {
+    arrow_str(&c, li, lif.li.CPS);
+  }
+  // StringData: HasName, HasRelativePath, HasWorkingDir, HasArguments & HasIconLocation
+  for (i = 0; i < 5; i++)
+  {
+    arrow_str(&c, lif.lh.Flags & (0x00000004 << i), lif.lsd.Data[i]);
+  }
+  arrow_int(&c, 1, ed);
+  arrow_int(&c, ed & CONSOLE_FE_PROPS, lif.led.lcfep.CodePage);
+  if (lif.led.ldp.DarwinDataUnicode[0] != 0)
+  {
+    arrow_wstr(&c, ed & DARWIN_PROPS, lif.led.ldp.DarwinDataUnicode);
+  }
+  else
+  {
+    arrow_str(&c, ed & DARWIN_PROPS, lif.led.ldp.DarwinDataAnsi);
+  }
+  if (lif.led.lep.TargetUnicode[0] != 0)
+  {
+    arrow_wstr(&c, ed & ENVIRONMENT_PROPS, lif.led.lep.TargetUnicode);
+  }
+  else
+  {
+    arrow_str(&c, ed & ENVIRONMENT_PROPS, lif.led.lep.TargetAnsi);
+  }
+  if (lif.led.liep.TargetUnicode[0] != 0)
+  {
+    arrow_wstr(&c, ed & ICON_ENVIRONMENT_PROPS, lif.led.liep.TargetUnicode);
+  }
+  else
+  {
+    arrow_str(&c, ed & ICON_ENVIRONMENT_PROPS, lif.led.liep.TargetAnsi);
+  }
+  arrow_str(&c, ed & KNOWN_FOLDER_PROPS, lif_a.leda.lkfpa.KFGUID.UUID);
+  arrow_str(&c, ed & KNOWN_FOLDER_PROPS, lif_a.leda.lkfpa.KFGUID.Name);
+  arrow_int(&c, ed & SPECIAL_FOLDER_PROPS, lif.led.lsfp.SpecialFolderID);
+  arrow_str(&c, ed & TRACKER_PROPS, lif_a.leda.ltpa.MachineID);
+  // The droids & their times (if they are time based UUIDs), with the MAC
+  // address of the machine that last saw the target after Droid2
+  droid[0] = &lif.led.ltp.Droid1;
+  droid[1] = &lif.led.ltp.Droid2;
+  droid[2] = &lif.led.ltp.DroidBirth1;
+  droid[3] = &lif.led.ltp.DroidBirth2;
+  droid_a[0] = &lif_a.leda.ltpa.Droid1;
+  droid_a[1] = &lif_a.leda.ltpa.Droid2;
+  droid_a[2] = &lif_a.leda.ltpa.DroidBirth1;
+  droid_a[3] = &lif_a.leda.ltpa.DroidBirth2;
+  for (i = 0; i < 4; i++)
+  {
+    arrow_str(&c, ed & TRACKER_PROPS, droid_a[i]->UUID);
+    arrow_int(&c, (ed & TRACKER_PROPS) && (get_uuid_time(droid[i]) != 0), get_uuid_time(droid[i]));
+    if (i == 1)
+    {
+      arrow_str(&c, ed & TRACKER_PROPS, droid_a[i]->Node);
+    }
+  }
+  arrow_int(&c, ed & VISTA_AND_ABOVE_IDLIST_PROPS, lif.led.lvidlp.NumItemIDs);
+
+  if (aipc_row(arrow_writer) < 0)
+  {
+    exit(EXIT_FAILURE);
+  }
+}
+
+//
+//Function: sqlite_out() adds the link file to the '-o sqlite' database
+void sqlite_out(FILE* fp, char* fname)
+{
+  struct LIF         lif;
+  struct LIF_A       lif_a;
+  struct stat        statbuf;
+
+  fstat(fileno(fp), &statbuf);
+  if (decode_lif(fp, statbuf.st_size, LIF_SEC_ALL, &lif) < 0)
+  {
+    fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
+    return;
+  }
+  if (ascii_lif(&lif, &lif_a, LIF_A_NUMERIC))
+  {
+    fprintf(stderr, "Could not make ASCII version of \'%s\' - sorry\n", fname);
+    return;
+  }
+  if (ldb_add(&lif, &lif_a, fname, &statbuf) < 0)
+  {
+    exit(EXIT_FAILURE);
+  }
+}
+
+/******************************************************************************/
+// '-o json' doesn't decode into a LIF at all: lif_walk() calls back with each
+// part of the link file as it finds it and the callbacks write it straight
+// out as JSON.
+
+#define JS_NONE       0 // The part of the link file being written
+#define JS_HEADER     1
+#define JS_IDLIST     2
+#define JS_LINKINFO   3
+#define JS_STRINGS    4
+#define JS_EXTRADATA  5
+
+struct JSON_CTX
+{
+  struct JW_WRITER    w;
+  int                 Section;    // JS_*, whose object or array (if it has one) is open
+  int                 Block;      // An ExtraData block's object is open
+  int                 Inner;      // Its "items" or "properties" array is open
+};
+
+unsigned char         * json_buf = NULL; // Each link file is read into this
+size_t                json_bufsize = 0;
+
+static const char * json_strings[5] =
+{
+  "name", "relative_path", "working_dir", "arguments", "icon_location"
+};
+static const char * json_blocks[13] =
+{
+  NULL, "EnvironmentVariableDataBlock", "ConsoleDataBlock", "TrackerDataBlock", "ConsoleFEDataBlock",
+  "SpecialFolderDataBlock", "DarwinDataBlock", "IconEnvironmentDataBlock", "ShimDataBlock",
+  "PropertyStoreDataBlock", "VistaAndAboveIDListDataBlock", "KnownFolderDataBlock", "VistaAndAboveIDListDataBlock"
+};
+
+//
+//Function: json_u32() & json_u64() read little endian numbers
+uint32_t json_u32(const unsigned char * p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+uint64_t json_u64(const unsigned char * p)
+{
+  return (uint64_t)json_u32(p) | ((uint64_t)json_u32(p + 4) << 32);
+}
+
+//
+//Function: json_time() writes a FILETIME as an ISO 8601 UTC time, or null if
+//it is 0. The date is worked out from the day number (as civil_from_days()
+//in http://howardhinnant.github.io/date_algorithms.html) so that any FILETIME
+//can be written.
+void json_time(struct JW_WRITER * w, const char * key, int64_t ft)
+{
+  int64_t secs, days, era, doe, yoe, y, doy, mp, d, m;
+  char buf[64];
+
+  if (ft == 0)
+  {
+    jw_null(w, key);
+    return;
+  }
+  secs = ft / 10000000;
+  days = secs / 86400 - 134774; // Days since 1970-01-01 (FILETIMEs start in 1601)
+  secs %= 86400;
+  days += 719468;
+  era = (days >= 0 ? days : days - 146096) / 146097;
+  doe = days - era * 146097;
+  yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  y = yoe + era * 400;
+  doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%07dZ", (int)(y + (m <= 2)), (int)m, (int)d,
+    (int)(secs / 3600), (int)((secs / 60) % 60), (int)(secs % 60), (int)(ft % 10000000));
+  jw_str(w, key, buf, JW_NUL);
+}
+
+//
+//Function: json_guid() writes 16 bytes of a GUID, as stored, in the usual
+//{xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx} form
+void json_guid(struct JW_WRITER * w, const char * key, const unsigned char * g)
+{
+  char buf[40];
+
+  snprintf(buf, sizeof(buf), "{%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X}",
+    g[3], g[2], g[1], g[0], g[5], g[4], g[7], g[6], g[8], g[9], g[10], g[11], g[12], g[13], g[14], g[15]);
+  jw_str(w, key, buf, JW_NUL);
+}
+
+//
+//Function: json_view() writes a string from the link file (if it has it)
+void json_view(struct JW_WRITER * w, const char * key, const struct LIF_VIEW * v, int unicode)
+{
+  if (v->Data != NULL)
+  {
+    if (unicode)
+    {
+      jw_utf16(w, key, v->Data, v->Size);
+    }
+    else
+    {
+      jw_str(w, key, (const char *)v->Data, v->Size);
+    }
+  }
+}
+
+//
+//Function: json_section() closes what is open of the last part written and
+//opens the object or array of the next (if it has one)
+void json_section(struct JSON_CTX * c, int section)
+{
+  if (c->Section == section)
+  {
+    return;
+  }
+  if (c->Inner)
+  {
+    jw_close(&c->w);
+    c->Inner = 0;
+  }
+  if (c->Block)
+  {
+    jw_close(&c->w);
+    c->Block = 0;
+  }
+  if ((c->Section == JS_IDLIST) || (c->Section == JS_STRINGS) || (c->Section == JS_EXTRADATA))
+  {
+    jw_close(&c->w);
+  }
+  switch (section)
+  {
+  case JS_IDLIST:
+    jw_open(&c->w, "idlist", '[');
+    break;
+  case JS_STRINGS:
+    jw_open(&c->w, "strings", '{');
+    break;
+  case JS_EXTRADATA:
+    jw_open(&c->w, "extradata", '[');
+    break;
+  }
+  c->Section = section;
+}
+
+//
+//Function: json_inner() opens the "items" or "properties" array of the open
+//ExtraData block
+void json_inner(struct JSON_CTX * c, const char * key)
+{
+  if (c->Block && !c->Inner)
+  {
+    jw_open(&c->w, key, '[');
+    c->Inner = 1;
+  }
+}
+
+//
+//The lif_walk() callbacks
+int json_header(void * ctx, const struct LIF_WALK_HEADER * h)
+{
+  struct JSON_CTX * c = ctx;
+
+  json_section(c, JS_HEADER);
+  jw_open(&c->w, "header", '{');
+  jw_uint(&c->w, "flags", h->Flags);
+  jw_uint(&c->w, "attributes", h->Attributes);
+  json_time(&c->w, "created", h->CreationTime);
+  json_time(&c->w, "accessed", h->AccessTime);
+  json_time(&c->w, "written", h->WriteTime);
+  jw_uint(&c->w, "file_size", h->FileSize);
+  jw_int(&c->w, "icon_index", h->IconIndex);
+  jw_uint(&c->w, "show_state", h->ShowState);
+  jw_uint(&c->w, "hotkey", h->Hotkey);
+  jw_close(&c->w);
+  return 0;
+}
+
+int json_itemid(void * ctx, int list, int index, const struct LIF_VIEW * data)
+{
+  struct JSON_CTX * c = ctx;
+
+  (void)index;
+  if (list == LIF_WALK_IDLIST)
+  {
+    json_section(c, JS_IDLIST);
+  }
+  else
+  {
+    json_inner(c, "items");
+  }
+  jw_open(&c->w, NULL, '{');
+  jw_uint(&c->w, "posn", data->Posn - 2);
+  jw_uint(&c->w, "size", data->Size + 2);
+  if (data->Size > 0)
+  {
+    jw_uint(&c->w, "class", data->Data[0]);
+  }
+  jw_hex(&c->w, "data", data->Data, data->Size);
+  jw_close(&c->w);
+  return 0;
+}
+
+int json_linkinfo(void * ctx, const struct LIF_WALK_LINKINFO * li)
+{
+  struct JSON_CTX * c = ctx;
+
+  json_section(c, JS_LINKINFO);
+  jw_open(&c->w, "linkinfo", '{');
+  jw_uint(&c->w, "posn", li->Raw.Posn);
+  jw_uint(&c->w, "size", li->Raw.Size);
+  jw_uint(&c->w, "flags", li->Flags);
+  if (li->Flags & 0x00000001)
+  {
+    jw_uint(&c->w, "drive_type", li->DriveType);
+    jw_uint(&c->w, "drive_serial", li->DriveSerial);
+  }
+  json_view(&c->w, "volume_label", &li->VolumeLabel, 0);
+  json_view(&c->w, "volume_label_unicode", &li->VolumeLabelUnicode, 1);
+  json_view(&c->w, "local_base_path", &li->LocalBasePath, 0);
+  json_view(&c->w, "local_base_path_unicode", &li->LocalBasePathUnicode, 1);
+  if (li->Flags & 0x00000002)
+  {
+    jw_uint(&c->w, "network_flags", li->CNRFlags);
+    jw_uint(&c->w, "network_provider", li->NetworkProviderType);
+  }
+  json_view(&c->w, "net_name", &li->NetName, 0);
+  json_view(&c->w, "net_name_unicode", &li->NetNameUnicode, 1);
+  json_view(&c->w, "device_name", &li->DeviceName, 0);
+  json_view(&c->w, "device_name_unicode", &li->DeviceNameUnicode, 1);
+  json_view(&c->w, "common_path_suffix", &li->CommonPathSuffix, 0);
+  json_view(&c->w, "common_path_suffix_unicode", &li->CommonPathSuffixUnicode, 1);
+  jw_close(&c->w);
+  return 0;
+}
+
+int json_string(void * ctx, int which, int unicode, const struct LIF_VIEW * s)
+{
+  struct JSON_CTX * c = ctx;
+
+  json_section(c, JS_STRINGS);
+  json_view(&c->w, json_strings[which], s, unicode);
+  return 0;
+}
+
+int json_block(void * ctx, uint32_t sig, const struct LIF_VIEW * block)
+{
+  struct JSON_CTX * c = ctx;
+
+  json_section(c, JS_EXTRADATA);
+  if (c->Inner)
+  {
+    jw_close(&c->w);
+    c->Inner = 0;
+  }
+  if (c->Block)
+  {
+    jw_close(&c->w);
+  }
+  jw_open(&c->w, NULL, '{');
+  c->Block = 1;
+  jw_uint(&c->w, "signature", sig);
+  if ((sig >= 0xA0000001) && (sig <= 0xA000000C) && (sig != 0xA000000A))
+  {
+    jw_str(&c->w, "type", json_blocks[sig - 0xA0000000], JW_NUL);
+  }
+  jw_uint(&c->w, "posn", block->Posn);
+  jw_uint(&c->w, "size", block->Size);
+  if ((sig != 0xA0000009) && (sig != 0xA000000A) && (sig != 0xA000000C)) // (Their properties or items follow)
+  {
+    jw_hex(&c->w, "data", block->Data + 8, block->Size - 8);
+  }
+  return 0;
+}
+
+int json_property(void * ctx, const struct LIF_WALK_PROPERTY * p)
+{
+  struct JSON_CTX * c = ctx;
+  const unsigned char * v = p->Value.Data;
+  size_t size = p->Value.Size, len;
+
+  json_inner(c, "properties");
+  jw_open(&c->w, NULL, '{');
+  jw_int(&c->w, "store", p->Store);
+  json_guid(&c->w, "format_id", p->FormatID);
+  if (p->Name.Data != NULL)
+  {
+    jw_utf16(&c->w, "name", p->Name.Data, p->Name.Size);
+  }
+  else
+  {
+    jw_uint(&c->w, "id", p->ID);
+  }
+  jw_uint(&c->w, "type", p->Type);
+  switch (p->Type)
+  {
+  case VT_I2:
+    if (size >= 2)
+    {
+      jw_int(&c->w, "value", (int16_t)(v[0] | (v[1] << 8)));
+    }
+    break;
+  case VT_UI2:
+    if (size >= 2)
+    {
+      jw_uint(&c->w, "value", v[0] | (v[1] << 8));
+    }
+    break;
+  case VT_BOOL:
+    if (size >= 2)
+    {
+      jw_bool(&c->w, "value", (v[0] | v[1]) != 0);
+    }
+    break;
+  case VT_I4:
+  case VT_INT:
+    if (size >= 4)
+    {
+      jw_int(&c->w, "value", (int32_t)json_u32(v));
+    }
+    break;
+  case VT_UI4:
+  case VT_UINT:
+  case VT_ERROR:
+    if (size >= 4)
+    {
+      jw_uint(&c->w, "value", json_u32(v));
+    }
+    break;
+  case VT_I8:
+    if (size >= 8)
+    {
+      jw_int(&c->w, "value", (int64_t)json_u64(v));
+    }
+    break;
+  case VT_UI8:
+    if (size >= 8)
+    {
+      jw_uint(&c->w, "value", json_u64(v));
+    }
+    break;
+  case VT_FILETIME:
+    if (size >= 8)
+    {
+      json_time(&c->w, "value", (int64_t)json_u64(v));
+    }
+    break;
+  case VT_CLSID:
+    if (size >= 16)
+    {
+      json_guid(&c->w, "value", v);
+    }
+    break;
+  case VT_LPWSTR: // A count of characters then the string
+    if (size >= 4)
+    {
+      len = (size_t)json_u32(v) * 2;
+      jw_utf16(&c->w, "value", v + 4, (len < size - 4) ? len : size - 4);
+    }
+    break;
+  case VT_BSTR:
+  case VT_LPSTR: // A count of bytes then the string
+    if (size >= 4)
+    {
+      len = json_u32(v);
+      len = (len < size - 4) ? len : size - 4;
+      while ((len > 0) && (v[4 + len - 1] == 0))
+      {
+        len--;
+      }
+      jw_str(&c->w, "value", (const char *)v + 4, len);
+    }
+    break;
+  default:
+    jw_hex(&c->w, "value", v, size);
+  }
+  jw_close(&c->w);
+  return 0;
+}
+
+//
+//Function: json_out() writes the link file as a line of JSON
+void json_out(FILE* fp, char* fname)
+{
+  static const struct LIF_CALLBACKS cb =
+  {
+    json_header, json_itemid, json_linkinfo, json_string, json_block, json_property
+  };
+  static const int section_of[] = { 0, 0, 1, 2, 3, 4 }; // JS_* to ParseErrors[]
+  struct JSON_CTX c;
+  struct stat statbuf;
+  unsigned char * p;
+  size_t size;
+  int ret;
+
+  fstat(fileno(fp), &statbuf);
+  size = (size_t)statbuf.st_size;
+  if (size > json_bufsize)
+  {
+    if ((p = realloc(json_buf, size)) == NULL)
+    {
+      fprintf(stderr, "Unable to allocate memory to read \'%s\'\n", fname);
+      exit(EXIT_FAILURE);
+    }
+    json_buf = p;
+    json_bufsize = size;
+  }
+  fseek(fp, 0, SEEK_SET);
+  size = fread(json_buf, 1, size, fp);
+
+  memset(&c, 0, sizeof(c));
+  jw_start(&c.w, stdout);
+  jw_open(&c.w, NULL, '{');
+  jw_str(&c.w, "file", fname, JW_NUL);
+  jw_uint(&c.w, "size", size);
+  ret = lif_walk(json_buf, size, &cb, &c);
+  json_section(&c, JS_NONE);
+  if (ret != 0)
+  {
+    // The parts up to the error have been written, say where it stopped
+    jw_str(&c.w, "error", lif_strerror(ret), JW_NUL);
+    stats.ParseErrors[section_of[c.Section]]++;
+    PG_ADD(Errors, 1);
+    fprintf(stderr, "Error processing file \'%s\' - sorry\n", fname);
+  }
+  jw_close(&c.w);
+}
+
+//
+//Function: where_ok() decodes just the sections that the '--where' filter
+//needs and tests them, so files that don't match are never converted to
+//ASCII or formatted. Returns 1 if the file should be output, 0 if not.
+int where_ok(FILE* fp, char* fname, int size)
+{
+  struct LIF lif;
+
+  st_lap(&stats, ST_FILTER);
+  if (get_lif_at(fp, 0, size, where_mask, &lif) < 0)
+  {
+    return 1; // Let the output function report the error
+  }
+  return where_match(where_tree, &lif, fname, (uint64_t)size);
+}
+
+//
+//Function: out_file() writes a link file in the output type chosen
+void out_file(FILE* fp, char* fname, int less, int idlist)
+{
+  if (plan_len > 0) // Just the columns chosen with '-F'
+  {
+    plan_out(fp, fname, (output_type == csv) ? ',' : '\t');
+  }
+  else switch (output_type)
+  {
+  case csv:
+    sv_out(fp, fname, less, ','); // Output to a separated file with the separator being a comma
+    break;
+  case tsv:
+    sv_out(fp, fname, less, '\t'); // Output to a separated file with the separator being a tab
+    break;
+  case xml:
+    xml_out(fp, fname, less, idlist);
+    break;
+  case timeline:
+    timeline_out(fp, fname);
+    break;
+  case arrow:
+    arrow_out(fp, fname);
+    break;
+  case sqlite:
+    sqlite_out(fp, fname);
+    break;
+  case json:
+    json_out(fp, fname);
+    break;
+  case txt:
+  default:       //Anything other than these 4 options should have been
+    //trapped already - this is just belt & braces!
+    text_out(fp, fname, less, idlist); // Output to plain text
+  }
+}
+
+//
+//Function: proc_file() processes regular files
+void proc_file(char* fname, int less, int idlist)
+{
+  FILE *fp;
+  struct stat statbuf;
+
+  st_lap(&stats, ST_OPEN);
+  stats.Files++;
+  //Try to open a file pointer
+  if ((fp = fopen(fname, "rb")) == NULL)
+  {
+    //unsuccessful
+    stats.OpenErrors++;
+    PG_ADD(Errors, 1);
+    perror("Error");
+    fprintf(stderr, "whilst processing file: \'%s\'\n", fname);
+  }
+  else
+  {
+    stat(fname, &statbuf);
+    if (statbuf.st_size >= 76) //Don't bother with files that aren't big enough
+    {
+      //successful
+      stats.BytesRead += statbuf.st_size;
+      PG_ADD(Bytes, statbuf.st_size);
+      st_lap(&stats, ST_TEST);
+      if (test_link(fp) == 0) // Test to see if the file has the right magic
+      {
+        if ((where_tree == NULL) || where_ok(fp, fname, statbuf.st_size))
+        {
+          st_lap(&stats, ST_OUTPUT);
+          pmc_lap(PMC_FORMAT);
+          out_file(fp, fname, less, idlist);
+          filecount++;
+          stats.Links++;
+        }
+        else
+        {
+          stats.Filtered++;
+        }
+      }
+      else
+      {
+        stats.NotLink++;
+        PG_ADD(Errors, 1);
+        fprintf(stderr, "Not a Link File:\t%s\n", fname);
+      }
+
+      st_lap(&stats, ST_OPEN);
+      pmc_lap(PMC_OTHER);
+      if (fclose(fp) != 0)
+      {
+        //Can't close the file for some reason
+        perror("Error in function proc_file()");
+        fprintf(stderr, "whilst closing file: \'%s\'\n", fname);
+        exit(EXIT_FAILURE);
+      }
+    }
+    else
+    {
+      stats.NotLink++;
+      PG_ADD(Errors, 1);
+      fprintf(stderr, "Not a Link File:\t%s\n", fname);
+    }
+  }
+  PG_ADD(Files, 1);
+  st_lap(&stats, ST_OTHER);
+}
+
+//
+//Function: serve_errors() counts the link files that couldn't be decoded
+uint64_t serve_errors(void)
+{
+  uint64_t n = stats.AsciiErrors;
+  int i;
+
+  for (i = 0; i < ST_NUMSECTIONS; i++)
+  {
+    n += stats.ParseErrors[i];
+  }
+  return n;
+}
+
+//
+//Function: serve_render() renders a link file for a '--serve' request as
+//'lifer -o FORMAT' would for that one file (so csv & tsv have their header
+//line and xml is a whole document). It is called in a worker process, which
+//has its own copy of lifer's globals, so output_type & stdout can be changed.
+const char * serve_render(void * ctx, const char * format, const char * name, FILE * fp, FILE * out)
+{
+  static const char * formats[5] = { "csv", "tsv", "txt", "xml", "json" };
+  static const enum otype types[5] = { csv, tsv, txt, xml, json };
+  struct RENDER_OPTS * so = ctx;
+  struct stat statbuf;
+  uint64_t errors;
+  FILE * saved;
+  int i;
+
+  for (i = 0; (i < 5) && (strcmp(format, formats[i]) != 0); i++);
+  if (i == 5)
+  {
+    return "Unknown format, it can be csv, tsv, txt, xml or json";
+  }
+  if ((plan_len > 0) && (types[i] == json))
+  {
+    return "'-F' cannot be used with json";
+  }
+  fstat(fileno(fp), &statbuf);
+  if (!S_ISREG(statbuf.st_mode) || (statbuf.st_size < 76) || (test_link(fp) != 0))
+  {
+    stats.NotLink++;
+    return "Not a link file";
+  }
+  if ((where_tree != NULL) && !where_ok(fp, (char *)name, statbuf.st_size))
+  {
+    return "The link file doesn't match the '--where' filter";
+  }
+  errors = serve_errors();
+  output_type = types[i];
+  filecount = 0;
+  saved = stdout;
+  stdout = out;
+  out_file(fp, (char *)name, so->less, so->idlist);
+  if ((output_type == xml) && (ftell(stdout) > 0))
+  {
+    printf("</LinkFiles>\n");
+  }
+  fflush(stdout);
+  stdout = saved;
+  if ((ftell(out) == 0) && (serve_errors() != errors))
+  {
+    return "The link file could not be decoded";
+  }
+  return NULL;
+}
+
+//
+//Function: out_header() prints the header of the output type chosen (for
+//'--isolate', where the workers only print records)
+void out_header(int less)
+{
+  if (plan_len > 0)
+  {
+    if (output_type == xml)
     {
-      printf("<BlockSignature>%s</BlockSignature>\n", lif_a.leda.lvidlpa.sig);
-      printf("<NumItems>%s</NumItems>\n", lif_a.leda.lvidlpa.NumItemIDs);
+      xml_header();
     }
-    printf("</VistaAndAboveIDListDataBlock>\n");
+    else if (output_type != txt)
+    {
+      plan_header((output_type == csv) ? ',' : '\t');
+    }
+    return;
+  }
+  switch (output_type)
+  {
+  case csv:
+    sv_header(less, ',');
+    break;
+  case tsv:
+    sv_header(less, '\t');
+    break;
+  case xml:
+    xml_header();
+    break;
+  default:
+    break;
   }
-  printf("</ExtraData>\n");
+}
+
+//
+//Function: isolate_render() renders a link file for '--isolate'. It is called
+//in a worker process (with its own copy of lifer's globals) which prints just
+//the record, lifer prints the header before the first record it is given.
+void isolate_render(void * ctx, const char * path, FILE * out)
+{
+  struct RENDER_OPTS * ro = ctx;
+  FILE * saved;
 
-  printf("</EmbeddedInfo>\n");
-  printf("</LinkFile>\n");
+  isolate = 0;
+  filecount = 1;
+  saved = stdout;
+  stdout = out;
+  proc_file((char *)path, ro->less, ro->idlist);
+  fflush(stdout);
+  stdout = saved;
 }
 
 //
-//Function: proc_file() processes regular files
-void proc_file(char* fname, int less, int idlist)
+//Function: isolate_write() writes the output of a link file a worker has
+//rendered, in the order the files were read
+void isolate_write(void * ctx, const char * path, const char * out, size_t len)
 {
-  FILE *fp;
-  struct stat statbuf;
+  struct RENDER_OPTS * ro = ctx;
 
-  //Try to open a file pointer
-  if ((fp = fopen(fname, "rb")) == NULL)
+  (void)path;
+  if (len == 0)
   {
-    //unsuccessful
-    perror("Error");
-    fprintf(stderr, "whilst processing file: \'%s\'\n", fname);
+    return; // (not a link file, or filtered out)
   }
-  else
+  if (filecount == 0)
   {
-    stat(fname, &statbuf);
-    if (statbuf.st_size >= 76) //Don't bother with files that aren't big enough
-    {
-      //successful
-      if (test_link(fp) == 0) // Test to see if the file has the right magic
-      {
-        switch (output_type)
-        {
-        case csv:
-          sv_out(fp, fname, less, ','); // Output to a separated file with the separator being a comma
-          break;
-        case tsv:
-          sv_out(fp, fname, less, '\t'); // Output to a separated file with the separator being a tab
-          break;
-        case xml:
-          xml_out(fp, fname, less, idlist);
-          break;
-        case txt:
-        default:       //Anything other than these 4 options should have been
-          //trapped already - this is just belt & braces!
-          text_out(fp, fname, less, idlist); // Output to plain text
-        }
-        filecount++;
-      }
-      else
-      {
-        fprintf(stderr, "Not a Link File:\t%s\n", fname);
-      }
+    out_header(ro->less);
+  }
+  fwrite(out, 1, len, stdout);
+  filecount++;
+}
 
-      if (fclose(fp) != 0)
-      {
-        //Can't close the file for some reason
-        perror("Error in function proc_file()");
-        fprintf(stderr, "whilst closing file: \'%s\'\n", fname);
-        exit(EXIT_FAILURE);
-      }
-    }
-    else
-    {
-      fprintf(stderr, "Not a Link File:\t%s\n", fname);
-    }
+//
+//Function: isolate_quarantine() reports a link file a worker died over and
+//adds it to the '--quarantine' list
+void isolate_quarantine(void * ctx, const char * path, const char * why)
+{
+  (void)ctx;
+  PG_ADD(Files, 1); // (the worker didn't get to count it)
+  PG_ADD(Errors, 1);
+  fprintf(stderr, "Quarantined:\t%s\t(%s)\n", path, why);
+  if (quarantine_fp != NULL)
+  {
+    fprintf(quarantine_fp, "%s\n", path);
+    fflush(quarantine_fp);
+  }
+}
+
+//
+//Function: take_file() processes a regular file, or gives it to a worker
+//with '--isolate'
+void take_file(char* fname, int less, int idlist)
+{
+  if (!isolate)
+  {
+    proc_file(fname, less, idlist);
+  }
+  else if (iso_file(fname) < 0)
+  {
+    exit(EXIT_FAILURE);
   }
 }
 
@@ -2253,11 +4154,110 @@ void read_dir(char* dirname, int less, int idlist)
     //Don't want anything but regular files
     if ((statbuf.st_mode & S_IFMT) == S_IFREG)
     {
-      proc_file(entry->d_name, less, idlist);
+      take_file(entry->d_name, less, idlist);
     }
   }//End of iterating through directory entry
 }
 
+//
+//Function: stats_exit() prints the '--stats' report when lifer exits
+void stats_exit(void)
+{
+  fflush(stdout); // So the last of the output is counted
+  st_report(stderr, &stats);
+}
+
+//
+//Function: parse_size() returns the number of bytes in a size such as 512K,
+//64M or 2G, 0 if it isn't one
+size_t parse_size(const char * str)
+{
+  char *end;
+  double size = strtod(str, &end);
+
+  switch (*end)
+  {
+  case 'k':
+  case 'K':
+    size *= 1024;
+    end++;
+    break;
+  case 'm':
+  case 'M':
+    size *= 1024 * 1024;
+    end++;
+    break;
+  case 'g':
+  case 'G':
+    size *= 1024.0 * 1024 * 1024;
+    end++;
+    break;
+  }
+  if ((end == str) || ((*end != 0) && (strcmp(end, "B") != 0) && (strcmp(end, "b") != 0)) ||
+    (size < 1) || (size > (double)(SIZE_MAX / 2)))
+  {
+    return 0;
+  }
+  return (size_t)size;
+}
+
+//
+//Function: plan_memory() shares the '--max-memory' budget between the buffers
+//the output type & compressor need. Returns 0 if successful, -1 if the
+//budget is too small.
+int plan_memory(size_t budget)
+{
+  size_t rest, share = 0;
+  int rows;
+
+  if (budget <= MEM_BASE + (1024 * 1024))
+  {
+    fprintf(stderr, "Sorry, '--max-memory' must be more than %u MB\n", (MEM_BASE / (1024 * 1024)) + 1);
+    return -1;
+  }
+  rest = budget - MEM_BASE;
+  // The output's buffer gets half when there is a compressor to share with
+  if ((output_type == timeline) || (output_type == arrow) || (output_type == xml))
+  {
+    share = (compress_method != 0) ? rest / 2 : rest;
+  }
+  switch (output_type)
+  {
+  case timeline:
+    timeline_budget = share;
+    break;
+  case arrow:
+    rows = (share / ARROW_ROW_BYTES > (size_t)AIPC_ROWS) ? AIPC_ROWS : (int)(share / ARROW_ROW_BYTES);
+    if ((arrow_rows == 0) || (arrow_rows > rows))
+    {
+      arrow_rows = rows;
+    }
+    arrow_budget = (size_t)arrow_rows * ARROW_ROW_BYTES;
+    break;
+  case xml:
+    xml_bufsize = (share < XW_BUFSIZE) ? share : XW_BUFSIZE;
+    break;
+  default:
+    break;
+  }
+  compress_budget = rest - share;
+  if ((compress_method != 0) && ((compress_threads = zo_threads(compress_budget)) == 0))
+  {
+    // (the compressor needs 4 slots, as much again for the output's buffer)
+    fprintf(stderr, "Sorry, '--max-memory' is too small for '--compress', it needs at least %u MB\n",
+      (unsigned int)((MEM_BASE + ((share > 0) ? 2 : 1) * (4 * ((2 * ZO_BLOCK) + (ZO_BLOCK / 64)))) / (1024 * 1024)) + 1);
+    return -1;
+  }
+  return 0;
+}
+
+//
+//Function: perf_exit() prints the '--perf' report when lifer exits
+void perf_exit(void)
+{
+  pmc_report(stderr, filecount);
+}
+
 //
 //Main function
 int main(int argc, char *argv[])
@@ -2265,7 +4265,29 @@ int main(int argc, char *argv[])
   int opt, process = 1, less = 0, idlist = 0; // less is the flag for short info 
                 // (can't use short, it's a keyword)
   int proc_dir = 0;           // A flag to deal with processing just one directory
+  int show_stats = 0;         // '--stats'
+  int show_progress = -1;     // '--progress' seconds (0 for the default)
+  int show_perf = 0;          // '--perf'
+  char * quarantine_path = NULL; // '--quarantine'
+  struct RENDER_OPTS ro;      // The options for the '--isolate' workers
+  struct ISO_CALLBACKS iso_cb = { isolate_render, isolate_write, isolate_quarantine };
   struct stat statbuffer;     // File details buffer
+  static struct option long_options[] =
+  {
+    { "where", required_argument, NULL, 'w' },
+    { "batch-size", required_argument, NULL, 'B' }, // (no short form)
+    { "compress", required_argument, NULL, 'Z' },   // (no short form)
+    { "numeric-flags", no_argument, NULL, 'N' },    // (no short form)
+    { "stats", no_argument, NULL, 'S' },            // (no short form)
+    { "progress", optional_argument, NULL, 'P' },   // (no short form)
+    { "perf", no_argument, NULL, 'C' },             // (no short form)
+    { "max-memory", required_argument, NULL, 'M' }, // (no short form)
+    { "serve", required_argument, NULL, 'D' },      // (no short form)
+    { "workers", required_argument, NULL, 'W' },    // (no short form)
+    { "isolate", no_argument, NULL, 'I' },          // (no short form)
+    { "quarantine", required_argument, NULL, 'Q' }, // (no short form)
+    { NULL, 0, NULL, 0 }
+  };
 
   output_type = txt;      //default output type
   filecount = 0;
@@ -2278,7 +4300,7 @@ int main(int argc, char *argv[])
   }
 
   //Parse the options
-  while ((opt = getopt(argc, argv, "vhsio:")) != -1)
+  while ((opt = getopt_long(argc, argv, "vhsio:F:w:", long_options, NULL)) != -1)
   {
     // Parse supplied command line options
     switch (opt)
@@ -2293,7 +4315,7 @@ int main(int argc, char *argv[])
       process = 0;
       break;
     case '?':
-      printf("Usage: lifer [-vhsi] [-o csv|tsv|txt] file(s)|directory\n");
+      printf("Usage: lifer [-vhsi] [-F field,...] [-w filter] [-o csv|tsv|txt|xml|timeline|arrow|json|sqlite:FILE] file(s)|directory\n");
       process = 0;
       break;
     case 's':
@@ -2302,6 +4324,95 @@ int main(int argc, char *argv[])
     case 'i':
       idlist = 1;
       break;
+    case 'w':
+      if (strcmp(optarg, "list") == 0)
+      {
+        where_list(stdout);
+        process = 0;
+      }
+      else if (where_compile(optarg, &where_tree) < 0)
+      {
+        process = 0;
+      }
+      else
+      {
+        where_mask = where_sections(where_tree);
+      }
+      break;
+    case 'B':
+      if ((arrow_rows = atoi(optarg)) <= 0)
+      {
+        fprintf(stderr, "The batch size must be a number of rows greater than 0\n");
+        process = 0;
+      }
+      break;
+    case 'Z':
+      if (strcmp(optarg, "gzip") == 0)
+      {
+        compress_method = ZO_GZIP;
+      }
+      else if (strcmp(optarg, "zstd") == 0)
+      {
+        compress_method = ZO_ZSTD;
+      }
+      else
+      {
+        printf("Invalid argument to option \'--compress\'\n");
+        printf("Valid arguments are: \'gzip\' or \'zstd\'\n");
+        process = 0;
+      }
+      break;
+    case 'N':
+      lif_a_opts |= LIF_A_NUMERIC;
+      break;
+    case 'S':
+      show_stats = 1;
+      break;
+    case 'P':
+      show_progress = 0;
+      if ((optarg != NULL) && ((show_progress = atoi(optarg)) <= 0))
+      {
+        fprintf(stderr, "The progress interval must be a number of seconds greater than 0\n");
+        process = 0;
+      }
+      break;
+    case 'C':
+      show_perf = 1;
+      break;
+    case 'M':
+      if ((max_memory = parse_size(optarg)) == 0)
+      {
+        fprintf(stderr, "The memory budget must be a size such as 512M or 2G\n");
+        process = 0;
+      }
+      break;
+    case 'D':
+      serve_path = optarg;
+      break;
+    case 'W':
+      if ((workers = atoi(optarg)) <= 0)
+      {
+        fprintf(stderr, "The number of workers must be greater than 0\n");
+        process = 0;
+      }
+      break;
+    case 'I':
+      isolate = 1;
+      break;
+    case 'Q':
+      quarantine_path = optarg;
+      break;
+    case 'F':
+      if (strcmp(optarg, "list") == 0)
+      {
+        list_columns();
+        process = 0;
+      }
+      else if (build_plan(optarg) < 0)
+      {
+        process = 0;
+      }
+      break;
     case 'o':
       if (strcmp(optarg, "csv") == 0)
       {
@@ -2319,10 +4430,27 @@ int main(int argc, char *argv[])
       {
         output_type = xml;
       }
+      else if (strcmp(optarg, "timeline") == 0)
+      {
+        output_type = timeline;
+      }
+      else if (strcmp(optarg, "arrow") == 0)
+      {
+        output_type = arrow;
+      }
+      else if (strcmp(optarg, "json") == 0)
+      {
+        output_type = json;
+      }
+      else if ((strncmp(optarg, "sqlite:", 7) == 0) && (optarg[7] != 0))
+      {
+        output_type = sqlite;
+        sqlite_file = optarg + 7;
+      }
       else
       {
         printf("Invalid argument to option \'-o\'\n");
-        printf("Valid arguments are: \'csv\', \'tsv\', or \'txt\'[default]\n");
+        printf("Valid arguments are: \'csv\', \'tsv\', \'txt\'[default], \'xml\', \'timeline\', \'arrow\', \'json\' or \'sqlite:FILE\'\n");
         process = 0;
       }
       break;
@@ -2331,6 +4459,21 @@ int main(int argc, char *argv[])
     }
   }
 
+  if (process && (serve_path != NULL))
+  {
+    // Serve requests for single link files until stopped, the format is
+    // chosen by each request
+    struct RENDER_OPTS so;
+
+    if ((compress_method != 0) || (show_progress >= 0) || show_perf)
+    {
+      fprintf(stderr, "Sorry, '--compress', '--progress' and '--perf' cannot be used with '--serve'\n");
+      exit(EXIT_FAILURE);
+    }
+    so.less = less;
+    so.idlist = idlist;
+    exit((srv_serve(serve_path, workers, serve_render, &so) < 0) ? EXIT_FAILURE : EXIT_SUCCESS);
+  }
   if (process)
   {
     //Deal with the situation where valid options have been supplied
@@ -2341,6 +4484,136 @@ int main(int argc, char *argv[])
       help_message();
       exit(EXIT_FAILURE);
     }
+    // Only the outputs written a record at a time can come from workers
+    if (isolate)
+    {
+      if ((output_type == timeline) || (output_type == arrow) || (output_type == sqlite))
+      {
+        fprintf(stderr, "Sorry, '--isolate' can only be used with '-o csv|tsv|txt|xml|json'\n");
+        exit(EXIT_FAILURE);
+      }
+      if (show_stats || show_perf)
+      {
+        fprintf(stderr, "Sorry, '--stats' and '--perf' cannot be used with '--isolate'\n");
+        exit(EXIT_FAILURE);
+      }
+    }
+    if (quarantine_path != NULL)
+    {
+      if (!isolate)
+      {
+        fprintf(stderr, "Sorry, '--quarantine' needs '--isolate'\n");
+        exit(EXIT_FAILURE);
+      }
+      if ((quarantine_fp = fopen(quarantine_path, "a")) == NULL)
+      {
+        perror("Error opening the quarantine list");
+        exit(EXIT_FAILURE);
+      }
+    }
+    // Size the buffers to fit the '--max-memory' budget
+    if ((max_memory > 0) && (plan_memory(max_memory) < 0))
+    {
+      exit(EXIT_FAILURE);
+    }
+    // Start the clock & count the output (before the compressor takes over
+    // stdout so the report comes after the last of the output is written)
+    if (show_stats)
+    {
+      st_start(&stats);
+#ifndef _WIN32
+      stdout = st_count(stdout, &stats); // (Windows can't swap stdout)
+#endif
+      atexit(stats_exit);
+    }
+    // Report progress from another thread as the files are read
+    if ((show_progress >= 0) && (pg_start(show_progress, argc - optind, argv + optind) < 0))
+    {
+      exit(EXIT_FAILURE);
+    }
+    // Count the CPU events of this thread (not the compressor's or the
+    // progress reporter's)
+    if (show_perf && (pmc_start() > 0))
+    {
+      atexit(perf_exit);
+    }
+    // Everything written to stdout from here on goes through the compressor
+    if (compress_method != 0)
+    {
+      if (output_type == sqlite)
+      {
+        fprintf(stderr, "Sorry, '--compress' cannot be used with '-o sqlite'\n");
+        exit(EXIT_FAILURE);
+      }
+      if (zo_open(compress_method, compress_threads) < 0)
+      {
+        exit(EXIT_FAILURE);
+      }
+    }
+    // A timeline is collected as the files are read and printed at the end
+    if (output_type == timeline)
+    {
+      if (plan_len > 0)
+      {
+        fprintf(stderr, "Sorry, '-F' cannot be used with '-o timeline'\n");
+        exit(EXIT_FAILURE);
+      }
+      if (tl_init(timeline_budget) < 0)
+      {
+        exit(EXIT_FAILURE);
+      }
+    }
+    // The Arrow schema is written first, then the rows in batches as the files
+    // are read
+    if (output_type == arrow)
+    {
+      if (plan_len > 0)
+      {
+        fprintf(stderr, "Sorry, '-F' cannot be used with '-o arrow'\n");
+        exit(EXIT_FAILURE);
+      }
+#ifdef _WIN32
+      _setmode(_fileno(stdout), _O_BINARY); // No CR/LF translation of the stream
+#endif
+      if (aipc_open(stdout, arrow_fields, NUMARROW, arrow_rows, &arrow_writer) < 0)
+      {
+        exit(EXIT_FAILURE);
+      }
+    }
+    if (output_type == sqlite)
+    {
+      if (plan_len > 0)
+      {
+        fprintf(stderr, "Sorry, '-F' cannot be used with '-o sqlite'\n");
+        exit(EXIT_FAILURE);
+      }
+      if (ldb_open(sqlite_file) < 0)
+      {
+        exit(EXIT_FAILURE);
+      }
+    }
+    if ((output_type == json) && (plan_len > 0))
+    {
+      fprintf(stderr, "Sorry, '-F' cannot be used with '-o json'\n");
+      exit(EXIT_FAILURE);
+    }
+    // XML output is escaped as it is written, a large output buffer keeps
+    // the many small writes cheap
+    if (output_type == xml)
+    {
+      xw_buffer(stdout, xml_bufsize);
+    }
+    // The workers are started with the first file (after read_dir() has
+    // changed to the directory)
+    if (isolate)
+    {
+      ro.less = less;
+      ro.idlist = idlist;
+      if (iso_start(workers, &iso_cb, &ro) < 0)
+      {
+        exit(EXIT_FAILURE);
+      }
+    }
     for (; optind < argc; optind++)
     {
       if (stat(argv[optind], &statbuffer) != 0)
@@ -2368,17 +4641,67 @@ int main(int argc, char *argv[])
       //Process regular files
       else if (((statbuffer.st_mode & S_IFMT) == S_IFREG))
       {
-        proc_file(argv[optind], less, idlist);
+        take_file(argv[optind], less, idlist);
       }
       proc_dir = 1; //Prevent processing of directories after first argument
       //(The default behaviour is to process 1 directory OR
       //several files)
     }
+    // Write the output of the files the workers still have & stop them
+    if (isolate && (iso_finish() < 0))
+    {
+      exit(EXIT_FAILURE);
+    }
+    if (quarantine_fp != NULL)
+    {
+      fclose(quarantine_fp);
+    }
+    st_lap(&stats, ST_FINISH);
+    st_pool(&stats, "decode", 0, sizeof(struct LIF) + sizeof(struct LIF_A) + sizeof(struct LIF_SER_PROPSTORE_A));
     // If the output is XML then we need to make it well-formed and close it off properly
-    if (output_type == xml)
+    // (unless nothing was output, a filter may have matched no files)
+    if ((output_type == xml) && (filecount > 0))
     {
       printf("</LinkFiles>\n");
     }
+    // Now all the events are known the timeline can be sorted and printed
+    if (output_type == timeline)
+    {
+      printf("Time|Event|Link File|Target\n");
+      if (tl_finish(stdout) < 0)
+      {
+        fprintf(stderr, "Error writing the timeline\n");
+        exit(EXIT_FAILURE);
+      }
+      st_pool(&stats, "timeline", (timeline_budget > 0) ? timeline_budget : TL_BUDGET, tl_peak());
+    }
+    // Write the last record batch & end the stream
+    if (output_type == arrow)
+    {
+      st_pool(&stats, "arrow", arrow_budget, aipc_peak(arrow_writer));
+      if (aipc_close(arrow_writer) < 0)
+      {
+        exit(EXIT_FAILURE);
+      }
+    }
+    if (output_type == xml)
+    {
+      st_pool(&stats, "xml_buffer", (xml_bufsize > 0) ? xml_bufsize : XW_BUFSIZE, (xml_bufsize > 0) ? xml_bufsize : XW_BUFSIZE);
+    }
+    // Commit the last of the link files & index the database
+    if ((output_type == sqlite) && (ldb_close() < 0))
+    {
+      exit(EXIT_FAILURE);
+    }
+    // Compress & write the last block of the output
+    if (zo_close() < 0)
+    {
+      exit(EXIT_FAILURE);
+    }
+    if (compress_method != 0)
+    {
+      st_pool(&stats, "compressor", compress_budget, zo_peak());
+    }
   }
   exit(EXIT_SUCCESS);
 }
\ No newline at end of file